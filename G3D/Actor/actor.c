@@ -29,10 +29,12 @@
 
 	
 */
+#include <windows.h>	 // InterlockedIncrement for geActor_RenderPrepBatch
 #include <assert.h>
 #include <string.h>  //strnicmp		memmove()
 #include <math.h>	 // fabs()
 #include <stdio.h>	 //sscanf
+#include <stdlib.h>	 //qsort
 
 #include "world.h"	// to expose _Render apis in actor.h
 
@@ -43,6 +45,7 @@
 #include "Motion.h"
 #include "ErrorLog.h"
 #include "strblock.h"
+#include "WorkPool.h"
 #ifdef _DEBUG
 #include <crtdbg.h>
 #endif
@@ -73,8 +76,19 @@ typedef struct geActor
 	geExtBox			RenderHintExtBox;
 	int					RenderHintExtBoxCenterBoneIndex;
 	geBoolean			RenderHintExtBoxEnabled;
+
+	uint32				BoxStamp;				// bumped whenever the boxes are changed (not counting the pose)
+	struct geActor_BoxWatch	*BoxWatches;		// told whenever the boxes (or the pose) are changed
+	int					BoxWatchCount;
 } geActor;
 
+typedef struct geActor_BoxWatch
+{
+	geActor_BoxWatchCB	*CB;
+	void				*Context;
+	int32				 Tag;
+} geActor_BoxWatch;
+
 
 typedef struct geActor_Def
 {
@@ -95,6 +109,26 @@ int geActor_RefCount    = 0;
 int geActor_DefCount    = 0;
 int geActor_DefRefCount = 0;
 
+static void GENESISCC geActor_NotifyBoxWatches(geActor *A)
+{
+	int i;
+
+	for (i=0; i<A->BoxWatchCount; i++)
+		A->BoxWatches[i].CB(A->BoxWatches[i].Context, A->BoxWatches[i].Tag);
+}
+
+static void GENESISCC geActor_BoxChanged(geActor *A)
+{
+	A->BoxStamp++;
+	geActor_NotifyBoxWatches(A);
+}
+
+	// the pose tells us whenever it (or the pose it's attached to) changes
+static void GENESISCC geActor_PoseChanged(void *Context)
+{
+	geActor_NotifyBoxWatches((geActor *)Context);
+}
+
 	// returns number of actors that are currently created.
 GENESISAPI int GENESISCC geActor_GetCount(void)
 {
@@ -254,6 +288,8 @@ GENESISAPI geActor *GENESISCC geActor_Create(geActor_Def *ActorDefinition)
 	A->Puppet = NULL;
 	A->Pose   = NULL;
 	A->CueMotion = NULL;
+	A->BoxWatches = NULL;
+	A->BoxWatchCount = 0;
 
 	A->Pose = gePose_Create();
 	if (A->Pose == NULL)
@@ -261,6 +297,7 @@ GENESISAPI geActor *GENESISCC geActor_Create(geActor_Def *ActorDefinition)
 			geErrorLog_Add(ERR_ACTOR_ENOMEM, NULL);
 			goto ActorCreateFailure;
 		}
+	gePose_SetChangedCB(A->Pose, geActor_PoseChanged, A);
 	
 	A->RefCount          = 0;
 	A->BlendingType		 = GE_ACTOR_BLEND_HERMITE;
@@ -269,6 +306,7 @@ GENESISAPI geActor *GENESISCC geActor_Create(geActor_Def *ActorDefinition)
 	A->BoundingBoxCenterBoneIndex = GE_POSE_ROOT_JOINT;
 	A->RenderHintExtBoxCenterBoneIndex = GE_POSE_ROOT_JOINT;
 	A->RenderHintExtBoxEnabled = GE_FALSE;
+	A->BoxStamp          = 0;
 	A->StepBoneIndex     = GE_POSE_ROOT_JOINT;
 	geExtBox_Set(&(A->RenderHintExtBox), 0.0f,0.0f,0.0f,0.0f,0.0f,0.0f);
 	if (A->CueMotion == NULL)
@@ -392,6 +430,11 @@ GENESISAPI geBoolean GENESISCC geActor_Destroy(geActor **pA)
 			geMotion_Destroy(&(A->CueMotion));
 			A->CueMotion = NULL;
 		}
+	if ( A->BoxWatches != NULL )
+		{
+			geRam_Free(A->BoxWatches);
+			A->BoxWatches = NULL;
+		}
 	geRam_Free(*pA);
 	geActor_Count--;
 	*pA = NULL;
@@ -449,6 +492,9 @@ GENESISAPI geBoolean GENESISCC geActor_DestroyDirect(geActor **pA)
 
 		CurrentActor->UserData = NULL;
 
+		if (CurrentActor->BoxWatches != NULL)
+			geRam_Free(CurrentActor->BoxWatches);
+
 		// free the actor
 		geRam_Free(CurrentActor);
 		CurrentActor = NULL;
@@ -1072,6 +1118,53 @@ GENESISAPI geBoolean GENESISCC geActor_GetExtBox(const geActor *A, geExtBox *Ext
 }
 
 
+uint32 GENESISCC geActor_GetBoxStamp(const geActor *A)
+{
+	assert( geActor_IsValid(A) != GE_FALSE);
+
+	return A->BoxStamp + gePose_GetStamp(A->Pose);
+}
+
+geBoolean GENESISCC geActor_AddBoxWatch(geActor *A, geActor_BoxWatchCB *CB, void *Context, int32 Tag)
+{
+	geActor_BoxWatch *NewWatches;
+
+	assert( geActor_IsValid(A) != GE_FALSE);
+	assert( CB != NULL );
+
+	NewWatches = GE_RAM_REALLOC_ARRAY( A->BoxWatches, geActor_BoxWatch, A->BoxWatchCount+1 );
+	if ( NewWatches == NULL )
+		{
+			geErrorLog_Add( ERR_ACTOR_ENOMEM , NULL);
+			return GE_FALSE;
+		}
+	A->BoxWatches = NewWatches;
+	A->BoxWatches[A->BoxWatchCount].CB      = CB;
+	A->BoxWatches[A->BoxWatchCount].Context = Context;
+	A->BoxWatches[A->BoxWatchCount].Tag     = Tag;
+	A->BoxWatchCount++;
+	return GE_TRUE;
+}
+
+void GENESISCC geActor_RemoveBoxWatch(geActor *A, geActor_BoxWatchCB *CB, void *Context, int32 Tag)
+{
+	int i;
+
+	assert( geActor_IsValid(A) != GE_FALSE);
+
+	for (i=0; i<A->BoxWatchCount; i++)
+		{
+			if (   (A->BoxWatches[i].CB == CB) && (A->BoxWatches[i].Context == Context)
+				&& (A->BoxWatches[i].Tag == Tag) )
+				{
+					A->BoxWatches[i] = A->BoxWatches[A->BoxWatchCount-1];
+					A->BoxWatchCount--;
+					return;
+				}
+		}
+	assert(0);		// wasn't watching
+}
+
 GENESISAPI geBoolean GENESISCC geActor_SetExtBox(geActor *A,
 												 const geExtBox *ExtBox,
 												 const char *CenterOnThisNamedBone)
@@ -1082,6 +1175,7 @@ GENESISAPI geBoolean GENESISCC geActor_SetExtBox(geActor *A,
 	
 	A->BoundingBoxMinCorner = ExtBox->Min;
 	A->BoundingBoxMaxCorner = ExtBox->Max;
+	geActor_BoxChanged(A);
 	
 	if (geActor_GetBoneIndex(A,CenterOnThisNamedBone,&(A->BoundingBoxCenterBoneIndex))==GE_FALSE)
 		{
@@ -1143,6 +1237,7 @@ GENESISAPI geBoolean GENESISCC geActor_SetRenderHintExtBox(geActor *A, const geE
 		{
 			A->RenderHintExtBoxEnabled = GE_TRUE;
 		}
+	geActor_BoxChanged(A);
 
 	return GE_TRUE;
 }
@@ -1460,7 +1555,9 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationCue( geActor *A,
 }
 
 
-GENESISAPI geBoolean GENESISCC geActor_AnimationStep(geActor *A, geFloat DeltaTime )
+	// moves the cues along by DeltaTime, and kills the ones that are over or covered up.
+	// This is the part of AnimationStep that changes the motions, so it can't be threaded
+static void GENESISCC geActor_StepCues(geActor *A, geFloat DeltaTime )
 {
 	int i,Coverage,Count;
 	geMotion *M;
@@ -1506,9 +1603,17 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationStep(geActor *A, geFloat DeltaTi
 						}
 				}
 		}
+}
 
-	gePose_SetMotion( A->Pose, M, 0.0f, NULL );
-	geMotion_SetupEventIterator(M,-DeltaTime,0.0f);
+GENESISAPI geBoolean GENESISCC geActor_AnimationStep(geActor *A, geFloat DeltaTime )
+{
+	assert( geActor_IsValid(A) != GE_FALSE);
+	assert( DeltaTime >= 0.0f );
+	
+	geActor_StepCues(A,DeltaTime);
+
+	gePose_SetMotion( A->Pose, A->CueMotion, 0.0f, NULL );
+	geMotion_SetupEventIterator(A->CueMotion,-DeltaTime,0.0f);
 
 	return GE_TRUE;
 }
@@ -1883,6 +1988,7 @@ geBoolean GENESISCC geActor_RenderPrep( geActor *A, geWorld *World)
 		
 		A->BoundingBoxMinCorner = EB.Min;
 		A->BoundingBoxMaxCorner = EB.Max;
+		geActor_BoxChanged(A);
 	}
 	
 	return GE_TRUE;
@@ -1940,6 +2046,260 @@ geBoolean GENESISCC geActor_Render(const geActor *A, geEngine *Engine, geWorld *
 	return GE_TRUE;
 }
 
+//  Batched render prep and animation:  the actors are split up into groups that share the
+//  same pose at the top of their attachments (updating a pose updates the ones it's attached
+//  to), and each group is posed (and skinned) on one thread, so the groups can go at once.
+//  The batches are called every frame, usually with the same actors, so their lists are kept
+//  (as big as the most actors they've had), and so is the grouping while the actors and their
+//  attachments stay the same.  Called from one thread at a time, like the rest of the engine.
+#define ACTOR_PREP_PER_THREAD		4				// groups.  Not worth starting a thread for less
+
+typedef struct
+{
+	const geActor		*Actor;
+	const gePose		*Root;					// gePose_GetAttachRoot of the actors pose
+} geActor_PrepWork;
+
+typedef struct
+{
+	geActor_PrepWork	*Input;					// the actors given to the last batch, in order
+	int32				 NumInput;
+	geBoolean			 InputChanged;			// Input isn't what Work and Groups were made from
+	geActor_PrepWork	*Work;					// Input sorted by Root
+	int32				*Groups;				// first Work of each group, and one past the last
+	int32				 NumGroups;
+	int32				 MaxWork;				// what Input, Work and Groups have room for
+	const geCamera		*Camera;				// NULL to sample the cued motions instead
+	volatile LONG		 NextGroup;
+} geActor_PrepBatch;
+
+static geActor_PrepBatch geActor_RenderBatch;
+static geActor_PrepBatch geActor_AnimationBatch;
+
+static int geActor_PrepWorkCompare(const void *W1, const void *W2)
+{
+	const gePose *R1 = ((const geActor_PrepWork *)W1)->Root;
+	const gePose *R2 = ((const geActor_PrepWork *)W2)->Root;
+
+	if (R1 < R2)
+		return -1;
+	if (R1 > R2)
+		return 1;
+	return 0;
+}
+
+	// makes room in Batch for Count actors.  Returns GE_FALSE if there isn't memory.
+static geBoolean geActor_GrowPrepBatch(geActor_PrepBatch *Batch, int32 Count)
+{
+	geActor_PrepWork *Work;
+	int32 *Groups;
+
+	if (Count <= Batch->MaxWork)
+		return GE_TRUE;
+
+	Work = GE_RAM_REALLOC_ARRAY(Batch->Input, geActor_PrepWork, Count);
+	if (Work == NULL)
+		return GE_FALSE;
+	Batch->Input = Work;
+
+	Work = GE_RAM_REALLOC_ARRAY(Batch->Work, geActor_PrepWork, Count);
+	if (Work == NULL)
+		return GE_FALSE;
+	Batch->Work = Work;
+
+	Groups = GE_RAM_REALLOC_ARRAY(Batch->Groups, int32, Count+1);
+	if (Groups == NULL)
+		return GE_FALSE;
+	Batch->Groups = Groups;
+
+	Batch->MaxWork = Count;
+	return GE_TRUE;
+}
+
+	// puts A at Index of the batch's actors, noting if it isn't what was there last time
+static void geActor_SetPrepWork(geActor_PrepBatch *Batch, int32 Index, const geActor *A)
+{
+	geActor_PrepWork *W;
+	const gePose *Root;
+
+	assert( Index < Batch->MaxWork );
+
+	W = &(Batch->Input[Index]);
+	Root = gePose_GetAttachRoot(A->Pose);
+	if (Index >= Batch->NumInput || W->Actor != A || W->Root != Root)
+		{
+			W->Actor = A;
+			W->Root  = Root;
+			Batch->InputChanged = GE_TRUE;
+		}
+}
+
+static void geActor_FreePrepBatch(geActor_PrepBatch *Batch)
+{
+	if (Batch->Input != NULL)
+		geRam_Free(Batch->Input);
+	if (Batch->Work != NULL)
+		geRam_Free(Batch->Work);
+	if (Batch->Groups != NULL)
+		geRam_Free(Batch->Groups);
+	memset(Batch, 0, sizeof(*Batch));
+}
+
+	// takes groups off the batch until there are none left
+static void geActor_RunPrepBatch(void *Context)
+{
+	geActor_PrepBatch *Batch;
+	LONG g;
+	int32 i;
+	const geActor *A;
+
+	Batch = (geActor_PrepBatch *)Context;
+
+	while ((g = InterlockedIncrement(&Batch->NextGroup)-1) < Batch->NumGroups)
+		{
+			for (i=Batch->Groups[g]; i<Batch->Groups[g+1]; i++)
+				{
+					A = Batch->Work[i].Actor;
+					if (Batch->Camera == NULL)
+						{	// geActor_AnimationStepBatch bound the cue motion to the pose, so this doesn't allocate
+							gePose_SetMotion(A->Pose, A->CueMotion, 0.0f, NULL);
+							continue;
+						}
+					// if this fails, gePuppet_Render just does it over itself
+					gePuppet_PrepGeometry(A->Puppet, A->Pose, Batch->Camera);
+				}
+		}
+}
+
+	// groups the first NumWork of Batch->Input (unless they're the ones grouped last time),
+	// and runs them on up to NumThreads
+static void geActor_StartPrepBatch(geActor_PrepBatch *Batch, int32 NumWork, int32 NumThreads)
+{
+	int32		i;
+
+	if (Batch->InputChanged != GE_FALSE || NumWork != Batch->NumInput)
+		{
+			memcpy(Batch->Work, Batch->Input, sizeof(geActor_PrepWork) * NumWork);
+			qsort(Batch->Work, NumWork, sizeof(geActor_PrepWork), geActor_PrepWorkCompare);
+
+			Batch->NumGroups = 0;
+			for (i=0; i<NumWork; i++)
+				{
+					if (i == 0 || Batch->Work[i].Root != Batch->Work[i-1].Root)
+						Batch->Groups[Batch->NumGroups++] = i;
+				}
+			Batch->Groups[Batch->NumGroups] = NumWork;
+
+			Batch->NumInput = NumWork;
+			Batch->InputChanged = GE_FALSE;
+		}
+
+	if (Batch->NumGroups <= 0)
+		return;
+
+	Batch->NextGroup = 0;
+	NumThreads = WorkPool_NumThreads(NumThreads, Batch->NumGroups, ACTOR_PREP_PER_THREAD);
+
+	WorkPool_Run(geActor_RunPrepBatch, Batch, NumThreads);
+}
+
+geBoolean GENESISCC geActor_RenderPrepBatch(const geActor * const *Actors, int32 Count, const geCamera *Camera, int32 NumThreads)
+{
+	geActor_PrepBatch *Batch = &geActor_RenderBatch;
+	int32		i, NumWork;
+	const geActor *A;
+
+	assert( Actors != NULL || Count == 0 );
+	assert( Camera != NULL );
+
+	// whatever was prepped before is no good anymore
+	gePuppet_BeginGeometryBatch();
+
+	if (Count <= 0)
+		return GE_TRUE;
+
+	if (geActor_GrowPrepBatch(Batch, Count) == GE_FALSE)
+		{
+			geErrorLog_Add( ERR_ACTOR_ENOMEM , NULL);
+			return GE_FALSE;
+		}
+
+	// anything that allocates or logs errors is done here, on this thread
+	NumWork = 0;
+	for (i=0; i<Count; i++)
+		{
+			A = Actors[i];
+			assert( geActor_IsValid(A) != GE_FALSE );
+			if (A->Puppet == NULL)
+				continue;
+
+			if (gePuppet_AllocateGeometry(A->Puppet)==GE_FALSE)
+				{
+					geErrorLog_Add( ERR_ACTOR_RENDER_PREP , NULL);
+					return GE_FALSE;
+				}
+
+			geActor_SetPrepWork(Batch, NumWork, A);
+			NumWork++;
+		}
+
+	Batch->Camera = Camera;
+	geActor_StartPrepBatch(Batch, NumWork, NumThreads);
+
+	return GE_TRUE;
+}
+
+GENESISAPI geBoolean GENESISCC geActor_AnimationStepBatch(geActor * const *Actors, int32 Count, geFloat DeltaTime, int32 NumThreads)
+{
+	geActor_PrepBatch *Batch = &geActor_AnimationBatch;
+	int32		i, NumWork;
+	geActor		*A;
+
+	assert( Actors != NULL || Count == 0 );
+	assert( DeltaTime >= 0.0f );
+
+	if (Count <= 0)
+		return GE_TRUE;
+
+	if (geActor_GrowPrepBatch(Batch, Count) == GE_FALSE)
+		{	// still step them, one at a time
+			for (i=0; i<Count; i++)
+				geActor_AnimationStep(Actors[i],DeltaTime);
+			return GE_TRUE;
+		}
+
+	// the cues free and share motions, and binding the cue motion to the pose allocates,
+	// so all that is done here, on this thread.  The threads only sample.
+	NumWork = 0;
+	for (i=0; i<Count; i++)
+		{
+			A = Actors[i];
+			assert( geActor_IsValid(A) != GE_FALSE );
+			geActor_StepCues(A,DeltaTime);
+			geMotion_SetupEventIterator(A->CueMotion,-DeltaTime,0.0f);
+
+			if (gePose_PrepareMotion(A->Pose, A->CueMotion) == GE_FALSE)
+				{	// no binding: sampling would use the paths' own key caches, so not on the threads
+					gePose_SetMotion(A->Pose, A->CueMotion, 0.0f, NULL);
+					continue;
+				}
+
+			geActor_SetPrepWork(Batch, NumWork, A);
+			NumWork++;
+		}
+
+	Batch->Camera = NULL;
+	geActor_StartPrepBatch(Batch, NumWork, NumThreads);
+
+	return GE_TRUE;
+}
+
+void GENESISCC geActor_BatchShutdown(void)
+{
+	geActor_FreePrepBatch(&geActor_RenderBatch);
+	geActor_FreePrepBatch(&geActor_AnimationBatch);
+}
+
 GENESISAPI int GENESISCC geActor_GetMaterialCount(const geActor *A)
 {
 	assert( geActor_IsValid(A) != GE_FALSE );
@@ -23,6 +23,7 @@
 #include <string.h>						//strlen(), strcpy()
 #include <math.h> 						//fabs()
 #include <stdio.h>						//sscanf
+#include <stdlib.h>						//qsort()
 
 #include "body.h"
 #include "body._h"
@@ -125,6 +126,182 @@ geBoolean GENESISCC geBody_IsValid(const geBody *B)
 }
 	
 
+typedef struct geBody_SkinPoint
+{
+	geVec3d			Point;
+	geBody_Index	BoneIndex;
+	geBody_Index	Index;
+} geBody_SkinPoint;
+
+static int geBody_SkinPointCompare(const void *P1, const void *P2)
+{
+	const geBody_SkinPoint *SP1 = (const geBody_SkinPoint *)P1;
+	const geBody_SkinPoint *SP2 = (const geBody_SkinPoint *)P2;
+
+	if (SP1->BoneIndex != SP2->BoneIndex)
+		return SP1->BoneIndex - SP2->BoneIndex;
+	return SP1->Index - SP2->Index;		// keep the original order within a bone
+}
+
+static void GENESISCC geBody_DestroySkinPack(geBody_SkinPack **PPack)
+{
+	geBody_SkinPack *Pack;
+
+	assert( PPack != NULL );
+	Pack = *PPack;
+	if (Pack == NULL)
+		return;
+	if (Pack->BatchArray != NULL)
+		geRam_Free(Pack->BatchArray);
+	if (Pack->X != NULL)
+		geRam_Free(Pack->X);
+	if (Pack->Index != NULL)
+		geRam_Free(Pack->Index);
+	geRam_Free(*PPack);
+	*PPack = NULL;
+}
+
+static geBody_SkinPack *GENESISCC geBody_CreateSkinPack(geBody_SkinPoint *Points, int Count)
+	// sorts Points by bone, then packs them
+{
+	geBody_SkinPack *Pack;
+	geBody_SkinBatch *Batch;
+	int i,j,Slot;
+
+	assert( Points != NULL || Count == 0 );
+
+	qsort(Points, Count, sizeof(geBody_SkinPoint), geBody_SkinPointCompare);
+
+	Pack = GE_RAM_ALLOCATE_STRUCT(geBody_SkinPack);
+	if (Pack == NULL)
+		{
+			geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+			return NULL;
+		}
+	Pack->BatchCount = 0;
+	Pack->BatchArray = NULL;
+	Pack->Size = 0;
+	Pack->X = Pack->Y = Pack->Z = NULL;
+	Pack->Index = NULL;
+
+	for (i=0; i<Count; i=j)
+		{
+			for (j=i+1; j<Count && Points[j].BoneIndex == Points[i].BoneIndex; j++)
+				;
+			Pack->BatchCount++;
+			Pack->Size += (j-i + GE_BODY_SKIN_BLOCK-1) & ~(GE_BODY_SKIN_BLOCK-1);
+		}
+
+	if (Pack->BatchCount == 0)
+		return Pack;
+
+	Pack->BatchArray = GE_RAM_ALLOCATE_ARRAY(geBody_SkinBatch, Pack->BatchCount);
+	Pack->X = GE_RAM_ALLOCATE_ARRAY(geFloat, Pack->Size * 3);
+	Pack->Index = GE_RAM_ALLOCATE_ARRAY(geBody_Index, Pack->Size);
+	if (Pack->BatchArray == NULL || Pack->X == NULL || Pack->Index == NULL)
+		{
+			geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+			geBody_DestroySkinPack(&Pack);
+			return NULL;
+		}
+	Pack->Y = Pack->X + Pack->Size;
+	Pack->Z = Pack->Y + Pack->Size;
+
+	Slot = 0;
+	Batch = Pack->BatchArray;
+	for (i=0; i<Count; i=j, Batch++)
+		{
+			Batch->BoneIndex = Points[i].BoneIndex;
+			Batch->Start = Slot;
+			for (j=i; j<Count && Points[j].BoneIndex == Points[i].BoneIndex; j++, Slot++)
+				{
+					Pack->X[Slot] = Points[j].Point.X;
+					Pack->Y[Slot] = Points[j].Point.Y;
+					Pack->Z[Slot] = Points[j].Point.Z;
+					Pack->Index[Slot] = Points[j].Index;
+				}
+			for ( ; (Slot - Batch->Start) & (GE_BODY_SKIN_BLOCK-1); Slot++)
+				{
+					Pack->X[Slot] = Pack->X[Slot-1];
+					Pack->Y[Slot] = Pack->Y[Slot-1];
+					Pack->Z[Slot] = Pack->Z[Slot-1];
+					Pack->Index[Slot] = Pack->Index[Slot-1];
+				}
+			Batch->Count = Slot - Batch->Start;
+		}
+	assert( Slot == Pack->Size );
+
+	return Pack;
+}
+
+static void GENESISCC geBody_UnpackSkin(geBody *B)
+{
+	assert( B != NULL );
+	geBody_DestroySkinPack(&(B->VertexPack));
+	geBody_DestroySkinPack(&(B->NormalPack));
+	B->SkinPacked = GE_FALSE;
+}
+
+geBoolean GENESISCC geBody_PackSkin(geBody *B)
+{
+	geBody_SkinPoint *Points;
+	int i,Count;
+
+	assert( geBody_IsValid(B) != GE_FALSE );
+
+	if (B->SkinPacked != GE_FALSE)
+		{
+			return (B->VertexPack != NULL && B->NormalPack != NULL);
+		}
+
+	// Only tried once per change to the skin, so the render threads never rebuild them
+	B->SkinPacked = GE_TRUE;
+
+	Points = GE_RAM_ALLOCATE_ARRAY(geBody_SkinPoint, MAX(B->XSkinVertexCount,B->SkinNormalCount) + 1);
+	if (Points == NULL)
+		{
+			geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+			return GE_FALSE;
+		}
+
+	for (i=0,Count=0; i<B->XSkinVertexCount; i++)
+		{
+			const geBody_XSkinVertex *SV = &(B->XSkinVertexArray[i]);
+			if (SV->LevelOfDetailMask)
+				{
+					Points[Count].Point     = SV->XPoint;
+					Points[Count].BoneIndex = SV->BoneIndex;
+					Points[Count].Index     = (geBody_Index)i;
+					Count++;
+				}
+		}
+	B->VertexPack = geBody_CreateSkinPack(Points,Count);
+
+	for (i=0,Count=0; i<B->SkinNormalCount; i++)
+		{
+			const geBody_Normal *N = &(B->SkinNormalArray[i]);
+			if (N->LevelOfDetailMask)
+				{
+					Points[Count].Point     = N->Normal;
+					Points[Count].BoneIndex = N->BoneIndex;
+					Points[Count].Index     = (geBody_Index)i;
+					Count++;
+				}
+		}
+	B->NormalPack = geBody_CreateSkinPack(Points,Count);
+
+	geRam_Free(Points);
+
+	if (B->VertexPack == NULL || B->NormalPack == NULL)
+		{
+			geBody_UnpackSkin(B);
+			B->SkinPacked = GE_TRUE;
+			return GE_FALSE;
+		}
+	return GE_TRUE;
+}
+
+
 static geBody *GENESISCC geBody_CreateNull(void)
 {
 	geBody *B;
@@ -156,6 +333,9 @@ static geBody *GENESISCC geBody_CreateNull(void)
 			B->SkinFaces[i].FaceArray = NULL;
 		}
 	B->LevelsOfDetail = 1;
+	B->SkinPacked = GE_FALSE;
+	B->VertexPack = NULL;
+	B->NormalPack = NULL;
 	B->IsValid = B;
 
 	geVec3d_Set(&(B->BoundingBoxMin),0.0f,0.0f,0.0f);
@@ -170,6 +350,7 @@ static void GENESISCC geBody_DestroyPossiblyIncompleteBody( geBody **PB )
 
 	B = *PB;
 	B->IsValid = NULL;
+	geBody_UnpackSkin(B);
 	if (B->XSkinVertexArray != NULL)
 		{
 			geRam_Free( B->XSkinVertexArray );
@@ -710,6 +891,8 @@ geBoolean GENESISCC geBody_AddFace(	geBody *B,
 	assert( MaterialIndex >= 0 );
 	assert(	MaterialIndex < B->MaterialCount );
 
+	geBody_UnpackSkin(B);
+
 	if (geBody_AddSkinVertex(B,Vertex1,U1,V1,(geBody_Index)BoneIndex1,&(F.VtxIndex[0]))==GE_FALSE)
 		{	// error already recorded
 			return GE_FALSE;
@@ -1077,6 +1260,9 @@ geBody *GENESISCC geBody_CreateFromFile(geVFile *pFile)
 		{	geErrorLog_Add( ERR_BODY_FILE_READ , NULL);	goto CreateError;}
 	geVFile_Close(SubFile);
 
+	// no error if this fails, geBodyInst just skins it one point at a time
+	geBody_PackSkin(B);
+
 	BitmapDirectory = geVFile_Open(VFile,GE_BODY_BITMAP_DIRECTORY_NAME, 
 									GE_VFILE_OPEN_DIRECTORY | GE_VFILE_OPEN_READONLY);
 	if (BitmapDirectory == NULL)
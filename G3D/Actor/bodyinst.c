@@ -26,6 +26,7 @@
 #include "ram.h"
 #include "errorlog.h"
 #include "strblock.h"
+#include "Drivers\SoftDrv2\CPUSimd.h"
 
 
 
@@ -35,9 +36,321 @@ typedef struct geBodyInst
 	geBodyInst_Geometry		 ExportGeometry;
 	int						 LastLevelOfDetail;
 	geBodyInst_Index		 FaceCount;
+	geFloat					*PackScratch;		// X, then Y, then Z of the skinned packed points
+	int32					 PackScratchSize;	// Points in each of X, Y and Z
+	geXForm3d				*BatchXForms;		// One per bone batch being skinned
+	int32					 BatchXFormCount;
 } geBodyInst;
 
 
+typedef struct geBodyInst_Projection
+{
+	geFloat Scale,ZScale;
+	geFloat XCenter,YCenter;
+	geFloat MinZ;
+} geBodyInst_Projection;
+
+	// Transforms every slot of Pack by its batch's transform in XForms, into X,Y,Z.
+	// Translate is GE_FALSE for normals.  If Proj is not NULL the points are then
+	// projected exactly like geCamera_Project/ProjectZ do.  If Mins is not NULL, Mins
+	// and Maxs are grown to hold the results.
+typedef void GENESISCC geBodyInst_SkinBlocksFunc(
+	const geBody_SkinPack *Pack, const geXForm3d *XForms, geBoolean Translate,
+	const geBodyInst_Projection *Proj, 
+	geFloat *X, geFloat *Y, geFloat *Z, geVec3d *Mins, geVec3d *Maxs);
+
+static geBodyInst_SkinBlocksFunc *geBodyInst_SkinBlocks = NULL;
+
+
+static void GENESISCC geBodyInst_SkinBlocks_C(
+	const geBody_SkinPack *Pack, const geXForm3d *XForms, geBoolean Translate,
+	const geBodyInst_Projection *Proj, 
+	geFloat *X, geFloat *Y, geFloat *Z, geVec3d *Mins, geVec3d *Maxs)
+{
+	const geBody_SkinBatch *Batch;
+	const geXForm3d *M;
+	int b,i,End;
+
+	for (b=0,Batch=Pack->BatchArray,M=XForms; b<Pack->BatchCount; b++,Batch++,M++)
+		{
+			End = Batch->Start + Batch->Count;
+			for (i=Batch->Start; i<End; i++)
+				{
+					geFloat VX = Pack->X[i], VY = Pack->Y[i], VZ = Pack->Z[i];
+					geFloat RX,RY,RZ;
+					RX = (VX * M->AX) + (VY * M->AY) + (VZ * M->AZ);
+					RY = (VX * M->BX) + (VY * M->BY) + (VZ * M->BZ);
+					RZ = (VX * M->CX) + (VY * M->CY) + (VZ * M->CZ);
+					if (Translate)
+						{
+							RX += M->Translation.X;
+							RY += M->Translation.Y;
+							RZ += M->Translation.Z;
+						}
+					if (Proj != NULL)
+						{
+							geFloat PZ,ScaleOverZ;
+							PZ = -RZ;
+							if (PZ < Proj->MinZ)
+								PZ = Proj->MinZ;
+							#ifdef ONE_OVER_Z_PIPELINE
+							RZ = 1.0f / PZ;
+							ScaleOverZ = Proj->Scale * RZ;
+							#else
+							ScaleOverZ = Proj->Scale / PZ;
+							RZ = PZ * Proj->ZScale;
+							#endif
+							RX = ( RX * ScaleOverZ ) + Proj->XCenter;
+							RY = Proj->YCenter - ( RY * ScaleOverZ );
+						}
+					X[i] = RX;
+					Y[i] = RY;
+					Z[i] = RZ;
+					if (Mins != NULL)
+						{
+							if (RX > Maxs->X ) Maxs->X = RX;
+							if (RX < Mins->X ) Mins->X = RX;
+							if (RY > Maxs->Y ) Maxs->Y = RY;
+							if (RY < Mins->Y ) Mins->Y = RY;
+							if (RZ > Maxs->Z ) Maxs->Z = RZ;
+							if (RZ < Mins->Z ) Mins->Z = RZ;
+						}
+				}
+		}
+}
+
+#ifdef GE_HAVE_SSE2
+	// 4 points at a time.  The sums are done in the same order as the C version, and
+	// max/min pick the same way the compares do, so the results are identical.
+static void GENESISCC geBodyInst_SkinBlocks_SSE2(
+	const geBody_SkinPack *Pack, const geXForm3d *XForms, geBoolean Translate,
+	const geBodyInst_Projection *Proj, 
+	geFloat *X, geFloat *Y, geFloat *Z, geVec3d *Mins, geVec3d *Maxs)
+{
+	const geBody_SkinBatch *Batch;
+	const geXForm3d *M;
+	int b,i,End;
+	__m128 MinX,MinY,MinZ,MaxX,MaxY,MaxZ;
+	__m128 Sign,ProjMinZ,ProjScale,ProjZScale,ProjXCenter,ProjYCenter;
+	geFloat Lanes[4];
+
+	MinX = _mm_set1_ps(Mins ? Mins->X : 0.0f);
+	MinY = _mm_set1_ps(Mins ? Mins->Y : 0.0f);
+	MinZ = _mm_set1_ps(Mins ? Mins->Z : 0.0f);
+	MaxX = _mm_set1_ps(Mins ? Maxs->X : 0.0f);
+	MaxY = _mm_set1_ps(Mins ? Maxs->Y : 0.0f);
+	MaxZ = _mm_set1_ps(Mins ? Maxs->Z : 0.0f);
+
+	Sign = _mm_set1_ps(-0.0f);
+	ProjMinZ = ProjScale = ProjZScale = ProjXCenter = ProjYCenter = _mm_setzero_ps();
+	if (Proj != NULL)
+		{
+			ProjMinZ    = _mm_set1_ps(Proj->MinZ);
+			ProjScale   = _mm_set1_ps(Proj->Scale);
+			ProjZScale  = _mm_set1_ps(Proj->ZScale);
+			ProjXCenter = _mm_set1_ps(Proj->XCenter);
+			ProjYCenter = _mm_set1_ps(Proj->YCenter);
+		}
+
+	for (b=0,Batch=Pack->BatchArray,M=XForms; b<Pack->BatchCount; b++,Batch++,M++)
+		{
+			__m128 AX = _mm_set1_ps(M->AX), AY = _mm_set1_ps(M->AY), AZ = _mm_set1_ps(M->AZ);
+			__m128 BX = _mm_set1_ps(M->BX), BY = _mm_set1_ps(M->BY), BZ = _mm_set1_ps(M->BZ);
+			__m128 CX = _mm_set1_ps(M->CX), CY = _mm_set1_ps(M->CY), CZ = _mm_set1_ps(M->CZ);
+			__m128 TX = _mm_set1_ps(M->Translation.X);
+			__m128 TY = _mm_set1_ps(M->Translation.Y);
+			__m128 TZ = _mm_set1_ps(M->Translation.Z);
+
+			End = Batch->Start + Batch->Count;
+			for (i=Batch->Start; i<End; i+=4)
+				{
+					__m128 VX = _mm_loadu_ps(Pack->X+i);
+					__m128 VY = _mm_loadu_ps(Pack->Y+i);
+					__m128 VZ = _mm_loadu_ps(Pack->Z+i);
+					__m128 RX,RY,RZ;
+
+					RX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(VX,AX),_mm_mul_ps(VY,AY)),_mm_mul_ps(VZ,AZ));
+					RY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(VX,BX),_mm_mul_ps(VY,BY)),_mm_mul_ps(VZ,BZ));
+					RZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(VX,CX),_mm_mul_ps(VY,CY)),_mm_mul_ps(VZ,CZ));
+					if (Translate)
+						{
+							RX = _mm_add_ps(RX,TX);
+							RY = _mm_add_ps(RY,TY);
+							RZ = _mm_add_ps(RZ,TZ);
+						}
+					if (Proj != NULL)
+						{
+							__m128 PZ,ScaleOverZ;
+							PZ = _mm_max_ps(ProjMinZ,_mm_xor_ps(RZ,Sign));
+							#ifdef ONE_OVER_Z_PIPELINE
+							RZ = _mm_div_ps(_mm_set1_ps(1.0f),PZ);
+							ScaleOverZ = _mm_mul_ps(ProjScale,RZ);
+							#else
+							ScaleOverZ = _mm_div_ps(ProjScale,PZ);
+							RZ = _mm_mul_ps(PZ,ProjZScale);
+							#endif
+							RX = _mm_add_ps(_mm_mul_ps(RX,ScaleOverZ),ProjXCenter);
+							RY = _mm_sub_ps(ProjYCenter,_mm_mul_ps(RY,ScaleOverZ));
+						}
+					_mm_storeu_ps(X+i,RX);
+					_mm_storeu_ps(Y+i,RY);
+					_mm_storeu_ps(Z+i,RZ);
+					if (Mins != NULL)
+						{
+							MaxX = _mm_max_ps(RX,MaxX);
+							MinX = _mm_min_ps(RX,MinX);
+							MaxY = _mm_max_ps(RY,MaxY);
+							MinY = _mm_min_ps(RY,MinY);
+							MaxZ = _mm_max_ps(RZ,MaxZ);
+							MinZ = _mm_min_ps(RZ,MinZ);
+						}
+				}
+		}
+
+	if (Mins != NULL)
+		{
+			#define GE_BODYINST_REDUCE(V,Dest,Op)			\
+				_mm_storeu_ps(Lanes,V);						\
+				for (i=0; i<4; i++)							\
+					if (Lanes[i] Op Dest) Dest = Lanes[i];
+
+			GE_BODYINST_REDUCE(MaxX,Maxs->X,>);
+			GE_BODYINST_REDUCE(MinX,Mins->X,<);
+			GE_BODYINST_REDUCE(MaxY,Maxs->Y,>);
+			GE_BODYINST_REDUCE(MinY,Mins->Y,<);
+			GE_BODYINST_REDUCE(MaxZ,Maxs->Z,>);
+			GE_BODYINST_REDUCE(MinZ,Mins->Z,<);
+
+			#undef GE_BODYINST_REDUCE
+		}
+}
+#endif
+
+#ifdef GE_HAVE_AVX2
+	// 8 points at a time, otherwise the same as the SSE2 version
+static void GENESISCC geBodyInst_SkinBlocks_AVX2(
+	const geBody_SkinPack *Pack, const geXForm3d *XForms, geBoolean Translate,
+	const geBodyInst_Projection *Proj, 
+	geFloat *X, geFloat *Y, geFloat *Z, geVec3d *Mins, geVec3d *Maxs)
+{
+	const geBody_SkinBatch *Batch;
+	const geXForm3d *M;
+	int b,i,End;
+	__m256 MinX,MinY,MinZ,MaxX,MaxY,MaxZ;
+	__m256 Sign,ProjMinZ,ProjScale,ProjZScale,ProjXCenter,ProjYCenter;
+	geFloat Lanes[8];
+
+	MinX = _mm256_set1_ps(Mins ? Mins->X : 0.0f);
+	MinY = _mm256_set1_ps(Mins ? Mins->Y : 0.0f);
+	MinZ = _mm256_set1_ps(Mins ? Mins->Z : 0.0f);
+	MaxX = _mm256_set1_ps(Mins ? Maxs->X : 0.0f);
+	MaxY = _mm256_set1_ps(Mins ? Maxs->Y : 0.0f);
+	MaxZ = _mm256_set1_ps(Mins ? Maxs->Z : 0.0f);
+
+	Sign = _mm256_set1_ps(-0.0f);
+	ProjMinZ = ProjScale = ProjZScale = ProjXCenter = ProjYCenter = _mm256_setzero_ps();
+	if (Proj != NULL)
+		{
+			ProjMinZ    = _mm256_set1_ps(Proj->MinZ);
+			ProjScale   = _mm256_set1_ps(Proj->Scale);
+			ProjZScale  = _mm256_set1_ps(Proj->ZScale);
+			ProjXCenter = _mm256_set1_ps(Proj->XCenter);
+			ProjYCenter = _mm256_set1_ps(Proj->YCenter);
+		}
+
+	for (b=0,Batch=Pack->BatchArray,M=XForms; b<Pack->BatchCount; b++,Batch++,M++)
+		{
+			__m256 AX = _mm256_set1_ps(M->AX), AY = _mm256_set1_ps(M->AY), AZ = _mm256_set1_ps(M->AZ);
+			__m256 BX = _mm256_set1_ps(M->BX), BY = _mm256_set1_ps(M->BY), BZ = _mm256_set1_ps(M->BZ);
+			__m256 CX = _mm256_set1_ps(M->CX), CY = _mm256_set1_ps(M->CY), CZ = _mm256_set1_ps(M->CZ);
+			__m256 TX = _mm256_set1_ps(M->Translation.X);
+			__m256 TY = _mm256_set1_ps(M->Translation.Y);
+			__m256 TZ = _mm256_set1_ps(M->Translation.Z);
+
+			End = Batch->Start + Batch->Count;
+			for (i=Batch->Start; i<End; i+=8)
+				{
+					__m256 VX = _mm256_loadu_ps(Pack->X+i);
+					__m256 VY = _mm256_loadu_ps(Pack->Y+i);
+					__m256 VZ = _mm256_loadu_ps(Pack->Z+i);
+					__m256 RX,RY,RZ;
+
+					// No fma, so the roundings match the other versions
+					RX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(VX,AX),_mm256_mul_ps(VY,AY)),_mm256_mul_ps(VZ,AZ));
+					RY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(VX,BX),_mm256_mul_ps(VY,BY)),_mm256_mul_ps(VZ,BZ));
+					RZ = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(VX,CX),_mm256_mul_ps(VY,CY)),_mm256_mul_ps(VZ,CZ));
+					if (Translate)
+						{
+							RX = _mm256_add_ps(RX,TX);
+							RY = _mm256_add_ps(RY,TY);
+							RZ = _mm256_add_ps(RZ,TZ);
+						}
+					if (Proj != NULL)
+						{
+							__m256 PZ,ScaleOverZ;
+							PZ = _mm256_max_ps(ProjMinZ,_mm256_xor_ps(RZ,Sign));
+							#ifdef ONE_OVER_Z_PIPELINE
+							RZ = _mm256_div_ps(_mm256_set1_ps(1.0f),PZ);
+							ScaleOverZ = _mm256_mul_ps(ProjScale,RZ);
+							#else
+							ScaleOverZ = _mm256_div_ps(ProjScale,PZ);
+							RZ = _mm256_mul_ps(PZ,ProjZScale);
+							#endif
+							RX = _mm256_add_ps(_mm256_mul_ps(RX,ScaleOverZ),ProjXCenter);
+							RY = _mm256_sub_ps(ProjYCenter,_mm256_mul_ps(RY,ScaleOverZ));
+						}
+					_mm256_storeu_ps(X+i,RX);
+					_mm256_storeu_ps(Y+i,RY);
+					_mm256_storeu_ps(Z+i,RZ);
+					if (Mins != NULL)
+						{
+							MaxX = _mm256_max_ps(RX,MaxX);
+							MinX = _mm256_min_ps(RX,MinX);
+							MaxY = _mm256_max_ps(RY,MaxY);
+							MinY = _mm256_min_ps(RY,MinY);
+							MaxZ = _mm256_max_ps(RZ,MaxZ);
+							MinZ = _mm256_min_ps(RZ,MinZ);
+						}
+				}
+		}
+
+	if (Mins != NULL)
+		{
+			#define GE_BODYINST_REDUCE(V,Dest,Op)			\
+				_mm256_storeu_ps(Lanes,V);					\
+				for (i=0; i<8; i++)							\
+					if (Lanes[i] Op Dest) Dest = Lanes[i];
+
+			GE_BODYINST_REDUCE(MaxX,Maxs->X,>);
+			GE_BODYINST_REDUCE(MinX,Mins->X,<);
+			GE_BODYINST_REDUCE(MaxY,Maxs->Y,>);
+			GE_BODYINST_REDUCE(MinY,Mins->Y,<);
+			GE_BODYINST_REDUCE(MaxZ,Maxs->Z,>);
+			GE_BODYINST_REDUCE(MinZ,Mins->Z,<);
+
+			#undef GE_BODYINST_REDUCE
+		}
+
+	_mm256_zeroupper();
+}
+#endif
+
+static void GENESISCC geBodyInst_PickSkinBlocks(void)
+{
+	geBodyInst_SkinBlocks = geBodyInst_SkinBlocks_C;
+
+#ifdef GE_HAVE_SSE2
+	if (CPUInfo_TestForSSE2())
+		geBodyInst_SkinBlocks = geBodyInst_SkinBlocks_SSE2;
+#endif
+
+#ifdef GE_HAVE_AVX2
+	if (CPUInfo_TestForAVX2())
+		geBodyInst_SkinBlocks = geBodyInst_SkinBlocks_AVX2;
+#endif
+}
+
+
 
 void GENESISCC geBodyInst_PostScale(const geXForm3d *M,const geVec3d *S,geXForm3d *Scaled)
 {
@@ -84,6 +397,10 @@ geBodyInst *GENESISCC geBodyInst_Create(const geBody *B)
 
 	BI->LastLevelOfDetail   = -1;
 	BI->FaceCount =  0;
+	BI->PackScratch = NULL;
+	BI->PackScratchSize = 0;
+	BI->BatchXForms = NULL;
+	BI->BatchXFormCount = 0;
 
 	return BI;
 }
@@ -110,6 +427,16 @@ void GENESISCC geBodyInst_Destroy( geBodyInst **BI)
 			geRam_Free( G->FaceList );
 			G->FaceList = NULL;
 		}
+	if ((*BI)->PackScratch != NULL )
+		{
+			geRam_Free( (*BI)->PackScratch );
+			(*BI)->PackScratch = NULL;
+		}
+	if ((*BI)->BatchXForms != NULL )
+		{
+			geRam_Free( (*BI)->BatchXForms );
+			(*BI)->BatchXForms = NULL;
+		}
 	geRam_Free( *BI );
 	*BI = NULL;
 }
@@ -184,9 +511,156 @@ static geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometryPrep(
 				}
 			BI->FaceCount = B->SkinFaces[GE_BODY_HIGHEST_LOD].FaceCount;
 		}
+
+	if (geBodyInst_SkinBlocks == NULL)
+		{
+			geBodyInst_PickSkinBlocks();
+		}
+
+	// the packs are only a cache of the skin, so making them doesn't really change the body
+	if (geBody_PackSkin((geBody *)B) != GE_FALSE)
+		{
+			int32 Size,BatchCount;
+
+			Size = B->VertexPack->Size;
+			if (B->NormalPack->Size > Size)
+				Size = B->NormalPack->Size;
+			BatchCount = B->VertexPack->BatchCount;
+			if (B->NormalPack->BatchCount > BatchCount)
+				BatchCount = B->NormalPack->BatchCount;
+
+			if (BI->PackScratchSize < Size)
+				{
+					if (BI->PackScratch != NULL)
+						{
+							geRam_Free(BI->PackScratch);
+						}
+					BI->PackScratch = GE_RAM_ALLOCATE_ARRAY(geFloat,Size*3);
+					if ( BI->PackScratch == NULL )
+						{
+							geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+							BI->PackScratchSize = 0;
+							return NULL;
+						}
+					BI->PackScratchSize = Size;
+				}
+			if (BI->BatchXFormCount < BatchCount)
+				{
+					if (BI->BatchXForms != NULL)
+						{
+							geRam_Free(BI->BatchXForms);
+						}
+					BI->BatchXForms = GE_RAM_ALLOCATE_ARRAY(geXForm3d,BatchCount);
+					if ( BI->BatchXForms == NULL )
+						{
+							geErrorLog_Add(ERR_BODY_ENOMEM, NULL);
+							BI->BatchXFormCount = 0;
+							return NULL;
+						}
+					BI->BatchXFormCount = BatchCount;
+				}
+		}
 	return G;
 }
 
+static geBoolean GENESISCC geBodyInst_SkinPacked(
+	const geBodyInst *BI,
+	geBodyInst_Geometry *G,
+	const geVec3d *ScaleVector,
+	const geXForm3d *BoneXFArray,
+	const geCamera *Camera)
+	// skins the body from it's packed bone batches.  returns GE_FALSE if it has none.
+{
+	const geBody *B;
+	const geBody_SkinPack *Pack;
+	const geBody_SkinBatch *Batch;
+	geBodyInst_Projection Proj;
+	geFloat *X,*Y,*Z;
+	int b,i,End;
+
+	B = BI->BodyTemplate;
+	if (B->VertexPack == NULL || B->NormalPack == NULL || BI->PackScratch == NULL)
+		{
+			return GE_FALSE;
+		}
+	assert( BI->PackScratchSize >= B->VertexPack->Size );
+	assert( BI->PackScratchSize >= B->NormalPack->Size );
+	assert( geBodyInst_SkinBlocks != NULL );
+
+	X = BI->PackScratch;
+	Y = X + BI->PackScratchSize;
+	Z = Y + BI->PackScratchSize;
+
+	// transform and (with a camera) project the vertices
+	Pack = B->VertexPack;
+	for (b=0,Batch=Pack->BatchArray; b<Pack->BatchCount; b++,Batch++)
+		{
+			geXForm3d *XF = &(BI->BatchXForms[b]);
+			if (Camera != NULL)
+				{
+					geXForm3d_Multiply(		geCamera_GetCameraSpaceXForm(Camera), 
+											&(BoneXFArray[Batch->BoneIndex]),
+											XF);
+					geBodyInst_PostScale(XF,ScaleVector,XF);
+				}
+			else
+				{
+					geBodyInst_PostScale(&BoneXFArray[Batch->BoneIndex],ScaleVector,XF);
+				}
+		}
+	if (Camera != NULL)
+		{
+			geCamera_GetProjection(Camera,&Proj.Scale,&Proj.ZScale,&Proj.XCenter,&Proj.YCenter,&Proj.MinZ);
+		}
+
+	geVec3d_Set(&(G->Maxs), -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER, -GE_BODY_REALLY_BIG_NUMBER );
+	geVec3d_Set(&(G->Mins), GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER, GE_BODY_REALLY_BIG_NUMBER );
+	geBodyInst_SkinBlocks(Pack,BI->BatchXForms,GE_TRUE,(Camera != NULL) ? &Proj : NULL,
+							X,Y,Z,&(G->Mins),&(G->Maxs));
+
+	for (b=0,Batch=Pack->BatchArray; b<Pack->BatchCount; b++,Batch++)
+		{
+			End = Batch->Start + Batch->Count;
+			for (i=Batch->Start; i<End; i++)
+				{
+					const geBody_XSkinVertex *S = &(B->XSkinVertexArray[Pack->Index[i]]);
+					geBodyInst_SkinVertex *D = &(G->SkinVertexArray[Pack->Index[i]]);
+					D->SVPoint.X = X[i];
+					D->SVPoint.Y = Y[i];
+					D->SVPoint.Z = Z[i];
+					D->SVU = S->XU;
+					D->SVV = S->XV;
+					D->ReferenceBoneIndex = Batch->BoneIndex;
+				}
+		}
+
+	// rotate the normals (by the bones alone)
+	Pack = B->NormalPack;
+	for (b=0,Batch=Pack->BatchArray; b<Pack->BatchCount; b++,Batch++)
+		{
+			BI->BatchXForms[b] = BoneXFArray[Batch->BoneIndex];
+		}
+
+	geBodyInst_SkinBlocks(Pack,BI->BatchXForms,GE_FALSE,NULL,X,Y,Z,NULL,NULL);
+
+	for (i=0; i<Pack->Size; i++)
+		{
+			geVec3d *D = &(G->NormalArray[Pack->Index[i]]);
+			D->X = X[i];
+			D->Y = Y[i];
+			D->Z = Z[i];
+		}
+
+	return GE_TRUE;
+}
+
+
+geBoolean GENESISCC geBodyInst_PrepGeometry(geBodyInst *BI)
+{
+	assert( BI != NULL );
+	return (geBodyInst_GetGeometryPrep(BI,0) != NULL);
+}
+
 const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
 	const geBodyInst *BI, 
 	const geVec3d *ScaleVector,
@@ -227,6 +701,7 @@ const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
 		}
 
 
+	if (geBodyInst_SkinPacked(BI,G,ScaleVector,BoneXFArray,Camera) == GE_FALSE)
 	{	
 		int i,LevelOfDetailBit;
 	
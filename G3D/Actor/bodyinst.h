@@ -119,6 +119,10 @@ const geBodyInst_Geometry *GENESISCC geBodyInst_GetGeometry(
 								int LevelOfDetail,
 								const geCamera *Camera);
 
+	// Makes room for the geometry.  geBodyInst_GetGeometry does this itself, but it only
+	// allocates on one thread at a time if this is called first.
+geBoolean GENESISCC geBodyInst_PrepGeometry(geBodyInst *BI);
+
 
 #ifdef __cplusplus
 }
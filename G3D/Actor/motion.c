@@ -48,6 +48,9 @@ typedef enum { MOTION_NODE_UNDECIDED, MOTION_NODE_BRANCH, MOTION_NODE_LEAF } geM
 #define MOTION_BLEND_PART_OF_TRANSFORM(TForm)  ((TForm).Translation.X)						
 #define MOTION_BLEND_PART_OF_VECTOR(Vec)  ((Vec).X)						
 
+#define MOTION_PATH_CURSORS		2		// gePath_SampleChannelsCursor's, for rotation and translation
+#define MOTION_BLEND_CURSORS	MOTION_PATH_CURSORS
+
 
 typedef struct geMotion_Leaf
 {
@@ -481,7 +484,71 @@ GENESISAPI void GENESISCC geMotion_Sample(const geMotion *M, int PathIndex, gePa
 }
 
 
+	// samples P with Cursor if there is one, or with the keys cached in P if not
+static void GENESISCC geMotion_SamplePath(const gePath *P, gePath_TimeType Time, int32 *Cursor,
+							geQuaternion *Rotation, geVec3d *Translation)
+{
+	if (Cursor != NULL)
+		gePath_SampleChannelsCursor(P,Time,Cursor,Rotation,Translation);
+	else
+		gePath_SampleChannels(P,Time,Rotation,Translation);
+}
+
+static geFloat GENESISCC geMotion_SampleBlend(const gePath *Blend, gePath_TimeType Time, int32 *Cursor)
+{
+	geVec3d BlendVector;
+	geQuaternion Dummy;
+
+	geMotion_SamplePath(Blend,Time,Cursor,&Dummy,&BlendVector);
+	return MOTION_BLEND_PART_OF_VECTOR(BlendVector);
+}
+
+	// a branch's cursors are the cursors of each mixer in turn: its motion's, then the blend
+	// path's.  Hands out the next mixer's, and moves *Cursor past them.
+static void GENESISCC geMotion_MixerCursors(const geMotion_Mixer *Mixer, int32 **Cursor,
+							int32 **MotionCursor, int32 **BlendCursor)
+{
+	if (*Cursor == NULL)
+		{
+			*MotionCursor = NULL;
+			*BlendCursor  = NULL;
+			return;
+		}
+	*MotionCursor = *Cursor;
+	*BlendCursor  = *Cursor + geMotion_GetCursorCount(Mixer->Motion);
+	*Cursor       = *BlendCursor + MOTION_BLEND_CURSORS;
+}
+
+int GENESISCC geMotion_GetCursorCount(const geMotion *M)
+{
+	int i,Count;
+
+	assert( M != NULL );
+	assert( geMotion_IsValid(M) != GE_FALSE );
+
+	switch (M->NodeType)
+		{
+			case (MOTION_NODE_BRANCH):
+				Count = 0;
+				for (i=0; i<M->Branch.MixerCount; i++)
+					{
+						assert( M->Branch.MixerArray[i].Motion != NULL );
+						Count += geMotion_GetCursorCount(M->Branch.MixerArray[i].Motion) + MOTION_BLEND_CURSORS;
+					}
+				return Count;
+			case (MOTION_NODE_LEAF):
+				return MOTION_PATH_CURSORS;
+			default:
+				return 0;
+		}
+}
+
 GENESISAPI void GENESISCC geMotion_SampleChannels(const geMotion *M, int PathIndex, gePath_TimeType Time, geQuaternion *Rotation, geVec3d *Translation)
+{
+	geMotion_SampleChannelsCursor(M,PathIndex,Time,NULL,Rotation,Translation);
+}
+
+void GENESISCC geMotion_SampleChannelsCursor(const geMotion *M, int PathIndex, gePath_TimeType Time, int32 *Cursor, geQuaternion *Rotation, geVec3d *Translation)
 {
 	assert( M           != NULL);
 	assert( Rotation    != NULL );
@@ -498,6 +565,7 @@ GENESISAPI void GENESISCC geMotion_SampleChannels(const geMotion *M, int PathInd
 					geQuaternion R;
 					geVec3d      T;
 					geMotion_Mixer *Mixer;
+					int32 *MotionCursor,*BlendCursor;
 					int i;
 
 					if ( M->Branch.MixerCount == 0 )
@@ -511,9 +579,10 @@ GENESISAPI void GENESISCC geMotion_SampleChannels(const geMotion *M, int PathInd
 					Mixer = &(M->Branch.MixerArray[0]);
 					
 					assert(Mixer->Motion != NULL );
-					geMotion_SampleChannels(Mixer->Motion,PathIndex,
+					geMotion_MixerCursors(Mixer,&Cursor,&MotionCursor,&BlendCursor);
+					geMotion_SampleChannelsCursor(Mixer->Motion,PathIndex,
 											(Time - Mixer->TimeOffset) * Mixer->TimeScale,
-											Rotation,Translation);
+											MotionCursor,Rotation,Translation);
 				
 					for (i=1; i<M->Branch.MixerCount; i++)
 						{
@@ -527,13 +596,9 @@ GENESISAPI void GENESISCC geMotion_SampleChannels(const geMotion *M, int PathInd
 
 							MixTime = (Time - Mixer->TimeOffset) * Mixer->TimeScale;
 
-							geMotion_SampleChannels(Mixer->Motion,PathIndex,MixTime,&R,&T);
-							{
-								geVec3d BlendVector;
-								geQuaternion Dummy;
-								gePath_SampleChannels(Mixer->Blend,MixTime,&Dummy,&BlendVector);
-								BlendAmount = MOTION_BLEND_PART_OF_VECTOR(BlendVector);
-							}
+							geMotion_MixerCursors(Mixer,&Cursor,&MotionCursor,&BlendCursor);
+							geMotion_SampleChannelsCursor(Mixer->Motion,PathIndex,MixTime,MotionCursor,&R,&T);
+							BlendAmount = geMotion_SampleBlend(Mixer->Blend,MixTime,BlendCursor);
 							geQuaternion_Slerp(Rotation,&R,BlendAmount,Rotation);
 							Translation->X = LINEAR_BLEND(Translation->X,T.X,BlendAmount);
 							Translation->Y = LINEAR_BLEND(Translation->Y,T.Y,BlendAmount);
@@ -547,7 +612,7 @@ GENESISAPI void GENESISCC geMotion_SampleChannels(const geMotion *M, int PathInd
 					assert( ( PathIndex >=0 ) && ( PathIndex < M->Leaf.PathCount ) );
 					P= M->Leaf.PathArray[PathIndex];
 					assert( P != NULL );
-					gePath_SampleChannels(P,Time,Rotation,Translation);
+					geMotion_SamplePath(P,Time,Cursor,Rotation,Translation);
 				}
 				break;
 			default:
@@ -576,6 +641,11 @@ GENESISAPI geBoolean GENESISCC geMotion_SampleNamed(const geMotion *M, const cha
 
 
 GENESISAPI geBoolean GENESISCC geMotion_SampleChannelsNamed(const geMotion *M, const char *PathName, gePath_TimeType Time, geQuaternion *Rotation, geVec3d *Translation)
+{
+	return geMotion_SampleChannelsNamedCursor(M,PathName,Time,NULL,Rotation,Translation);
+}
+
+geBoolean GENESISCC geMotion_SampleChannelsNamedCursor(const geMotion *M, const char *PathName, gePath_TimeType Time, int32 *Cursor, geQuaternion *Rotation, geVec3d *Translation)
 {
 	geBoolean AnyChannels=GE_FALSE;
 	assert( M           != NULL);
@@ -594,6 +664,7 @@ GENESISAPI geBoolean GENESISCC geMotion_SampleChannelsNamed(const geMotion *M, c
 					geQuaternion R;
 					geVec3d T;
 					geMotion_Mixer *Mixer;
+					int32 *MotionCursor,*BlendCursor;
 
 					if ( M->Branch.MixerCount == 0 )
 						{
@@ -616,18 +687,15 @@ GENESISAPI geBoolean GENESISCC geMotion_SampleChannelsNamed(const geMotion *M, c
 
 							MixTime = (Time - Mixer->TimeOffset) * Mixer->TimeScale;
 
+							geMotion_MixerCursors(Mixer,&Cursor,&MotionCursor,&BlendCursor);
+
 							// hmm. is BlendAmount still good if there is no path?
-							if ( geMotion_SampleChannelsNamed(Mixer->Motion,PathName,MixTime,&R,&T)
+							if ( geMotion_SampleChannelsNamedCursor(Mixer->Motion,PathName,MixTime,MotionCursor,&R,&T)
 								 != GE_FALSE )
 								{
 									if (AnyChannels != GE_FALSE)
 										{
-											{
-												geVec3d BlendVector;
-												geQuaternion Dummy;
-												gePath_SampleChannels(Mixer->Blend,MixTime,&Dummy,&BlendVector);
-												BlendAmount = MOTION_BLEND_PART_OF_VECTOR(BlendVector);
-											}
+											BlendAmount = geMotion_SampleBlend(Mixer->Blend,MixTime,BlendCursor);
 											geQuaternion_Slerp(Rotation,&R,BlendAmount,Rotation);
 											Translation->X = LINEAR_BLEND(Translation->X,T.X,BlendAmount);
 											Translation->Y = LINEAR_BLEND(Translation->Y,T.Y,BlendAmount);
@@ -651,7 +719,7 @@ GENESISAPI geBoolean GENESISCC geMotion_SampleChannelsNamed(const geMotion *M, c
 						{
 							return GE_FALSE;
 						}
-					gePath_SampleChannels(P,Time,Rotation,Translation);
+					geMotion_SamplePath(P,Time,Cursor,Rotation,Translation);
 					AnyChannels = GE_TRUE;
 				}
 				break;
@@ -1208,6 +1276,11 @@ GENESISAPI geBoolean  GENESISCC geMotion_SetBaseTransform( geMotion *M,int SubMo
 
 #pragma warning( disable : 4701)	// don't want to set Translation until we are ready
 GENESISAPI geBoolean GENESISCC geMotion_GetTransform( const geMotion *M, geFloat Time, geXForm3d *Transform)
+{
+	return geMotion_GetTransformCursor(M,Time,NULL,Transform);
+}
+
+geBoolean GENESISCC geMotion_GetTransformCursor( const geMotion *M, geFloat Time, int32 *Cursor, geXForm3d *Transform)
 {
 	assert( M         != NULL);
 	assert( geMotion_IsValid(M) != GE_FALSE );
@@ -1225,6 +1298,7 @@ GENESISAPI geBoolean GENESISCC geMotion_GetTransform( const geMotion *M, geFloat
 					geVec3d      T,Translation;
 					geMotion_Mixer *Mixer;
 					geFloat MixTime;
+					int32 *MotionCursor,*BlendCursor;
 					int i;
 					int MixCount=0;
 
@@ -1245,7 +1319,8 @@ GENESISAPI geBoolean GENESISCC geMotion_GetTransform( const geMotion *M, geFloat
 							assert( Mixer->Blend  != NULL );
 							
 							MixTime = (Time - Mixer->TimeOffset) * Mixer->TimeScale;
-							if (geMotion_GetTransform(Mixer->Motion,MixTime,Transform)!=GE_FALSE)
+							geMotion_MixerCursors(Mixer,&Cursor,&MotionCursor,&BlendCursor);
+							if (geMotion_GetTransformCursor(Mixer->Motion,MixTime,MotionCursor,Transform)!=GE_FALSE)
 								{
 									DoMix=GE_TRUE;
 									if (Mixer->TransformUsed!=GE_FALSE)
@@ -1272,12 +1347,7 @@ GENESISAPI geBoolean GENESISCC geMotion_GetTransform( const geMotion *M, geFloat
 										{
 											geQuaternion_FromMatrix(Transform,&R);
 											T = Transform->Translation;
-											{
-												geVec3d BlendVector;
-												geQuaternion Dummy;
-												gePath_SampleChannels(Mixer->Blend,MixTime,&Dummy,&BlendVector);
-												BlendAmount = MOTION_BLEND_PART_OF_VECTOR(BlendVector);
-											}
+											BlendAmount = geMotion_SampleBlend(Mixer->Blend,MixTime,BlendCursor);
 											geQuaternion_Slerp(&Rotation,&R,BlendAmount,&Rotation);
 											Translation.X = LINEAR_BLEND(Translation.X,T.X,BlendAmount);
 											Translation.Y = LINEAR_BLEND(Translation.Y,T.Y,BlendAmount);
@@ -766,6 +766,7 @@ static geBoolean GENESISCC gePath_SampleChannel(
 	const gePath_Channel *Channel,			// channel to sample
 	geBoolean Looped,
 	gePath_TimeType Time, 
+	int32 *Cursor,							// caller's record of the last key (NULL to use the channel's)
 	void *Result)
 				// return GE_TRUE if sample was made,
 				// return GE_FALSE if no sample was made (no keyframes)
@@ -775,6 +776,8 @@ static geBoolean GENESISCC gePath_SampleChannel(
 	gePath_TimeType T;				// 0..1 blending factor
 	gePath_TimeType AdjTime;		// parameter Time adjusted for looping.
 	int Length;
+	const char *Keys;				// the channel's keys: one array of (time,value), ElementSize apart
+	int ElementSize;
 	
 	assert( Channel != NULL );
 	assert( Result != NULL );
@@ -793,6 +796,35 @@ static geBoolean GENESISCC gePath_SampleChannel(
 	AdjTime = gePath_AdjustTimeForLooping(Looped,Time,
 			Channel->StartTime,Channel->EndTime);
 
+	// the keys are read straight off the array, rather than through the accessors
+	Keys = (const char *)geTKArray_Element(Channel->KeyList, 0);
+	ElementSize = geTKArray_ElementSize(Channel->KeyList);
+
+	if (Cursor != NULL)
+	{
+		Index1 = geTKArray_BSearchFrom( Channel->KeyList, AdjTime, *Cursor );
+		*Cursor = Index1;
+		Index2 = Index1 + 1;
+
+		// same edge conditions as below
+		if ( Index1 < 0 )	
+		{
+			if (Looped!=GE_FALSE) 
+				Index1 = Length -1;
+			else
+				Index1 = 0;
+		}
+		if ( Index2 >= Length )
+		{
+			if (Looped!=GE_FALSE)
+				Index2 = 0;
+			else
+				Index2 = Length - 1;
+		}
+		Time1 = *(const geTKArray_TimeType *)(Keys + Index1*ElementSize);
+		Time2 = *(const geTKArray_TimeType *)(Keys + Index2*ElementSize);
+	}
+	else
 	if (	( Channel->LastKey1Time <= AdjTime ) && 
 			( AdjTime < Channel->LastKey2Time  ) )
 	{  
@@ -842,8 +874,8 @@ static geBoolean GENESISCC gePath_SampleChannel(
 		T = (AdjTime-Time1) / (Time2 - Time1);
 	
 	gePath_Statics.InterpolationTable[Channel->InterpolationType](
-				geTKArray_Element(Channel->KeyList,Index1),
-				geTKArray_Element(Channel->KeyList,Index2),
+				Keys + Index1*ElementSize,
+				Keys + Index2*ElementSize,
 				T,Result);
 
 	return GE_TRUE;
@@ -869,7 +901,7 @@ GENESISAPI void GENESISCC gePath_Sample(const gePath *P, gePath_TimeType Time, g
 	else
 		Looped = GE_FALSE;
 
-	if(gePath_SampleChannel(&(P->Rotation), Looped, Time, (void*)&Rotation) == GE_TRUE)
+	if(gePath_SampleChannel(&(P->Rotation), Looped, Time, NULL, (void*)&Rotation) == GE_TRUE)
 	{
 		geQuaternion_ToMatrix(&Rotation, Matrix);
 	}
@@ -878,7 +910,7 @@ GENESISAPI void GENESISCC gePath_Sample(const gePath *P, gePath_TimeType Time, g
 		geXForm3d_SetIdentity(Matrix);
 	}
 
-	if(gePath_SampleChannel(&(P->Translation), Looped, Time, (void*)&Translation) == GE_TRUE)
+	if(gePath_SampleChannel(&(P->Translation), Looped, Time, NULL, (void*)&Translation) == GE_TRUE)
 	{
 		Matrix->Translation = Translation;
 	}
@@ -906,12 +938,41 @@ void GENESISCC gePath_SampleChannels(const gePath *P, gePath_TimeType Time, geQu
 	else
 		Looped = GE_FALSE;
 	
-	if(gePath_SampleChannel(&(P->Rotation), Looped, Time, (void*)Rotation) == GE_FALSE)
+	if(gePath_SampleChannel(&(P->Rotation), Looped, Time, NULL, (void*)Rotation) == GE_FALSE)
+	{
+		geQuaternion_SetNoRotation(Rotation);
+	}
+
+	if(gePath_SampleChannel(&(P->Translation), Looped, Time, NULL, (void*)Translation) == GE_FALSE)
+	{
+		Translation->X  = Translation->Y = Translation->Z = 0.0f;
+	}
+}
+
+void GENESISCC gePath_SampleChannelsCursor(const gePath *P, gePath_TimeType Time, int32 *Cursor, geQuaternion *Rotation, geVec3d *Translation)
+{
+	geBoolean Looped;
+	assert( P != NULL );
+	assert( Cursor != NULL );
+	assert( Rotation != NULL );
+	assert( Translation != NULL );
+
+	if (P->Dirty)
+		{
+			gePath_Recompute((gePath *)P);
+		}
+
+	if (P->Looped)
+		Looped = GE_TRUE;
+	else
+		Looped = GE_FALSE;
+	
+	if(gePath_SampleChannel(&(P->Rotation), Looped, Time, &(Cursor[0]), (void*)Rotation) == GE_FALSE)
 	{
 		geQuaternion_SetNoRotation(Rotation);
 	}
 
-	if(gePath_SampleChannel(&(P->Translation), Looped, Time, (void*)Translation) == GE_FALSE)
+	if(gePath_SampleChannel(&(P->Translation), Looped, Time, &(Cursor[1]), (void*)Translation) == GE_FALSE)
 	{
 		Translation->X  = Translation->Y = Translation->Z = 0.0f;
 	}
@@ -19,8 +19,6 @@
 /*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
 /*                                                                                      */
 /****************************************************************************************/
-#pragma message ("could optimize a name binded setPose by caching the mapping from motionpath[i] to joint[j]")
-
 #include <assert.h>
 #include <string.h>
 
@@ -30,6 +28,7 @@
 #include "StrBlock.h"
 
 #define GE_POSE_STARTING_JOINT_COUNT (1)
+#define GE_POSE_MOTION_BINDINGS (4)				// motions a pose remembers how to sample
 
 
 /* this object maintains a hierarchy of joints.
@@ -58,6 +57,24 @@ typedef struct gePose_Joint
 	int			 Covered;			// if joint has been 100% set (no blending)
 } gePose_Joint;						// structure to bind a name and a path for a joint
 
+	// which of a motion's paths drives each joint, and where in each path's keys the last
+	// sample was (in every path a blended motion samples, blend paths too).  Made the first time a motion is set into the pose, so the names aren't
+	// looked up and the keys aren't searched for again on every sample.
+typedef struct gePose_MotionBinding
+{
+	const geMotion	 *Motion;			// NULL if unused
+	geBoolean		  MotionHasNames;	// the binding is only good while these still match
+	int32			  MotionChecksum;
+	int				  MotionPathCount;
+	int				  JointCount;
+	int32			  NameChecksum;
+	int				  CursorCount;		// geMotion_GetCursorCount(Motion): how many each joint has
+	geBoolean		  NameBinding;		// joints are sampled by name: the motion's names don't match exactly
+	uint32			  LastUsed;
+	int				 *PathIndex;		// path for each joint, -1 if it has none.  NULL for blended motions
+	int32			 *Cursor;			// CursorCount per joint, then CursorCount for the root transform
+} gePose_MotionBinding;
+
 typedef struct gePose
 {
 	int				  JointCount;	// number of joints in the motion
@@ -75,8 +92,62 @@ typedef struct gePose
 	geXFArray		 *TransformArray;	
 	gePose_Joint	 *JointArray;
 	int				  OnlyThisJoint;		// update only this joint (and it's parents) if this is >0
+	uint32			  Stamp;				// bumped every time the pose is changed
+	gePose_ChangedCB *ChangedCB;			// told every time the pose is changed
+	void			 *ChangedContext;
+	gePose			 *FirstSlave;			// poses attached to this one, so they can be told too
+	gePose			 *NextSlave;			// next pose attached to Parent
+	gePose_MotionBinding Bindings[GE_POSE_MOTION_BINDINGS];
+	uint32			  BindingClock;			// bumped every time a binding is looked up
 } gePose;
 
+	// tells P and everything attached to it that they moved
+static void GENESISCC gePose_NotifyChanged(gePose *P)
+{
+	gePose *Slave;
+
+	if (P->ChangedCB != NULL)
+		P->ChangedCB(P->ChangedContext);
+
+	for (Slave = P->FirstSlave; Slave != NULL; Slave = Slave->NextSlave)
+		gePose_NotifyChanged(Slave);
+}
+
+static void GENESISCC gePose_Changed(gePose *P)
+{
+	P->Stamp++;
+	gePose_NotifyChanged(P);
+}
+
+	// takes P off of it's masters list of slaves
+static void GENESISCC gePose_UnlinkSlave(gePose *P)
+{
+	gePose **Link;
+
+	if (P->Parent == NULL)
+		return;
+
+	for (Link = &(P->Parent->FirstSlave); *Link != NULL; Link = &((*Link)->NextSlave))
+		{
+			if (*Link == P)
+				{
+					*Link = P->NextSlave;
+					break;
+				}
+		}
+	P->NextSlave = NULL;
+}
+
+	// the masters stamps are about to stop being added in to gePose_GetStamp(), so
+	// fold them into ours to keep it from ever going back to an old value
+static void GENESISCC gePose_FoldParentStamp(gePose *P)
+{
+	const gePose *Parent;
+
+	for (Parent = P->Parent; Parent != NULL; Parent = Parent->Parent)
+		P->Stamp += Parent->Stamp;
+}
+
 
 
 static void gePose_ReattachTransforms(gePose *P)
@@ -171,6 +242,153 @@ static void GENESISCC gePose_InitializeJoint(gePose_Joint *Joint, int ParentJoin
 
 
 
+static void GENESISCC gePose_UnbindMotion(gePose_MotionBinding *B)
+{
+	assert( B != NULL );
+	if (B->PathIndex != NULL)
+		geRam_Free(B->PathIndex);
+	if (B->Cursor != NULL)
+		geRam_Free(B->Cursor);
+	B->PathIndex = NULL;
+	B->Cursor    = NULL;
+	B->Motion    = NULL;
+}
+
+	// finds (or makes) the binding of M to P.  Returns NULL if M has no paths yet, or if
+	// there isn't memory for the binding.  Callers sample M by index or by name, the old
+	// way, when there's no binding.
+static gePose_MotionBinding *GENESISCC gePose_BindMotion(gePose *P, const geMotion *M)
+{
+	gePose_MotionBinding *B,*Oldest;
+	geBoolean HasNames,Exact;
+	int32 Checksum;
+	int PathCount,CursorCount;
+	int i,j;
+
+	assert( P != NULL );
+	assert( M != NULL );
+
+	CursorCount = geMotion_GetCursorCount(M);
+	if (CursorCount <= 0)
+		return NULL;
+	PathCount = geMotion_GetPathCount(M);
+	HasNames = geMotion_HasNames(M);
+	Checksum = geMotion_GetNameChecksum(M);
+
+	P->BindingClock++;
+	Oldest = &(P->Bindings[0]);
+	for (i=0,B=P->Bindings; i<GE_POSE_MOTION_BINDINGS; i++,B++)
+		{
+			if (	(B->Motion == M) && 
+					(B->MotionHasNames  == HasNames) && 
+					(B->MotionChecksum  == Checksum) && 
+					(B->MotionPathCount == PathCount) &&
+					(B->CursorCount     == CursorCount) &&
+					(B->JointCount      == P->JointCount) && 
+					(B->NameChecksum    == P->NameChecksum) )
+				{
+					B->LastUsed = P->BindingClock;
+					return B;
+				}
+			if (B->LastUsed < Oldest->LastUsed)
+				Oldest = B;
+		}
+
+	B = Oldest;
+	gePose_UnbindMotion(B);
+
+	if (geMotion_GetSubMotionCount(M) == 0)
+		{	// blended motions find the paths for each joint as they're sampled
+			B->PathIndex = GE_RAM_ALLOCATE_ARRAY(int, P->JointCount+1);
+		}
+	B->Cursor = GE_RAM_ALLOCATE_ARRAY(int32, (P->JointCount+1)*CursorCount);
+	if (B->Cursor == NULL || (B->PathIndex == NULL && geMotion_GetSubMotionCount(M) == 0))
+		{	// not an error: the motion just gets sampled the slow way
+			gePose_UnbindMotion(B);
+			return NULL;
+		}
+
+	for (j=0; j<(P->JointCount+1)*CursorCount; j++)
+		B->Cursor[j] = -1;
+
+	Exact = gePose_MatchesMotionExactly(P,M);
+	for (j=0; j<P->JointCount && B->PathIndex != NULL; j++)
+		{
+			B->PathIndex[j]  = -1;
+			if (Exact == GE_TRUE)
+				{
+					if (j < PathCount)
+						B->PathIndex[j] = j;
+				}
+			else
+				{	// same as geMotion_GetPathNamed: the first path with the joint's name
+					const char *JointName = geStrBlock_GetString(P->JointNames,j);
+					for (i=0; i<PathCount; i++)
+						{
+							const char *PathName = geMotion_GetNameOfPath(M,i);
+							if (PathName != NULL && strcmp(JointName,PathName)==0)
+								{
+									B->PathIndex[j] = i;
+									break;
+								}
+						}
+				}
+		}
+
+	B->Motion          = M;
+	B->MotionHasNames  = HasNames;
+	B->MotionChecksum  = Checksum;
+	B->MotionPathCount = PathCount;
+	B->JointCount      = P->JointCount;
+	B->NameChecksum    = P->NameChecksum;
+	B->CursorCount     = CursorCount;
+	B->NameBinding     = (Exact == GE_TRUE) ? GE_FALSE : GE_TRUE;
+	B->LastUsed        = P->BindingClock;
+	return B;
+}
+
+	// samples the path bound to a joint.  Returns GE_FALSE if the joint has none.
+static geBoolean GENESISCC gePose_SampleBoundJoint(gePose *P, gePose_MotionBinding *B, const geMotion *M, 
+							int JointIndex, geFloat Time, geQuaternion *Rotation, geVec3d *Translation)
+{
+	int PathIndex;
+	int32 *Cursor;
+
+	assert( P != NULL );
+	assert( B != NULL );
+	assert( B->Motion == M );
+	assert( JointIndex >= 0 && JointIndex < B->JointCount );
+
+	Cursor = &(B->Cursor[JointIndex*B->CursorCount]);
+	if (B->PathIndex == NULL)
+		{	// blended: the sub-motions' paths are found by index or by name, like the old way
+			if (B->NameBinding == GE_FALSE)
+				{
+					geMotion_SampleChannelsCursor(M,JointIndex,Time,Cursor,Rotation,Translation);
+					return GE_TRUE;
+				}
+			return geMotion_SampleChannelsNamedCursor(M,geStrBlock_GetString(P->JointNames,JointIndex),
+								Time,Cursor,Rotation,Translation);
+		}
+
+	PathIndex = B->PathIndex[JointIndex];
+	if (PathIndex < 0)
+		return GE_FALSE;
+	gePath_SampleChannelsCursor(geMotion_GetPath(M,PathIndex),Time,Cursor,Rotation,Translation);
+	return GE_TRUE;
+}
+
+	// geMotion_GetTransform, with the binding's root transform cursors if there's a binding
+static geBoolean GENESISCC gePose_GetMotionTransform(gePose_MotionBinding *B, const geMotion *M,
+							geFloat Time, geXForm3d *Transform)
+{
+	if (B == NULL)
+		return geMotion_GetTransform(M,Time,Transform);
+
+	assert( B->Motion == M );
+	return geMotion_GetTransformCursor(M,Time,&(B->Cursor[B->JointCount*B->CursorCount]),Transform);
+}
+
 gePose *GENESISCC gePose_Create(void)
 {
 	gePose *P;
@@ -186,6 +404,11 @@ gePose *GENESISCC gePose_Create(void)
 	P->OnlyThisJoint = GE_POSE_ROOT_JOINT-1;		
 	P->JointNames = geStrBlock_Create();
 	P->Touched = GE_FALSE;
+	P->Stamp = 0;
+	P->ChangedCB = NULL;
+	P->ChangedContext = NULL;
+	P->FirstSlave = NULL;
+	P->NextSlave = NULL;
 	if ( P->JointNames == NULL )
 		{
 			geErrorLog_Add(ERR_POSE_CREATE_ENOMEM, NULL);
@@ -201,6 +424,8 @@ gePose *GENESISCC gePose_Create(void)
 
 	P->Slave = GE_FALSE;
 	P->Parent = NULL;
+	memset(P->Bindings,0,sizeof(P->Bindings));
+	P->BindingClock = 0;
 	gePose_ReattachTransforms(P);
 	gePose_InitializeJoint(&(P->RootJoint),GE_POSE_ROOT_JOINT,NULL);
 
@@ -225,6 +450,7 @@ void GENESISCC gePose_Destroy(gePose **PP)
 
 	assert( (*PP)->JointNames != NULL );
 	assert( geStrBlock_GetCount((*PP)->JointNames) == (*PP)->JointCount );
+	gePose_UnlinkSlave(*PP);
 	geStrBlock_Destroy( &( (*PP)->JointNames ) );
 	if ((*PP)->TransformArray!=NULL)
 		{
@@ -232,6 +458,11 @@ void GENESISCC gePose_Destroy(gePose **PP)
 		}
 	if ((*PP)->JointArray != NULL)
 		geRam_Free((*PP)->JointArray);
+	{
+		int i;
+		for (i=0; i<GE_POSE_MOTION_BINDINGS; i++)
+			gePose_UnbindMotion(&((*PP)->Bindings[i]));
+	}
 	geRam_Free( *PP );
 
 	*PP = NULL;
@@ -323,8 +554,12 @@ geBoolean GENESISCC gePose_Attach(gePose *Slave, int SlaveBoneIndex,
 			P=P->Parent;
 		}
 
+	gePose_FoldParentStamp(Slave);
+	gePose_UnlinkSlave(Slave);
 	Slave->SlaveJointIndex = SlaveBoneIndex;
 	Slave->Parent = Master;
+	Slave->NextSlave = Master->FirstSlave;
+	Master->FirstSlave = Slave;
 	if (SlaveBoneIndex == GE_POSE_ROOT_JOINT)
 		{
 			Slave->Slave = GE_FALSE;
@@ -336,6 +571,7 @@ geBoolean GENESISCC gePose_Attach(gePose *Slave, int SlaveBoneIndex,
 
 	gePose_InitializeJoint(&(Slave->RootJoint),MasterBoneIndex,Attachment);
 	Slave->Touched = GE_TRUE;
+	gePose_Changed(Slave);
 	Slave->ParentsLastTransform = *(Master->RootJoint.Transform);
 	
 	return GE_TRUE;
@@ -344,12 +580,23 @@ geBoolean GENESISCC gePose_Attach(gePose *Slave, int SlaveBoneIndex,
 
 void GENESISCC gePose_Detach(gePose *P)
 {
+	gePose_FoldParentStamp(P);
+	gePose_UnlinkSlave(P);
 	P->Parent = NULL;
 	P->Slave = GE_FALSE;
 	gePose_InitializeJoint(&(P->RootJoint),GE_POSE_ROOT_JOINT,NULL);
+	gePose_Changed(P);
 }
 
 
+const gePose *GENESISCC gePose_GetAttachRoot(const gePose *P)
+{
+	assert( P != NULL );
+	while (P->Parent != NULL)
+		P = P->Parent;
+	return P;
+}
+
 static geBoolean GENESISCC gePose_TransformCompare(const geXForm3d *T1, const geXForm3d *T2)
 {
 	if (T1->AX != T2->AX) return GE_FALSE;
@@ -584,6 +831,7 @@ geBoolean GENESISCC gePose_AddJoint(
 	Joint = &( P->JointArray[JointCount] );
 	gePose_InitializeJoint(Joint,ParentJointIndex, Attachment);
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
 
 	*JointIndex = JointCount;
 
@@ -618,6 +866,26 @@ void GENESISCC gePose_SetJointAttachment(gePose *P,
 		gePose_SetAttachmentRotationFlag(J);
 	}
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
+}
+
+uint32 GENESISCC gePose_GetStamp(const gePose *P)
+{
+	assert( P != NULL );
+
+	// a slave moves with it's master
+	if (P->Parent != NULL)
+		return P->Stamp + gePose_GetStamp(P->Parent);
+
+	return P->Stamp;
+}
+
+void GENESISCC gePose_SetChangedCB(gePose *P, gePose_ChangedCB *CB, void *Context)
+{
+	assert( P != NULL );
+
+	P->ChangedCB = CB;
+	P->ChangedContext = Context;
 }
 
 void GENESISCC gePose_GetJointTransform(const gePose *P, int JointIndex,geXForm3d *Transform)
@@ -658,6 +926,7 @@ void GENESISCC gePose_SetJointLocalTransform(gePose *P, int JointIndex,const geX
 		J->Touched = GE_TRUE;
 	}
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
 }
 
 int GENESISCC gePose_GetJointCount(const gePose *P)
@@ -708,12 +977,14 @@ void GENESISCC gePose_Clear(gePose *P,const geXForm3d *Transform)
 			P->Touched = GE_TRUE;
 		}	
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
 }	
 
 void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 							const geXForm3d *Transform)
 {
 	geBoolean NameBinding;
+	gePose_MotionBinding *Binding;
 	int i;
 	gePose_Joint *J;
 	geXForm3d RootTransform;
@@ -722,10 +993,14 @@ void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 
 	P->OnlyThisJoint = GE_POSE_ROOT_JOINT-1;		// calling this function disables one-joint optimizations
 
+	Binding = NULL;
+	if (M != NULL)
+		Binding = gePose_BindMotion(P,M);
+
 	if (P->Parent==NULL)
 		{
 			geBoolean SetRoot = GE_FALSE;
-			if (geMotion_GetTransform(M,Time,&RootTransform)!=GE_FALSE)
+			if (gePose_GetMotionTransform(Binding,M,Time,&RootTransform)!=GE_FALSE)
 				{
 					SetRoot = GE_TRUE;
 
@@ -762,11 +1037,17 @@ void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 		NameBinding = GE_TRUE;
 
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
 	#pragma message("could optimize this by looping two ways (min(jointcount,pathcount))")
 	for (i=0, J=&(P->JointArray[0]); i<P->JointCount; i++,J++)
 		{
 			//gePath *JointPath;
-			if (NameBinding == GE_FALSE)
+			if (Binding != NULL)
+				{
+					if (gePose_SampleBoundJoint(P,Binding,M,i,Time,&(J->LocalRotation),&(J->LocalTranslation))==GE_FALSE)
+						continue;
+				}
+			else if (NameBinding == GE_FALSE)
 				{
 					geMotion_SampleChannels(M,i,Time,&(J->LocalRotation),&(J->LocalTranslation));
 
@@ -788,8 +1069,19 @@ void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M, geFloat Time,
 		}
 }
 
+geBoolean GENESISCC gePose_PrepareMotion(gePose *P, const geMotion *M)
+{
+	assert( P != NULL );
+	assert( M != NULL );
+
+	// once M is bound, setting it finds the binding and samples with the binding's cursors
+	if (gePose_BindMotion(P,M) == NULL)
+		return GE_FALSE;
+	return GE_TRUE;
+}
+
 static void GENESISCC gePose_SetMotionForABoneRecursion(gePose *P, const geMotion *M, geFloat Time,
-							int BoneIndex,geBoolean NameBinding)
+							int BoneIndex,geBoolean NameBinding,gePose_MotionBinding *Binding)
 {
 	gePose_Joint *J;
 	geBoolean Touched = GE_FALSE;
@@ -799,7 +1091,11 @@ static void GENESISCC gePose_SetMotionForABoneRecursion(gePose *P, const geMotio
 
 	J=&(P->JointArray[BoneIndex]);
 
-	if (NameBinding == GE_FALSE)
+	if (Binding != NULL)
+		{
+			Touched = gePose_SampleBoundJoint(P,Binding,M,BoneIndex,Time,&(J->LocalRotation),&(J->LocalTranslation));
+		}
+	else if (NameBinding == GE_FALSE)
 		{
 			geMotion_SampleChannels(M,BoneIndex,Time,&(J->LocalRotation),&(J->LocalTranslation));
 			Touched = GE_TRUE;
@@ -819,7 +1115,7 @@ static void GENESISCC gePose_SetMotionForABoneRecursion(gePose *P, const geMotio
 			J->LocalTranslation.Z *= P->Scale.Z;
 		}
 	if (J->ParentJoint != GE_POSE_ROOT_JOINT)
-		gePose_SetMotionForABoneRecursion(P,M,Time,J->ParentJoint,NameBinding);
+		gePose_SetMotionForABoneRecursion(P,M,Time,J->ParentJoint,NameBinding,Binding);
 	
 }
 
@@ -828,15 +1124,20 @@ void GENESISCC gePose_SetMotionForABone(gePose *P, const geMotion *M, geFloat Ti
 {
 	geBoolean NameBinding;
 	geXForm3d RootTransform;
+	gePose_MotionBinding *Binding;
 	
 	assert( P != NULL );
 	//assert( M != NULL );
 	P->OnlyThisJoint = BoneIndex;		// calling this function enables single-joint optimizations
+
+	Binding = NULL;
+	if (M != NULL)
+		Binding = gePose_BindMotion(P,M);
 	
 	if (P->Parent==NULL)
 		{
 			geBoolean SetRoot = GE_FALSE;
-			if (geMotion_GetTransform(M,Time,&RootTransform)!=GE_FALSE)
+			if (gePose_GetMotionTransform(Binding,M,Time,&RootTransform)!=GE_FALSE)
 				{
 					SetRoot = GE_TRUE;
 
@@ -877,8 +1178,9 @@ void GENESISCC gePose_SetMotionForABone(gePose *P, const geMotion *M, geFloat Ti
 		NameBinding = GE_TRUE;
 
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
 
-	gePose_SetMotionForABoneRecursion(P, M, Time, BoneIndex, NameBinding);
+	gePose_SetMotionForABoneRecursion(P, M, Time, BoneIndex, NameBinding, Binding);
 }
 	
 
@@ -900,6 +1202,7 @@ void GENESISCC gePose_BlendMotion(
 	geQuaternion R1;
 	geVec3d      T1;
 	geXForm3d    RootTransform;
+	gePose_MotionBinding *Binding;
 	
 	assert( P != NULL );
 	//assert( M != NULL );  // M can be NULL
@@ -916,10 +1219,14 @@ void GENESISCC gePose_BlendMotion(
 			BlendAmount = t2*3.0f -t3-t3;
 		}
 
+	Binding = NULL;
+	if (M != NULL)
+		Binding = gePose_BindMotion(P,M);
+
 	if (P->Parent==NULL)
 		{
 			geBoolean SetRoot = GE_FALSE;
-			if (geMotion_GetTransform(M,Time,&RootTransform)!=GE_FALSE)
+			if (gePose_GetMotionTransform(Binding,M,Time,&RootTransform)!=GE_FALSE)
 				{
 					SetRoot = GE_TRUE;
 
@@ -965,12 +1272,18 @@ void GENESISCC gePose_BlendMotion(
 		NameBinding = GE_TRUE;
 	
 	P->Touched = GE_TRUE;
+	gePose_Changed(P);
 
 	for (i=0, J=&(P->JointArray[0]); i<P->JointCount; i++,J++)
 		{
 			//gePath *JointPath;
 							
-			if (NameBinding == GE_FALSE)
+			if (Binding != NULL)
+				{
+					if (gePose_SampleBoundJoint(P,Binding,M,i,Time,&R1,&T1)==GE_FALSE)
+						continue;
+				}
+			else if (NameBinding == GE_FALSE)
 				{
 					geMotion_SampleChannels(M,i,Time,&R1,&T1);
 					//JointPath = geMotion_GetPath(M,i);
@@ -1048,6 +1361,7 @@ void GENESISCC gePose_SetScale(gePose *P, const geVec3d *Scale )
 				J->Touched = GE_TRUE;
 			}
 		P->Touched = GE_TRUE;
+		gePose_Changed(P);
 	}
 }
 
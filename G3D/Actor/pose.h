@@ -102,6 +102,11 @@ void GENESISCC gePose_Clear(gePose *P, const geXForm3d *Transform);
 	// if Transform is non-NULL, it is applied to the Motion
 void GENESISCC gePose_SetMotion(gePose *P, const geMotion *M,geFloat Time,const geXForm3d *Transform);
 
+	// gets P ready to be set to M (with gePose_SetMotion and the like) on another thread.
+	// Returns GE_TRUE if setting M won't allocate anything or change M's paths, so poses
+	// can be set to shared motions on different threads at once.
+geBoolean GENESISCC gePose_PrepareMotion(gePose *P, const geMotion *M);
+
 	// optimization:  if this is called, then all pose computations are limited to the BoneIndex'th bone, and
 	// it's parents (including the root bone).  This is true for all queries until an entire motion is set or blended
 	// into the pose.
@@ -124,6 +129,16 @@ void GENESISCC gePose_BlendMotion(gePose *P, const geMotion *M, geFloat Time,
 	// get a joint's current transform (relative to world space)
 void GENESISCC gePose_GetJointTransform(const gePose *P, int JointIndex,geXForm3d *Transform);
 
+	// returns a number that changes whenever the pose (or a pose it's attached to) is changed.
+uint32 GENESISCC gePose_GetStamp(const gePose *P);
+
+	// called whenever the pose (or a pose it's attached to) is changed, from whatever thread
+	// changed it.
+typedef void GENESISCC gePose_ChangedCB(void *Context);
+
+	// sets the one callback told about changes to the pose (NULL for none).
+void GENESISCC gePose_SetChangedCB(gePose *P, gePose_ChangedCB *CB, void *Context);
+
 	// get the transforms for the entire pose. *TransformArray must not be changed.
 const geXFArray *GENESISCC gePose_GetAllJointTransforms(const gePose *P);
 
@@ -150,6 +165,10 @@ geBoolean GENESISCC gePose_Attach(gePose *Slave, int SlaveBoneIndex,
 
 void GENESISCC gePose_Detach(gePose *P);
 
+	// returns the pose at the top of P's attachments (P if it isn't attached).  Updating a
+	// pose updates the ones above it, so poses with the same top can't be updated at once.
+const gePose *GENESISCC gePose_GetAttachRoot(const gePose *P);
+
 	// a pose can also maintain a record of which joints are touched by a given motion.
 	// these funtions set,clear and query the record.
 	// ClearCoverage clears the coverage flag for all joints 
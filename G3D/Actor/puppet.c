@@ -50,6 +50,7 @@
 #include "bitmap._h"
 
 #define PUPPET_DEFAULT_MAX_DYNAMIC_LIGHTS 3
+#define PUPPET_MAX_LIGHTS 64			// the closest this many lights in range are gathered at a point
 
 typedef struct gePuppet_Color
 {
@@ -98,8 +99,14 @@ typedef struct gePuppet
 	geBoolean			 AmbientLightFromStaticLights;	// use static lights from map   
 	geBoolean			 DoTestRayCollision;			//test static light in shadow   
 	int					 MaxStaticLightsToUse; 			//max number of light to use
+
+	const geBodyInst_Geometry *PreppedGeometry;		// from gePuppet_PrepGeometry (NULL if none)
+	const geCamera		*PreppedCamera;
+	uint32				 PreppedBatch;
 } gePuppet;
 
+static uint32 gePuppet_GeometryBatch = 0;		// bumped by gePuppet_BeginGeometryBatch
+
 typedef struct
 {
 	geVec3d			Normal;
@@ -116,16 +123,16 @@ typedef struct
 	gePuppet_Color  FillLightColor;
 	gePuppet_Color	Ambient;
 	geVec3d			SurfaceNormal;
-	gePuppet_Light StaticLights[MAX_DYNAMIC_LIGHTS];
+	gePuppet_Light StaticLights[PUPPET_MAX_LIGHTS];
 	int StaticLightCount;
-	gePuppet_Light	Lights[MAX_DYNAMIC_LIGHTS];
+	gePuppet_Light	Lights[PUPPET_MAX_LIGHTS];
 	int				LightCount;
 	geBoolean		PerBoneLighting;
 } gePuppet_LightParamGroup;
 
 typedef struct
 {
-	gePuppet_Light Lights[MAX_DYNAMIC_LIGHTS];
+	gePuppet_Light Lights[PUPPET_MAX_LIGHTS];
 	int LightCount;
 } gePuppet_BoneLight;
 
@@ -309,6 +316,10 @@ gePuppet *GENESISCC gePuppet_Create(geVFile *TextureFS, const geBody *B, geWorld
 	P->TextureFileContext = TextureFS;
 
 	P->World = World;
+
+	P->PreppedGeometry = NULL;
+	P->PreppedCamera = NULL;
+	P->PreppedBatch = 0;
 	
 	P->AmbientLightFromStaticLights = GE_FALSE;	//BY DEFAULT DO NOTHING 
 	P->DoTestRayCollision = GE_FALSE; 
@@ -496,53 +507,84 @@ void GENESISCC gePuppet_SetLightingOptions(gePuppet *P,
 }	
 
 
+// moves the closest Count lights to the front of LP, in order (the rest are left in any order)
+static void GENESISCC gePuppet_SortClosestLights(gePuppet_Light *LP, int LightCount, int Count)
+{
+	int i,j,Closest;
+
+	for (i=0; i<Count && i<LightCount-1; i++)
+		{
+			Closest = i;
+			for (j=i+1; j<LightCount; j++)
+				{
+					if (LP[j].Distance < LP[Closest].Distance)
+						Closest = j;
+				}
+			if (Closest != i)
+				{
+					gePuppet_Light Swap = LP[Closest];
+					LP[Closest] = LP[i];
+					LP[i] = Swap;
+				}
+		}
+}
+
 static int GENESISCC gePuppet_PrepLights(const gePuppet *P, 
 	geWorld *World,
 	gePuppet_Light *LP,
 	const geVec3d *ReferencePoint)
 {
-	int i,j,cnt;
+	int i,cnt,Farthest,Ref;
+	Light_DLight *DLight;
 
-	Light_LightInfo *L;
 	assert( P );
 	assert( LP );
 
-	L = (World->LightInfo);
-	for (i=0,cnt=0; i<MAX_DYNAMIC_LIGHTS; i++)
+	// only the lights binned into the reference points leaf can reach it
+	Farthest = 0;
+	for (DLight = Light_WorldGetFirstDLight(World, ReferencePoint, &Ref), cnt=0; DLight; DLight = Light_WorldGetNextDLight(World, &Ref))
 		{
-			if (L->DynamicLights[i].Active)
+			geVec3d Normal;
+			geFloat Distance;
+
+			if (!DLight->Active)			// removed since the lists were built
+				continue;
+
+			geVec3d_Subtract(&(DLight->Pos),ReferencePoint,&Normal);
+
+			Distance =	Normal.X * Normal.X + 
+						Normal.Y * Normal.Y +
+						Normal.Z * Normal.Z;
+			if (Distance >= DLight->Radius*DLight->Radius)
+				continue;
+
+			// once LP is full, a light has to be closer than the farthest one to get in
+			if (cnt == PUPPET_MAX_LIGHTS)
 				{
-					geVec3d *Position = &(L->DynamicLights[i].Pos);
-					geVec3d Normal;
+					if (Distance >= LP[Farthest].Distance)
+						continue;
+					i = Farthest;
+				}
+			else
+				i = cnt++;
 
-					geVec3d_Subtract(Position,ReferencePoint,&Normal);
+			LP[i].Distance = Distance;
+			LP[i].Color.Red = DLight->Color.r;
+			LP[i].Color.Green = DLight->Color.g;
+			LP[i].Color.Blue = DLight->Color.b;
+			LP[i].Radius = DLight->Radius;
+			LP[i].Normal = Normal;
 
-					LP[cnt].Distance =	Normal.X * Normal.X + 
-										Normal.Y * Normal.Y +
-										Normal.Z * Normal.Z;
-					if (LP[cnt].Distance < L->DynamicLights[i].Radius*L->DynamicLights[i].Radius)
-						{
-							LP[cnt].Color.Red = L->DynamicLights[i].Color.r;
-							LP[cnt].Color.Green = L->DynamicLights[i].Color.g;
-							LP[cnt].Color.Blue = L->DynamicLights[i].Color.b;
-							LP[cnt].Radius = L->DynamicLights[i].Radius;
-							LP[cnt].Normal = Normal;
-							cnt++;
-						}
+			if (cnt == PUPPET_MAX_LIGHTS)
+				{
+					for (i=1, Farthest=0; i<cnt; i++)
+						if (LP[i].Distance > LP[Farthest].Distance)
+							Farthest = i;
 				}
 		}
 
 	// sort dynamic lights by distance (squared)
-	for(i=0; i<P->MaxDynamicLightsToUse && i<cnt; i++) //rush out    when enough lights sorted
-     for(j=i+1; j<cnt; j++)
-     {
-       if (LP[i].Distance > LP[j].Distance)
-       {
-         gePuppet_Light Swap = LP[j];
-         LP[j] = LP[i];
-         LP[i] = Swap;
-       }
-     }
+	gePuppet_SortClosestLights(LP, cnt, P->MaxDynamicLightsToUse);
 
 	// go back and finish setting up closest lights
 	for (i=0; i<cnt; i++)
@@ -648,7 +690,7 @@ static int  GENESISCC gePuppet_ComputeAmbientLight(
 	
 	if(P->AmbientLightFromStaticLights != GE_FALSE) 
 	{
-		int i,j,cnt;
+		int i,cnt;
 		geEntity_EntitySet * entitySet = NULL;
 		geEntity * entity = NULL;
 		light * aLight;
@@ -656,8 +698,8 @@ static int  GENESISCC gePuppet_ComputeAmbientLight(
 		if (entitySet != NULL)
 			entity = geEntity_EntitySetGetNextEntity(entitySet, entity);
 		
-		//loop through all static lights and select the ones that touch the actor, with    a max limit of MAX_DYNAMIC_LIGHTS
-		for (i=0,cnt=0; entity != NULL && cnt<MAX_DYNAMIC_LIGHTS; i++)
+		//loop through all static lights and select the ones that touch the actor, with    a max limit of PUPPET_MAX_LIGHTS
+		for (i=0,cnt=0; entity != NULL && cnt<PUPPET_MAX_LIGHTS; i++)
 		{
 			geVec3d *Position;
 			geVec3d Normal;
@@ -696,16 +738,7 @@ static int  GENESISCC gePuppet_ComputeAmbientLight(
 		}
 		// sort static lights by distance    (squared)
 		// for(i=0; i<cnt; i++)
-		for(i=0; i<P->MaxDynamicLightsToUse && i<cnt; i++) //rush out    when enough lights sorted
-			for(j=i+1; j<cnt; j++)
-			{
-				if (LP[i].Distance > LP[j].Distance)
-				{
-					gePuppet_Light Swap = LP[j];
-					LP[j] = LP[i];
-					LP[i] = Swap;
-				}
-			}
+		gePuppet_SortClosestLights(LP, cnt, P->MaxDynamicLightsToUse);
 			// go back and finish setting up    closest lights
 			for (i=0; i<cnt; i++)
 			{
@@ -1205,6 +1238,8 @@ geBoolean GENESISCC gePuppet_RenderThroughFrustum(const gePuppet *P,
 	assert( Camera );
 	assert( Joints );
 
+	((gePuppet *)P)->PreppedGeometry = NULL;		// about to be written over
+
 	JointTransforms = gePose_GetAllJointTransforms(Joints);
 
 	#pragma message ("Level of detail hacked:")
@@ -1507,6 +1542,47 @@ int Puppet_AverageIndex = 0;
 #endif
 
 
+void GENESISCC gePuppet_BeginGeometryBatch(void)
+{
+	gePuppet_GeometryBatch++;
+}
+
+geBoolean GENESISCC gePuppet_AllocateGeometry(gePuppet *P)
+{
+	assert( P != NULL );
+
+	P->PreppedGeometry = NULL;
+	if (geBodyInst_PrepGeometry(P->BodyInstance)==GE_FALSE)
+		{
+			geErrorLog_Add(ERR_PUPPET_RENDER, NULL);
+			return GE_FALSE;
+		}
+	return GE_TRUE;
+}
+
+geBoolean GENESISCC gePuppet_PrepGeometry(gePuppet *P, const gePose *Joints, const geCamera *Camera)
+{
+	geVec3d Scale;
+	const geXFArray *JointTransforms;
+
+	assert( P      );
+	assert( Joints );
+	assert( Camera );
+
+	// only touches this puppet and it's pose (and the ones the pose is attached to)
+	JointTransforms = gePose_GetAllJointTransforms(Joints);
+	gePose_GetScale(Joints,&Scale);
+
+	P->PreppedGeometry = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 0, Camera);
+	if (P->PreppedGeometry == NULL)
+		{
+			return GE_FALSE;
+		}
+	P->PreppedCamera = Camera;
+	P->PreppedBatch = gePuppet_GeometryBatch;
+	return GE_TRUE;
+}
+
 geBoolean GENESISCC gePuppet_Render(	const gePuppet *P, 
 							const gePose *Joints,
 							geEngine *Engine, 
@@ -1529,11 +1605,18 @@ geBoolean GENESISCC gePuppet_Render(	const gePuppet *P,
 	#define BACK_EDGE (1.0f)
 
 	const geBodyInst_Geometry *G;
+	const geBodyInst_Geometry *Prepped;
 	assert( P      );
 	assert( Engine );
 	assert( World  );
 	assert( Camera );
 
+	// take the prepped geometry (if any) now, so it can't be used again next time
+	Prepped = NULL;
+	if (P->PreppedBatch == gePuppet_GeometryBatch && P->PreppedCamera == Camera)
+		Prepped = P->PreppedGeometry;
+	((gePuppet *)P)->PreppedGeometry = NULL;
+
 	#ifdef PROFILE
 	rdtsc_read(&RDTSCStart);
     rdtsc_zero(&RDTSCEnd);
@@ -1636,8 +1719,15 @@ geBoolean GENESISCC gePuppet_Render(	const gePuppet *P,
 	JointTransforms = gePose_GetAllJointTransforms(Joints);
 
 	#pragma message ("Level of detail hacked:")
-	gePose_GetScale(Joints,&Scale);
-	G = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 0,Camera);
+	if (Prepped != NULL)
+		{
+			G = Prepped;
+		}
+	else
+		{
+			gePose_GetScale(Joints,&Scale);
+			G = geBodyInst_GetGeometry(P->BodyInstance, &Scale, JointTransforms, 0,Camera);
+		}
 
 	if ( G == NULL )
 		{
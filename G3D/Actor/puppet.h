@@ -58,6 +58,14 @@ geBoolean GENESISCC gePuppet_Render(const gePuppet *P,
 					const geCamera *Camera, 
 					geExtBox *Box);
 
+	// Skinning ahead of gePuppet_Render.  gePuppet_BeginGeometryBatch starts a new batch (the
+	// geometry from older ones won't be used), then gePuppet_AllocateGeometry gets each puppet
+	// ready on one thread, then gePuppet_PrepGeometry can be called for different puppets 
+	// at once.  gePuppet_Render uses the geometry if it's from the same batch and camera.
+void GENESISCC gePuppet_BeginGeometryBatch(void);
+geBoolean GENESISCC gePuppet_AllocateGeometry(gePuppet *P);
+geBoolean GENESISCC gePuppet_PrepGeometry(gePuppet *P, const gePose *Joints, const geCamera *Camera);
+
 int GENESISCC gePuppet_GetMaterialCount( gePuppet *P );
 geBoolean GENESISCC gePuppet_GetMaterial( gePuppet *P, int MaterialIndex,
 									geBitmap **Bitmap, 
@@ -264,6 +264,38 @@ int GENESISCC geTKArray_BSearch(
 	return hi;
 }
 
+#define TK_BSEARCH_FROM_STEPS (4)	// keys to walk forward before giving up and searching
+
+int GENESISCC geTKArray_BSearchFrom(
+	const geTKArray *A,				// sorted array to search
+	geTKArray_TimeType Key,			// searching for this key
+	int Hint)						// what the last search returned (or -1)
+{
+	int i,Steps;
+	const char *Array;
+	int ElementSize;
+
+	TK_ASSERT_VALID(A);
+
+	Array = A->Elements;
+	ElementSize = A->ElementSize;
+
+	if ( (Hint >= -1) && (Hint < A->NumElements) )
+		{
+			if ( (Hint < 0) || (*(geTKArray_TimeType *)(Array + Hint*ElementSize) <= Key) )
+				{
+					for (i=Hint, Steps=0; Steps<TK_BSEARCH_FROM_STEPS; i++,Steps++)
+						{
+							if ( i+1 >= A->NumElements )
+								return i;
+							if ( Key < *(geTKArray_TimeType *)(Array + (i+1)*ElementSize) )
+								return i;
+						}
+				}
+		}
+	return geTKArray_BSearch(A,Key);
+}
+
 
 geBoolean GENESISCC geTKArray_Insert(
 	geTKArray **PtrA,				// sorted array to insert into
@@ -73,6 +73,13 @@ int GENESISCC geTKArray_BSearch(
 	// search is only accurate to 2*TKA_TIME_TOLERANCE.  
 	// if multiple keys exist within 2*TKA_TIME_TOLERANCE, this will find an arbitrary one of them.
 
+int GENESISCC geTKArray_BSearchFrom(
+	const geTKArray *Array,			// sorted array to search
+	geTKArray_TimeType Key,			// searching for this time
+	int Hint);						// what the last search returned (or -1)
+	// Same as geTKArray_BSearch, but first walks forward a few keys from Hint. 
+	// when the searches move forward through time, this is usually found in a step or two.
+
 geBoolean GENESISCC geTKArray_Insert(
 	geTKArray **Array,
 	geTKArray_TimeType Key,			// time to insert
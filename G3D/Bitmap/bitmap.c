@@ -70,6 +70,7 @@ see {} for notes/long-term-todos
 #include	"bitmap.__h"
 #include	"bitmap_blitdata.h"
 #include	"bitmap_gamma.h"
+#include	"bitmap_kernels.h"
 
 #include	"palcreate.h"
 #include	"palettize.h"
@@ -2433,7 +2434,7 @@ int fmxtra,tow,toh,toxtra,fmw,fmh,fmstep,x,y,bpp;
 		return GE_FALSE;
 	}
 
-	// {} todo : average for some special cases (16rgb,24rgb,32rgb)
+	// the common formats average through bitmap_kernels
 
 	bpp = gePixelFormat_BytesPerPel(FmInfo->Format);
 
@@ -2444,6 +2445,7 @@ int fmxtra,tow,toh,toxtra,fmw,fmh,fmstep,x,y,bpp;
 	gePixelFormat_ColorPutter PutColor;
 	const gePixelFormat_Operations *ops;
 	uint8 *fmp,*fmp2,*top;
+	geBitmap_Mip Mip;
 
 		fmp = FmBits;
 		top = ToBits;
@@ -2503,6 +2505,18 @@ int fmxtra,tow,toh,toxtra,fmw,fmh,fmstep,x,y,bpp;
 				top += toxtra;
 			}
 		}
+		else if ( geBitmap_Kernels_GetMip(FmInfo->Format,&Mip) )
+		{
+			// the same (R1+R2+R3+R4+2)>>2 as below, a row at a time
+			for(y=toh;y--;)
+			{
+				if ( (y+y + 1) == fmh )	fmp2 = fmp;
+				else					fmp2 = fmp + (FmInfo->Stride*bpp);
+				Mip.Row(top,fmp,fmp2,tow,&Mip);
+				fmp += tow*2*bpp + fmxtra;
+				top += tow*bpp + toxtra;
+			}
+		}
 		else
 		{
 			for(y=toh;y--;)
@@ -4107,6 +4121,7 @@ static geBoolean geBitmap_ReadFromBMP(geBitmap * Bmp,geVFile * F)
 BITMAPFILEHEADER 	bmfh;
 BITMAPINFOHEADER	bmih;
 int bPad,myRowWidth,bmpRowWidth,pelBytes;
+const char * Src;
 
 	// Windows Bitmap
 
@@ -4193,7 +4208,25 @@ int bPad,myRowWidth,bmpRowWidth,pelBytes;
 	if ( ! geBitmap_AllocSystemMip(Bmp,0) )
 		return GE_FALSE;
 
-	if ( bmih.biHeight > 0 )
+	// if the file is mapped, copy the rows straight out of it instead of reading them one by one
+	if ( (Src = geVFile_GetMappedView(F, bmpRowWidth * Bmp->Info.Height)) != NULL )
+	{
+	int y;
+	char * row;
+		row = Bmp->Data[0];
+		if ( bmih.biHeight > 0 )
+			row += (Bmp->Info.Height - 1) * myRowWidth;
+		for(y= Bmp->Info.Height;y--;)
+		{
+			memcpy(row, Src, bmpRowWidth);
+			Src += bmpRowWidth;
+			if ( bmih.biHeight > 0 )
+				row -= myRowWidth;
+			else
+				row += myRowWidth;
+		}
+	}
+	else if ( bmih.biHeight > 0 )
 	{
 	int y;
 	char * row;
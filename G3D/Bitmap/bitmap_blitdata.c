@@ -38,6 +38,7 @@
 #include	"bitmap._h"
 #include	"bitmap.__h"
 #include	"bitmap_blitdata.h"
+#include	"bitmap_kernels.h"
 
 #include	"vfile.h"
 #include	"ErrorLog.h"
@@ -51,8 +52,6 @@
 #include	"timer.h"
 #endif
 
-//#define DONT_USE_ASM
-
 /*}{*********************************************************************/
 
 // parameters to the main BlitData call are set up in here & shared
@@ -94,6 +93,8 @@ geBoolean BlitData_DePalettize(void);
 geBoolean BlitData_FromSeparateAlpha(void);
 geBoolean BlitData_ToSeparateAlpha(void);
 
+static void BlitData_ConvertRows(const geBitmap_Convert *Convert);
+
 geBoolean geBitmap_BlitData_Sub(	const geBitmap_Info * iSrcInfo,const void *iSrcData, const geBitmap *iSrcBmp,
 								geBitmap_Info * iDstInfo,void *iDstData,	const geBitmap *iDstBmp,
 								int iSizeX,int iSizeY)
@@ -495,8 +496,16 @@ uint32 ColorKey,Pixel;
 	}
 	else if ( DstInfo->HasColorKey )
 	{
+	geBitmap_Convert Convert;
+
 		ColorKey = DstInfo->ColorKey;
 
+		if ( geBitmap_Kernels_GetConvert(SrcFormat,DstFormat,GE_TRUE,ColorKey,&Convert) )
+		{
+			BlitData_ConvertRows(&Convert);
+			return GE_TRUE;
+		}
+
 		for(y=SizeY;y--;)
 		{
 			for(x=SizeX;x--;)
@@ -544,6 +553,14 @@ uint32 ColorKey,Pixel;
 	}
 	else
 	{
+	geBitmap_Convert Convert;
+
+		if ( geBitmap_Kernels_GetConvert(SrcFormat,DstFormat,GE_FALSE,0,&Convert) )
+		{
+			BlitData_ConvertRows(&Convert);
+			return GE_TRUE;
+		}
+
 		for(y=SizeY;y--;)
 		{
 			for(x=SizeX;x--;)
@@ -561,6 +578,25 @@ uint32 ColorKey,Pixel;
 
 /*}{*********************************************************************/
 
+static void BlitData_ConvertRows(const geBitmap_Convert *Convert)
+{
+const uint8 *SrcPtr;
+uint8 *DstPtr;
+int y;
+
+	SrcPtr = (const uint8 *)SrcData;
+	DstPtr = (uint8 *)DstData;
+
+	for(y=SizeY;y--;)
+	{
+		Convert->Row(DstPtr,SrcPtr,SizeX,Convert);
+		SrcPtr += SrcRowBytes;
+		DstPtr += DstRowBytes;
+	}
+}
+
+/*}{*********************************************************************/
+
 geBoolean BlitData_FromSeparateAlpha(void)
 {
 geBitmap_Info AlphaInfo;
@@ -1120,11 +1156,18 @@ gePixelFormat Format;
 	{
 	int x,y;
 	uint32 Pixel,DstColorKey;
+	geBitmap_Convert Convert;
 
 		//this is common
 
 		assert(DstInfo->HasColorKey);
 		DstColorKey = DstInfo->ColorKey;
+
+		if ( geBitmap_Kernels_GetRekey(Format,SrcInfo->HasColorKey,SrcInfo->ColorKey,DstColorKey,&Convert) )
+		{
+			BlitData_ConvertRows(&Convert);
+			return GE_TRUE;
+		}
 		
 		if ( SrcInfo->HasColorKey )
 		{
@@ -1345,10 +1388,12 @@ geBoolean BlitData_DePalettize(void)
 	// pal -> unpal : easy
 	if ( SrcFormat == GE_PIXELFORMAT_8BIT )
 	{
-	uint8 * SrcPtr;
+	uint8 * SrcPtr,*DstPtr,*PalData;
 	geBitmap_Palette * DstPal;
 	int x,y,pal;
 	const gePixelFormat_Operations *SrcOps,*DstOps;
+	geBitmap_DePalRow DePalRow;
+	uint32 Pal32[256];
 
 		x = y = pal = 0; //touch 'em
 
@@ -1437,393 +1482,30 @@ geBoolean BlitData_DePalettize(void)
 			}
 		}
 
-		SrcPtr = (uint8 *)SrcData;
-
 		// Pal -> UnPal loops : very common & very fast
+		//	the kernels look up whole Dst pixels, in the low bytes of a uint32
 
-		switch( gePixelFormat_BytesPerPel(DstFormat) )
+		if ( ! (DePalRow = geBitmap_Kernels_GetDePal(gePixelFormat_BytesPerPel(DstFormat))) )
 		{
-			default:
-			{
-				geBitmap_Palette_Destroy(&DstPal);
-				return GE_FALSE;
-			}
-			case 1:
-			{
-			uint8 *DstPtr,*PalData;
-				PalData = (uint8 *)DstPal->Data;
-				DstPtr  = (uint8 *)DstData;
-				for(y=SizeY;y--;)
-				{
-
-					#ifdef DONT_USE_ASM
-
-					for(x=SizeX;x--;)
-					{
-						pal = *SrcPtr++;
-						*DstPtr++ = PalData[pal];
-					}
-
-					#else
-
-					#pragma message("Bitmap_Blitdata :using assembly DePalettize code")
-					// {} is this minimal push safe in _fastcall ? aparently so!
-
-					__asm
-					{
-						push ebp
-
-						mov ecx,SizeX
-						mov esi,SrcPtr
-						mov edi,DstPtr
-						mov ebp,PalData
-
-						xor eax,eax
-						xor edx,edx
-						
-					moredata1:
-
-						mov al, BYTE PTR [esi]
-						mov dl, BYTE PTR [ebp + eax]
-						mov BYTE PTR [edi], dl
-
-						inc esi
-						inc edi
-						dec ecx
-
-						jnz moredata1
-
-						pop ebp
-					}
-
-					SrcPtr += SizeX;
-					DstPtr += SizeX;
-
-					#endif
-
-					SrcPtr += SrcXtra;
-					DstPtr += DstXtra;
-				}
-				break;
-			}
-			case 2:
-			{
-			uint16 *DstPtr,*PalData;
-
-				PalData = (uint16 *)DstPal->Data;
-				DstPtr  = (uint16 *)DstData;
-
-			#ifdef DO_TIMER
-			{
-			#pragma message("Blitdata : doing timer")
-				TIMER_VARS(WordCopy);
-
-				timerFP = fopen("q:\\timer.log","at+");
-				Timer_Start();
-				TIMER_P(WordCopy);
-			#endif // DO_TIMER
-
-				for(y=SizeY;y--;)
-				{
-					#ifdef DONT_USE_ASM
-
-					for(x=SizeX;x--;)
-					{
-						pal = *SrcPtr++;
-						*DstPtr++ = PalData[pal];
-					}
-
-					#else
-
-					#if 1 // {
-					if ( (SizeX&1) == 0 )
-					{
-						assert( (((uint32)PalData)&3) == 0 );
-						assert( (((uint32)DstPtr )&3) == 0 );
-
-						// pair two pixels so we can output in dwords
-						
-						__asm
-						{
-							//pusha
-							push ebp
-
-							mov ecx,SizeX
-							mov esi,SrcPtr
-							mov edi,DstPtr
-							mov ebp,PalData
-
-							xor eax,eax
-							
-						moredata2_z:
-
-							//WordCopy : 0.000664 secs
-							//	about 12 clocks per pixel (!?)
-
-							// this is godly fast
-
-							movzx eax, BYTE PTR [esi+0]
-							movzx eax, WORD PTR [ebp + eax*2]
-
-							movzx edx, BYTE PTR [esi+1]
-							movzx edx, WORD PTR [ebp + edx*2]
-							shl edx,16
-
-							xor eax,edx
-
-							mov DWORD PTR [edi], eax
-
-							add esi,2
-							add edi,4
-
-							sub ecx,2
-							jnz moredata2_z
-
-#if 0 //{ 
-						// the old bad way:
-						// 0.000710 secs
-						moredata2_z:
-
-							//xor edx,edx	//xor edx,0 ; sneaky trick?
-
-							//mov al, BYTE PTR [esi]
-							movzx eax, BYTE PTR [esi]
-							inc esi
-
-							movzx edx, WORD PTR [ebp + eax*2]
-							//mov dx, WORD PTR [ebp + eax*2]
-
-							movzx eax, BYTE PTR [esi]
-							inc esi
-
-							// make room fo a new dx
-							//shl edx,16
-							//mov dx, WORD PTR [ebp + eax*2]	// !! STALL !! ; movzx eax, [] instead?
-							// byte order is wrong; fix with rol; 1 clock
-							//rol edx,16
-
-							movzx eax, WORD PTR [ebp + eax*2]	// can I do this?
-							shl eax,16
-							xor edx,eax
-
-							mov DWORD PTR [edi], edx
-							add edi,4
-
-							sub ecx,2
-							jnz moredata2_z
-#endif //}
-
-							pop ebp
-							//popa
-						}
-
-					}
-					else
-					#endif //}
-					{
-
-						__asm
-						{
-							//pusha
-							push ebp
-
-							mov ecx,SizeX
-							mov esi,SrcPtr
-							mov edi,DstPtr
-							mov ebp,PalData
-
-							xor eax,eax
-							xor edx,edx
-							
-						moredata2:
-
-							// about 14 clocks (!)
-
-							//mov al, BYTE PTR [esi]
-							movzx eax, BYTE PTR [esi]
-							//movzx edx, WORD PTR [ebp + eax*2]
-							mov dx, WORD PTR [ebp + eax*2]
-							mov WORD PTR [edi], dx
-
-							inc esi
-							add edi,2
-
-							dec ecx
-							jnz moredata2
-
-							pop ebp
-							//popa
-						}
-					}
-
-					SrcPtr += SizeX;
-					DstPtr += SizeX;
-
-					#endif
-
-					SrcPtr += SrcXtra;
-					DstPtr += DstXtra;
-				}
-
-				#ifdef DO_TIMER
-				TIMER_Q(WordCopy);
-				TIMER_COUNT();
-				Timer_Stop();
-				if ( timerFP )
-				{
-					TIMER_REPORT(WordCopy);
-				}
-			}
-			#endif
-
-				// C , Debug :
-				//WordCopy             : 0.001243 : 99.4 %
-				// asm paired : mov al,
-				//WordCopy             : 0.000858 : 99.1 %
-				// asm paired : movzx eax,
-				//WordCopy             : 0.000798 : 98.9 %
-				// asm paired : with xor edx,0 & movzx edx,
-				//WordCopy             : 0.000903 : 99.2 %
-				// asm paired : with xor edx,0 & mov dx,
-				//WordCopy             : 0.000941 : 99.4 %
-				// asm : not paired 
-				//WordCopy             : 0.000765 : 98.8 %
-				// asm : paired, using xor edx,eax !
-				//WordCopy             : 0.000710 : 98.9 %
-
-				break;
-			}
-			case 3:
-			{
-			uint8 *DstPtr,*PalData;
-				PalData = (uint8 *)DstPal->Data;
-				DstPtr  = (uint8 *)DstData;
-
-//				pushTSC();
-
-				for(y=SizeY;y--;)
-				{
-
-					#ifdef DONT_USE_ASM
-					{
-					uint8 *PalPtr;
-
-						for(x=SizeX;x--;)
-						{
-							pal = *SrcPtr++;
-							PalPtr = PalData + (3*pal);
-							*DstPtr++ = *PalPtr++;
-							*DstPtr++ = *PalPtr++;
-							*DstPtr++ = *PalPtr;
-						}
-
-					}
-					#else
-
-					__asm
-					{
-						push ebp
-
-						mov ecx,SizeX
-						mov esi,SrcPtr
-						mov edi,DstPtr
-						mov ebp,PalData
-
-						xor eax,eax
-						xor edx,edx
-						
-					moredata3:
-
-						movzx eax, BYTE PTR [esi]
-						inc esi
-
-						imul eax,3
-						add eax,ebp
-						mov dl, BYTE PTR [eax]
-						mov BYTE PTR [edi], dl
-						inc edi
-						mov dl, BYTE PTR [eax + 1]
-						mov BYTE PTR [edi], dl
-						inc edi
-						mov dl, BYTE PTR [eax + 2]
-						mov BYTE PTR [edi], dl
-						inc edi
-
-						dec ecx
-						jnz moredata3
-
-						pop ebp
-					}
-
-					SrcPtr += SizeX;
-					DstPtr += SizeX*3;
-
-					#endif
-
-					SrcPtr += SrcXtra;
-					DstPtr += DstXtra;
-				}
-				
-//				showPopTSCper("depal 24bit",SizeX*SizeY,"pixel");
-
-				break;
-			}
-			case 4:
-			{
-			uint32 *DstPtr,*PalData;
-				PalData = (uint32 *)DstPal->Data;
-				DstPtr  = (uint32 *)DstData;
-				for(y=SizeY;y--;)
-				{
-					#ifdef DONT_USE_ASM
-
-					for(x=SizeX;x--;)
-					{
-						pal = *SrcPtr++;
-						*DstPtr++ = PalData[pal];
-					}
-
-					#else
-
-					assert( (((uint32)PalData)&3) == 0);
-					assert( (((uint32)DstPtr)&3) == 0);
-
-					__asm
-					{
-						push ebp
-
-						mov ecx,SizeX
-						mov esi,SrcPtr
-						mov edi,DstPtr
-						mov ebp,PalData
-
-						xor eax,eax
-						
-					moredata4:
-
-						mov al, BYTE PTR [esi]
-						mov edx, DWORD PTR [ebp + eax*4]
-						mov DWORD PTR [edi], edx
-
-						inc esi
-						add edi,4
-
-						dec ecx
-						jnz moredata4
-
-						pop ebp
-					}
-
-					SrcPtr += SizeX;
-					DstPtr += SizeX;
+			geBitmap_Palette_Destroy(&DstPal);
+			return GE_FALSE;
+		}
 
-					#endif
+		memset(Pal32,0,sizeof(Pal32));
+		PalData = (uint8 *)DstPal->Data;
+		for(pal=0;pal<DstPal->Size && pal<256;pal++)
+		{
+			memcpy(Pal32+pal,PalData,DstPelBytes);
+			PalData += DstPelBytes;
+		}
 
-					SrcPtr += SrcXtra;
-					DstPtr += DstXtra;
-				}
-				break;
-			}
+		SrcPtr = (uint8 *)SrcData;
+		DstPtr = (uint8 *)DstData;
+		for(y=SizeY;y--;)
+		{
+			DePalRow(DstPtr,SrcPtr,SizeX,Pal32);
+			SrcPtr += SrcRowBytes;
+			DstPtr += DstRowBytes;
 		}
 
 		geBitmap_Palette_Destroy(&DstPal);
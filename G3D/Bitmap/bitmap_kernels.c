@@ -0,0 +1,1242 @@
+/****************************************************************************************/
+/*  Bitmap_Kernels.c                                                                    */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description:  Row converters for the common BlitData and UpdateMips cases           */
+/*					(SSE2/AVX2 when the cpu has them)									*/
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+
+/*}{*********************************************************************/
+
+#include	<stdio.h>
+#include	<assert.h>
+#include	<string.h>
+
+#include	"basetype.h"
+#include	"bitmap_kernels.h"
+#include	"Drivers\SoftDrv2\CPUSimd.h"
+
+/*}{*********************************************************************/
+
+// where R,G,B & A are in the 8-bit-per-channel formats ; these are the byte orders
+//	that the Get_ and Put_ functions of pixelformat.c use
+
+typedef struct
+{
+	gePixelFormat	Format;
+	int				Bytes;
+	int				R,G,B,A;	// A is -1 for none
+} Kernels_Layout;
+
+static const Kernels_Layout Kernels_Layouts[] =
+{
+	{ GE_PIXELFORMAT_24BIT_RGB,		3,	0,1,2,-1 },
+	{ GE_PIXELFORMAT_24BIT_BGR,		3,	2,1,0,-1 },
+	{ GE_PIXELFORMAT_32BIT_RGBX,	4,	3,2,1,-1 },
+	{ GE_PIXELFORMAT_32BIT_XRGB,	4,	2,1,0,-1 },
+	{ GE_PIXELFORMAT_32BIT_BGRX,	4,	1,2,3,-1 },
+	{ GE_PIXELFORMAT_32BIT_XBGR,	4,	0,1,2,-1 },
+	{ GE_PIXELFORMAT_32BIT_RGBA,	4,	3,2,1, 0 },
+	{ GE_PIXELFORMAT_32BIT_ARGB,	4,	2,1,0, 3 },
+	{ GE_PIXELFORMAT_32BIT_BGRA,	4,	1,2,3, 0 },
+	{ GE_PIXELFORMAT_32BIT_ABGR,	4,	0,1,2, 3 },
+};
+
+static const Kernels_Layout * Kernels_FindLayout(gePixelFormat Format)
+{
+int i;
+	for(i=0;i<(int)(sizeof(Kernels_Layouts)/sizeof(Kernels_Layouts[0]));i++)
+	{
+		if ( Kernels_Layouts[i].Format == Format )
+			return Kernels_Layouts + i;
+	}
+return NULL;
+}
+
+/*}{*********************************************************************/
+//	Plain C versions
+/*}{*********************************************************************/
+
+static void Swizzle_C(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+int SrcBytes,DstBytes,s0,s1,s2,s3;
+uint32 Pixel,Fill,Keep,ColorKey;
+geBoolean HasColorKey;
+
+	// in locals, since the Dst writes could alias Convert
+	SrcBytes = Convert->SrcBytes;
+	DstBytes = Convert->DstBytes;
+	s0 = Convert->Shuffle[0];
+	s1 = Convert->Shuffle[1];
+	s2 = Convert->Shuffle[2];
+	s3 = Convert->Shuffle[3];
+	Fill = Convert->Fill;
+	Keep = Convert->Keep;
+	HasColorKey = Convert->HasColorKey;
+	ColorKey = Convert->ColorKey;
+
+	for(;Count--;)
+	{
+		Pixel = Fill;
+		if ( s0 >= 0 ) Pixel |= ((uint32)Src[s0]);
+		if ( s1 >= 0 ) Pixel |= ((uint32)Src[s1])<<8;
+		if ( s2 >= 0 ) Pixel |= ((uint32)Src[s2])<<16;
+		if ( s3 >= 0 ) Pixel |= ((uint32)Src[s3])<<24;
+
+		if ( DstBytes == 4 )
+		{
+			if ( HasColorKey && Pixel == ColorKey )
+				Pixel ^= 1;
+			*((uint32 *)Dst) = Pixel | (*((uint32 *)Dst) & Keep);
+		}
+		else
+		{
+			Dst[0] = (uint8)(Pixel);
+			Dst[1] = (uint8)(Pixel>>8);
+			Dst[2] = (uint8)(Pixel>>16);
+		}
+		Src += SrcBytes;
+		Dst += DstBytes;
+	}
+}
+
+// 4444 -> ARGB/XRGB ; R,G,B get the +8 Get_4444 gives them, A doesn't
+static void Expand4444_C(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+uint32 p,Pixel;
+
+	for(;Count--;)
+	{
+		p = *((uint16 *)Src);
+		Pixel = ((p&0x000F)<<4) | ((p&0x00F0)<<8) | ((p&0x0F00)<<12) | ((p&0xF000)<<16) | 0x080808;
+		Pixel = (Pixel & Convert->Mask) | (*((uint32 *)Dst) & Convert->Keep);
+		if ( Convert->HasColorKey && Pixel == Convert->ColorKey )
+			Pixel ^= 1;
+		*((uint32 *)Dst) = Pixel;
+		Src += 2;
+		Dst += 4;
+	}
+}
+
+// ARGB/XRGB -> 4444 ; the X of XRGB is an A of 255, like Get_32xrgb gives
+static void Pack4444_C(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+uint32 p,Pixel;
+
+	for(;Count--;)
+	{
+		p = (*((uint32 *)Src) & Convert->Mask) | Convert->Fill;
+		Pixel = ((p>>16)&0xF000) | ((p>>12)&0x0F00) | ((p>>8)&0x00F0) | ((p>>4)&0x000F);
+		if ( Convert->HasColorKey && Pixel == Convert->ColorKey )
+			Pixel ^= 1;
+		*((uint16 *)Dst) = (uint16)Pixel;
+		Src += 4;
+		Dst += 2;
+	}
+}
+
+static void Rekey16_C(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+uint16 *pSrc,*pDst;
+uint32 Pixel;
+
+	pSrc = (uint16 *)Src;
+	pDst = (uint16 *)Dst;
+	for(;Count--;)
+	{
+		Pixel = *pSrc++;
+		if ( Convert->SrcHasColorKey && Pixel == Convert->SrcColorKey )
+			Pixel = Convert->ColorKey;
+		else if ( Pixel == Convert->ColorKey )
+			Pixel = Convert->SrcHasColorKey ? Convert->SrcColorKey : (Pixel^1);
+		*pDst++ = (uint16)Pixel;
+	}
+}
+
+static void Rekey32_C(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+uint32 *pSrc,*pDst;
+uint32 Pixel;
+
+	pSrc = (uint32 *)Src;
+	pDst = (uint32 *)Dst;
+	for(;Count--;)
+	{
+		Pixel = *pSrc++;
+		if ( Convert->SrcHasColorKey && Pixel == Convert->SrcColorKey )
+			Pixel = Convert->ColorKey;
+		else if ( Pixel == Convert->ColorKey )
+			Pixel = Convert->SrcHasColorKey ? Convert->SrcColorKey : (Pixel^1);
+		*pDst++ = Pixel;
+	}
+}
+
+static void DePal1_C(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+	for(;Count--;)
+		*Dst++ = (uint8)Pal[*Src++];
+}
+
+static void DePal2_C(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+uint16 *pDst;
+	pDst = (uint16 *)Dst;
+	for(;Count--;)
+		*pDst++ = (uint16)Pal[*Src++];
+}
+
+static void DePal3_C(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+uint32 Pixel;
+	for(;Count--;)
+	{
+		Pixel = Pal[*Src++];
+		Dst[0] = (uint8)(Pixel);
+		Dst[1] = (uint8)(Pixel>>8);
+		Dst[2] = (uint8)(Pixel>>16);
+		Dst += 3;
+	}
+}
+
+static void DePal4_C(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+uint32 *pDst;
+	pDst = (uint32 *)Dst;
+	for(;Count--;)
+		*pDst++ = Pal[*Src++];
+}
+
+// the 24 & 32 bit formats : every byte is a channel, (a+b+c+d+2)>>2
+static void MipBytes_C(uint8 *Dst,const uint8 *Src1,const uint8 *Src2,int Count,const geBitmap_Mip *Mip)
+{
+int b,Bytes;
+
+	Bytes = Mip->Bytes;
+	for(;Count--;)
+	{
+		for(b=0;b<Bytes;b++)
+		{
+			if ( ! ((Mip->Keep >> (b<<3)) & 0xFF) )
+				Dst[b] = (uint8)((Src1[b] + Src1[b+Bytes] + Src2[b] + Src2[b+Bytes] + 2)>>2);
+		}
+		Src1 += Bytes+Bytes;
+		Src2 += Bytes+Bytes;
+		Dst += Bytes;
+	}
+}
+
+// the 16 bit formats : Get_ centers every field but the alphas in it's range, so
+//	averaging the 8 bit colors and Put_'ing them works out to (a+b+c+d+Round)>>2 per field
+static void Mip16_C(uint8 *Dst,const uint8 *Src1,const uint8 *Src2,int Count,const geBitmap_Mip *Mip)
+{
+const uint16 *p1,*p2;
+uint16 *pDst;
+uint32 Pixel,Sum,m;
+int f,s;
+
+	p1 = (const uint16 *)Src1;
+	p2 = (const uint16 *)Src2;
+	pDst = (uint16 *)Dst;
+	for(;Count--;)
+	{
+		Pixel = 0;
+		for(f=0;f<Mip->NumFields;f++)
+		{
+			s = Mip->Shift[f];
+			m = Mip->FieldMask[f];
+			Sum = ((p1[0]>>s)&m) + ((p1[1]>>s)&m) + ((p2[0]>>s)&m) + ((p2[1]>>s)&m);
+			Pixel |= ((Sum + Mip->Round[f])>>2)<<s;
+		}
+		*pDst++ = (uint16)Pixel;
+		p1 += 2;
+		p2 += 2;
+	}
+}
+
+static geBitmap_ConvertRow	Kernels_Swizzle		= Swizzle_C;
+static geBitmap_ConvertRow	Kernels_Expand4444	= Expand4444_C;
+static geBitmap_ConvertRow	Kernels_Pack4444	= Pack4444_C;
+static geBitmap_ConvertRow	Kernels_Rekey16		= Rekey16_C;
+static geBitmap_ConvertRow	Kernels_Rekey32		= Rekey32_C;
+static geBitmap_DePalRow	Kernels_DePal[5]	= { NULL, DePal1_C, DePal2_C, DePal3_C, DePal4_C };
+static geBitmap_MipRow		Kernels_MipBytes	= MipBytes_C;
+static geBitmap_MipRow		Kernels_Mip16		= Mip16_C;
+
+static geBoolean			Kernels_Ready		= GE_FALSE;
+
+#ifdef GE_HAVE_SSE2
+/*}{*********************************************************************/
+//	SSE2 versions
+/*}{*********************************************************************/
+
+// the Src bytes that all move the same distance go in one shift
+typedef struct
+{
+	int		NumMoves;
+	__m128i	Mask[4];
+	__m128i	Shift[4];
+	int		Left[4];
+} SSE2_Moves;
+
+static void SSE2_MakeMoves(const geBitmap_Convert *Convert,SSE2_Moves *Moves)
+{
+uint32 Mask[7];
+int b,d;
+
+	memset(Mask,0,sizeof(Mask));
+	for(b=0;b<4;b++)
+	{
+		if ( Convert->Shuffle[b] >= 0 )
+			Mask[b - Convert->Shuffle[b] + 3] |= ((uint32)0xFF)<<(Convert->Shuffle[b]<<3);
+	}
+
+	Moves->NumMoves = 0;
+	for(d=0;d<7;d++)
+	{
+		if ( Mask[d] )
+		{
+			Moves->Mask[Moves->NumMoves]  = _mm_set1_epi32(Mask[d]);
+			Moves->Shift[Moves->NumMoves] = _mm_cvtsi32_si128( (d >= 3 ? (d-3) : (3-d)) << 3 );
+			Moves->Left[Moves->NumMoves]  = (d >= 3);
+			Moves->NumMoves++;
+		}
+	}
+}
+
+static __m128i SSE2_DoMoves(__m128i S,const SSE2_Moves *Moves)
+{
+__m128i P,T;
+int m;
+
+	P = _mm_setzero_si128();
+	for(m=0;m<Moves->NumMoves;m++)
+	{
+		T = _mm_and_si128(S,Moves->Mask[m]);
+		if ( Moves->Left[m] )
+			T = _mm_sll_epi32(T,Moves->Shift[m]);
+		else
+			T = _mm_srl_epi32(T,Moves->Shift[m]);
+		P = _mm_or_si128(P,T);
+	}
+return P;
+}
+
+// Pixel ^= 1 where Pixel == Key
+#define SSE2_UNKEY32(P,Key,One)	P = _mm_xor_si128(P, _mm_and_si128(_mm_cmpeq_epi32(P,Key),One))
+#define SSE2_UNKEY16(P,Key,One)	P = _mm_xor_si128(P, _mm_and_si128(_mm_cmpeq_epi16(P,Key),One))
+
+// only does 4 -> 4 ; the 24 bit ones need a byte shuffle
+static void Swizzle_SSE2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+SSE2_Moves Moves;
+__m128i P,Fill,Keep,Key,One;
+int x;
+
+	if ( Convert->SrcBytes != 4 || Convert->DstBytes != 4 )
+	{
+		Swizzle_C(Dst,Src,Count,Convert);
+		return;
+	}
+
+	SSE2_MakeMoves(Convert,&Moves);
+	Fill = _mm_set1_epi32(Convert->Fill);
+	Keep = _mm_set1_epi32(Convert->Keep);
+	Key  = _mm_set1_epi32(Convert->ColorKey);
+	One  = _mm_set1_epi32(1);
+
+	for(x=0;x+4<=Count;x+=4)
+	{
+		P = SSE2_DoMoves(_mm_loadu_si128((const __m128i *)(Src+x*4)),&Moves);
+		P = _mm_or_si128(P,Fill);
+		if ( Convert->Keep )
+			P = _mm_or_si128(P, _mm_and_si128(_mm_loadu_si128((const __m128i *)(Dst+x*4)),Keep));
+		if ( Convert->HasColorKey )
+			SSE2_UNKEY32(P,Key,One);
+		_mm_storeu_si128((__m128i *)(Dst+x*4),P);
+	}
+
+	Swizzle_C(Dst+x*4,Src+x*4,Count-x,Convert);
+}
+
+static __m128i SSE2_Expand4444(__m128i p)
+{
+__m128i P;
+	P =	_mm_or_si128(
+			_mm_or_si128(	_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0x000F)), 4),
+							_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0x00F0)), 8) ),
+			_mm_or_si128(	_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0x0F00)),12),
+							_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0xF000)),16) ) );
+return _mm_or_si128(P,_mm_set1_epi32(0x080808));
+}
+
+static void Expand4444_SSE2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+__m128i S,P[2],Zero,Mask,Keep,Key,One;
+int x,i;
+
+	Zero = _mm_setzero_si128();
+	Mask = _mm_set1_epi32(Convert->Mask);
+	Keep = _mm_set1_epi32(Convert->Keep);
+	Key  = _mm_set1_epi32(Convert->ColorKey);
+	One  = _mm_set1_epi32(1);
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		S = _mm_loadu_si128((const __m128i *)(Src+x*2));
+		P[0] = SSE2_Expand4444(_mm_unpacklo_epi16(S,Zero));
+		P[1] = SSE2_Expand4444(_mm_unpackhi_epi16(S,Zero));
+
+		for(i=0;i<2;i++)
+		{
+			P[i] = _mm_and_si128(P[i],Mask);
+			if ( Convert->Keep )
+				P[i] = _mm_or_si128(P[i], _mm_and_si128(_mm_loadu_si128((const __m128i *)(Dst+x*4+i*16)),Keep));
+			if ( Convert->HasColorKey )
+				SSE2_UNKEY32(P[i],Key,One);
+			_mm_storeu_si128((__m128i *)(Dst+x*4+i*16),P[i]);
+		}
+	}
+
+	Expand4444_C(Dst+x*4,Src+x*2,Count-x,Convert);
+}
+
+static __m128i SSE2_Pack4444(__m128i p)
+{
+__m128i P;
+	P =	_mm_or_si128(
+			_mm_or_si128(	_mm_and_si128(_mm_srli_epi32(p,16),_mm_set1_epi32(0xF000)),
+							_mm_and_si128(_mm_srli_epi32(p,12),_mm_set1_epi32(0x0F00)) ),
+			_mm_or_si128(	_mm_and_si128(_mm_srli_epi32(p, 8),_mm_set1_epi32(0x00F0)),
+							_mm_and_si128(_mm_srli_epi32(p, 4),_mm_set1_epi32(0x000F)) ) );
+
+	// sign extend, so the signed pack doesn't saturate it
+return _mm_srai_epi32(_mm_slli_epi32(P,16),16);
+}
+
+static void Pack4444_SSE2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+__m128i P0,P1,P,Mask,Fill,Key,One;
+int x;
+
+	Mask = _mm_set1_epi32(Convert->Mask);
+	Fill = _mm_set1_epi32(Convert->Fill);
+	Key  = _mm_set1_epi16((short)Convert->ColorKey);
+	One  = _mm_set1_epi16(1);
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		P0 = _mm_or_si128(_mm_and_si128(_mm_loadu_si128((const __m128i *)(Src+x*4   )),Mask),Fill);
+		P1 = _mm_or_si128(_mm_and_si128(_mm_loadu_si128((const __m128i *)(Src+x*4+16)),Mask),Fill);
+		P = _mm_packs_epi32(SSE2_Pack4444(P0),SSE2_Pack4444(P1));
+		if ( Convert->HasColorKey )
+			SSE2_UNKEY16(P,Key,One);
+		_mm_storeu_si128((__m128i *)(Dst+x*2),P);
+	}
+
+	Pack4444_C(Dst+x*2,Src+x*4,Count-x,Convert);
+}
+
+static void Rekey16_SSE2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+__m128i P,IsSrc,IsDst,SrcKey,DstKey,One;
+int x;
+
+	SrcKey = _mm_set1_epi16((short)Convert->SrcColorKey);
+	DstKey = _mm_set1_epi16((short)Convert->ColorKey);
+	One    = _mm_set1_epi16(1);
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		P = _mm_loadu_si128((const __m128i *)(Src+x*2));
+		if ( Convert->SrcHasColorKey )
+		{
+			IsSrc = _mm_cmpeq_epi16(P,SrcKey);
+			IsDst = _mm_cmpeq_epi16(P,DstKey);
+			P = _mm_or_si128( _mm_andnot_si128(_mm_or_si128(IsSrc,IsDst),P),
+					_mm_or_si128(_mm_and_si128(IsSrc,DstKey),_mm_and_si128(IsDst,SrcKey)) );
+		}
+		else
+		{
+			SSE2_UNKEY16(P,DstKey,One);
+		}
+		_mm_storeu_si128((__m128i *)(Dst+x*2),P);
+	}
+
+	Rekey16_C(Dst+x*2,Src+x*2,Count-x,Convert);
+}
+
+static void Rekey32_SSE2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+__m128i P,IsSrc,IsDst,SrcKey,DstKey,One;
+int x;
+
+	SrcKey = _mm_set1_epi32(Convert->SrcColorKey);
+	DstKey = _mm_set1_epi32(Convert->ColorKey);
+	One    = _mm_set1_epi32(1);
+
+	for(x=0;x+4<=Count;x+=4)
+	{
+		P = _mm_loadu_si128((const __m128i *)(Src+x*4));
+		if ( Convert->SrcHasColorKey )
+		{
+			IsSrc = _mm_cmpeq_epi32(P,SrcKey);
+			IsDst = _mm_cmpeq_epi32(P,DstKey);
+			P = _mm_or_si128( _mm_andnot_si128(_mm_or_si128(IsSrc,IsDst),P),
+					_mm_or_si128(_mm_and_si128(IsSrc,DstKey),_mm_and_si128(IsDst,SrcKey)) );
+		}
+		else
+		{
+			SSE2_UNKEY32(P,DstKey,One);
+		}
+		_mm_storeu_si128((__m128i *)(Dst+x*4),P);
+	}
+
+	Rekey32_C(Dst+x*4,Src+x*4,Count-x,Convert);
+}
+
+// 4 Dst pixels out of 8 pixels of each Src row : the rows are added as 16 bits, then
+//	the 64 bit halfs (neighboring pixels) are added
+#define SSE2_MIP4(A,B,Zero,Two,Out)											\
+{																			\
+	__m128i	L, H;															\
+	L = _mm_add_epi16(_mm_unpacklo_epi8(A,Zero),_mm_unpacklo_epi8(B,Zero));	\
+	H = _mm_add_epi16(_mm_unpackhi_epi8(A,Zero),_mm_unpackhi_epi8(B,Zero));	\
+	Out = _mm_add_epi16(_mm_unpacklo_epi64(L,H),_mm_unpackhi_epi64(L,H));	\
+	Out = _mm_srli_epi16(_mm_add_epi16(Out,Two),2);							\
+}
+
+static void MipBytes_SSE2(uint8 *Dst,const uint8 *Src1,const uint8 *Src2,int Count,const geBitmap_Mip *Mip)
+{
+__m128i P0,P1,P,Zero,Two,Keep;
+int x;
+
+	if ( Mip->Bytes != 4 )
+	{
+		MipBytes_C(Dst,Src1,Src2,Count,Mip);
+		return;
+	}
+
+	Zero = _mm_setzero_si128();
+	Two  = _mm_set1_epi16(2);
+	Keep = _mm_set1_epi32(Mip->Keep);
+
+	for(x=0;x+4<=Count;x+=4)
+	{
+		SSE2_MIP4(_mm_loadu_si128((const __m128i *)(Src1+x*8   )),_mm_loadu_si128((const __m128i *)(Src2+x*8   )),Zero,Two,P0);
+		SSE2_MIP4(_mm_loadu_si128((const __m128i *)(Src1+x*8+16)),_mm_loadu_si128((const __m128i *)(Src2+x*8+16)),Zero,Two,P1);
+		P = _mm_packus_epi16(P0,P1);
+		if ( Mip->Keep )
+			P = _mm_or_si128(_mm_andnot_si128(Keep,P),_mm_and_si128(_mm_loadu_si128((const __m128i *)(Dst+x*4)),Keep));
+		_mm_storeu_si128((__m128i *)(Dst+x*4),P);
+	}
+
+	MipBytes_C(Dst+x*4,Src1+x*8,Src2+x*8,Count-x,Mip);
+}
+
+// the 16 bit field sums of 4 Dst pixels, out of 8 pixels of each Src row
+static __m128i SSE2_Mip16(__m128i A,__m128i B,const geBitmap_Mip *Mip)
+{
+__m128i Out,Sum,Shift,Mask,LoWord;
+int f;
+
+	Out = _mm_setzero_si128();
+	LoWord = _mm_set1_epi32(0xFFFF);
+	for(f=0;f<Mip->NumFields;f++)
+	{
+		Shift = _mm_cvtsi32_si128(Mip->Shift[f]);
+		Mask  = _mm_set1_epi16((short)Mip->FieldMask[f]);
+		Sum = _mm_add_epi16(_mm_and_si128(_mm_srl_epi16(A,Shift),Mask),_mm_and_si128(_mm_srl_epi16(B,Shift),Mask));
+		Sum = _mm_add_epi32(_mm_and_si128(Sum,LoWord),_mm_srli_epi32(Sum,16));
+		Sum = _mm_srli_epi32(_mm_add_epi32(Sum,_mm_set1_epi32(Mip->Round[f])),2);
+		Out = _mm_or_si128(Out,_mm_sll_epi32(Sum,Shift));
+	}
+return _mm_srai_epi32(_mm_slli_epi32(Out,16),16);
+}
+
+static void Mip16_SSE2(uint8 *Dst,const uint8 *Src1,const uint8 *Src2,int Count,const geBitmap_Mip *Mip)
+{
+__m128i P0,P1;
+int x;
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		P0 = SSE2_Mip16(_mm_loadu_si128((const __m128i *)(Src1+x*4   )),_mm_loadu_si128((const __m128i *)(Src2+x*4   )),Mip);
+		P1 = SSE2_Mip16(_mm_loadu_si128((const __m128i *)(Src1+x*4+16)),_mm_loadu_si128((const __m128i *)(Src2+x*4+16)),Mip);
+		_mm_storeu_si128((__m128i *)(Dst+x*2),_mm_packs_epi32(P0,P1));
+	}
+
+	Mip16_C(Dst+x*2,Src1+x*4,Src2+x*4,Count-x,Mip);
+}
+#endif
+
+#ifdef GE_HAVE_AVX2
+/*}{*********************************************************************/
+//	AVX2 versions
+/*}{*********************************************************************/
+
+// the 12 byte Dst of a 24 bit row goes out exactly, so the converters still work in place
+#define AVX2_STORE24(Dst,P)												\
+{																		\
+	__m128i	Hi;															\
+	Hi = _mm256_extracti128_si256(P,1);									\
+	_mm_storeu_si128((__m128i *)(Dst),_mm256_castsi256_si128(P));		\
+	_mm_storel_epi64((__m128i *)((Dst)+12),Hi);							\
+	*((int *)((Dst)+20)) = _mm_cvtsi128_si32(_mm_srli_si128(Hi,8));		\
+}
+
+// any of 24/32 -> 24/32 with a byte shuffle; each 128 bit lane does 4 pixels
+static void Swizzle_AVX2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+uint8 Control[16];
+__m256i P,Shuffle,Fill,Keep,Key,One;
+int x,p,b,SrcBytes,DstBytes,Need;
+
+	SrcBytes = Convert->SrcBytes;
+	DstBytes = Convert->DstBytes;
+
+	memset(Control,0x80,sizeof(Control));
+	for(p=0;p<4;p++)
+	{
+		for(b=0;b<DstBytes;b++)
+		{
+			if ( Convert->Shuffle[b] >= 0 )
+				Control[p*DstBytes + b] = (uint8)(p*SrcBytes + Convert->Shuffle[b]);
+		}
+	}
+
+	Shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)Control));
+	Fill = _mm256_set1_epi32(Convert->Fill);
+	Keep = _mm256_set1_epi32(Convert->Keep);
+	Key  = _mm256_set1_epi32(Convert->ColorKey);
+	One  = _mm256_set1_epi32(1);
+
+	// a 24 bit Src reads 16 bytes for the 12 each lane uses
+	Need = (SrcBytes == 3) ? 10 : 8;
+
+	for(x=0;x+Need<=Count;x+=8)
+	{
+		P = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(Src+x*SrcBytes))),
+									_mm_loadu_si128((const __m128i *)(Src+x*SrcBytes+4*SrcBytes)),1);
+		P = _mm256_shuffle_epi8(P,Shuffle);
+
+		if ( DstBytes == 4 )
+		{
+			P = _mm256_or_si256(P,Fill);
+			if ( Convert->Keep )
+				P = _mm256_or_si256(P, _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(Dst+x*4)),Keep));
+			if ( Convert->HasColorKey )
+				P = _mm256_xor_si256(P, _mm256_and_si256(_mm256_cmpeq_epi32(P,Key),One));
+			_mm256_storeu_si256((__m256i *)(Dst+x*4),P);
+		}
+		else
+		{
+			AVX2_STORE24(Dst+x*3,P);
+		}
+	}
+
+	Swizzle_C(Dst+x*DstBytes,Src+x*SrcBytes,Count-x,Convert);
+}
+
+static void Rekey32_AVX2(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert)
+{
+__m256i P,IsSrc,IsDst,SrcKey,DstKey,One;
+int x;
+
+	SrcKey = _mm256_set1_epi32(Convert->SrcColorKey);
+	DstKey = _mm256_set1_epi32(Convert->ColorKey);
+	One    = _mm256_set1_epi32(1);
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		P = _mm256_loadu_si256((const __m256i *)(Src+x*4));
+		IsDst = _mm256_cmpeq_epi32(P,DstKey);
+		if ( Convert->SrcHasColorKey )
+		{
+			IsSrc = _mm256_cmpeq_epi32(P,SrcKey);
+			P = _mm256_blendv_epi8(P,DstKey,IsSrc);
+			P = _mm256_blendv_epi8(P,SrcKey,IsDst);
+		}
+		else
+		{
+			P = _mm256_xor_si256(P, _mm256_and_si256(IsDst,One));
+		}
+		_mm256_storeu_si256((__m256i *)(Dst+x*4),P);
+	}
+
+	Rekey32_C(Dst+x*4,Src+x*4,Count-x,Convert);
+}
+
+// 8 palette entries
+#define AVX2_GATHER8(Src,Pal)	_mm256_i32gather_epi32((const int *)(Pal), _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(Src))), 4)
+
+static void DePal2_AVX2(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+__m256i P;
+int x;
+
+	for(x=0;x+16<=Count;x+=16)
+	{
+		// the entries are 16 bits, so the unsigned pack is exact
+		P = _mm256_packus_epi32(AVX2_GATHER8(Src+x,Pal),AVX2_GATHER8(Src+x+8,Pal));
+		P = _mm256_permute4x64_epi64(P,_MM_SHUFFLE(3,1,2,0));
+		_mm256_storeu_si256((__m256i *)(Dst+x*2),P);
+	}
+
+	DePal2_C(Dst+x*2,Src+x,Count-x,Pal);
+}
+
+static void DePal3_AVX2(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+__m256i P,Shuffle;
+int x;
+
+	Shuffle = _mm256_setr_epi8(	0,1,2,4,5,6,8,9,10,12,13,14,-128,-128,-128,-128,
+								0,1,2,4,5,6,8,9,10,12,13,14,-128,-128,-128,-128);
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		P = _mm256_shuffle_epi8(AVX2_GATHER8(Src+x,Pal),Shuffle);
+		AVX2_STORE24(Dst+x*3,P);
+	}
+
+	DePal3_C(Dst+x*3,Src+x,Count-x,Pal);
+}
+
+static void DePal4_AVX2(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal)
+{
+int x;
+
+	for(x=0;x+8<=Count;x+=8)
+		_mm256_storeu_si256((__m256i *)(Dst+x*4),AVX2_GATHER8(Src+x,Pal));
+
+	DePal4_C(Dst+x*4,Src+x,Count-x,Pal);
+}
+
+// SSE2_MIP4 for 8 Src pixels a lane ; lane 0 gets Dst 0,1 and lane 1 gets Dst 2,3
+#define AVX2_MIP4(A,B,Zero,Two,Out)														\
+{																						\
+	__m256i	L, H;																		\
+	L = _mm256_add_epi16(_mm256_unpacklo_epi8(A,Zero),_mm256_unpacklo_epi8(B,Zero));	\
+	H = _mm256_add_epi16(_mm256_unpackhi_epi8(A,Zero),_mm256_unpackhi_epi8(B,Zero));	\
+	Out = _mm256_add_epi16(_mm256_unpacklo_epi64(L,H),_mm256_unpackhi_epi64(L,H));		\
+	Out = _mm256_srli_epi16(_mm256_add_epi16(Out,Two),2);								\
+}
+
+static void MipBytes_AVX2(uint8 *Dst,const uint8 *Src1,const uint8 *Src2,int Count,const geBitmap_Mip *Mip)
+{
+__m256i P0,P1,P,Zero,Two,Keep;
+int x;
+
+	if ( Mip->Bytes != 4 )
+	{
+		MipBytes_C(Dst,Src1,Src2,Count,Mip);
+		return;
+	}
+
+	Zero = _mm256_setzero_si256();
+	Two  = _mm256_set1_epi16(2);
+	Keep = _mm256_set1_epi32(Mip->Keep);
+
+	for(x=0;x+8<=Count;x+=8)
+	{
+		AVX2_MIP4(_mm256_loadu_si256((const __m256i *)(Src1+x*8   )),_mm256_loadu_si256((const __m256i *)(Src2+x*8   )),Zero,Two,P0);
+		AVX2_MIP4(_mm256_loadu_si256((const __m256i *)(Src1+x*8+32)),_mm256_loadu_si256((const __m256i *)(Src2+x*8+32)),Zero,Two,P1);
+
+		// the pack leaves Dst 0,1,4,5 in lane 0 and 2,3,6,7 in lane 1
+		P = _mm256_permute4x64_epi64(_mm256_packus_epi16(P0,P1),_MM_SHUFFLE(3,1,2,0));
+		if ( Mip->Keep )
+			P = _mm256_or_si256(_mm256_andnot_si256(Keep,P),_mm256_and_si256(_mm256_loadu_si256((const __m256i *)(Dst+x*4)),Keep));
+		_mm256_storeu_si256((__m256i *)(Dst+x*4),P);
+	}
+
+	MipBytes_C(Dst+x*4,Src1+x*8,Src2+x*8,Count-x,Mip);
+}
+#endif
+
+/*}{*********************************************************************/
+
+void geBitmap_Kernels_Init(void)
+{
+	Kernels_Swizzle		= Swizzle_C;
+	Kernels_Expand4444	= Expand4444_C;
+	Kernels_Pack4444	= Pack4444_C;
+	Kernels_Rekey16		= Rekey16_C;
+	Kernels_Rekey32		= Rekey32_C;
+	Kernels_DePal[1]	= DePal1_C;
+	Kernels_DePal[2]	= DePal2_C;
+	Kernels_DePal[3]	= DePal3_C;
+	Kernels_DePal[4]	= DePal4_C;
+	Kernels_MipBytes	= MipBytes_C;
+	Kernels_Mip16		= Mip16_C;
+
+#ifdef GE_HAVE_SSE2
+	if ( CPUInfo_TestForSSE2() )
+	{
+		Kernels_Swizzle		= Swizzle_SSE2;
+		Kernels_Expand4444	= Expand4444_SSE2;
+		Kernels_Pack4444	= Pack4444_SSE2;
+		Kernels_Rekey16		= Rekey16_SSE2;
+		Kernels_Rekey32		= Rekey32_SSE2;
+		Kernels_MipBytes	= MipBytes_SSE2;
+		Kernels_Mip16		= Mip16_SSE2;
+	}
+#endif
+
+#ifdef GE_HAVE_AVX2
+	if ( CPUInfo_TestForAVX2() )
+	{
+		// the 1 byte lookup stays in C
+		Kernels_Swizzle		= Swizzle_AVX2;
+		Kernels_Rekey32		= Rekey32_AVX2;
+		Kernels_DePal[2]	= DePal2_AVX2;
+		Kernels_DePal[3]	= DePal3_AVX2;
+		Kernels_DePal[4]	= DePal4_AVX2;
+		Kernels_MipBytes	= MipBytes_AVX2;
+	}
+#endif
+
+	Kernels_Ready = GE_TRUE;
+}
+
+/*}{*********************************************************************/
+
+geBitmap_DePalRow geBitmap_Kernels_GetDePal(int Bytes)
+{
+	if ( ! Kernels_Ready )
+		geBitmap_Kernels_Init();
+
+	if ( Bytes < 1 || Bytes > 4 )
+		return NULL;
+
+return Kernels_DePal[Bytes];
+}
+
+geBoolean geBitmap_Kernels_GetConvert(gePixelFormat SrcFormat,gePixelFormat DstFormat,
+								geBoolean DstHasColorKey,uint32 DstColorKey,geBitmap_Convert *Convert)
+{
+const Kernels_Layout *SrcLayout,*DstLayout;
+int b;
+
+	assert(Convert);
+
+	if ( ! Kernels_Ready )
+		geBitmap_Kernels_Init();
+
+	memset(Convert,0,sizeof(*Convert));
+	for(b=0;b<4;b++)
+		Convert->Shuffle[b] = -1;
+	Convert->HasColorKey = DstHasColorKey;
+	Convert->ColorKey = DstColorKey;
+
+	if ( SrcFormat == GE_PIXELFORMAT_16BIT_4444_ARGB )
+	{
+		if ( DstFormat != GE_PIXELFORMAT_32BIT_ARGB && DstFormat != GE_PIXELFORMAT_32BIT_XRGB )
+			return GE_FALSE;
+
+		Convert->Row = Kernels_Expand4444;
+		Convert->SrcBytes = 2;
+		Convert->DstBytes = 4;
+		Convert->Mask = (DstFormat == GE_PIXELFORMAT_32BIT_ARGB) ? 0xFFFFFFFF : 0x00FFFFFF;
+
+		// with a ColorKey, BlitData_Raw Composes the pixel, which makes the X zero
+		Convert->Keep = DstHasColorKey ? 0 : ~Convert->Mask;
+		return GE_TRUE;
+	}
+	else if ( DstFormat == GE_PIXELFORMAT_16BIT_4444_ARGB )
+	{
+		if ( SrcFormat != GE_PIXELFORMAT_32BIT_ARGB && SrcFormat != GE_PIXELFORMAT_32BIT_XRGB )
+			return GE_FALSE;
+
+		Convert->Row = Kernels_Pack4444;
+		Convert->SrcBytes = 4;
+		Convert->DstBytes = 2;
+		Convert->Mask = (SrcFormat == GE_PIXELFORMAT_32BIT_ARGB) ? 0xFFFFFFFF : 0x00FFFFFF;
+		Convert->Fill = ~Convert->Mask;
+		return GE_TRUE;
+	}
+
+	SrcLayout = Kernels_FindLayout(SrcFormat);
+	DstLayout = Kernels_FindLayout(DstFormat);
+	if ( ! SrcLayout || ! DstLayout )
+		return GE_FALSE;
+
+	// PutPixel_24bit has it's own byte order; leave that to BlitData_Raw
+	if ( DstHasColorKey && DstLayout->Bytes != 4 )
+		return GE_FALSE;
+
+	Convert->Row = Kernels_Swizzle;
+	Convert->SrcBytes = SrcLayout->Bytes;
+	Convert->DstBytes = DstLayout->Bytes;
+
+	Convert->Shuffle[DstLayout->R] = SrcLayout->R;
+	Convert->Shuffle[DstLayout->G] = SrcLayout->G;
+	Convert->Shuffle[DstLayout->B] = SrcLayout->B;
+	Convert->Mask = (((uint32)0xFF)<<(DstLayout->R<<3)) | (((uint32)0xFF)<<(DstLayout->G<<3)) | (((uint32)0xFF)<<(DstLayout->B<<3));
+
+	if ( DstLayout->A >= 0 )
+	{
+		Convert->Mask |= ((uint32)0xFF)<<(DstLayout->A<<3);
+		if ( SrcLayout->A >= 0 )
+			Convert->Shuffle[DstLayout->A] = SrcLayout->A;
+		else
+			Convert->Fill = ((uint32)0xFF)<<(DstLayout->A<<3);
+	}
+	else if ( DstLayout->Bytes == 4 && ! DstHasColorKey )
+	{
+		Convert->Keep = ~Convert->Mask;
+	}
+
+return GE_TRUE;
+}
+
+geBoolean geBitmap_Kernels_GetRekey(gePixelFormat Format,geBoolean SrcHasColorKey,uint32 SrcColorKey,
+								uint32 DstColorKey,geBitmap_Convert *Convert)
+{
+int b;
+
+	assert(Convert);
+
+	if ( ! Kernels_Ready )
+		geBitmap_Kernels_Init();
+
+	memset(Convert,0,sizeof(*Convert));
+	for(b=0;b<4;b++)
+		Convert->Shuffle[b] = -1;
+
+	switch( gePixelFormat_BytesPerPel(Format) )
+	{
+		default:
+			return GE_FALSE;
+		case 2:
+			Convert->Row = Kernels_Rekey16;
+			break;
+		case 4:
+			Convert->Row = Kernels_Rekey32;
+			break;
+	}
+
+	Convert->SrcBytes = Convert->DstBytes = gePixelFormat_BytesPerPel(Format);
+	Convert->HasColorKey = GE_TRUE;
+	Convert->ColorKey = DstColorKey;
+	Convert->SrcHasColorKey = SrcHasColorKey;
+	Convert->SrcColorKey = SrcColorKey;
+
+return GE_TRUE;
+}
+
+geBoolean geBitmap_Kernels_GetMip(gePixelFormat Format,geBitmap_Mip *Mip)
+{
+const Kernels_Layout *Layout;
+
+	assert(Mip);
+
+	if ( ! Kernels_Ready )
+		geBitmap_Kernels_Init();
+
+	memset(Mip,0,sizeof(*Mip));
+
+	switch(Format)
+	{
+		case GE_PIXELFORMAT_16BIT_565_RGB:
+		case GE_PIXELFORMAT_16BIT_565_BGR:
+			Mip->NumFields = 3;
+			Mip->Shift[0] = 0;	Mip->FieldMask[0] = 0x1F;	Mip->Round[0] = 2;
+			Mip->Shift[1] = 5;	Mip->FieldMask[1] = 0x3F;	Mip->Round[1] = 2;
+			Mip->Shift[2] = 11;	Mip->FieldMask[2] = 0x1F;	Mip->Round[2] = 2;
+			break;
+		case GE_PIXELFORMAT_16BIT_555_RGB:
+		case GE_PIXELFORMAT_16BIT_555_BGR:
+		case GE_PIXELFORMAT_16BIT_1555_ARGB:
+			Mip->NumFields = 3;
+			Mip->Shift[0] = 0;	Mip->FieldMask[0] = 0x1F;	Mip->Round[0] = 2;
+			Mip->Shift[1] = 5;	Mip->FieldMask[1] = 0x1F;	Mip->Round[1] = 2;
+			Mip->Shift[2] = 10;	Mip->FieldMask[2] = 0x1F;	Mip->Round[2] = 2;
+			if ( Format == GE_PIXELFORMAT_16BIT_1555_ARGB )
+			{
+				Mip->NumFields = 4;
+				Mip->Shift[3] = 15;	Mip->FieldMask[3] = 0x1;	Mip->Round[3] = 0;
+			}
+			break;
+		case GE_PIXELFORMAT_16BIT_4444_ARGB:
+			Mip->NumFields = 4;
+			Mip->Shift[0] = 0;	Mip->FieldMask[0] = 0xF;	Mip->Round[0] = 2;
+			Mip->Shift[1] = 4;	Mip->FieldMask[1] = 0xF;	Mip->Round[1] = 2;
+			Mip->Shift[2] = 8;	Mip->FieldMask[2] = 0xF;	Mip->Round[2] = 2;
+			Mip->Shift[3] = 12;	Mip->FieldMask[3] = 0xF;	Mip->Round[3] = 0;
+			break;
+		default:
+			if ( ! (Layout = Kernels_FindLayout(Format)) )
+				return GE_FALSE;
+
+			Mip->Row = Kernels_MipBytes;
+			Mip->Bytes = Layout->Bytes;
+
+			// R+G+B+X == 0+1+2+3
+			if ( Layout->Bytes == 4 && Layout->A < 0 )
+				Mip->Keep = ((uint32)0xFF)<<((6 - Layout->R - Layout->G - Layout->B)<<3);
+			return GE_TRUE;
+	}
+
+	Mip->Row = Kernels_Mip16;
+	Mip->Bytes = 2;
+
+return GE_TRUE;
+}
+
+#ifdef BITMAP_KERNELS_BENCHMARK
+/*}{*********************************************************************/
+//	Benchmark
+/*}{*********************************************************************/
+
+#include	<windows.h>
+
+#define BENCH_WIDTH		(256)
+#define BENCH_ROWS		(256)
+#define BENCH_LOOPS		(20)
+
+typedef struct
+{
+	const char *		Name;
+	geBitmap_ConvertRow	Swizzle,Expand4444,Pack4444,Rekey16,Rekey32;
+	geBitmap_DePalRow	DePal[5];
+	geBitmap_MipRow		MipBytes,Mip16;
+} Bench_Kernels;
+
+static uint8	BenchSrc[BENCH_WIDTH*4*2];
+static uint8	BenchRef[BENCH_WIDTH*4],BenchDst[BENCH_WIDTH*4];
+static uint32	BenchPal[256];
+
+static geFloat BenchSeconds(LARGE_INTEGER *Start)
+{
+LARGE_INTEGER End,Freq;
+
+	QueryPerformanceCounter(&End);
+	QueryPerformanceFrequency(&Freq);
+
+return (geFloat)(End.QuadPart - Start->QuadPart) / (geFloat)Freq.QuadPart;
+}
+
+static void BenchReport(const char *What,const char *Name,geFloat Time,geBoolean Same)
+{
+char Str[256];
+	sprintf(Str,"Bitmap_Kernels: %-24s %-4s  %.3fus per %ix%i%s\n",What,Name,
+		Time*1000000.0f/(geFloat)BENCH_LOOPS,BENCH_WIDTH,BENCH_ROWS,Same ? "" : "  *** DOES NOT MATCH C ***");
+	OutputDebugString(Str);
+}
+
+// runs Row over every Count up to BENCH_WIDTH against C, then times full rows
+static void BenchConvert(const char *What,const Bench_Kernels *K,geBitmap_ConvertRow C,geBitmap_ConvertRow Row,
+							const geBitmap_Convert *Convert)
+{
+LARGE_INTEGER Start;
+geBoolean Same;
+int Count,i;
+
+	Same = GE_TRUE;
+	for(Count=0;Count<=BENCH_WIDTH;Count++)
+	{
+		memset(BenchRef,0x5A,sizeof(BenchRef));
+		memset(BenchDst,0x5A,sizeof(BenchDst));
+		C(BenchRef,BenchSrc,Count,Convert);
+		Row(BenchDst,BenchSrc,Count,Convert);
+		if ( memcmp(BenchRef,BenchDst,sizeof(BenchRef)) )
+			Same = GE_FALSE;
+	}
+
+	QueryPerformanceCounter(&Start);
+	for(i=BENCH_LOOPS*BENCH_ROWS;i--;)
+		Row(BenchDst,BenchSrc,BENCH_WIDTH,Convert);
+
+	BenchReport(What,K->Name,BenchSeconds(&Start),Same);
+}
+
+static void BenchDePal(int Bytes,const Bench_Kernels *K,const Bench_Kernels *C)
+{
+LARGE_INTEGER Start;
+geBoolean Same;
+char What[64];
+int Count,i;
+
+	Same = GE_TRUE;
+	for(Count=0;Count<=BENCH_WIDTH;Count++)
+	{
+		memset(BenchRef,0x5A,sizeof(BenchRef));
+		memset(BenchDst,0x5A,sizeof(BenchDst));
+		C->DePal[Bytes](BenchRef,BenchSrc,Count,BenchPal);
+		K->DePal[Bytes](BenchDst,BenchSrc,Count,BenchPal);
+		if ( memcmp(BenchRef,BenchDst,sizeof(BenchRef)) )
+			Same = GE_FALSE;
+	}
+
+	QueryPerformanceCounter(&Start);
+	for(i=BENCH_LOOPS*BENCH_ROWS;i--;)
+		K->DePal[Bytes](BenchDst,BenchSrc,BENCH_WIDTH,BenchPal);
+
+	sprintf(What,"DePal %i",Bytes);
+	BenchReport(What,K->Name,BenchSeconds(&Start),Same);
+}
+
+static void BenchMip(const char *What,const Bench_Kernels *K,geBitmap_MipRow C,geBitmap_MipRow Row,
+						const geBitmap_Mip *Mip)
+{
+LARGE_INTEGER Start;
+geBoolean Same;
+int Count,i;
+
+	Same = GE_TRUE;
+	for(Count=0;Count<=BENCH_WIDTH/2;Count++)
+	{
+		memset(BenchRef,0x5A,sizeof(BenchRef));
+		memset(BenchDst,0x5A,sizeof(BenchDst));
+		C(BenchRef,BenchSrc,BenchSrc+BENCH_WIDTH*4,Count,Mip);
+		Row(BenchDst,BenchSrc,BenchSrc+BENCH_WIDTH*4,Count,Mip);
+		if ( memcmp(BenchRef,BenchDst,sizeof(BenchRef)) )
+			Same = GE_FALSE;
+	}
+
+	QueryPerformanceCounter(&Start);
+	for(i=BENCH_LOOPS*BENCH_ROWS;i--;)
+		Row(BenchDst,BenchSrc,BenchSrc+BENCH_WIDTH*4,BENCH_WIDTH/2,Mip);
+
+	BenchReport(What,K->Name,BenchSeconds(&Start),Same);
+}
+
+void geBitmap_Kernels_Benchmark(void)
+{
+static const gePixelFormat Pairs[][2] =
+{
+	{ GE_PIXELFORMAT_24BIT_RGB,  GE_PIXELFORMAT_32BIT_XRGB },
+	{ GE_PIXELFORMAT_32BIT_XRGB, GE_PIXELFORMAT_24BIT_RGB  },
+	{ GE_PIXELFORMAT_24BIT_BGR,  GE_PIXELFORMAT_24BIT_RGB  },
+	{ GE_PIXELFORMAT_32BIT_RGBA, GE_PIXELFORMAT_32BIT_ARGB },
+	{ GE_PIXELFORMAT_24BIT_RGB,  GE_PIXELFORMAT_32BIT_ARGB },
+	{ GE_PIXELFORMAT_32BIT_ARGB, GE_PIXELFORMAT_16BIT_4444_ARGB },
+	{ GE_PIXELFORMAT_16BIT_4444_ARGB, GE_PIXELFORMAT_32BIT_XRGB },
+};
+static const gePixelFormat MipFormats[] =
+{
+	GE_PIXELFORMAT_16BIT_565_RGB, GE_PIXELFORMAT_16BIT_4444_ARGB, GE_PIXELFORMAT_24BIT_RGB,
+	GE_PIXELFORMAT_32BIT_XRGB, GE_PIXELFORMAT_32BIT_ARGB,
+};
+Bench_Kernels Kernels[3];
+geBitmap_Convert Convert,Rekey;
+geBitmap_Mip Mip;
+int NumKernels,i,k,p,Key;
+char What[64];
+
+	geBitmap_Kernels_Init();
+
+	Kernels[0].Name = "C";
+	Kernels[0].Swizzle = Swizzle_C;
+	Kernels[0].Expand4444 = Expand4444_C;
+	Kernels[0].Pack4444 = Pack4444_C;
+	Kernels[0].Rekey16 = Rekey16_C;
+	Kernels[0].Rekey32 = Rekey32_C;
+	Kernels[0].DePal[1] = DePal1_C;
+	Kernels[0].DePal[2] = DePal2_C;
+	Kernels[0].DePal[3] = DePal3_C;
+	Kernels[0].DePal[4] = DePal4_C;
+	Kernels[0].MipBytes = MipBytes_C;
+	Kernels[0].Mip16 = Mip16_C;
+	NumKernels = 1;
+
+#ifdef GE_HAVE_SSE2
+	if ( CPUInfo_TestForSSE2() )
+	{
+		Kernels[NumKernels] = Kernels[0];
+		Kernels[NumKernels].Name = "SSE2";
+		Kernels[NumKernels].Swizzle = Swizzle_SSE2;
+		Kernels[NumKernels].Expand4444 = Expand4444_SSE2;
+		Kernels[NumKernels].Pack4444 = Pack4444_SSE2;
+		Kernels[NumKernels].Rekey16 = Rekey16_SSE2;
+		Kernels[NumKernels].Rekey32 = Rekey32_SSE2;
+		Kernels[NumKernels].MipBytes = MipBytes_SSE2;
+		Kernels[NumKernels].Mip16 = Mip16_SSE2;
+		NumKernels++;
+	}
+#endif
+
+#ifdef GE_HAVE_AVX2
+	if ( CPUInfo_TestForAVX2() )
+	{
+		Kernels[NumKernels] = Kernels[NumKernels-1];
+		Kernels[NumKernels].Name = "AVX2";
+		Kernels[NumKernels].Swizzle = Swizzle_AVX2;
+		Kernels[NumKernels].Rekey32 = Rekey32_AVX2;
+		Kernels[NumKernels].DePal[2] = DePal2_AVX2;
+		Kernels[NumKernels].DePal[3] = DePal3_AVX2;
+		Kernels[NumKernels].DePal[4] = DePal4_AVX2;
+		Kernels[NumKernels].MipBytes = MipBytes_AVX2;
+		NumKernels++;
+	}
+#endif
+
+	// the low bytes hit the colorkeys below every so often
+	for(i=0;i<(int)sizeof(BenchSrc);i++)
+		BenchSrc[i] = (uint8)((i*167 + (i>>3)*13) & 255);
+	for(i=0;i<256;i++)
+		BenchPal[i] = (uint32)(i*0x01030507 + 0x2468ACE1);
+
+	for(k=0;k<NumKernels;k++)
+	{
+		for(p=0;p<(int)(sizeof(Pairs)/sizeof(Pairs[0]));p++)
+		{
+			for(Key=0;Key<2;Key++)
+			{
+			geBitmap_ConvertRow C;
+
+				if ( ! geBitmap_Kernels_GetConvert(Pairs[p][0],Pairs[p][1],Key,*((uint16 *)BenchSrc),&Convert) )
+					continue;
+
+				if ( Pairs[p][0] == GE_PIXELFORMAT_16BIT_4444_ARGB )
+					{ C = Expand4444_C; Convert.Row = Kernels[k].Expand4444; }
+				else if ( Pairs[p][1] == GE_PIXELFORMAT_16BIT_4444_ARGB )
+					{ C = Pack4444_C; Convert.Row = Kernels[k].Pack4444; }
+				else
+					{ C = Swizzle_C; Convert.Row = Kernels[k].Swizzle; }
+
+				sprintf(What,"%s -> %s%s",gePixelFormat_Description(Pairs[p][0]),gePixelFormat_Description(Pairs[p][1]),Key ? " CK" : "");
+				BenchConvert(What,Kernels+k,C,Convert.Row,&Convert);
+			}
+		}
+
+		for(Key=0;Key<2;Key++)
+		{
+			geBitmap_Kernels_GetRekey(GE_PIXELFORMAT_16BIT_565_RGB,Key,*((uint16 *)(BenchSrc+2)),*((uint16 *)BenchSrc),&Rekey);
+			BenchConvert(Key ? "Rekey 16, swap" : "Rekey 16",Kernels+k,Rekey16_C,Kernels[k].Rekey16,&Rekey);
+			geBitmap_Kernels_GetRekey(GE_PIXELFORMAT_32BIT_XRGB,Key,*((uint32 *)(BenchSrc+4)),*((uint32 *)BenchSrc),&Rekey);
+			BenchConvert(Key ? "Rekey 32, swap" : "Rekey 32",Kernels+k,Rekey32_C,Kernels[k].Rekey32,&Rekey);
+		}
+
+		for(i=1;i<=4;i++)
+			BenchDePal(i,Kernels+k,Kernels);
+
+		for(p=0;p<(int)(sizeof(MipFormats)/sizeof(MipFormats[0]));p++)
+		{
+			geBitmap_Kernels_GetMip(MipFormats[p],&Mip);
+			sprintf(What,"Mip %s",gePixelFormat_Description(MipFormats[p]));
+			if ( Mip.Bytes == 2 )
+				BenchMip(What,Kernels+k,Mip16_C,Kernels[k].Mip16,&Mip);
+			else
+				BenchMip(What,Kernels+k,MipBytes_C,Kernels[k].MipBytes,&Mip);
+		}
+	}
+}
+#endif
+
+/*}{*********************************************************************/
@@ -0,0 +1,103 @@
+/****************************************************************************************/
+/*  Bitmap_Kernels.h                                                                    */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description:  Row converters for the common BlitData and UpdateMips cases           */
+/*					(SSE2/AVX2 when the cpu has them)									*/
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef BITMAP_KERNELS_H
+#define BITMAP_KERNELS_H
+
+#include "basetype.h"
+#include "pixelformat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*}{*********************************************************************/
+
+// Every kernel gives exactly the pixels the GetColor/PutColor (or ComposePixel/PutPixel)
+//	loops it stands in for would.  Count is in pixels of the Dst row.
+
+typedef struct geBitmap_Convert geBitmap_Convert;
+typedef struct geBitmap_Mip		geBitmap_Mip;
+
+typedef void (*geBitmap_ConvertRow)(uint8 *Dst,const uint8 *Src,int Count,const geBitmap_Convert *Convert);
+typedef void (*geBitmap_DePalRow)(uint8 *Dst,const uint8 *Src,int Count,const uint32 *Pal);
+typedef void (*geBitmap_MipRow)(uint8 *Dst,const uint8 *Src1,const uint8 *Src2,int Count,const geBitmap_Mip *Mip);
+
+struct geBitmap_Convert
+{
+	geBitmap_ConvertRow	Row;
+	int			SrcBytes,DstBytes;
+	int			Shuffle[4];		// the Src byte that goes in each Dst byte; -1 for none
+	uint32		Mask;			// the bits the kernel makes ; for the 4444 packer, the Src bits it uses
+	uint32		Fill;			// or'ed in : the alpha of formats that didn't have one
+	uint32		Keep;			// Dst bits that are left alone (the X of the X formats)
+	geBoolean	HasColorKey;	// Dst pixels that come out as ColorKey are ^1'd, like BlitData_Raw does
+	uint32		ColorKey;
+	geBoolean	SrcHasColorKey;	// only for the re-keyers : SrcColorKey and ColorKey trade places
+	uint32		SrcColorKey;
+};
+
+struct geBitmap_Mip
+{
+	geBitmap_MipRow	Row;
+	int			Bytes;
+	uint32		Keep;			// Dst bits that are left alone (the X of the X formats)
+	int			NumFields;		// for the 16 bit formats :
+	int			Shift[4];
+	uint32		FieldMask[4];
+	uint32		Round[4];		// 2, except for the alphas, which GetColor doesn't center
+};
+
+/*}{*********************************************************************/
+
+	// the DePal row for a Dst of Bytes (1-4) per pixel ; Pal has the 256 Dst pixels, in the
+	//	low Bytes of each entry
+geBitmap_DePalRow geBitmap_Kernels_GetDePal(int Bytes);
+
+	// fills out Convert to do (SrcFormat -> DstFormat) the way BlitData_Raw does, with or
+	//	without a Dst ColorKey ; returns GE_FALSE if there's no kernel for it
+geBoolean geBitmap_Kernels_GetConvert(gePixelFormat SrcFormat,gePixelFormat DstFormat,
+								geBoolean DstHasColorKey,uint32 DstColorKey,geBitmap_Convert *Convert);
+
+	// fills out Convert to do the colorkey swaps of BlitData_SameFormat in Format
+geBoolean geBitmap_Kernels_GetRekey(gePixelFormat Format,geBoolean SrcHasColorKey,uint32 SrcColorKey,
+								uint32 DstColorKey,geBitmap_Convert *Convert);
+
+	// fills out Mip to do the 2x2 box filter of UpdateMips_Data in Format (no colorkey)
+geBoolean geBitmap_Kernels_GetMip(gePixelFormat Format,geBitmap_Mip *Mip);
+
+	// points the kernels at the fastest versions the cpu can run ; the Get's do it the
+	//	first time they're called
+void geBitmap_Kernels_Init(void);
+
+#ifdef BITMAP_KERNELS_BENCHMARK
+	// checks every version against the C ones, and times them over texture sized rows
+void geBitmap_Kernels_Benchmark(void);
+#endif
+
+/*}{*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //BITMAP_KERNELS_H
@@ -189,6 +189,21 @@ geFloat GENESISCC geCamera_GetScale(const geCamera *Camera)
 	return Camera->Scale;
 }
 
+//=====================================================================================
+//	geCamera_GetProjection
+//=====================================================================================
+void GENESISCC geCamera_GetProjection(const geCamera *Camera, geFloat *Scale, geFloat *ZScale, 
+										geFloat *XCenter, geFloat *YCenter, geFloat *MinZ)
+{
+	assert( Camera != NULL );
+
+	*Scale = Camera->Scale;
+	*ZScale = Camera->ZScale;
+	*XCenter = Camera->XCenter;
+	*YCenter = Camera->YCenter;
+	*MinZ = CAMERA_MINIMUM_PROJECTION_DISTANCE;
+}
+
 //=====================================================================================
 //	geCamera_SetAttributes
 //=====================================================================================
@@ -49,6 +49,9 @@ GENESISAPI void GENESISCC geCamera_GetFarClipPlane(const geCamera *Camera, geBoo
 GENESISAPI void GENESISCC geCamera_GetClippingRect(const geCamera *Camera, geRect *Rect);
 void GENESISCC geCamera_GetWidthHeight(const geCamera *Camera,geFloat *Width,geFloat *Height);
 geFloat GENESISCC geCamera_GetScale(const geCamera *Camera);
+	// The numbers geCamera_Project/ProjectZ use, for code that projects many points at once
+void GENESISCC geCamera_GetProjection(const geCamera *Camera, geFloat *Scale, geFloat *ZScale, 
+										geFloat *XCenter, geFloat *YCenter, geFloat *MinZ);
 GENESISAPI void GENESISCC geCamera_SetAttributes(geCamera *Camera, geFloat Fov, const geRect *Rect);
 void geCamera_FillDriverInfo(geCamera *Camera);
 GENESISAPI void GENESISCC geCamera_ScreenPointToWorld (	const geCamera	*Camera,
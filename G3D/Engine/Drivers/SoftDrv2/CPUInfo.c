@@ -126,6 +126,89 @@ static uint32	CPUInfo_GetCPUIDEDX(uint32 funcNum)
 }
 
 
+	// funcs 7 and up have sub functions, these always ask for sub function 0
+static uint32	CPUInfo_GetCPUIDECX(uint32 funcNum)
+{
+	uint32	retval;
+
+	Test_CPU_bits();
+	if (Flag_CPUID)
+		{
+			__try
+			{
+				_asm
+				{
+					mov	eax,funcNum
+					xor	ecx,ecx
+					CPUID
+					mov	retval,ecx
+				}
+			}__except(EXCEPTION_EXECUTE_HANDLER)
+			{
+				retval	=0;
+			}
+		}
+	else
+		{
+			retval = 0;
+		}
+	
+	return	retval;
+}
+
+static uint32	CPUInfo_GetCPUIDEBX(uint32 funcNum)
+{
+	uint32	retval;
+
+	Test_CPU_bits();
+	if (Flag_CPUID)
+		{
+			__try
+			{
+				_asm
+				{
+					mov	eax,funcNum
+					xor	ecx,ecx
+					CPUID
+					mov	retval,ebx
+				}
+			}__except(EXCEPTION_EXECUTE_HANDLER)
+			{
+				retval	=0;
+			}
+		}
+	else
+		{
+			retval = 0;
+		}
+	
+	return	retval;
+}
+
+	// low half of XCR0: which register sets the os saves on a task switch
+static uint32	CPUInfo_GetXCR0(void)
+{
+	uint32	retval;
+
+	__try
+	{
+		_asm
+		{
+			xor	ecx,ecx
+			_emit 0fh				// xgetbv
+			_emit 01h
+			_emit 0d0h
+			mov	retval,eax
+		}
+	}__except(EXCEPTION_EXECUTE_HANDLER)
+	{
+		retval	=0;
+	}
+
+	return	retval;
+}
+
+
 static uint32	CPUInfo_GetCPUIDString(uint32 funcNum, char *szId)
 {
 	uint32	retval;
@@ -205,3 +288,35 @@ geBoolean CPUInfo_TestForMMX(void)
 
 	return GE_FALSE;
 }
+
+geBoolean CPUInfo_TestForSSE2(void)
+{
+	if (CPUInfo_GetCPUIDEAX(0) < 1)
+		return GE_FALSE;
+
+	if (CPUInfo_GetCPUIDEDX(0x1) & (1<<26))
+		return GE_TRUE;
+
+	return GE_FALSE;
+}
+
+geBoolean CPUInfo_TestForAVX2(void)
+{
+	uint32	TypeFlags;
+
+	if (CPUInfo_GetCPUIDEAX(0) < 7)
+		return GE_FALSE;
+
+	// the cpu has avx, and the os saves the ymm registers (osxsave, then xcr0 bits 1 and 2)
+	TypeFlags = CPUInfo_GetCPUIDECX(0x1);
+	if ((TypeFlags & ((1<<27)|(1<<28))) != ((1<<27)|(1<<28)))
+		return GE_FALSE;
+
+	if ((CPUInfo_GetXCR0() & 6) != 6)
+		return GE_FALSE;
+
+	if (CPUInfo_GetCPUIDEBX(0x7) & (1<<5))
+		return GE_TRUE;
+
+	return GE_FALSE;
+}
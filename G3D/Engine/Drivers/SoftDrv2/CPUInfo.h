@@ -33,6 +33,8 @@ extern "C" {
 
 geBoolean CPUInfo_TestFor3DNow(void);
 geBoolean CPUInfo_TestForMMX(void);
+geBoolean CPUInfo_TestForSSE2(void);
+geBoolean CPUInfo_TestForAVX2(void);
 
 #ifdef __cplusplus
 }
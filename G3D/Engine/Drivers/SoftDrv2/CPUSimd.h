@@ -0,0 +1,44 @@
+/****************************************************************************************/
+/*  CPUSimd.H                                                                           */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description:  which vector instruction sets the compiler can build kernels for      */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef CPUSimd_H
+#define CPUSimd_H
+
+//  Compilers that know the instructions get GE_HAVE_SSE2 / GE_HAVE_AVX2, and the
+//  intrinsics for them.  Kernels built with them are still only used if the cpu
+//  says it has them (CPUInfo_TestForSSE2 / CPUInfo_TestForAVX2).
+//  VC6, which the .dsp/.mak projects are for, has neither, so it only builds the C
+//  versions.  SSE2 needs VC7 (_MSC_VER 1300) or later, AVX2 needs VC11 (1700) or later.
+
+#include "CPUInfo.h"
+
+#if defined(__SSE2__) || (defined(_MSC_VER) && _MSC_VER >= 1300)
+	#define GE_HAVE_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && _MSC_VER >= 1700)
+	#define GE_HAVE_AVX2
+	#include <immintrin.h>
+#endif
+
+#endif
+
@@ -152,6 +152,10 @@ SOURCE=.\CPUInfo.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\CPUSimd.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\DDRAWDisplay.h
 # End Source File
 # Begin Source File
@@ -44,6 +44,8 @@
 #include "geassert.h"
 
 #include "BitmapList.h"
+#include "WorkPool.h"
+#include "Actor.h"
 //#define SKY_HACK
 //extern BOOL GlobalReset;
 
@@ -316,6 +318,9 @@ void Sys_EngineFree(geEngine *Engine)
 
 	List_Stop();
 
+	geActor_BatchShutdown();
+	WorkPool_Shutdown();
+
 	geRam_Free(Engine);
 }
 
@@ -342,6 +342,14 @@ GENESISAPI geBoolean geWorld_Collision(geWorld *World, const geVec3d *Mins, cons
 	return Trace_GEWorldCollision(World, Mins, Maxs, Front, Back, Contents, CollideFlags, UserFlags, CollisionCB, Context, Col);
 }
 
+//========================================================================================
+//	geWorld_CollisionBatch
+//========================================================================================
+GENESISAPI geBoolean geWorld_CollisionBatch(geWorld *World, GE_CollisionQuery *Queries, int32 NumQueries, int32 NumThreads)
+{
+	return Trace_CollisionBatch(World, Queries, NumQueries, NumThreads);
+}
+
 //========================================================================================
 //	geWorld_GetContents
 //========================================================================================
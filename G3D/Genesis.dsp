@@ -90,6 +90,30 @@ LIB32=link.exe -lib
 # PROP Default_Filter ""
 # Begin Source File
 
+SOURCE=.\World\ActorTree.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\World\ActorTree.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\World\BSPCache.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\World\BSPCache.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\World\LightKernel.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\World\LightKernel.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\World\Fog.c
 # End Source File
 # Begin Source File
@@ -222,6 +246,14 @@ SOURCE=.\Engine\Logo\WebUrl.c
 # End Group
 # Begin Source File
 
+SOURCE=.\Engine\Drivers\SoftDrv2\CPUInfo.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\Engine\Drivers\SoftDrv2\CPUSimd.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Engine\BitmapList.c
 # End Source File
 # Begin Source File
@@ -476,6 +508,14 @@ SOURCE=.\Support\Ram.h
 
 SOURCE=.\Support\ramdll.c
 # End Source File
+# Begin Source File
+
+SOURCE=.\Support\WorkPool.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\Support\WorkPool.h
+# End Source File
 # End Group
 # Begin Group "Physics"
 
@@ -650,6 +690,14 @@ SOURCE=.\Bitmap\bitmap_gamma.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Bitmap\bitmap_kernels.c
+# End Source File
+# Begin Source File
+
+SOURCE=.\Bitmap\bitmap_kernels.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Bitmap\pixelformat.c
 # End Source File
 # Begin Source File
@@ -52,6 +52,7 @@ typedef struct		geActor				geActor;
 typedef struct		geActor_Def			geActor_Def;		// the definition of an actor's geometry/bone structure
 
 typedef struct		geWorld				geWorld;
+typedef struct		geWorld_Loader		geWorld_Loader;
 
 typedef struct		geWorld_Model		geWorld_Model;
 
@@ -200,6 +201,23 @@ typedef struct
 	GE_Plane		Plane;							// Impact Plane
 } GE_Collision;
 
+// One test for geWorld_CollisionBatch (same as the geWorld_Collision arguments)
+typedef struct
+{
+	const geVec3d	*Mins;							// Mins of object (in object-space).  This CAN be NULL
+	const geVec3d	*Maxs;							// Maxs of object (in object-space).  This CAN be NULL
+	geVec3d			Front;							// Front of line (in world-space)
+	geVec3d			Back;							// Back of line (in world-space)
+	uint32			Contents;						// Contents to collide with
+	uint32			CollideFlags;					// GE_COLLIDE_ALL, etc...
+	uint32			UserFlags;						// To mask out actors
+	GE_CollisionCB	*CollisionCB;					// Gets called from other threads!!!
+	void			*Context;
+
+	geBoolean		Hit;							// Filled in with what geWorld_Collision would return
+	GE_Collision	Col;							// Filled in if Hit
+} GE_CollisionQuery;
+
 // If these render states change, they must change in DCommon.h too!!!
 // These are still under construction, and are for debug purposes only.
 // They are merely means of overriding ways the engine normally renders primitives, etc...
@@ -397,6 +415,19 @@ GENESISAPI void *geSound_GetDSound(void);
 GENESISAPI geWorld		*geWorld_Create(geVFile *File);
 GENESISAPI void			geWorld_Free(geWorld *World);
 
+// Like geWorld_Create, but loads out of Cache (a baked copy of File) when it's up to date.  When
+// it isn't, File is loaded as usual and baked into Cache, so Cache should be opened for update.
+GENESISAPI geWorld		*geWorld_CreateCached(geVFile *File, geVFile *Cache);
+
+// Loads a world on other threads, so the caller can keep going.  Poll and Finish have to be called
+// from the thread that created the loader, and they log whatever failed on the other threads.
+// File must stay open, and not be touched, until Finish.  Neither can any other file opened out of
+// the same VFS or parent file be read till then: files that aren't mapped share the parent's file
+// position, so a read from any of them moves File out from under the loader.
+GENESISAPI geWorld_Loader	*geWorld_CreateAsync(geVFile *File);
+GENESISAPI geBoolean	geWorld_LoaderPoll(geWorld_Loader *Loader);		// GE_TRUE once Finish won't have to wait
+GENESISAPI geWorld		*geWorld_LoaderFinish(geWorld_Loader *Loader);	// Waits, and frees the loader.  NULL if the load failed.
+
 // World Actors
 GENESISAPI geBoolean	geWorld_RemoveActor    (geWorld *World, geActor *Actor);
 GENESISAPI geBoolean    geWorld_AddActor       (geWorld *World, geActor *Actor, uint32 Flags, uint32 UserFlags);
@@ -485,6 +516,13 @@ GENESISAPI geBoolean geWorld_Collision(	geWorld *World,				// World to collide w
 										GE_Collision *Col);			// Structure filled with info about what was collided with
 	// NOTE - Mins/Maxs CAN be NULL.  If you are just testing a point, then use NULL (it's faster!!!).
 
+GENESISAPI geBoolean geWorld_CollisionBatch(geWorld *World,		// World to collide with
+										GE_CollisionQuery *Queries,	// Tests to run, results are filled in
+										int32 NumQueries,
+										int32 NumThreads);			// 0 = one per cpu
+	// NOTE - Runs the tests at the same time on several threads.  Don't change the world, or
+	//	move actors/models until it returns.  The CollisionCB's must be safe to call from any thread.
+
 GENESISAPI geBoolean geWorld_GetContents(geWorld *World, const geVec3d *Pos, const geVec3d *Mins, const geVec3d *Maxs, uint32 Flags, uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context, GE_Contents *Contents);
 // changed texture name
 GENESISAPI geBoolean geWorld_GetTextureName(geWorld *World, const geVec3d *Pos, const geVec3d *Mins, const geVec3d *Maxs, char *TexName);
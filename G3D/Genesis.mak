@@ -43,15 +43,19 @@ CLEAN :
 	-@erase "$(INTDIR)\A_CORONA.obj"
 	-@erase "$(INTDIR)\A_STREAK.obj"
 	-@erase "$(INTDIR)\actor.obj"
+	-@erase "$(INTDIR)\ActorTree.obj"
+	-@erase "$(INTDIR)\BSPCache.obj"
 	-@erase "$(INTDIR)\bitmap.obj"
 	-@erase "$(INTDIR)\bitmap_blitdata.obj"
 	-@erase "$(INTDIR)\bitmap_gamma.obj"
+	-@erase "$(INTDIR)\bitmap_kernels.obj"
 	-@erase "$(INTDIR)\BitmapList.obj"
 	-@erase "$(INTDIR)\body.obj"
 	-@erase "$(INTDIR)\bodyinst.obj"
 	-@erase "$(INTDIR)\Box.obj"
 	-@erase "$(INTDIR)\Camera.obj"
 	-@erase "$(INTDIR)\CORONA.obj"
+	-@erase "$(INTDIR)\CPUInfo.obj"
 	-@erase "$(INTDIR)\crc32.obj"
 	-@erase "$(INTDIR)\CSNetMgr.obj"
 	-@erase "$(INTDIR)\dirtree.obj"
@@ -73,6 +77,7 @@ CLEAN :
 	-@erase "$(INTDIR)\genesis.idb"
 	-@erase "$(INTDIR)\genesis.res"
 	-@erase "$(INTDIR)\Light.obj"
+	-@erase "$(INTDIR)\LightKernel.obj"
 	-@erase "$(INTDIR)\list.obj"
 	-@erase "$(INTDIR)\log.obj"
 	-@erase "$(INTDIR)\logo.obj"
@@ -116,6 +121,7 @@ CLEAN :
 	-@erase "$(INTDIR)\WBitmap.obj"
 	-@erase "$(INTDIR)\WebUrl.obj"
 	-@erase "$(INTDIR)\wgClip.obj"
+	-@erase "$(INTDIR)\WorkPool.obj"
 	-@erase "$(INTDIR)\World.obj"
 	-@erase "$(INTDIR)\XFArray.obj"
 	-@erase "$(INTDIR)\Xform3d.obj"
@@ -134,6 +140,9 @@ BSC32_SBRS= \
 LIB32=link.exe -lib
 LIB32_FLAGS=/nologo /out:"$(OUTDIR)\Genesis.lib" 
 LIB32_OBJS= \
+	"$(INTDIR)\ActorTree.obj" \
+	"$(INTDIR)\BSPCache.obj" \
+	"$(INTDIR)\LightKernel.obj" \
 	"$(INTDIR)\Fog.obj" \
 	"$(INTDIR)\Frustum.obj" \
 	"$(INTDIR)\Gbspfile.obj" \
@@ -153,6 +162,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\LogoActor.obj" \
 	"$(INTDIR)\streak.obj" \
 	"$(INTDIR)\WebUrl.obj" \
+	"$(INTDIR)\CPUInfo.obj" \
 	"$(INTDIR)\BitmapList.obj" \
 	"$(INTDIR)\engine.obj" \
 	"$(INTDIR)\fontbmp.obj" \
@@ -183,6 +193,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\mempool.obj" \
 	"$(INTDIR)\Ram.obj" \
 	"$(INTDIR)\ramdll.obj" \
+	"$(INTDIR)\WorkPool.obj" \
 	"$(INTDIR)\matrix33.obj" \
 	"$(INTDIR)\PhysicsJoint.obj" \
 	"$(INTDIR)\PhysicsObject.obj" \
@@ -199,6 +210,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\bitmap.obj" \
 	"$(INTDIR)\bitmap_blitdata.obj" \
 	"$(INTDIR)\bitmap_gamma.obj" \
+	"$(INTDIR)\bitmap_kernels.obj" \
 	"$(INTDIR)\pixelformat.obj" \
 	"$(INTDIR)\font.obj" \
 	"$(INTDIR)\wgClip.obj" \
@@ -235,15 +247,19 @@ CLEAN :
 	-@erase "$(INTDIR)\A_CORONA.obj"
 	-@erase "$(INTDIR)\A_STREAK.obj"
 	-@erase "$(INTDIR)\actor.obj"
+	-@erase "$(INTDIR)\ActorTree.obj"
+	-@erase "$(INTDIR)\BSPCache.obj"
 	-@erase "$(INTDIR)\bitmap.obj"
 	-@erase "$(INTDIR)\bitmap_blitdata.obj"
 	-@erase "$(INTDIR)\bitmap_gamma.obj"
+	-@erase "$(INTDIR)\bitmap_kernels.obj"
 	-@erase "$(INTDIR)\BitmapList.obj"
 	-@erase "$(INTDIR)\body.obj"
 	-@erase "$(INTDIR)\bodyinst.obj"
 	-@erase "$(INTDIR)\Box.obj"
 	-@erase "$(INTDIR)\Camera.obj"
 	-@erase "$(INTDIR)\CORONA.obj"
+	-@erase "$(INTDIR)\CPUInfo.obj"
 	-@erase "$(INTDIR)\crc32.obj"
 	-@erase "$(INTDIR)\CSNetMgr.obj"
 	-@erase "$(INTDIR)\dirtree.obj"
@@ -266,6 +282,7 @@ CLEAN :
 	-@erase "$(INTDIR)\genesis.pdb"
 	-@erase "$(INTDIR)\genesis.res"
 	-@erase "$(INTDIR)\Light.obj"
+	-@erase "$(INTDIR)\LightKernel.obj"
 	-@erase "$(INTDIR)\list.obj"
 	-@erase "$(INTDIR)\log.obj"
 	-@erase "$(INTDIR)\logo.obj"
@@ -309,6 +326,7 @@ CLEAN :
 	-@erase "$(INTDIR)\WBitmap.obj"
 	-@erase "$(INTDIR)\WebUrl.obj"
 	-@erase "$(INTDIR)\wgClip.obj"
+	-@erase "$(INTDIR)\WorkPool.obj"
 	-@erase "$(INTDIR)\World.obj"
 	-@erase "$(INTDIR)\XFArray.obj"
 	-@erase "$(INTDIR)\Xform3d.obj"
@@ -327,6 +345,9 @@ BSC32_SBRS= \
 LIB32=link.exe -lib
 LIB32_FLAGS=/nologo /out:"$(OUTDIR)\Genesis.lib" 
 LIB32_OBJS= \
+	"$(INTDIR)\ActorTree.obj" \
+	"$(INTDIR)\BSPCache.obj" \
+	"$(INTDIR)\LightKernel.obj" \
 	"$(INTDIR)\Fog.obj" \
 	"$(INTDIR)\Frustum.obj" \
 	"$(INTDIR)\Gbspfile.obj" \
@@ -346,6 +367,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\LogoActor.obj" \
 	"$(INTDIR)\streak.obj" \
 	"$(INTDIR)\WebUrl.obj" \
+	"$(INTDIR)\CPUInfo.obj" \
 	"$(INTDIR)\BitmapList.obj" \
 	"$(INTDIR)\engine.obj" \
 	"$(INTDIR)\fontbmp.obj" \
@@ -376,6 +398,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\mempool.obj" \
 	"$(INTDIR)\Ram.obj" \
 	"$(INTDIR)\ramdll.obj" \
+	"$(INTDIR)\WorkPool.obj" \
 	"$(INTDIR)\matrix33.obj" \
 	"$(INTDIR)\PhysicsJoint.obj" \
 	"$(INTDIR)\PhysicsObject.obj" \
@@ -392,6 +415,7 @@ LIB32_OBJS= \
 	"$(INTDIR)\bitmap.obj" \
 	"$(INTDIR)\bitmap_blitdata.obj" \
 	"$(INTDIR)\bitmap_gamma.obj" \
+	"$(INTDIR)\bitmap_kernels.obj" \
 	"$(INTDIR)\pixelformat.obj" \
 	"$(INTDIR)\font.obj" \
 	"$(INTDIR)\wgClip.obj" \
@@ -456,6 +480,24 @@ LIB32_OBJS= \
 
 
 !IF "$(CFG)" == "Genesis - Win32 Release" || "$(CFG)" == "Genesis - Win32 Debug"
+SOURCE=.\World\ActorTree.c
+
+"$(INTDIR)\ActorTree.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
+SOURCE=.\World\BSPCache.c
+
+"$(INTDIR)\BSPCache.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
+SOURCE=.\World\LightKernel.c
+
+"$(INTDIR)\LightKernel.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\World\Fog.c
 
 "$(INTDIR)\Fog.obj" : $(SOURCE) "$(INTDIR)"
@@ -570,6 +612,12 @@ SOURCE=.\Engine\Logo\WebUrl.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\Engine\Drivers\SoftDrv2\CPUInfo.c
+
+"$(INTDIR)\CPUInfo.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\Engine\BitmapList.c
 
 "$(INTDIR)\BitmapList.obj" : $(SOURCE) "$(INTDIR)"
@@ -750,6 +798,12 @@ SOURCE=.\Support\ramdll.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\Support\WorkPool.c
+
+"$(INTDIR)\WorkPool.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\Physics\matrix33.c
 
 "$(INTDIR)\matrix33.obj" : $(SOURCE) "$(INTDIR)"
@@ -846,6 +900,12 @@ SOURCE=.\Bitmap\bitmap_gamma.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\Bitmap\bitmap_kernels.c
+
+"$(INTDIR)\bitmap_kernels.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\Bitmap\pixelformat.c
 
 "$(INTDIR)\pixelformat.obj" : $(SOURCE) "$(INTDIR)"
@@ -44,15 +44,19 @@ CLEAN :
 	-@erase "$(INTDIR)\A_CORONA.obj"
 	-@erase "$(INTDIR)\A_STREAK.obj"
 	-@erase "$(INTDIR)\actor.obj"
+	-@erase "$(INTDIR)\ActorTree.obj"
+	-@erase "$(INTDIR)\BSPCache.obj"
 	-@erase "$(INTDIR)\bitmap.obj"
 	-@erase "$(INTDIR)\bitmap_blitdata.obj"
 	-@erase "$(INTDIR)\bitmap_gamma.obj"
+	-@erase "$(INTDIR)\bitmap_kernels.obj"
 	-@erase "$(INTDIR)\BitmapList.obj"
 	-@erase "$(INTDIR)\body.obj"
 	-@erase "$(INTDIR)\bodyinst.obj"
 	-@erase "$(INTDIR)\Box.obj"
 	-@erase "$(INTDIR)\Camera.obj"
 	-@erase "$(INTDIR)\CORONA.obj"
+	-@erase "$(INTDIR)\CPUInfo.obj"
 	-@erase "$(INTDIR)\crc32.obj"
 	-@erase "$(INTDIR)\CSNetMgr.obj"
 	-@erase "$(INTDIR)\dirtree.obj"
@@ -73,6 +77,7 @@ CLEAN :
 	-@erase "$(INTDIR)\geAssert.obj"
 	-@erase "$(INTDIR)\genesis.res"
 	-@erase "$(INTDIR)\Light.obj"
+	-@erase "$(INTDIR)\LightKernel.obj"
 	-@erase "$(INTDIR)\list.obj"
 	-@erase "$(INTDIR)\log.obj"
 	-@erase "$(INTDIR)\logo.obj"
@@ -117,6 +122,7 @@ CLEAN :
 	-@erase "$(INTDIR)\WBitmap.obj"
 	-@erase "$(INTDIR)\WebUrl.obj"
 	-@erase "$(INTDIR)\wgClip.obj"
+	-@erase "$(INTDIR)\WorkPool.obj"
 	-@erase "$(INTDIR)\World.obj"
 	-@erase "$(INTDIR)\XFArray.obj"
 	-@erase "$(INTDIR)\Xform3d.obj"
@@ -159,6 +165,7 @@ LINK32_OBJS= \
 	"$(INTDIR)\bitmap.obj" \
 	"$(INTDIR)\bitmap_blitdata.obj" \
 	"$(INTDIR)\bitmap_gamma.obj" \
+	"$(INTDIR)\bitmap_kernels.obj" \
 	"$(INTDIR)\pixelformat.obj" \
 	"$(INTDIR)\A_CORONA.obj" \
 	"$(INTDIR)\A_STREAK.obj" \
@@ -167,6 +174,7 @@ LINK32_OBJS= \
 	"$(INTDIR)\logo.obj" \
 	"$(INTDIR)\LogoActor.obj" \
 	"$(INTDIR)\streak.obj" \
+	"$(INTDIR)\CPUInfo.obj" \
 	"$(INTDIR)\BitmapList.obj" \
 	"$(INTDIR)\engine.obj" \
 	"$(INTDIR)\fontbmp.obj" \
@@ -184,11 +192,15 @@ LINK32_OBJS= \
 	"$(INTDIR)\mempool.obj" \
 	"$(INTDIR)\Ram.obj" \
 	"$(INTDIR)\ramdll.obj" \
+	"$(INTDIR)\WorkPool.obj" \
 	"$(INTDIR)\dirtree.obj" \
 	"$(INTDIR)\fsdos.obj" \
 	"$(INTDIR)\Fsmemory.obj" \
 	"$(INTDIR)\fsvfs.obj" \
 	"$(INTDIR)\vfile.obj" \
+	"$(INTDIR)\ActorTree.obj" \
+	"$(INTDIR)\BSPCache.obj" \
+	"$(INTDIR)\LightKernel.obj" \
 	"$(INTDIR)\Fog.obj" \
 	"$(INTDIR)\Frustum.obj" \
 	"$(INTDIR)\Gbspfile.obj" \
@@ -252,15 +264,19 @@ CLEAN :
 	-@erase "$(INTDIR)\A_CORONA.obj"
 	-@erase "$(INTDIR)\A_STREAK.obj"
 	-@erase "$(INTDIR)\actor.obj"
+	-@erase "$(INTDIR)\ActorTree.obj"
+	-@erase "$(INTDIR)\BSPCache.obj"
 	-@erase "$(INTDIR)\bitmap.obj"
 	-@erase "$(INTDIR)\bitmap_blitdata.obj"
 	-@erase "$(INTDIR)\bitmap_gamma.obj"
+	-@erase "$(INTDIR)\bitmap_kernels.obj"
 	-@erase "$(INTDIR)\BitmapList.obj"
 	-@erase "$(INTDIR)\body.obj"
 	-@erase "$(INTDIR)\bodyinst.obj"
 	-@erase "$(INTDIR)\Box.obj"
 	-@erase "$(INTDIR)\Camera.obj"
 	-@erase "$(INTDIR)\CORONA.obj"
+	-@erase "$(INTDIR)\CPUInfo.obj"
 	-@erase "$(INTDIR)\crc32.obj"
 	-@erase "$(INTDIR)\CSNetMgr.obj"
 	-@erase "$(INTDIR)\dirtree.obj"
@@ -281,6 +297,7 @@ CLEAN :
 	-@erase "$(INTDIR)\geAssert.obj"
 	-@erase "$(INTDIR)\genesis.res"
 	-@erase "$(INTDIR)\Light.obj"
+	-@erase "$(INTDIR)\LightKernel.obj"
 	-@erase "$(INTDIR)\list.obj"
 	-@erase "$(INTDIR)\log.obj"
 	-@erase "$(INTDIR)\logo.obj"
@@ -326,6 +343,7 @@ CLEAN :
 	-@erase "$(INTDIR)\WBitmap.obj"
 	-@erase "$(INTDIR)\WebUrl.obj"
 	-@erase "$(INTDIR)\wgClip.obj"
+	-@erase "$(INTDIR)\WorkPool.obj"
 	-@erase "$(INTDIR)\World.obj"
 	-@erase "$(INTDIR)\XFArray.obj"
 	-@erase "$(INTDIR)\Xform3d.obj"
@@ -370,6 +388,7 @@ LINK32_OBJS= \
 	"$(INTDIR)\bitmap.obj" \
 	"$(INTDIR)\bitmap_blitdata.obj" \
 	"$(INTDIR)\bitmap_gamma.obj" \
+	"$(INTDIR)\bitmap_kernels.obj" \
 	"$(INTDIR)\pixelformat.obj" \
 	"$(INTDIR)\A_CORONA.obj" \
 	"$(INTDIR)\A_STREAK.obj" \
@@ -378,6 +397,7 @@ LINK32_OBJS= \
 	"$(INTDIR)\logo.obj" \
 	"$(INTDIR)\LogoActor.obj" \
 	"$(INTDIR)\streak.obj" \
+	"$(INTDIR)\CPUInfo.obj" \
 	"$(INTDIR)\BitmapList.obj" \
 	"$(INTDIR)\engine.obj" \
 	"$(INTDIR)\fontbmp.obj" \
@@ -395,11 +415,15 @@ LINK32_OBJS= \
 	"$(INTDIR)\mempool.obj" \
 	"$(INTDIR)\Ram.obj" \
 	"$(INTDIR)\ramdll.obj" \
+	"$(INTDIR)\WorkPool.obj" \
 	"$(INTDIR)\dirtree.obj" \
 	"$(INTDIR)\fsdos.obj" \
 	"$(INTDIR)\Fsmemory.obj" \
 	"$(INTDIR)\fsvfs.obj" \
 	"$(INTDIR)\vfile.obj" \
+	"$(INTDIR)\ActorTree.obj" \
+	"$(INTDIR)\BSPCache.obj" \
+	"$(INTDIR)\LightKernel.obj" \
 	"$(INTDIR)\Fog.obj" \
 	"$(INTDIR)\Frustum.obj" \
 	"$(INTDIR)\Gbspfile.obj" \
@@ -611,6 +635,12 @@ SOURCE=.\Bitmap\bitmap_gamma.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\Bitmap\bitmap_kernels.c
+
+"$(INTDIR)\bitmap_kernels.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\Bitmap\pixelformat.c
 
 "$(INTDIR)\pixelformat.obj" : $(SOURCE) "$(INTDIR)"
@@ -665,6 +695,12 @@ SOURCE=.\Engine\Logo\WebUrl.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\Engine\Drivers\SoftDrv2\CPUInfo.c
+
+"$(INTDIR)\CPUInfo.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\Engine\BitmapList.c
 
 "$(INTDIR)\BitmapList.obj" : $(SOURCE) "$(INTDIR)"
@@ -767,6 +803,12 @@ SOURCE=.\Support\ramdll.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\Support\WorkPool.c
+
+"$(INTDIR)\WorkPool.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\VFile\dirtree.c
 
 "$(INTDIR)\dirtree.obj" : $(SOURCE) "$(INTDIR)"
@@ -797,6 +839,24 @@ SOURCE=.\VFile\vfile.c
 	$(CPP) $(CPP_PROJ) $(SOURCE)
 
 
+SOURCE=.\World\ActorTree.c
+
+"$(INTDIR)\ActorTree.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
+SOURCE=.\World\BSPCache.c
+
+"$(INTDIR)\BSPCache.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
+SOURCE=.\World\LightKernel.c
+
+"$(INTDIR)\LightKernel.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\World\Fog.c
 
 "$(INTDIR)\Fog.obj" : $(SOURCE) "$(INTDIR)"
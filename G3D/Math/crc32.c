@@ -117,10 +117,13 @@ return(crc);
 
 uint32 CRC32_Array(const uint8 * buf,uint32 buflen)
 {
-uint32 crc = (~((uint32)0));
-
 	if (!buf ) return 0;
 
+return CRC32_Finish(CRC32_AddArray(CRC32_Start(),buf,buflen));
+}
+
+uint32 CRC32_AddArray(uint32 crc,const uint8 * buf,uint32 buflen)
+{
 	while( (buflen&0xF) != 0 )
 	{
 		STEPCRC(crc,*buf); buf++;
@@ -152,8 +155,6 @@ uint32 crc = (~((uint32)0));
 		STEPCRC(crc,*buf); buf++;
 	}
 
-	crc ^= 0xFFFFFFFF;
-
 return crc;
 }
 
@@ -36,6 +36,7 @@ extern uint32 CRC32_Finish(uint32 crc);
 extern uint32 CRC32_AddByte(uint32 crc,uint8 b);
 extern uint32 CRC32_AddWord(uint32 crc,uint16 w);
 extern uint32 CRC32_AddLong(uint32 crc,uint32 w);
+extern uint32 CRC32_AddArray(uint32 crc,const uint8 * buf,uint32 buflen);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,228 @@
+/****************************************************************************************/
+/*  WorkPool.c                                                                          */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Worker threads kept around for the batched engine calls                */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Assert.h>
+#include <String.h>
+
+#include "WorkPool.h"
+
+//
+//	The batched calls (geWorld_CollisionBatch, geActor_RenderPrepBatch, ...) run every frame,
+//	so their threads are made once and kept.  Each worker sleeps on its own Start event, runs
+//	the current work when it's set, and then sets its Done event.
+//
+
+//=====================================================================================
+//	Defines / Structure defines
+//=====================================================================================
+#if (WORKPOOL_MAX_THREADS-1 > MAXIMUM_WAIT_OBJECTS)
+#error WORKPOOL_MAX_THREADS has too many workers to wait on
+#endif
+
+typedef struct
+{
+	HANDLE			Thread;
+	HANDLE			Start;					// Auto reset, set by WorkPool_Run
+	HANDLE			Done;					// Auto reset, set by the worker when the work returns
+} WorkPool_Worker;
+
+//=====================================================================================
+//	Local Static Globals
+//=====================================================================================
+static WorkPool_Worker		Workers[WORKPOOL_MAX_THREADS-1];
+static int32				NumWorkers;
+
+static WorkPool_WorkFunc	*CurrentWork;
+static void					*CurrentContext;
+
+static volatile LONG		Busy;					// 1 while a WorkPool_Run has the workers
+static volatile LONG		Quit;					// Set by WorkPool_Shutdown
+
+//=====================================================================================
+//	WorkPool_Thread
+//=====================================================================================
+static DWORD WINAPI WorkPool_Thread(LPVOID Param)
+{
+	WorkPool_Worker		*Worker;
+
+	Worker = (WorkPool_Worker*)Param;
+
+	while (1)
+	{
+		WaitForSingleObject(Worker->Start, INFINITE);
+
+		if (Quit)
+			break;
+
+		CurrentWork(CurrentContext);
+
+		SetEvent(Worker->Done);
+	}
+
+	return 0;
+}
+
+//=====================================================================================
+//	WorkPool_AddWorker
+//=====================================================================================
+static geBoolean WorkPool_AddWorker(void)
+{
+	WorkPool_Worker		*Worker;
+	DWORD				ThreadID;
+
+	assert(NumWorkers < WORKPOOL_MAX_THREADS-1);
+
+	Worker = &Workers[NumWorkers];
+
+	Worker->Start = CreateEvent(NULL, FALSE, FALSE, NULL);
+	Worker->Done = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	if (!Worker->Start || !Worker->Done)
+		goto ExitWithError;
+
+	Worker->Thread = CreateThread(NULL, 0, WorkPool_Thread, Worker, 0, &ThreadID);
+
+	if (!Worker->Thread)
+		goto ExitWithError;
+
+	NumWorkers++;
+
+	return GE_TRUE;
+
+	ExitWithError:
+	{
+		if (Worker->Start)
+			CloseHandle(Worker->Start);
+		if (Worker->Done)
+			CloseHandle(Worker->Done);
+
+		memset(Worker, 0, sizeof(WorkPool_Worker));
+
+		return GE_FALSE;
+	}
+}
+
+//=====================================================================================
+//	WorkPool_NumThreads
+//=====================================================================================
+int32 WorkPool_NumThreads(int32 Requested, int32 NumItems, int32 ItemsPerThread)
+{
+	SYSTEM_INFO		Info;
+	int32			NumThreads;
+
+	assert(ItemsPerThread > 0);
+
+	NumThreads = Requested;
+
+	if (NumThreads <= 0)
+	{
+		GetSystemInfo(&Info);
+		NumThreads = (int32)Info.dwNumberOfProcessors;
+	}
+
+	if (NumThreads > NumItems / ItemsPerThread)
+		NumThreads = NumItems / ItemsPerThread;
+	if (NumThreads > WORKPOOL_MAX_THREADS)
+		NumThreads = WORKPOOL_MAX_THREADS;
+	if (NumThreads < 1)
+		NumThreads = 1;
+
+	return NumThreads;
+}
+
+//=====================================================================================
+//	WorkPool_Run
+//=====================================================================================
+void WorkPool_Run(WorkPool_WorkFunc *Work, void *Context, int32 NumThreads)
+{
+	HANDLE		Done[WORKPOOL_MAX_THREADS-1];
+	int32		i, NumStarted;
+
+	assert(Work != NULL);
+
+	if (NumThreads > WORKPOOL_MAX_THREADS)
+		NumThreads = WORKPOOL_MAX_THREADS;
+
+	if (NumThreads <= 1 || InterlockedExchange((LONG *)&Busy, 1))
+	{
+		Work(Context);
+		return;
+	}
+
+	while (NumWorkers < NumThreads-1)
+	{
+		if (!WorkPool_AddWorker())
+			break;				// The ones we have will get it done
+	}
+
+	CurrentWork = Work;
+	CurrentContext = Context;
+
+	// This thread works too, so start one less
+	NumStarted = NumThreads-1;
+
+	if (NumStarted > NumWorkers)
+		NumStarted = NumWorkers;
+
+	for (i=0; i< NumStarted; i++)
+	{
+		Done[i] = Workers[i].Done;
+		SetEvent(Workers[i].Start);
+	}
+
+	Work(Context);
+
+	if (NumStarted)
+		WaitForMultipleObjects(NumStarted, Done, TRUE, INFINITE);
+
+	CurrentWork = NULL;
+	CurrentContext = NULL;
+
+	InterlockedExchange((LONG *)&Busy, 0);
+}
+
+//=====================================================================================
+//	WorkPool_Shutdown
+//=====================================================================================
+void WorkPool_Shutdown(void)
+{
+	int32		i;
+
+	assert(!Busy);
+
+	Quit = 1;
+
+	for (i=0; i< NumWorkers; i++)
+	{
+		SetEvent(Workers[i].Start);
+		WaitForSingleObject(Workers[i].Thread, INFINITE);
+
+		CloseHandle(Workers[i].Thread);
+		CloseHandle(Workers[i].Start);
+		CloseHandle(Workers[i].Done);
+	}
+
+	memset(Workers, 0, sizeof(Workers));
+	NumWorkers = 0;
+
+	Quit = 0;
+}
@@ -0,0 +1,62 @@
+/****************************************************************************************/
+/*  WorkPool.h                                                                          */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Worker threads kept around for the batched engine calls                */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef GE_WORKPOOL_H
+#define GE_WORKPOOL_H
+
+#include "BaseType.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Defines / Structure defines
+//=====================================================================================
+#define WORKPOOL_MAX_THREADS		64			// Counting the caller.  MAXIMUM_WAIT_OBJECTS, so the workers can be waited on at once
+
+// Called on each thread of a WorkPool_Run.  Any one call can end up with all of the work,
+// so it should take items off a shared counter until there are none left.
+typedef void WorkPool_WorkFunc(void *Context);
+
+//=====================================================================================
+//	Function ProtoTypes
+//=====================================================================================
+
+// How many threads (counting the caller) to split NumItems over.  Requested <= 0 asks for one
+// per processor.  Never more than one per ItemsPerThread items, or WORKPOOL_MAX_THREADS, and
+// never less than 1.
+int32		WorkPool_NumThreads(int32 Requested, int32 NumItems, int32 ItemsPerThread);
+
+// Calls Work(Context) on NumThreads threads at once (this one, and NumThreads-1 of the pool's
+// workers), and returns when they have all returned.  The workers are started the first time
+// they're needed, and then wait for the next run.  If the workers are already busy (another
+// thread is running a batch, or Work runs one itself), Work just runs on this thread.
+void		WorkPool_Run(WorkPool_WorkFunc *Work, void *Context, int32 NumThreads);
+
+// Stops the workers.  Must not be called during a WorkPool_Run.  The next run starts them again.
+void		WorkPool_Shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,6 +32,9 @@
 #include	"dirtree-common.h"
 
 #define	DIRTREE_FILE_SIGNATURE	MAKEFOURCC('D', 'T', '0', '1')
+
+// Directories with at least this many entries get their children hashed on their names
+#define	DIRTREE_HASH_MIN_CHILDREN	16
 static int DirTree_SignatureBase=0x696C6345;
 static int DirTree_SignatureOffset=0x21657370;
 
@@ -46,6 +49,12 @@ typedef struct	DirTree
 	struct DirTree *	Parent;
 	struct DirTree *	Children;
 	struct DirTree *	Siblings;
+
+	int					ChildCount;
+	struct DirTree **	ChildHash;			// Children by name (case insensitive), NULL if not hashed
+	unsigned int		ChildHashSize;		// Power of 2
+	unsigned int		NameHash;
+	struct DirTree *	HashNext;			// Next in our parents ChildHash bucket
 }	DirTree;
 
 typedef struct	DirTree_Finder
@@ -55,6 +64,161 @@ typedef struct	DirTree_Finder
 	DirTree *	Current;
 }	DirTree_Finder;
 
+#ifdef	DIRTREE_BENCHMARK
+static	geBoolean	BenchNoHash = GE_FALSE;
+#endif
+
+//	Hash of the first Length characters of Name, folded to lower case the way stricmp does
+static	unsigned int	HashName(const char *Name, int Length)
+{
+	unsigned int	Hash;
+	int				i;
+
+	Hash = 2166136261u;
+	for	(i=0; i<Length; i++)
+	{
+		unsigned int	c;
+
+		c = (unsigned char)Name[i];
+		if	(c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		Hash = (Hash ^ c) * 16777619u;
+	}
+
+	return Hash;
+}
+
+//	Each bucket keeps its entries in sibling order, so when two names only differ in case
+//	FindChild gets the same one walking the children would.  New children go at the front
+//	of the siblings, so they go at the front of their bucket.
+static	void	HashInsert(DirTree **Buckets, unsigned int Size, DirTree *Child)
+{
+	DirTree **	Bucket;
+
+	Bucket = &Buckets[Child->NameHash & (Size - 1)];
+	Child->HashNext = *Bucket;
+	*Bucket = Child;
+}
+
+static	void	HashAppend(DirTree **Buckets, unsigned int Size, DirTree *Child)
+{
+	DirTree **	pLink;
+
+	pLink = &Buckets[Child->NameHash & (Size - 1)];
+	while	(*pLink)
+		pLink = &(*pLink)->HashNext;
+
+	Child->HashNext = NULL;
+	*pLink = Child;
+}
+
+//	(Re)builds the name hash of Tree's children, sized for ChildCount.  Failing to get
+//	the memory isn't an error: lookups just walk the children.
+static	void	HashChildren(DirTree *Tree)
+{
+	DirTree **		Buckets;
+	unsigned int	Size;
+	DirTree *		Child;
+
+	if	(Tree->ChildCount < DIRTREE_HASH_MIN_CHILDREN)
+		return;
+
+	Size = DIRTREE_HASH_MIN_CHILDREN;
+	while	(Size < (unsigned int)Tree->ChildCount)
+		Size <<= 1;
+
+	Buckets = geRam_Allocate(Size * sizeof(*Buckets));
+	if	(!Buckets)
+		return;
+	memset(Buckets, 0, Size * sizeof(*Buckets));
+
+	for	(Child = Tree->Children; Child; Child = Child->Siblings)
+		HashAppend(Buckets, Size, Child);
+
+	if	(Tree->ChildHash)
+		geRam_Free(Tree->ChildHash);
+
+	Tree->ChildHash = Buckets;
+	Tree->ChildHashSize = Size;
+}
+
+static	void	HashUnlink(DirTree *Tree, DirTree *Child)
+{
+	DirTree **	pLink;
+
+	if	(!Tree->ChildHash)
+		return;
+
+	pLink = &Tree->ChildHash[Child->NameHash & (Tree->ChildHashSize - 1)];
+	while	(*pLink)
+	{
+		if	(*pLink == Child)
+		{
+			*pLink = Child->HashNext;
+			break;
+		}
+		pLink = &(*pLink)->HashNext;
+	}
+
+	Child->HashNext = NULL;
+}
+
+//	Builds the name hash of every directory under Tree that has enough children
+static	void	HashTree(DirTree *Tree)
+{
+	DirTree *	Child;
+
+	HashChildren(Tree);
+
+	for	(Child = Tree->Children; Child; Child = Child->Siblings)
+	{
+		if	(Child->Children)
+			HashTree(Child);
+	}
+}
+
+//	Finds the child of Tree named by the first Length characters of Name
+static	DirTree *	FindChild(const DirTree *Tree, const char *Name, int Length)
+{
+	DirTree *		Child;
+	unsigned int	Hash;
+
+#ifdef	DIRTREE_BENCHMARK
+	if	(BenchNoHash == GE_FALSE)
+#endif
+	if	(Tree->ChildHash)
+	{
+		Hash = HashName(Name, Length);
+		for	(Child = Tree->ChildHash[Hash & (Tree->ChildHashSize - 1)]; Child; Child = Child->HashNext)
+		{
+			if	(Child->NameHash == Hash &&
+				 !strnicmp(Child->Name, Name, Length) && Child->Name[Length] == '\0')
+				return Child;
+		}
+		return NULL;
+	}
+
+	for	(Child = Tree->Children; Child; Child = Child->Siblings)
+	{
+		if	(!strnicmp(Child->Name, Name, Length) && Child->Name[Length] == '\0')
+			return Child;
+	}
+
+	return NULL;
+}
+
+//	Length of the first directory (or file) name in Path
+static	int		NameLength(const char *Path)
+{
+	const char *	End;
+
+	End = Path;
+	while	(*End && *End != '\\')
+		End++;
+
+	return End - Path;
+}
+
 DirTree *DirTree_Create(void)
 {
 	DirTree *	Tree;
@@ -79,16 +243,30 @@ DirTree *DirTree_Create(void)
 void	DirTree_Destroy(DirTree *Tree)
 {
 	assert(Tree);
-	assert(Tree->Name);
 
-	if	(Tree->Children)
-		DirTree_Destroy(Tree->Children);
+	// Siblings are walked, not recursed on: a directory can have a lot of them
+	while	(Tree)
+	{
+		DirTree *	Next;
+
+		assert(Tree->Name);
 
-	if	(Tree->Siblings)
-		DirTree_Destroy(Tree->Siblings);
+		Next = Tree->Siblings;
 
-	geRam_Free(Tree->Name);
-	geRam_Free(Tree);
+		if	(Tree->Children)
+			DirTree_Destroy(Tree->Children);
+
+		if	(Tree->ChildHash)
+			geRam_Free(Tree->ChildHash);
+
+		if	(Tree->Hints.HintData)
+			geRam_Free(Tree->Hints.HintData);
+
+		geRam_Free(Tree->Name);
+		geRam_Free(Tree);
+
+		Tree = Next;
+	}
 }
 
 static	geBoolean	WriteTree(const DirTree *Tree, geVFile *File)
@@ -97,66 +275,67 @@ static	geBoolean	WriteTree(const DirTree *Tree, geVFile *File)
 	int		Terminator;
 
 	assert(Tree);
-	assert(Tree->Name);
 
-	Terminator = DIRTREE_LIST_NOTTERMINATED;
-	if	(geVFile_Write(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
-		return GE_FALSE;
-
-	// Write out the name
-	Length = strlen(Tree->Name) + 1;
-	if	(geVFile_Write(File, &Length, sizeof(Length)) == GE_FALSE)
-		return GE_FALSE;
-	if	(Length > 0)
+	// Write Tree and its siblings, each followed by its children
+	while	(Tree)
 	{
-		if	(geVFile_Write(File, Tree->Name, Length) == GE_FALSE)
+		assert(Tree->Name);
+
+		Terminator = DIRTREE_LIST_NOTTERMINATED;
+		if	(geVFile_Write(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
 			return GE_FALSE;
-	}
 
-	// Write out the attribute information
-	if	(geVFile_Write(File, &Tree->Time, sizeof(Tree->Time)) == GE_FALSE)
-		return GE_FALSE;
+		// Write out the name
+		Length = strlen(Tree->Name) + 1;
+		if	(geVFile_Write(File, &Length, sizeof(Length)) == GE_FALSE)
+			return GE_FALSE;
+		if	(Length > 0)
+		{
+			if	(geVFile_Write(File, Tree->Name, Length) == GE_FALSE)
+				return GE_FALSE;
+		}
 
-	if	(geVFile_Write(File, &Tree->AttributeFlags, sizeof(Tree->AttributeFlags)) == GE_FALSE)
-		return GE_FALSE;
+		// Write out the attribute information
+		if	(geVFile_Write(File, &Tree->Time, sizeof(Tree->Time)) == GE_FALSE)
+			return GE_FALSE;
 
-	if	(geVFile_Write(File, &Tree->Size, sizeof(Tree->Size)) == GE_FALSE)
-		return GE_FALSE;
+		if	(geVFile_Write(File, &Tree->AttributeFlags, sizeof(Tree->AttributeFlags)) == GE_FALSE)
+			return GE_FALSE;
 
-	if	(geVFile_Write(File, &Tree->Offset, sizeof(Tree->Offset)) == GE_FALSE)
-		return GE_FALSE;
-	
-	if	(geVFile_Write(File, &Tree->Hints.HintDataLength, sizeof(Tree->Hints.HintDataLength)) == GE_FALSE)
-		return GE_FALSE;
+		if	(geVFile_Write(File, &Tree->Size, sizeof(Tree->Size)) == GE_FALSE)
+			return GE_FALSE;
 
-	if	(Tree->Hints.HintDataLength != 0)
-		//bug fix. someone got copy happy and forgot to remove the & from Tree->Hints.HintData
-		if	(geVFile_Write(File, Tree->Hints.HintData, Tree->Hints.HintDataLength) == GE_FALSE)
+		if	(geVFile_Write(File, &Tree->Offset, sizeof(Tree->Offset)) == GE_FALSE)
 			return GE_FALSE;
-	
-	// Write out the Children
-	if	(Tree->Children)
-	{
-		WriteTree(Tree->Children, File);
-	}
-	else
-	{
-		Terminator = DIRTREE_LIST_TERMINATED;
-		if	(geVFile_Write(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
+		
+		if	(geVFile_Write(File, &Tree->Hints.HintDataLength, sizeof(Tree->Hints.HintDataLength)) == GE_FALSE)
 			return GE_FALSE;
-	}
 
-	// Write out the Siblings
-	if	(Tree->Siblings)
-	{
-		WriteTree(Tree->Siblings, File);
-	}
-	else
-	{
-		Terminator = DIRTREE_LIST_TERMINATED;
-		if	(geVFile_Write(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
-			return GE_FALSE;
+		if	(Tree->Hints.HintDataLength != 0)
+			//bug fix. someone got copy happy and forgot to remove the & from Tree->Hints.HintData
+			if	(geVFile_Write(File, Tree->Hints.HintData, Tree->Hints.HintDataLength) == GE_FALSE)
+				return GE_FALSE;
+		
+		// Write out the Children
+		if	(Tree->Children)
+		{
+			if	(WriteTree(Tree->Children, File) == GE_FALSE)
+				return GE_FALSE;
+		}
+		else
+		{
+			Terminator = DIRTREE_LIST_TERMINATED;
+			if	(geVFile_Write(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
+				return GE_FALSE;
+		}
+
+		Tree = Tree->Siblings;
 	}
+
+	// End of the siblings
+	Terminator = DIRTREE_LIST_TERMINATED;
+	if	(geVFile_Write(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
+		return GE_FALSE;
 	
 	return GE_TRUE;
 }
@@ -252,87 +431,93 @@ geBoolean DirTree_GetSize(const DirTree *Tree, long *Size)
 	return GE_TRUE;
 }
 
-static	geBoolean	ReadTree(geVFile *File, DirTree **TreePtr)
+//	Reads a list of siblings (and their children) into *TreePtr.  Whatever was read is
+//	linked in, even on failure, so the caller can destroy it.
+static	geBoolean	ReadTree(geVFile *File, DirTree *Parent, DirTree **TreePtr)
 {
 	int			Terminator;
 	int			Length;
 	DirTree *	Tree;
 
-	if	(geVFile_Read(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
-		return GE_FALSE;
+	*TreePtr = NULL;
 
-	if	(Terminator == DIRTREE_LIST_TERMINATED)
+	while	(1)
 	{
-		*TreePtr = NULL;
-		return GE_TRUE;
-	}
-
-	Tree = geRam_Allocate(sizeof(*Tree));
-	if	(!Tree)
-		return GE_FALSE;
-	memset(Tree, 0, sizeof(*Tree));
+		if	(geVFile_Read(File, &Terminator, sizeof(Terminator)) == GE_FALSE)
+			return GE_FALSE;
 
-	// Read the name
-	if	(geVFile_Read(File, &Length, sizeof(Length)) == GE_FALSE)
-		goto fail;
+		if	(Terminator == DIRTREE_LIST_TERMINATED)
+			return GE_TRUE;
 
-	assert(Length > 0);
-	Tree->Name = geRam_Allocate(Length);
-	if	(!Tree->Name)
-	{
-		geRam_Free(Tree);
-		return GE_FALSE;
-	}
-	
-	if	(geVFile_Read(File, Tree->Name, Length) == GE_FALSE)
-		goto fail;
+		Tree = geRam_Allocate(sizeof(*Tree));
+		if	(!Tree)
+			return GE_FALSE;
+		memset(Tree, 0, sizeof(*Tree));
 
-//printf("Reading '%s'\n", Tree->Name);
+		// Read the name
+		if	(geVFile_Read(File, &Length, sizeof(Length)) == GE_FALSE)
+			goto fail;
 
-	// Read out the attribute information
-	if	(geVFile_Read(File, &Tree->Time, sizeof(Tree->Time)) == GE_FALSE)
-		goto fail;
+		if	(Length <= 0)
+			goto fail;
+		Tree->Name = geRam_Allocate(Length);
+		if	(!Tree->Name)
+			goto fail;
+		
+		if	(geVFile_Read(File, Tree->Name, Length) == GE_FALSE)
+			goto fail;
+		Tree->Name[Length - 1] = '\0';
 
-	if	(geVFile_Read(File, &Tree->AttributeFlags, sizeof(Tree->AttributeFlags)) == GE_FALSE)
-		goto fail;
+//printf("Reading '%s'\n", Tree->Name);
 
-	if	(geVFile_Read(File, &Tree->Size, sizeof(Tree->Size)) == GE_FALSE)
-		goto fail;
+		// Read out the attribute information
+		if	(geVFile_Read(File, &Tree->Time, sizeof(Tree->Time)) == GE_FALSE)
+			goto fail;
 
-	if	(geVFile_Read(File, &Tree->Offset, sizeof(Tree->Offset)) == GE_FALSE)
-		goto fail;
+		if	(geVFile_Read(File, &Tree->AttributeFlags, sizeof(Tree->AttributeFlags)) == GE_FALSE)
+			goto fail;
 
-	if	(geVFile_Read(File, &Tree->Hints.HintDataLength, sizeof(Tree->Hints.HintDataLength)) == GE_FALSE)
-		goto fail;
+		if	(geVFile_Read(File, &Tree->Size, sizeof(Tree->Size)) == GE_FALSE)
+			goto fail;
 
-	if	(Tree->Hints.HintDataLength != 0)
-	{
-		Tree->Hints.HintData = geRam_Allocate(Tree->Hints.HintDataLength);
-		if	(!Tree->Hints.HintData)
+		if	(geVFile_Read(File, &Tree->Offset, sizeof(Tree->Offset)) == GE_FALSE)
 			goto fail;
-		//bug fix. someone got copy happy and forgot to remove the & from Tree->Hints.HintData
-		if	(geVFile_Read(File, Tree->Hints.HintData, Tree->Hints.HintDataLength) == GE_FALSE)
+
+		if	(geVFile_Read(File, &Tree->Hints.HintDataLength, sizeof(Tree->Hints.HintDataLength)) == GE_FALSE)
 			goto fail;
-	}
 
-//printf("Reading children of '%s'\n", Tree->Name);
-	// Read the children
-	if	(ReadTree(File, &Tree->Children) == GE_FALSE)
-		goto fail;
+		if	(Tree->Hints.HintDataLength != 0)
+		{
+			Tree->Hints.HintData = geRam_Allocate(Tree->Hints.HintDataLength);
+			if	(!Tree->Hints.HintData)
+				goto fail;
+			//bug fix. someone got copy happy and forgot to remove the & from Tree->Hints.HintData
+			if	(geVFile_Read(File, Tree->Hints.HintData, Tree->Hints.HintDataLength) == GE_FALSE)
+				goto fail;
+		}
 
-//printf("Reading siblings of '%s'\n", Tree->Name);
-	// Read the Siblings
-	if	(ReadTree(File, &Tree->Siblings) == GE_FALSE)
-		goto fail;
+		Tree->Parent = Parent;
+		Tree->NameHash = HashName(Tree->Name, Length - 1);
+		if	(Parent)
+			Parent->ChildCount++;
 
-//DirTree_Dump(Tree);
+		*TreePtr = Tree;
+		TreePtr = &Tree->Siblings;
 
-	*TreePtr = Tree;
+//printf("Reading children of '%s'\n", Tree->Name);
+		// Read the children
+		if	(ReadTree(File, Tree, &Tree->Children) == GE_FALSE)
+			return GE_FALSE;
 
-	return GE_TRUE;
+//DirTree_Dump(Tree);
+	}
 
 fail:
-	DirTree_Destroy(Tree);
+	if	(Tree->Hints.HintData)
+		geRam_Free(Tree->Hints.HintData);
+	if	(Tree->Name)
+		geRam_Free(Tree->Name);
+	geRam_Free(Tree);
 	return GE_FALSE;
 }
 
@@ -352,7 +537,14 @@ DirTree *DirTree_CreateFromFile(geVFile *File)
 	if	(Header.Signature != DIRTREE_FILE_SIGNATURE)
 		return GE_FALSE;
 
-	if	(ReadTree(File, &Res) == GE_FALSE)
+	if	(ReadTree(File, NULL, &Res) == GE_FALSE)
+	{
+		if	(Res)
+			DirTree_Destroy(Res);
+		return NULL;
+	}
+
+	if	(!Res)
 		return NULL;
 
 	geVFile_Tell(File, &EndPosition);
@@ -362,38 +554,39 @@ DirTree *DirTree_CreateFromFile(geVFile *File)
 		return NULL;
 	}
 
+	// Index the names once, so opens don't walk directories
+	HashTree(Res);
+
 	return Res;
 }
 
 DirTree *DirTree_FindExact(const DirTree *Tree, const char *Path)
 {
-	static char	Buff[_MAX_PATH];
-	DirTree *	Siblings;
+	int		Length;
 
 	assert(Tree);
 	assert(Path);
 
-	if	(*Path == '\\')
-		return NULL;
+	while	(1)
+	{
+		if	(*Path == '\\')
+			return NULL;
 
-	if	(*Path == '\0')
-		return (DirTree *)Tree;
+		if	(*Path == '\0')
+			return (DirTree *)Tree;
 
-	Path = GetNextDir(Path, Buff);
+		Length = NameLength(Path);
+		Tree = FindChild(Tree, Path, Length);
+		if	(!Tree)
+			return NULL;
 
-	Siblings = Tree->Children;
-	while	(Siblings)
-	{
-		if	(!stricmp(Siblings->Name, Buff))
-		{
-			if	(!*Path)
-				return Siblings;
-			return DirTree_FindExact(Siblings, Path);
-		}
-		Siblings = Siblings->Siblings;
-	}
+		Path += Length;
+		if	(*Path == '\\')
+			Path++;
 
-	return NULL;
+		if	(!*Path)
+			return (DirTree *)Tree;
+	}
 }
 
 DirTree *DirTree_FindPartial(
@@ -401,36 +594,37 @@ DirTree *DirTree_FindPartial(
 	const char *	Path,
 	const char **	LeftOvers)
 {
-	static char	Buff[_MAX_PATH];
-	DirTree *	Siblings;
+	DirTree *	Child;
+	int			Length;
 
 	assert(Tree);
 	assert(Path);
 
-	if	(*Path == '\\')
-		return NULL;
+	while	(1)
+	{
+		if	(*Path == '\\')
+			return NULL;
 
-	*LeftOvers = Path;
+		*LeftOvers = Path;
 
-	if	(*Path == '\0')
-		return (DirTree *)Tree;
+		if	(*Path == '\0')
+			return (DirTree *)Tree;
 
-	Path = GetNextDir(Path, Buff);
+		Length = NameLength(Path);
+		Child = FindChild(Tree, Path, Length);
+		if	(!Child)
+			return (DirTree *)Tree;
 
-	Siblings = Tree->Children;
-	while	(Siblings)
-	{
-		if	(!stricmp(Siblings->Name, Buff))
-		{
-			*LeftOvers = Path;
-			if	(!*Path)
-				return Siblings;
-			return DirTree_FindPartial(Siblings, Path, LeftOvers);
-		}
-		Siblings = Siblings->Siblings;
-	}
+		Path += Length;
+		if	(*Path == '\\')
+			Path++;
 
-	return (DirTree *)Tree;
+		*LeftOvers = Path;
+		if	(!*Path)
+			return Child;
+
+		Tree = Child;
+	}
 }
 
 DirTree * DirTree_AddFile(DirTree *Tree, const char *Path, geBoolean IsDirectory)
@@ -471,6 +665,14 @@ DirTree * DirTree_AddFile(DirTree *Tree, const char *Path, geBoolean IsDirectory
 
 	NewEntry->Siblings = Tree->Children;
 						 Tree->Children = NewEntry;
+	NewEntry->Parent = Tree;
+	NewEntry->NameHash = HashName(NewEntry->Name, strlen(NewEntry->Name));
+
+	Tree->ChildCount++;
+	if	(Tree->ChildHash && (unsigned int)Tree->ChildCount <= Tree->ChildHashSize * 2)
+		HashInsert(Tree->ChildHash, Tree->ChildHashSize, NewEntry);
+	else
+		HashChildren(Tree);
 
 	if	(IsDirectory == GE_TRUE)
 		NewEntry->AttributeFlags |= GE_VFILE_ATTRIB_DIRECTORY;
@@ -504,6 +706,9 @@ geBoolean DirTree_Remove(DirTree *Tree, DirTree *SubTree)
 	{
 		if	(pSiblings->Siblings == SubTree)
 		{
+			HashUnlink(Parent, SubTree);
+			Parent->ChildCount--;
+
 			pSiblings->Siblings = SubTree->Siblings;
 			if	(SubTree == Parent->Children)
 				Parent->Children = SubTree->Siblings;
@@ -730,3 +935,137 @@ void DirTree_Dump(const DirTree *Tree)
 }
 
 #endif
+
+#ifdef	DIRTREE_BENCHMARK
+
+#include	<windows.h>
+
+#include	"vfile.h"
+
+#define	BENCH_NUM_DIRS		64
+
+static	float	BenchSeconds(LARGE_INTEGER *Start)
+{
+	LARGE_INTEGER	End, Freq;
+
+	QueryPerformanceCounter(&End);
+	QueryPerformanceFrequency(&Freq);
+
+	return (float)(End.QuadPart - Start->QuadPart) / (float)Freq.QuadPart;
+}
+
+//	Builds a VFS pack of NumFiles files in each of BENCH_NUM_DIRS directories, in a memory file
+static	geVFile *	BenchCreatePack(int NumFiles)
+{
+	geVFile_MemoryContext	MemContext;
+	geVFile *	MemFile;
+	geVFile *	VFS;
+	geVFile *	File;
+	char		Path[64];
+	int			i;
+
+	MemContext.Data = NULL;
+	MemContext.DataLength = 0;
+	MemFile = geVFile_OpenNewSystem(NULL, GE_VFILE_TYPE_MEMORY, NULL, &MemContext, GE_VFILE_OPEN_CREATE);
+	if	(!MemFile)
+		return NULL;
+
+	VFS = geVFile_OpenNewSystem(MemFile, GE_VFILE_TYPE_VIRTUAL, NULL, NULL, GE_VFILE_OPEN_CREATE | GE_VFILE_OPEN_DIRECTORY);
+	if	(!VFS)
+	{
+		geVFile_Close(MemFile);
+		return NULL;
+	}
+
+	for	(i=0; i<BENCH_NUM_DIRS; i++)
+	{
+		sprintf(Path, "Dir%03d", i);
+		File = geVFile_Open(VFS, Path, GE_VFILE_OPEN_CREATE | GE_VFILE_OPEN_DIRECTORY);
+		if	(File)
+			geVFile_Close(File);
+	}
+	for	(i=0; i<BENCH_NUM_DIRS * NumFiles; i++)
+	{
+		sprintf(Path, "Dir%03d\\File%05d.bmp", i % BENCH_NUM_DIRS, i / BENCH_NUM_DIRS);
+		File = geVFile_Open(VFS, Path, GE_VFILE_OPEN_CREATE);
+		if	(File)
+		{
+			geVFile_Write(File, &i, sizeof(i));
+			geVFile_Close(File);
+		}
+	}
+
+	// Writes the directory out
+	geVFile_Close(VFS);
+
+	geVFile_Seek(MemFile, 0, GE_VFILE_SEEKSET);
+	return MemFile;
+}
+
+//	Opens (and closes) every file in the pack by name, the way loading a level does
+static	float	BenchOpenPack(geVFile *MemFile, int NumFiles, int *Opened)
+{
+	geVFile *		VFS;
+	geVFile *		File;
+	LARGE_INTEGER	Start;
+	float			Time;
+	char			Path[64];
+	int				i;
+
+	*Opened = 0;
+
+	QueryPerformanceCounter(&Start);
+
+	geVFile_Seek(MemFile, 0, GE_VFILE_SEEKSET);
+	VFS = geVFile_OpenNewSystem(MemFile, GE_VFILE_TYPE_VIRTUAL, NULL, NULL, GE_VFILE_OPEN_READONLY | GE_VFILE_OPEN_DIRECTORY);
+	if	(!VFS)
+		return 0.0f;
+
+	for	(i=0; i<BENCH_NUM_DIRS * NumFiles; i++)
+	{
+		sprintf(Path, "DIR%03d\\file%05d.BMP", i % BENCH_NUM_DIRS, i / BENCH_NUM_DIRS);
+		File = geVFile_Open(VFS, Path, GE_VFILE_OPEN_READONLY);
+		if	(File)
+		{
+			(*Opened)++;
+			geVFile_Close(File);
+		}
+	}
+
+	geVFile_Close(VFS);
+
+	Time = BenchSeconds(&Start);
+	return Time;
+}
+
+//	Opens every file in a large pack, through the name hashes and by walking the children
+void DirTree_Benchmark(void)
+{
+	int		NumFiles;
+	char	Str[256];
+
+	for	(NumFiles = 16; NumFiles <= 4096; NumFiles *= 4)
+	{
+		geVFile *	MemFile;
+		float		HashTime, WalkTime;
+		int			HashOpened, WalkOpened;
+
+		MemFile = BenchCreatePack(NumFiles);
+		if	(!MemFile)
+			break;
+
+		HashTime = BenchOpenPack(MemFile, NumFiles, &HashOpened);
+
+		BenchNoHash = GE_TRUE;
+		WalkTime = BenchOpenPack(MemFile, NumFiles, &WalkOpened);
+		BenchNoHash = GE_FALSE;
+
+		sprintf(Str, "DirTree: opening a pack of %d dirs x %5d files: hashed %.2fms (%d opened), walked %.2fms (%d opened)\n",
+			BENCH_NUM_DIRS, NumFiles, HashTime*1000.0f, HashOpened, WalkTime*1000.0f, WalkOpened);
+		OutputDebugString(Str);
+
+		geVFile_Close(MemFile);
+	}
+}
+
+#endif
@@ -82,6 +82,12 @@ void DirTree_DestroyFinder(DirTree_Finder *Finder);
 DirTree * DirTree_FinderGetNextFile(DirTree_Finder *Finder);
 
 
+#ifdef	DIRTREE_BENCHMARK
+void DirTree_Benchmark(void);
+	// Times opening every file in a large VFS pack (built in memory), with and without
+	// the name hashes, and reports through OutputDebugString.
+#endif
+
 #ifdef	DEBUG
 void DirTree_Dump(const DirTree *Tree);
 #endif
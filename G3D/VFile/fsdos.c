@@ -51,6 +51,11 @@ typedef struct	DosFile
 	char *			FullPath;
 	const char *	Name;
 	geBoolean		IsDirectory;
+	geBoolean		ReadOnly;
+	HANDLE			MapHandle;			// Read only files get mapped the first time someone asks
+	const void *	View;
+	long			ViewSize;
+	geBoolean		MapFailed;			// Don't keep trying
 }	DosFile;
 
 typedef	struct	DosFinder
@@ -359,6 +364,7 @@ static	void *	GENESISCC FSDos_Open(
 		case	GE_VFILE_OPEN_READONLY:
 			Access = GENERIC_READ;
 			ShareMode = FILE_SHARE_READ | FILE_SHARE_WRITE;
+			NewFile->ReadOnly = GE_TRUE;
 			break;
 
 		case	GE_VFILE_OPEN_CREATE:
@@ -430,6 +436,11 @@ static	void	GENESISCC FSDos_Close(void *Handle)
 	{
 		assert(File->FileHandle != INVALID_HANDLE_VALUE);
 
+		if	(File->View)
+			UnmapViewOfFile((void *)File->View);
+		if	(File->MapHandle)
+			CloseHandle(File->MapHandle);
+
 		CloseHandle(File->FileHandle);
 	}
 	
@@ -883,6 +894,54 @@ static	geBoolean	GENESISCC FSDos_RenameFile(geVFile *FS, void *Handle, const cha
 	return GE_TRUE;
 }
 
+static	geBoolean	GENESISCC FSDos_GetView(const void *Handle, const void **View, long *Size)
+{
+	DosFile *	File;
+	DWORD		FileSize;
+
+	File = (DosFile *)Handle;
+
+	CHECK_HANDLE(File);
+
+	if	(File->IsDirectory == GE_TRUE || File->ReadOnly == GE_FALSE)
+		return GE_FALSE;
+
+	if	(!File->View)
+	{
+		if	(File->MapFailed == GE_TRUE)
+			return GE_FALSE;
+
+		File->MapFailed = GE_TRUE;
+
+		assert(File->FileHandle != INVALID_HANDLE_VALUE);
+
+		// Can't map an empty file
+		FileSize = GetFileSize(File->FileHandle, NULL);
+		if	(FileSize == 0xffffffff || FileSize == 0)
+			return GE_FALSE;
+
+		File->MapHandle = CreateFileMapping(File->FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if	(!File->MapHandle)
+			return GE_FALSE;
+
+		File->View = MapViewOfFile(File->MapHandle, FILE_MAP_READ, 0, 0, 0);
+		if	(!File->View)
+		{
+			CloseHandle(File->MapHandle);
+			File->MapHandle = NULL;
+			return GE_FALSE;
+		}
+
+		File->ViewSize = (long)FileSize;
+		File->MapFailed = GE_FALSE;
+	}
+
+	*View = File->View;
+	*Size = File->ViewSize;
+
+	return GE_TRUE;
+}
+
 static	geVFile_SystemAPIs	FSDos_APIs =
 {
 	FSDos_FinderCreate,
@@ -913,6 +972,8 @@ static	geVFile_SystemAPIs	FSDos_APIs =
 	FSDos_SetAttributes,
 	FSDos_SetTime,
 	FSDos_SetHints,
+
+	FSDos_GetView,
 };
 
 const geVFile_SystemAPIs *GENESISCC FSDos_GetAPIs(void)
@@ -28,6 +28,7 @@
 
 #include	"fsvfs.h"
 #include	"dirtree.h"
+#include	"Drivers\SoftDrv2\CPUSimd.h"
 
 //	"VF00"
 #define	VFSFILEHEADER_SIGNATURE	0x30304656
@@ -70,6 +71,10 @@ typedef	struct	VFSFile
 	long			Length;				// Current file size
 	char			Mask;
 
+	// Read only VFS read straight out of the RWOps file, when it can be mapped
+	const char *	View;				// The whole RWOps file (NULL if not mapped)
+	long			ViewSize;
+
 	unsigned int	OpenModeFlags;
 
 	// Things that are specific to the Root node
@@ -91,6 +96,67 @@ typedef	struct	VFSFinder
 #define	CHECK_HANDLE(H)	assert(H);assert(H->Signature == VFSFILE_SIGNATURE);
 #define	CHECK_FINDER(F)	assert(F);assert(F->Signature == VFSFINDER_SIGNATURE);
 
+//	Copies Count bytes from Src to Dest, xor'ing each with Mask.  Src and Dest can be the same.
+typedef	void	(GENESISCC *MaskCopyFN)(void *Dest, const void *Src, int Count, char Mask);
+
+static	MaskCopyFN	MaskCopy = NULL;
+
+static	void	GENESISCC MaskCopy_C(void *Dest, const void *Src, int Count, char Mask)
+{
+	unsigned char *			pDest;
+	const unsigned char *	pSrc;
+	int						i;
+
+	pDest = Dest;
+	pSrc = Src;
+
+	for	(i=0; i<Count; i++)
+		pDest[i] = (unsigned char)(pSrc[i] ^ Mask);
+}
+
+#ifdef	GE_HAVE_SSE2
+static	void	GENESISCC MaskCopy_SSE2(void *Dest, const void *Src, int Count, char Mask)
+{
+	unsigned char *			pDest;
+	const unsigned char *	pSrc;
+	__m128i					Mask16;
+	int						i;
+
+	pDest = Dest;
+	pSrc = Src;
+	Mask16 = _mm_set1_epi8(Mask);
+
+	for	(i=0; i+64<=Count; i+=64)
+	{
+		__m128i	a, b, c, d;
+
+		a = _mm_loadu_si128((const __m128i *)(pSrc + i));
+		b = _mm_loadu_si128((const __m128i *)(pSrc + i + 16));
+		c = _mm_loadu_si128((const __m128i *)(pSrc + i + 32));
+		d = _mm_loadu_si128((const __m128i *)(pSrc + i + 48));
+		_mm_storeu_si128((__m128i *)(pDest + i),	  _mm_xor_si128(a, Mask16));
+		_mm_storeu_si128((__m128i *)(pDest + i + 16), _mm_xor_si128(b, Mask16));
+		_mm_storeu_si128((__m128i *)(pDest + i + 32), _mm_xor_si128(c, Mask16));
+		_mm_storeu_si128((__m128i *)(pDest + i + 48), _mm_xor_si128(d, Mask16));
+	}
+
+	for	(; i+16<=Count; i+=16)
+		_mm_storeu_si128((__m128i *)(pDest + i), _mm_xor_si128(_mm_loadu_si128((const __m128i *)(pSrc + i)), Mask16));
+
+	MaskCopy_C(pDest + i, pSrc + i, Count - i, Mask);
+}
+#endif
+
+static	void	PickMaskCopy(void)
+{
+	MaskCopy = MaskCopy_C;
+
+#ifdef	GE_HAVE_SSE2
+	if	(CPUInfo_TestForSSE2())
+		MaskCopy = MaskCopy_SSE2;
+#endif
+}
+
 static	void *	GENESISCC FSVFS_FinderCreate(
 	geVFile *		FS,
 	void *			Handle,
@@ -269,6 +335,14 @@ static	void *	GENESISCC FSVFS_Open(
 		{
 			assert(!(OpenModeFlags & GE_VFILE_OPEN_UPDATE));
 			DirTree_GetFileSize(FileEntry, &NewFile->Length);
+
+			if	(Context->System->View &&
+				 NewFile->RWOpsStartPos >= 0 && NewFile->Length >= 0 &&
+				 NewFile->RWOpsStartPos + NewFile->Length <= Context->System->ViewSize)
+			{
+				NewFile->View	  = Context->System->View;
+				NewFile->ViewSize = Context->System->ViewSize;
+			}
 		}
 	}
 
@@ -377,6 +451,20 @@ static	void *	GENESISCC FSVFS_OpenNewSystem(
 			geRam_Free(NewFS);
 			return NULL;
 		}
+
+		// If nobody can write to us, our files can be read right out of the RWOps memory
+		if	(!(OpenModeFlags & GE_VFILE_OPEN_UPDATE))
+		{
+			const void *	View;
+			long			ViewSize;
+
+			if	(geVFile_GetView(RWOps, &View, &ViewSize) == GE_TRUE &&
+				 RWOpsStartPos + Header.DataLength <= ViewSize)
+			{
+				NewFS->View		= View;
+				NewFS->ViewSize	= ViewSize;
+			}
+		}
 	}
 	else
 	{
@@ -509,6 +597,18 @@ static	int			ClampOperationSize(const VFSFile *File, int Size)
 	return min(File->Length - File->CurrentRelPos, Size);
 }
 
+static	geBoolean	InView(const VFSFile *File, int Count)
+{
+	assert(!File->Directory);
+	assert(File->CurrentRelPos >= 0);
+
+	if	(!File->View)
+		return GE_FALSE;
+
+	// Seeks past the end of a file can take us past the end of the map
+	return (File->RWOpsStartPos + File->CurrentRelPos + Count <= File->ViewSize) ? GE_TRUE : GE_FALSE;
+}
+
 static	void		GENESISCC UpdateFilePos(VFSFile *File)
 {
 	long	RWOpsPos;
@@ -559,9 +659,6 @@ static	geBoolean	GENESISCC FSVFS_Read(void *Handle, void *Buff, int Count)
 {
 	VFSFile *	File;
 	geBoolean	Res;
-	int i;
-	char Bbyte;
-	char *TBuffer;
 
 #ifndef	NDEBUG
 	int			CurRelPos;
@@ -580,23 +677,35 @@ static	geBoolean	GENESISCC FSVFS_Read(void *Handle, void *Buff, int Count)
 	assert(File->CurrentRelPos >= 0);
 	assert(File->CurrentRelPos <= File->Length);
 
-	if	(!ForceFilePos(File))
+	if	(ClampOperationSize(File, Count) != Count)
 		return GE_FALSE;
 
-	if	(ClampOperationSize(File, Count) != Count)
+	if	(!MaskCopy)
+		PickMaskCopy();
+
+	if	(InView(File, Count))
+	{
+		const char *	Src;
+
+		Src = File->View + File->RWOpsStartPos + File->CurrentRelPos;
+		if	(File->Mask == 0)
+			memcpy(Buff, Src, Count);
+		else
+			MaskCopy(Buff, Src, Count, File->Mask);
+
+		File->CurrentRelPos += Count;
+		return GE_TRUE;
+	}
+
+	if	(!ForceFilePos(File))
 		return GE_FALSE;
 
 #ifndef	NDEBUG
 	CurRelPos = File->CurrentRelPos;
 #endif
 	Res = geVFile_Read(File->RWOps, Buff, Count);
-	TBuffer = Buff;
-	for(i=0;i<Count;i++)
-	{
-		memcpy(&Bbyte, (TBuffer+i),1);
-		Bbyte ^=File->Mask;
-		memcpy((TBuffer+i),&Bbyte,1);
-	}
+	if	(File->Mask != 0)
+		MaskCopy(Buff, Buff, Count, File->Mask);
 
 	UpdateFilePos(File);
 	assert(File->CurrentRelPos - CurRelPos == Count);
@@ -690,6 +799,15 @@ static	geBoolean	GENESISCC FSVFS_Seek(void *Handle, int Where, geVFile_Whence Wh
 	if	(AbsolutePos < File->RWOpsStartPos)
 		return GE_FALSE;
 
+	// Mapped files never touch the RWOps file pointer (see ForceFilePos)
+	if	(File->View)
+	{
+		File->CurrentRelPos = AbsolutePos - File->RWOpsStartPos;
+		if	(File->CurrentRelPos > File->Length)
+			File->Length = File->CurrentRelPos;
+		return GE_TRUE;
+	}
+
 	Res = geVFile_Seek(File->RWOps, AbsolutePos, GE_VFILE_SEEKSET);
 
 	UpdateFilePos(File);
@@ -772,6 +890,24 @@ static	geBoolean	GENESISCC FSVFS_GetProperties(const void *Handle, geVFile_Prope
 	return DirTree_GetName(File->DirEntry, &Properties->Name[0], sizeof(Properties->Name));
 }
 
+static	geBoolean	GENESISCC FSVFS_GetView(const void *Handle, const void **View, long *Size)
+{
+	const VFSFile *	File;
+
+	File = Handle;
+
+	CHECK_HANDLE(File);
+
+	// Masked bytes have to be copied to be read
+	if	(File->Directory || !File->View || File->Mask != 0)
+		return GE_FALSE;
+
+	*View = File->View + File->RWOpsStartPos;
+	*Size = min(File->Length, File->ViewSize - File->RWOpsStartPos);
+
+	return GE_TRUE;
+}
+
 static	geBoolean	GENESISCC FSVFS_SetSize(void *Handle, long Size)
 {
 	assert(!"Not implemented");
@@ -890,6 +1026,8 @@ static	geVFile_SystemAPIs	FSVFS_APIs =
 	FSVFS_SetAttributes,
 	FSVFS_SetTime,
 	FSVFS_SetHints,
+
+	FSVFS_GetView,
 };
 
 const geVFile_SystemAPIs * GENESISCC FSVFS_GetAPIs(void)
@@ -518,6 +518,42 @@ GENESISAPI geBoolean GENESISCC geVFile_Tell  (const geVFile *File, long *Positio
 	return File->APIs->Tell(File->FSData, Position);
 }
 
+geBoolean GENESISCC geVFile_GetView(const geVFile *File, const void **View, long *Size)
+{
+	assert(File);
+	assert(View);
+	assert(Size);
+
+	if	(!File->APIs->GetView)
+		return GE_FALSE;
+
+	return File->APIs->GetView(File->FSData, View, Size);
+}
+
+GENESISAPI const void * GENESISCC geVFile_GetMappedView(geVFile *File, int Count)
+{
+	const void *	View;
+	long			Size;
+	long			Position;
+
+	assert(File);
+	assert(Count >= 0);
+
+	if	(geVFile_GetView(File, &View, &Size) == GE_FALSE)
+		return NULL;
+
+	if	(File->APIs->Tell(File->FSData, &Position) == GE_FALSE)
+		return NULL;
+
+	if	(Position < 0 || Position > Size || Count > Size - Position)
+		return NULL;
+
+	if	(File->APIs->Seek(File->FSData, Position + Count, GE_VFILE_SEEKSET) == GE_FALSE)
+		return NULL;
+
+	return (const char *)View + Position;
+}
+
 GENESISAPI geBoolean GENESISCC geVFile_Size  (const geVFile *File, long *Size)
 {
 	assert(File);
@@ -175,6 +175,12 @@ GENESISAPI geBoolean GENESISCC geVFile_Printf		 (		geVFile *File, const char *Fo
 GENESISAPI geBoolean GENESISCC geVFile_EOF   		 (const geVFile *File);
 GENESISAPI geBoolean GENESISCC geVFile_Tell  		 (const geVFile *File, long *Position);
 GENESISAPI geBoolean GENESISCC geVFile_GetProperties(const geVFile *File, geVFile_Properties *Properties);
+GENESISAPI const void * GENESISCC geVFile_GetMappedView(geVFile *File, int Count);
+	// Returns a pointer to the next Count bytes of File, and moves the file
+	// pointer past them, like a geVFile_Read that doesn't copy.  The bytes
+	// are read only, and are good until File is closed.  Returns NULL if the
+	// file can't be read in place (it isn't mapped, or it's masked), without
+	// moving the file pointer; use geVFile_Read then.
 //geBoolean geVFile_GetName(geVFile *File, char *Buff, int MaxBuffLen);
 	// Gets the name of the file
 
@@ -0,0 +1,886 @@
+/****************************************************************************************/
+/*  ActorTree.c                                                                         */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Broadphase tree of the actors in a world                               */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Assert.h>
+#include <Stdio.h>
+
+#include "ActorTree.h"
+#include "World.h"
+#include "Actor.h"
+#include "Ram.h"
+#include "ErrorLog.h"
+
+//
+//	A dynamic bounding box tree (the same kind the physics people use).  Each actor gets a
+//	leaf with a box a little fatter than the actor, so an actor only has to be taken out and
+//	put back in when it leaves it's fat box.  The tree is kept balanced with rotations as
+//	it's changed, so it never gets much deeper than log2 of the actor count.
+//
+
+//=====================================================================================
+//	Defines / Structure defines
+//=====================================================================================
+#define ACTORTREE_NULL			(-1)
+#define ACTORTREE_GROW			64
+
+typedef struct
+{
+	geVec3d			Mins, Maxs;				// Fat box around everything under this node
+	int32			Parent;					// Next free node, when the node is free
+	int32			Children[2];			// ACTORTREE_NULL for leafs
+	int32			Height;					// 0 for leafs, -1 when free
+	int32			Proxy;					// Leafs only
+} ActorTree_Node;
+
+typedef struct ActorTree
+{
+	ActorTree_Node	*Nodes;
+	int32			NumNodes;
+	int32			FreeNode;
+	int32			Root;
+
+	ActorTree_Proxy	*Proxies;
+	int32			NumProxies;
+	int32			FreeProxy;
+
+	int32			*DirtyList;				// Proxies changed since the last update (room for NumProxies)
+	volatile long	NumDirty;
+} ActorTree;
+
+//=====================================================================================
+//	Local Static Function Prototypes
+//=====================================================================================
+static void SetProxyBox(ActorTree *Tree, int32 Proxy, const geExtBox *Box);
+static void GENESISCC ActorTree_ActorChanged(void *Context, int32 Proxy);
+
+//=====================================================================================
+//	ActorTree_Create
+//=====================================================================================
+ActorTree *ActorTree_Create(void)
+{
+	ActorTree	*Tree;
+
+	Tree = GE_RAM_ALLOCATE_STRUCT(ActorTree);
+
+	if (!Tree)
+	{
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		return NULL;
+	}
+
+	memset(Tree, 0, sizeof(ActorTree));
+
+	Tree->FreeNode = ACTORTREE_NULL;
+	Tree->Root = ACTORTREE_NULL;
+	Tree->FreeProxy = ACTORTREE_NULL;
+
+	return Tree;
+}
+
+//=====================================================================================
+//	ActorTree_Destroy
+//=====================================================================================
+void ActorTree_Destroy(ActorTree **Tree)
+{
+	assert(Tree);
+	assert(*Tree);
+
+	if ((*Tree)->Nodes)
+		geRam_Free((*Tree)->Nodes);
+
+	if ((*Tree)->Proxies)
+		geRam_Free((*Tree)->Proxies);
+
+	if ((*Tree)->DirtyList)
+		geRam_Free((*Tree)->DirtyList);
+
+	geRam_Free(*Tree);
+
+	*Tree = NULL;
+}
+
+//=====================================================================================
+//	Box helpers
+//=====================================================================================
+static void CombineBoxes(const geVec3d *Mins1, const geVec3d *Maxs1, const geVec3d *Mins2, const geVec3d *Maxs2, geVec3d *Mins, geVec3d *Maxs)
+{
+	Mins->X = min(Mins1->X, Mins2->X);
+	Mins->Y = min(Mins1->Y, Mins2->Y);
+	Mins->Z = min(Mins1->Z, Mins2->Z);
+	Maxs->X = max(Maxs1->X, Maxs2->X);
+	Maxs->Y = max(Maxs1->Y, Maxs2->Y);
+	Maxs->Z = max(Maxs1->Z, Maxs2->Z);
+}
+
+// Half the surface area of the box (all that's needed to compare the cost of boxes)
+static geFloat BoxCost(const geVec3d *Mins, const geVec3d *Maxs)
+{
+	geFloat		X, Y, Z;
+
+	X = Maxs->X - Mins->X;
+	Y = Maxs->Y - Mins->Y;
+	Z = Maxs->Z - Mins->Z;
+
+	return X*Y + Y*Z + Z*X;
+}
+
+static geBoolean BoxesOverlap(const geVec3d *Mins1, const geVec3d *Maxs1, const geVec3d *Mins2, const geVec3d *Maxs2)
+{
+	if (Maxs1->X < Mins2->X || Mins1->X > Maxs2->X)
+		return GE_FALSE;
+	if (Maxs1->Y < Mins2->Y || Mins1->Y > Maxs2->Y)
+		return GE_FALSE;
+	if (Maxs1->Z < Mins2->Z || Mins1->Z > Maxs2->Z)
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
+static geBoolean BoxInside(const geVec3d *Mins, const geVec3d *Maxs, const geVec3d *OMins, const geVec3d *OMaxs)
+{
+	if (Mins->X < OMins->X || Mins->Y < OMins->Y || Mins->Z < OMins->Z)
+		return GE_FALSE;
+	if (Maxs->X > OMaxs->X || Maxs->Y > OMaxs->Y || Maxs->Z > OMaxs->Z)
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	AllocNode
+//=====================================================================================
+static int32 AllocNode(ActorTree *Tree)
+{
+	ActorTree_Node	*Node;
+	int32			i;
+
+	if (Tree->FreeNode == ACTORTREE_NULL)
+	{
+		ActorTree_Node	*NewNodes;
+
+		NewNodes = GE_RAM_REALLOC_ARRAY(Tree->Nodes, ActorTree_Node, Tree->NumNodes+ACTORTREE_GROW);
+
+		if (!NewNodes)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return ACTORTREE_NULL;
+		}
+
+		Tree->Nodes = NewNodes;
+
+		// Chain the new ones onto the free list, in order
+		for (i=Tree->NumNodes+ACTORTREE_GROW-1; i>= Tree->NumNodes; i--)
+		{
+			Tree->Nodes[i].Height = -1;
+			Tree->Nodes[i].Parent = Tree->FreeNode;
+			Tree->FreeNode = i;
+		}
+
+		Tree->NumNodes += ACTORTREE_GROW;
+	}
+
+	i = Tree->FreeNode;
+	Node = &Tree->Nodes[i];
+	Tree->FreeNode = Node->Parent;
+
+	Node->Parent = ACTORTREE_NULL;
+	Node->Children[0] = ACTORTREE_NULL;
+	Node->Children[1] = ACTORTREE_NULL;
+	Node->Height = 0;
+	Node->Proxy = ACTORTREE_NULL;
+
+	return i;
+}
+
+//=====================================================================================
+//	FreeNode
+//=====================================================================================
+static void FreeNode(ActorTree *Tree, int32 i)
+{
+	assert(i >= 0 && i < Tree->NumNodes);
+	assert(Tree->Nodes[i].Height >= 0);
+
+	Tree->Nodes[i].Height = -1;
+	Tree->Nodes[i].Parent = Tree->FreeNode;
+	Tree->FreeNode = i;
+}
+
+//=====================================================================================
+//	FixNode
+//	Recomputes a nodes box and height from it's children
+//=====================================================================================
+static void FixNode(ActorTree *Tree, int32 i)
+{
+	ActorTree_Node	*Node, *C0, *C1;
+
+	Node = &Tree->Nodes[i];
+	C0 = &Tree->Nodes[Node->Children[0]];
+	C1 = &Tree->Nodes[Node->Children[1]];
+
+	CombineBoxes(&C0->Mins, &C0->Maxs, &C1->Mins, &C1->Maxs, &Node->Mins, &Node->Maxs);
+	Node->Height = 1 + max(C0->Height, C1->Height);
+}
+
+//=====================================================================================
+//	ReplaceChild
+//	Points whatever pointed at Old (it's parent, or the root) at New
+//=====================================================================================
+static void ReplaceChild(ActorTree *Tree, int32 Parent, int32 Old, int32 New)
+{
+	if (Parent == ACTORTREE_NULL)
+	{
+		Tree->Root = New;
+		return;
+	}
+
+	if (Tree->Nodes[Parent].Children[0] == Old)
+		Tree->Nodes[Parent].Children[0] = New;
+	else
+	{
+		assert(Tree->Nodes[Parent].Children[1] == Old);
+		Tree->Nodes[Parent].Children[1] = New;
+	}
+}
+
+//=====================================================================================
+//	Balance
+//	If one side of node A is more than 1 deeper than the other, rotates the deep
+//	child up into A's place.  Returns the node now in A's place.
+//=====================================================================================
+static int32 Balance(ActorTree *Tree, int32 A)
+{
+	ActorTree_Node	*NA;
+	int32			Up, Other, Side, Keep, Give, Diff;
+
+	NA = &Tree->Nodes[A];
+
+	if (NA->Height < 2)
+		return A;
+
+	Diff = Tree->Nodes[NA->Children[1]].Height - Tree->Nodes[NA->Children[0]].Height;
+
+	if (Diff > 1)
+		Side = 1;
+	else if (Diff < -1)
+		Side = 0;
+	else
+		return A;
+
+	Up = NA->Children[Side];			// The deep child, which is going up
+
+	// Of Up's children, the deeper one stays with Up, and the other goes down to A
+	if (Tree->Nodes[Tree->Nodes[Up].Children[0]].Height > Tree->Nodes[Tree->Nodes[Up].Children[1]].Height)
+	{
+		Keep = Tree->Nodes[Up].Children[0];
+		Give = Tree->Nodes[Up].Children[1];
+	}
+	else
+	{
+		Keep = Tree->Nodes[Up].Children[1];
+		Give = Tree->Nodes[Up].Children[0];
+	}
+
+	Other = NA->Children[!Side];
+
+	// Up takes A's place
+	Tree->Nodes[Up].Parent = NA->Parent;
+	ReplaceChild(Tree, NA->Parent, A, Up);
+
+	// A goes under Up, and takes Give in place of Up
+	Tree->Nodes[Up].Children[0] = A;
+	Tree->Nodes[Up].Children[1] = Keep;
+	NA->Parent = Up;
+
+	NA->Children[Side] = Give;
+	NA->Children[!Side] = Other;
+	Tree->Nodes[Give].Parent = A;
+
+	FixNode(Tree, A);
+	FixNode(Tree, Up);
+
+	return Up;
+}
+
+//=====================================================================================
+//	FixUpwards
+//	Rebalances and refits from node i all the way to the root
+//=====================================================================================
+static void FixUpwards(ActorTree *Tree, int32 i)
+{
+	while (i != ACTORTREE_NULL)
+	{
+		i = Balance(Tree, i);
+		FixNode(Tree, i);
+		i = Tree->Nodes[i].Parent;
+	}
+}
+
+//=====================================================================================
+//	InsertLeaf
+//	Walks down to the sibling that makes the tree cost the least, and pairs Leaf with it
+//=====================================================================================
+static geBoolean InsertLeaf(ActorTree *Tree, int32 Leaf)
+{
+	geVec3d		Mins, Maxs;
+	int32		i, Sibling, NewParent, OldParent;
+
+	if (Tree->Root == ACTORTREE_NULL)
+	{
+		Tree->Root = Leaf;
+		Tree->Nodes[Leaf].Parent = ACTORTREE_NULL;
+		return GE_TRUE;
+	}
+
+	i = Tree->Root;
+
+	while (Tree->Nodes[i].Height > 0)
+	{
+		ActorTree_Node	*Node;
+		geFloat			Cost, Inherit, ChildCost[2];
+		int32			c;
+
+		Node = &Tree->Nodes[i];
+
+		CombineBoxes(&Node->Mins, &Node->Maxs, &Tree->Nodes[Leaf].Mins, &Tree->Nodes[Leaf].Maxs, &Mins, &Maxs);
+
+		// Cost of pairing with this node, and what going further down would add to it
+		Cost = 2.0f * BoxCost(&Mins, &Maxs);
+		Inherit = 2.0f * (BoxCost(&Mins, &Maxs) - BoxCost(&Node->Mins, &Node->Maxs));
+
+		for (c=0; c< 2; c++)
+		{
+			ActorTree_Node	*Child;
+
+			Child = &Tree->Nodes[Node->Children[c]];
+
+			CombineBoxes(&Child->Mins, &Child->Maxs, &Tree->Nodes[Leaf].Mins, &Tree->Nodes[Leaf].Maxs, &Mins, &Maxs);
+
+			ChildCost[c] = BoxCost(&Mins, &Maxs) + Inherit;
+
+			if (Child->Height > 0)
+				ChildCost[c] -= BoxCost(&Child->Mins, &Child->Maxs);
+		}
+
+		if (Cost < ChildCost[0] && Cost < ChildCost[1])
+			break;
+
+		i = (ChildCost[0] < ChildCost[1]) ? Node->Children[0] : Node->Children[1];
+	}
+
+	Sibling = i;
+
+	NewParent = AllocNode(Tree);			// Nodes can move, so no pointers held across this
+
+	if (NewParent == ACTORTREE_NULL)
+		return GE_FALSE;
+
+	OldParent = Tree->Nodes[Sibling].Parent;
+
+	Tree->Nodes[NewParent].Parent = OldParent;
+	Tree->Nodes[NewParent].Children[0] = Sibling;
+	Tree->Nodes[NewParent].Children[1] = Leaf;
+	ReplaceChild(Tree, OldParent, Sibling, NewParent);
+
+	Tree->Nodes[Sibling].Parent = NewParent;
+	Tree->Nodes[Leaf].Parent = NewParent;
+
+	FixUpwards(Tree, NewParent);
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	RemoveLeaf
+//	Takes Leaf out of the tree (but doesn't free it), and puts it's sibling in it's parents place
+//=====================================================================================
+static void RemoveLeaf(ActorTree *Tree, int32 Leaf)
+{
+	int32		Parent, GrandParent, Sibling;
+
+	if (Leaf == Tree->Root)
+	{
+		Tree->Root = ACTORTREE_NULL;
+		return;
+	}
+
+	Parent = Tree->Nodes[Leaf].Parent;
+	GrandParent = Tree->Nodes[Parent].Parent;
+
+	if (Tree->Nodes[Parent].Children[0] == Leaf)
+		Sibling = Tree->Nodes[Parent].Children[1];
+	else
+		Sibling = Tree->Nodes[Parent].Children[0];
+
+	ReplaceChild(Tree, GrandParent, Parent, Sibling);
+	Tree->Nodes[Sibling].Parent = GrandParent;
+
+	FreeNode(Tree, Parent);
+
+	FixUpwards(Tree, GrandParent);
+}
+
+//=====================================================================================
+//	ActorTree_ActorChanged
+//	The actors box watch.  Puts the proxy on the dirty list, once.  Actors can be changed
+//	from any thread (geActor_RenderPrepBatch), so it only uses interlocked ops, and the
+//	list always has room, since a proxy is never on it twice.
+//=====================================================================================
+static void GENESISCC ActorTree_ActorChanged(void *Context, int32 Proxy)
+{
+	ActorTree	*Tree;
+
+	Tree = (ActorTree*)Context;
+
+	assert(Proxy >= 0 && Proxy < Tree->NumProxies);
+
+	if (InterlockedExchange(&Tree->Proxies[Proxy].Listed, 1))
+		return;				// Already on the list
+
+	Tree->DirtyList[InterlockedIncrement(&Tree->NumDirty)-1] = Proxy;
+}
+
+//=====================================================================================
+//	AddProxy
+//=====================================================================================
+static int32 AddProxy(ActorTree *Tree, int32 ActorIndex)
+{
+	ActorTree_Proxy	*Proxy;
+	int32			i;
+
+	assert(Tree);
+	assert(ActorIndex >= 0);
+
+	if (Tree->FreeProxy == ACTORTREE_NULL)
+	{
+		ActorTree_Proxy	*NewProxies;
+		int32			*NewDirtyList;
+
+		NewDirtyList = GE_RAM_REALLOC_ARRAY(Tree->DirtyList, int32, Tree->NumProxies+ACTORTREE_GROW);
+
+		if (!NewDirtyList)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return ACTORTREE_NULL;
+		}
+
+		Tree->DirtyList = NewDirtyList;
+
+		NewProxies = GE_RAM_REALLOC_ARRAY(Tree->Proxies, ActorTree_Proxy, Tree->NumProxies+ACTORTREE_GROW);
+
+		if (!NewProxies)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return ACTORTREE_NULL;
+		}
+
+		Tree->Proxies = NewProxies;
+
+		for (i=Tree->NumProxies+ACTORTREE_GROW-1; i>= Tree->NumProxies; i--)
+		{
+			Tree->Proxies[i].ActorIndex = ACTORTREE_NULL;
+			Tree->Proxies[i].Listed = 0;
+			Tree->Proxies[i].Node = Tree->FreeProxy;		// Next free
+			Tree->FreeProxy = i;
+		}
+
+		Tree->NumProxies += ACTORTREE_GROW;
+	}
+
+	i = Tree->FreeProxy;
+	Proxy = &Tree->Proxies[i];
+	Tree->FreeProxy = Proxy->Node;
+
+	Proxy->ActorIndex = ActorIndex;
+	Proxy->Stamp = 0;
+	Proxy->Dirty = GE_TRUE;
+	Proxy->Valid = GE_FALSE;
+	Proxy->RenderLeaf = -1;
+	Proxy->Node = ACTORTREE_NULL;
+
+	ActorTree_ActorChanged(Tree, i);
+
+	return i;
+}
+
+//=====================================================================================
+//	ActorTree_AddActor
+//	The actor goes in the tree on the next update, and from then on, whenever it changes
+//=====================================================================================
+int32 ActorTree_AddActor(ActorTree *Tree, int32 ActorIndex, geActor *Actor)
+{
+	int32		Proxy;
+
+	assert(Actor);
+
+	Proxy = AddProxy(Tree, ActorIndex);
+
+	if (Proxy == ACTORTREE_NULL)
+		return ACTORTREE_NULL;
+
+	if (!geActor_AddBoxWatch(Actor, ActorTree_ActorChanged, Tree, Proxy))
+	{
+		Tree->Proxies[Proxy].ActorIndex = ACTORTREE_NULL;
+		Tree->Proxies[Proxy].Node = Tree->FreeProxy;
+		Tree->FreeProxy = Proxy;
+		return ACTORTREE_NULL;
+	}
+
+	return Proxy;
+}
+
+//=====================================================================================
+//	ActorTree_RemoveActor
+//=====================================================================================
+void ActorTree_RemoveActor(ActorTree *Tree, int32 Proxy, geActor *Actor)
+{
+	ActorTree_Proxy	*P;
+
+	assert(Tree);
+	assert(Proxy >= 0 && Proxy < Tree->NumProxies);
+	assert(Actor);
+
+	P = &Tree->Proxies[Proxy];
+
+	assert(P->ActorIndex != ACTORTREE_NULL);
+
+	geActor_RemoveBoxWatch(Actor, ActorTree_ActorChanged, Tree, Proxy);
+
+	if (P->Node != ACTORTREE_NULL)
+	{
+		RemoveLeaf(Tree, P->Node);
+		FreeNode(Tree, P->Node);
+	}
+
+	P->ActorIndex = ACTORTREE_NULL;				// If it's still on the dirty list, the update skips it
+	P->Node = Tree->FreeProxy;
+	Tree->FreeProxy = Proxy;
+}
+
+//=====================================================================================
+//	ActorTree_SetActorIndex
+//	For when the world moves an actor around in it's array
+//=====================================================================================
+void ActorTree_SetActorIndex(ActorTree *Tree, int32 Proxy, int32 ActorIndex)
+{
+	assert(Tree);
+	assert(Proxy >= 0 && Proxy < Tree->NumProxies);
+	assert(Tree->Proxies[Proxy].ActorIndex != ACTORTREE_NULL);
+
+	Tree->Proxies[Proxy].ActorIndex = ActorIndex;
+}
+
+//=====================================================================================
+//	SetProxyBox
+//	Only touches the tree if the box has left the fat box it's leaf has
+//=====================================================================================
+static void SetProxyBox(ActorTree *Tree, int32 Proxy, const geExtBox *Box)
+{
+	ActorTree_Proxy	*P;
+	ActorTree_Node	*Node;
+	int32			Leaf;
+
+	P = &Tree->Proxies[Proxy];
+	P->Box = *Box;
+
+	if (P->Node != ACTORTREE_NULL)
+	{
+		Node = &Tree->Nodes[P->Node];
+
+		if (BoxInside(&Box->Min, &Box->Max, &Node->Mins, &Node->Maxs))
+			return;
+
+		Leaf = P->Node;
+		RemoveLeaf(Tree, Leaf);
+	}
+	else
+	{
+		Leaf = AllocNode(Tree);
+
+		if (Leaf == ACTORTREE_NULL)
+			return;							// It just won't be found, the error is already logged
+
+		Tree->Nodes[Leaf].Proxy = Proxy;
+		P->Node = Leaf;
+	}
+
+	Node = &Tree->Nodes[Leaf];
+
+	Node->Mins.X = Box->Min.X - ACTORTREE_MARGIN;
+	Node->Mins.Y = Box->Min.Y - ACTORTREE_MARGIN;
+	Node->Mins.Z = Box->Min.Z - ACTORTREE_MARGIN;
+	Node->Maxs.X = Box->Max.X + ACTORTREE_MARGIN;
+	Node->Maxs.Y = Box->Max.Y + ACTORTREE_MARGIN;
+	Node->Maxs.Z = Box->Max.Z + ACTORTREE_MARGIN;
+
+	if (!InsertLeaf(Tree, Leaf))
+	{
+		FreeNode(Tree, Leaf);
+		P->Node = ACTORTREE_NULL;
+	}
+}
+
+//=====================================================================================
+//	ActorTree_Update
+//	Only the proxies on the dirty list are looked at
+//=====================================================================================
+geBoolean ActorTree_Update(ActorTree *Tree, geWorld *World)
+{
+	World_Actor		*WA;
+	uint32			Stamp;
+	int32			i, Proxy;
+
+	assert(Tree);
+	assert(World);
+
+	for (i=0; i< Tree->NumDirty; i++)
+	{
+		ActorTree_Proxy	*P;
+		geExtBox		Box;
+		geBoolean		Enabled;
+		geVec3d			Center;
+
+		Proxy = Tree->DirtyList[i];
+		P = &Tree->Proxies[Proxy];
+
+		if (P->ActorIndex == ACTORTREE_NULL)
+		{
+			P->Listed = 0;
+			continue;					// Removed since
+		}
+
+		assert(P->ActorIndex < World->ActorCount);
+
+		WA = &World->ActorArray[P->ActorIndex];
+
+		assert(WA->Proxy == Proxy);
+
+		Stamp = geActor_GetBoxStamp(WA->Actor);
+
+		if (!P->Dirty && Stamp == P->Stamp)
+		{
+			P->Listed = 0;
+			continue;
+		}
+
+		P->Stamp = Stamp;
+		P->Dirty = GE_FALSE;
+
+		// Where the render code looks the actor up in the PVS
+		geActor_GetRenderHintExtBox(WA->Actor, &Box, &Enabled);
+
+		if (Enabled)
+		{
+			P->RenderBox = Box;
+			geExtBox_GetTranslation(&Box, &Center);
+			geWorld_GetLeaf(World, &Center, &P->RenderLeaf);
+		}
+		else
+			P->RenderLeaf = -1;
+
+		P->Valid = geActor_GetExtBox(WA->Actor, &Box);
+
+		if (P->Valid)
+			SetProxyBox(Tree, Proxy, &Box);
+
+		// Only now, since any change made while taking the boxes is already in them
+		P->Listed = 0;
+	}
+
+	Tree->NumDirty = 0;
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	ActorTree_IsUpToDate
+//=====================================================================================
+geBoolean ActorTree_IsUpToDate(const ActorTree *Tree)
+{
+	assert(Tree);
+
+	return Tree->NumDirty == 0;
+}
+
+//=====================================================================================
+//	ActorTree_GetProxy
+//=====================================================================================
+const ActorTree_Proxy *ActorTree_GetProxy(const ActorTree *Tree, int32 Proxy)
+{
+	assert(Tree);
+	assert(Proxy >= 0 && Proxy < Tree->NumProxies);
+
+	return &Tree->Proxies[Proxy];
+}
+
+//=====================================================================================
+//	QueryBox_r
+//=====================================================================================
+static geBoolean QueryBox_r(const ActorTree *Tree, int32 i, const geVec3d *Mins, const geVec3d *Maxs, ActorTree_QueryCB *CB, void *Context)
+{
+	const ActorTree_Node	*Node;
+
+	Node = &Tree->Nodes[i];
+
+	if (!BoxesOverlap(&Node->Mins, &Node->Maxs, Mins, Maxs))
+		return GE_TRUE;
+
+	if (Node->Height == 0)
+		return CB(&Tree->Proxies[Node->Proxy], Context);
+
+	if (!QueryBox_r(Tree, Node->Children[0], Mins, Maxs, CB, Context))
+		return GE_FALSE;
+
+	return QueryBox_r(Tree, Node->Children[1], Mins, Maxs, CB, Context);
+}
+
+//=====================================================================================
+//	ActorTree_QueryBox
+//	Calls CB for every actor whose fat box touches Mins/Maxs.  The caller still has to
+//	check the actors real box (Proxy->Box).
+//=====================================================================================
+void ActorTree_QueryBox(const ActorTree *Tree, const geVec3d *Mins, const geVec3d *Maxs, ActorTree_QueryCB *CB, void *Context)
+{
+	assert(Tree);
+	assert(Mins && Maxs);
+	assert(CB);
+
+	if (Tree->Root == ACTORTREE_NULL)
+		return;
+
+	QueryBox_r(Tree, Tree->Root, Mins, Maxs, CB, Context);
+}
+
+#ifdef ACTORTREE_BENCHMARK
+//=====================================================================================
+//	Benchmark
+//	Scatters actor sized boxes around a level sized space, moves them all a little,
+//	and traces short moves through them, with the tree and with a linear scan
+//=====================================================================================
+#define BENCH_WORLD_SIZE		(8192.0f)
+#define BENCH_NUM_QUERIES		(10000)
+
+static geBoolean BenchCount(const ActorTree_Proxy *Proxy, void *Context)
+{
+	(*(int32*)Context)++;
+	return GE_TRUE;
+}
+
+static geFloat BenchRand(void)
+{
+	return ((geFloat)rand() / (geFloat)RAND_MAX) * BENCH_WORLD_SIZE;
+}
+
+static geFloat BenchSeconds(LARGE_INTEGER *Start)
+{
+	LARGE_INTEGER	End, Freq;
+
+	QueryPerformanceCounter(&End);
+	QueryPerformanceFrequency(&Freq);
+
+	return (geFloat)(End.QuadPart - Start->QuadPart) / (geFloat)Freq.QuadPart;
+}
+
+void ActorTree_Benchmark(void)
+{
+	int32		NumActors;
+	char		Str[256];
+
+	for (NumActors = 250; NumActors <= 16000; NumActors *= 2)
+	{
+		ActorTree		*Tree;
+		geExtBox		*Boxes;
+		geVec3d			*QMins, *QMaxs;
+		LARGE_INTEGER	Start;
+		geFloat			UpdateTime, TreeTime, ScanTime;
+		int32			i, k, TreeHits, ScanHits;
+
+		Tree = ActorTree_Create();
+		Boxes = GE_RAM_ALLOCATE_ARRAY(geExtBox, NumActors);
+		QMins = GE_RAM_ALLOCATE_ARRAY(geVec3d, BENCH_NUM_QUERIES);
+		QMaxs = GE_RAM_ALLOCATE_ARRAY(geVec3d, BENCH_NUM_QUERIES);
+
+		if (!Tree || !Boxes || !QMins || !QMaxs)
+			break;
+
+		srand(1);
+
+		for (i=0; i< NumActors; i++)
+		{
+			geVec3d		Pos;
+
+			geVec3d_Set(&Pos, BenchRand(), BenchRand(), BenchRand());
+			geExtBox_Set(&Boxes[i], Pos.X-16.0f, Pos.Y, Pos.Z-16.0f, Pos.X+16.0f, Pos.Y+64.0f, Pos.Z+16.0f);
+
+			AddProxy(Tree, i);
+			SetProxyBox(Tree, i, &Boxes[i]);
+		}
+
+		for (i=0; i< BENCH_NUM_QUERIES; i++)
+		{
+			geVec3d_Set(&QMins[i], BenchRand(), BenchRand(), BenchRand());
+			geVec3d_Set(&QMaxs[i], QMins[i].X + 64.0f, QMins[i].Y + 64.0f, QMins[i].Z + 256.0f);
+		}
+
+		// One frame of movement (most stay inside their fat boxes)
+		QueryPerformanceCounter(&Start);
+
+		for (i=0; i< NumActors; i++)
+		{
+			geExtBox_Translate(&Boxes[i], (geFloat)(i%7)-3.0f, 0.0f, (geFloat)(i%5)-2.0f);
+			SetProxyBox(Tree, i, &Boxes[i]);
+		}
+
+		UpdateTime = BenchSeconds(&Start);
+
+		QueryPerformanceCounter(&Start);
+
+		TreeHits = 0;
+		for (i=0; i< BENCH_NUM_QUERIES; i++)
+			ActorTree_QueryBox(Tree, &QMins[i], &QMaxs[i], BenchCount, &TreeHits);
+
+		TreeTime = BenchSeconds(&Start);
+
+		QueryPerformanceCounter(&Start);
+
+		ScanHits = 0;
+		for (i=0; i< BENCH_NUM_QUERIES; i++)
+		{
+			for (k=0; k< NumActors; k++)
+			{
+				if (BoxesOverlap(&Boxes[k].Min, &Boxes[k].Max, &QMins[i], &QMaxs[i]))
+					ScanHits++;
+			}
+		}
+
+		ScanTime = BenchSeconds(&Start);
+
+		sprintf(Str, "ActorTree: %5i actors, update %.3fms, %i queries: tree %.2fms (%i fat hits), scan %.2fms (%i hits)\n",
+			NumActors, UpdateTime*1000.0f, BENCH_NUM_QUERIES, TreeTime*1000.0f, TreeHits, ScanTime*1000.0f, ScanHits);
+		OutputDebugString(Str);
+
+		geRam_Free(QMaxs);
+		geRam_Free(QMins);
+		geRam_Free(Boxes);
+		ActorTree_Destroy(&Tree);
+	}
+}
+#endif
@@ -0,0 +1,92 @@
+/****************************************************************************************/
+/*  ActorTree.h                                                                         */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Broadphase tree of the actors in a world                               */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef GE_ACTORTREE_H
+#define GE_ACTORTREE_H
+
+#include "Genesis.h"
+#include "BaseType.h"
+#include "ExtBox.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Defines / Structure defines
+//=====================================================================================
+#define ACTORTREE_MARGIN		(8.0f)		// How far an actor can move before it's put back in the tree
+
+typedef struct ActorTree ActorTree;
+
+//
+//	What the tree knows about each actor in the world.  The boxes are taken from the
+//	actor in ActorTree_Update, so they are good till the actor is changed again.  The
+//	tree watches each actor, and a change puts the actors proxy on the trees dirty list.
+//
+typedef struct
+{
+	int32			ActorIndex;				// Index into World->ActorArray (-1 if the proxy is free)
+	uint32			Stamp;					// geActor_GetBoxStamp when the boxes were taken
+	geBoolean		Dirty;					// GE_TRUE if the boxes need taking no matter what the stamp says
+	volatile long	Listed;					// 1 while the proxy is on the dirty list
+
+	geExtBox		Box;					// The actors ExtBox
+	geBoolean		Valid;					// GE_FALSE if geActor_GetExtBox failed
+	int32			RenderLeaf;				// Leaf the center of the render hint box is in (-1 if the hint is off)
+	geExtBox		RenderBox;				// The render hint box (only good if RenderLeaf != -1)
+
+	int32			Node;					// Leaf node in the tree (-1 if not in the tree yet)
+} ActorTree_Proxy;
+
+// Called for each proxy whose fat box touches the query box.  Return GE_FALSE to stop.
+typedef geBoolean ActorTree_QueryCB(const ActorTree_Proxy *Proxy, void *Context);
+
+//=====================================================================================
+//	Function ProtoTypes
+//=====================================================================================
+ActorTree	*ActorTree_Create(void);
+void		ActorTree_Destroy(ActorTree **Tree);
+
+int32		ActorTree_AddActor(ActorTree *Tree, int32 ActorIndex, geActor *Actor);	// Returns the proxy, -1 on failure
+void		ActorTree_RemoveActor(ActorTree *Tree, int32 Proxy, geActor *Actor);
+void		ActorTree_SetActorIndex(ActorTree *Tree, int32 Proxy, int32 ActorIndex);
+
+// Brings the tree up to date with the actors that changed since the last update (only
+// the ones on the dirty list are looked at).  Not thread safe (getting an actors box can
+// update it's pose, and actors can be changed from other threads while nothing is
+// updating), so batches call it up front.
+geBoolean	ActorTree_Update(ActorTree *Tree, geWorld *World);
+geBoolean	ActorTree_IsUpToDate(const ActorTree *Tree);		// GE_TRUE if nothing changed since the last update
+
+const ActorTree_Proxy *ActorTree_GetProxy(const ActorTree *Tree, int32 Proxy);
+void		ActorTree_QueryBox(const ActorTree *Tree, const geVec3d *Mins, const geVec3d *Maxs, ActorTree_QueryCB *CB, void *Context);
+
+#ifdef ACTORTREE_BENCHMARK
+// Times box queries against the tree and against a linear scan, for more and more actors
+void		ActorTree_Benchmark(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,453 @@
+/****************************************************************************************/
+/*  BSPCache.c                                                                          */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Baked copies of a loaded bsp, that load with one read                  */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Assert.h>
+#include <StdDef.h>
+
+#include "BSPCache.h"
+#include "GBSPFile.h"
+#include "Surface.h"
+#include "Ram.h"
+#include "ErrorLog.h"
+#include "crc32.h"
+
+//
+//	A cache file is a header, then one blob with every array of the bsp (and the SurfInfo
+//	and TexVerts Surf_BSPInit makes out of them) laid end to end, then the texdata.  The
+//	blob is read in one go, and the arrays are pointed into it.  The texdata is kept out of
+//	the blob, so it can still be let go of once the world has made it's bitmaps.
+//
+//	The structs are written just as they are in memory, so a cache is only good for the
+//	build that made it.  The element sizes are kept in the header, and a cache from a build
+//	they don't match is just stale.
+//
+//	The motions are text, and are made into geMotions on load, so they aren't baked.  They
+//	are read out of the source bsp every time.
+//
+
+//=====================================================================================
+//	Defines / Structure defines
+//=====================================================================================
+#define BSPCACHE_TAG		(('E'<<24) | ('K'<<16) | ('A'<<8) | 'B')		// "BAKE" in the file
+#define BSPCACHE_VERSION	1
+
+#define BSPCACHE_ALIGN		16				// Each array starts on this, from the start of the blob
+#define BSPCACHE_KEY_BLOCK	(64*1024)		// Read size, for keying files that aren't mapped
+
+enum
+{
+	BSPCACHE_MODELS,
+	BSPCACHE_NODES,
+	BSPCACHE_BNODES,
+	BSPCACHE_LEAFS,
+	BSPCACHE_CLUSTERS,
+	BSPCACHE_AREAS,
+	BSPCACHE_AREA_PORTALS,
+	BSPCACHE_PORTALS,
+	BSPCACHE_PLANES,
+	BSPCACHE_FACES,
+	BSPCACHE_LEAF_FACES,
+	BSPCACHE_LEAF_SIDES,
+	BSPCACHE_VERTS,
+	BSPCACHE_VERT_INDEX,
+	BSPCACHE_RGB_VERTS,
+	BSPCACHE_ENTDATA,
+	BSPCACHE_TEXTURES,
+	BSPCACHE_TEXINFO,
+	BSPCACHE_PALETTES,
+	BSPCACHE_LIGHTDATA,
+	BSPCACHE_VISDATA,
+	BSPCACHE_SURFINFO,
+	BSPCACHE_TEXVERTS,
+
+	BSPCACHE_NUM_ARRAYS
+};
+
+// Where an array, and it's count, are in a World_BSP
+typedef struct
+{
+	int32			PtrOffset;
+	int32			CountOffset;
+	int32			Size;					// sizeof an element
+} BSPCache_ArrayDef;
+
+typedef struct
+{
+	int32			Offset;					// From the start of the blob
+	int32			Count;
+	int32			Size;					// sizeof an element, in the build that baked it
+} BSPCache_Array;
+
+typedef struct
+{
+	uint32			Tag;					// BSPCACHE_TAG, once the whole cache is written
+	int32			Version;				// BSPCACHE_VERSION
+	int32			GBSPVersion;			// GBSP_VERSION
+	BSPCache_Key	Key;					// Of the bsp this was baked from
+
+	GBSP_Header		GBSPHeader;
+	GFX_SkyData		GFXSkyData;
+	int32			MotionsOffset;			// Where the motions are in the source bsp, 0 if there are none
+
+	int32			BlobSize;				// The blob follows the header,
+	int32			NumGFXTexData;			// and the texdata follows the blob
+	BSPCache_Array	Arrays[BSPCACHE_NUM_ARRAYS];
+} BSPCache_Header;
+
+#define BSPCACHE_GFX(Ptr, Count, Type)	{ offsetof(World_BSP, BSPData.Ptr), offsetof(World_BSP, BSPData.Count), sizeof(Type) }
+
+// In the same order as the enum above
+static const BSPCache_ArrayDef ArrayDefs[BSPCACHE_NUM_ARRAYS] =
+{
+	BSPCACHE_GFX(GFXModels,			NumGFXModels,			GFX_Model),
+	BSPCACHE_GFX(GFXNodes,			NumGFXNodes,			GFX_Node),
+	BSPCACHE_GFX(GFXBNodes,			NumGFXBNodes,			GFX_BNode),
+	BSPCACHE_GFX(GFXLeafs,			NumGFXLeafs,			GFX_Leaf),
+	BSPCACHE_GFX(GFXClusters,		NumGFXClusters,			GFX_Cluster),
+	BSPCACHE_GFX(GFXAreas,			NumGFXAreas,			GFX_Area),
+	BSPCACHE_GFX(GFXAreaPortals,	NumGFXAreaPortals,		GFX_AreaPortal),
+	BSPCACHE_GFX(GFXPortals,		NumGFXPortals,			GFX_Portal),
+	BSPCACHE_GFX(GFXPlanes,			NumGFXPlanes,			GFX_Plane),
+	BSPCACHE_GFX(GFXFaces,			NumGFXFaces,			GFX_Face),
+	BSPCACHE_GFX(GFXLeafFaces,		NumGFXLeafFaces,		int32),
+	BSPCACHE_GFX(GFXLeafSides,		NumGFXLeafSides,		GFX_LeafSide),
+	BSPCACHE_GFX(GFXVerts,			NumGFXVerts,			geVec3d),
+	BSPCACHE_GFX(GFXVertIndexList,	NumGFXVertIndexList,	int32),
+	BSPCACHE_GFX(GFXRGBVerts,		NumGFXRGBVerts,			geVec3d),
+	BSPCACHE_GFX(GFXEntData,		NumGFXEntData,			uint8),
+	BSPCACHE_GFX(GFXTextures,		NumGFXTextures,			GFX_Texture),
+	BSPCACHE_GFX(GFXTexInfo,		NumGFXTexInfo,			GFX_TexInfo),
+	BSPCACHE_GFX(GFXPalettes,		NumGFXPalettes,			DRV_Palette),
+	BSPCACHE_GFX(GFXLightData,		NumGFXLightData,		uint8),
+	BSPCACHE_GFX(GFXVisData,		NumGFXVisData,			uint8),
+
+	// Surf_BSPInit keeps one of these per face, and one per vert index
+	{ offsetof(World_BSP, SurfInfo), offsetof(World_BSP, BSPData.NumGFXFaces), sizeof(Surf_SurfInfo) },
+	{ offsetof(World_BSP, TexVerts), offsetof(World_BSP, BSPData.NumGFXVertIndexList), sizeof(Surf_TexVert) },
+};
+
+#define BSPCACHE_PTR(BSP, Def)		((void**)((uint8*)(BSP) + (Def)->PtrOffset))
+#define BSPCACHE_COUNT(BSP, Def)	((int32*)((uint8*)(BSP) + (Def)->CountOffset))
+
+#define BSPCACHE_ALIGNED(Bytes)		(((Bytes) + (BSPCACHE_ALIGN-1)) & ~(BSPCACHE_ALIGN-1))
+
+//=====================================================================================
+//	BSPCache_GetKey
+//=====================================================================================
+geBoolean BSPCache_GetKey(geVFile *File, BSPCache_Key *Key)
+{
+	long			Start, Size;
+	const uint8		*View;
+	uint8			*Block;
+	uint32			CRC;
+	int32			Left, Count;
+
+	assert(File != NULL);
+	assert(Key != NULL);
+
+	if (!geVFile_Tell(File, &Start))
+		return GE_FALSE;
+
+	if (!geVFile_Size(File, &Size) || Size < Start)
+		return GE_FALSE;
+
+	Key->Size = (int32)(Size - Start);
+
+	// If the file is mapped (or is in a mapped archive), this doesn't cost a copy
+	View = (const uint8*)geVFile_GetMappedView(File, Key->Size);
+
+	if (View)
+	{
+		Key->CRC = CRC32_Array(View, Key->Size);
+	}
+	else
+	{
+		Block = (uint8*)geRam_Allocate(BSPCACHE_KEY_BLOCK);
+
+		if (!Block)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return GE_FALSE;
+		}
+
+		CRC = CRC32_Start();
+
+		for (Left = Key->Size; Left > 0; Left -= Count)
+		{
+			Count = (Left < BSPCACHE_KEY_BLOCK) ? Left : BSPCACHE_KEY_BLOCK;
+
+			if (!geVFile_Read(File, Block, Count))
+			{
+				geRam_Free(Block);
+				return GE_FALSE;
+			}
+
+			CRC = CRC32_AddArray(CRC, Block, Count);
+		}
+
+		geRam_Free(Block);
+
+		Key->CRC = CRC32_Finish(CRC);
+	}
+
+	return geVFile_Seek(File, Start, GE_VFILE_SEEKSET);
+}
+
+//=====================================================================================
+//	BSPCache_Load
+//=====================================================================================
+World_BSP *BSPCache_Load(geVFile *Cache, geVFile *File, const BSPCache_Key *Key)
+{
+	BSPCache_Header			Header;
+	const BSPCache_ArrayDef	*Def;
+	const BSPCache_Array	*Array;
+	World_BSP				*BSP;
+	GBSP_BSPData			*BSPData;
+	int32					i, k;
+	long					Start;
+
+	assert(Cache != NULL);
+	assert(File != NULL);
+	assert(Key != NULL);
+
+	BSP = NULL;
+
+	// So File can still be loaded the normal way, if this doesn't work out
+	if (!geVFile_Tell(File, &Start))
+		return NULL;
+
+	if (!geVFile_Seek(Cache, 0, GE_VFILE_SEEKSET))
+		return NULL;
+
+	if (!geVFile_Read(Cache, &Header, sizeof(Header)))
+		return NULL;
+
+	if (Header.Tag != BSPCACHE_TAG || Header.Version != BSPCACHE_VERSION || Header.GBSPVersion != GBSP_VERSION)
+		return NULL;
+
+	if (Header.Key.Size != Key->Size || Header.Key.CRC != Key->CRC)
+		return NULL;
+
+	if (Header.BlobSize <= 0 || Header.NumGFXTexData < 0 || Header.MotionsOffset < 0)
+		return NULL;
+
+	for (i=0; i< BSPCACHE_NUM_ARRAYS; i++)
+	{
+		Def = &ArrayDefs[i];
+		Array = &Header.Arrays[i];
+
+		if (Array->Size != Def->Size)
+			return NULL;
+
+		if (Array->Offset < 0 || Array->Offset > Header.BlobSize)
+			return NULL;
+
+		if (Array->Count < 0 || Array->Count > (Header.BlobSize - Array->Offset) / Array->Size)
+			return NULL;
+
+		// SurfInfo and TexVerts share their counts with the faces and vert indexes
+		for (k=0; k< i; k++)
+		{
+			if (ArrayDefs[k].CountOffset == Def->CountOffset && Header.Arrays[k].Count != Array->Count)
+				return NULL;
+		}
+	}
+
+	BSP = GE_RAM_ALLOCATE_STRUCT(World_BSP);
+
+	if (!BSP)
+		goto OutOfMemory;
+
+	memset(BSP, 0, sizeof(World_BSP));
+
+	BSPData = &BSP->BSPData;
+
+	BSPData->GFXBlob = (uint8*)geRam_Allocate(Header.BlobSize);
+
+	if (!BSPData->GFXBlob)
+		goto OutOfMemory;
+
+	// The one read
+	if (!geVFile_Read(Cache, BSPData->GFXBlob, Header.BlobSize))
+		goto ExitWithError;
+
+	BSPData->GBSPHeader = Header.GBSPHeader;
+	BSPData->GFXSkyData = Header.GFXSkyData;
+	BSPData->MotionsOffset = Header.MotionsOffset;
+
+	for (i=0; i< BSPCACHE_NUM_ARRAYS; i++)
+	{
+		Def = &ArrayDefs[i];
+		Array = &Header.Arrays[i];
+
+		*BSPCACHE_COUNT(BSP, Def) = Array->Count;
+		*BSPCACHE_PTR(BSP, Def) = Array->Count ? BSPData->GFXBlob + Array->Offset : NULL;
+	}
+
+	// Fix up what pointed outside the blob when it was baked
+	for (i=0; i< BSPData->NumGFXModels; i++)
+		BSPData->GFXModels[i].Motion = NULL;
+
+	for (i=0; i< BSPData->NumGFXFaces; i++)
+	{
+		BSP->SurfInfo[i].LInfo.RGBLight[0] = NULL;
+		BSP->SurfInfo[i].LInfo.RGBLight[1] = NULL;
+		BSP->SurfInfo[i].LInfo.THandle = NULL;
+	}
+
+	// The texdata is only needed till the bitmaps are made, so it's used in place if it can be
+	if (Header.NumGFXTexData)
+	{
+		BSPData->GFXTexData = (uint8*)geVFile_GetMappedView(Cache, Header.NumGFXTexData);
+
+		if (BSPData->GFXTexData)
+		{
+			BSPData->GFXTexDataMapped = GE_TRUE;
+		}
+		else
+		{
+			BSPData->GFXTexData = (uint8*)geRam_Allocate(Header.NumGFXTexData);
+
+			if (!BSPData->GFXTexData)
+				goto OutOfMemory;
+
+			if (!geVFile_Read(Cache, BSPData->GFXTexData, Header.NumGFXTexData))
+				goto ExitWithError;
+		}
+
+		BSPData->NumGFXTexData = Header.NumGFXTexData;
+	}
+
+	if (BSPData->MotionsOffset)
+	{
+		if (!GBSP_LoadGBSPMotions(File, BSPData))
+			goto ExitWithError;
+	}
+
+	return BSP;
+
+	OutOfMemory:
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+
+	ExitWithError:
+	{
+		if (BSP)
+		{
+			GBSP_FreeGBSPFile(&BSP->BSPData);
+			geRam_Free(BSP);
+		}
+
+		geVFile_Seek(File, Start, GE_VFILE_SEEKSET);
+
+		return NULL;
+	}
+}
+
+//=====================================================================================
+//	BSPCache_Save
+//=====================================================================================
+geBoolean BSPCache_Save(const World_BSP *BSP, geVFile *Cache, const BSPCache_Key *Key)
+{
+	static const uint8		Pad[BSPCACHE_ALIGN] = {0};
+	BSPCache_Header			Header;
+	const BSPCache_ArrayDef	*Def;
+	BSPCache_Array			*Array;
+	const GBSP_BSPData		*BSPData;
+	int32					i, Offset, Bytes;
+
+	assert(BSP != NULL);
+	assert(Cache != NULL);
+	assert(Key != NULL);
+
+	BSPData = &BSP->BSPData;
+
+	assert(BSPData->GFXTexData != NULL || BSPData->NumGFXTexData == 0);
+	assert(BSP->SurfInfo != NULL || BSPData->NumGFXFaces == 0);
+
+	memset(&Header, 0, sizeof(Header));
+
+	// The tag is left off till everything else is written, so a cache that only got part way
+	// out is never used
+	Header.Version = BSPCACHE_VERSION;
+	Header.GBSPVersion = GBSP_VERSION;
+	Header.Key = *Key;
+
+	Header.GBSPHeader = BSPData->GBSPHeader;
+	Header.GFXSkyData = BSPData->GFXSkyData;
+	Header.MotionsOffset = BSPData->MotionsOffset;
+	Header.NumGFXTexData = BSPData->NumGFXTexData;
+
+	Offset = 0;
+
+	for (i=0; i< BSPCACHE_NUM_ARRAYS; i++)
+	{
+		Def = &ArrayDefs[i];
+		Array = &Header.Arrays[i];
+
+		Array->Offset = Offset;
+		Array->Count = *BSPCACHE_COUNT(BSP, Def);
+		Array->Size = Def->Size;
+
+		Offset += BSPCACHE_ALIGNED(Array->Count * Array->Size);
+	}
+
+	Header.BlobSize = Offset;
+
+	if (!geVFile_Seek(Cache, 0, GE_VFILE_SEEKSET))
+		goto ExitWithError;
+
+	if (!geVFile_Write(Cache, &Header, sizeof(Header)))
+		goto ExitWithError;
+
+	for (i=0; i< BSPCACHE_NUM_ARRAYS; i++)
+	{
+		Def = &ArrayDefs[i];
+		Array = &Header.Arrays[i];
+
+		Bytes = Array->Count * Array->Size;
+
+		if (Bytes && !geVFile_Write(Cache, *BSPCACHE_PTR(BSP, Def), Bytes))
+			goto ExitWithError;
+
+		if (BSPCACHE_ALIGNED(Bytes) != Bytes && !geVFile_Write(Cache, Pad, BSPCACHE_ALIGNED(Bytes) - Bytes))
+			goto ExitWithError;
+	}
+
+	if (BSPData->NumGFXTexData && !geVFile_Write(Cache, BSPData->GFXTexData, BSPData->NumGFXTexData))
+		goto ExitWithError;
+
+	Header.Tag = BSPCACHE_TAG;
+
+	if (!geVFile_Seek(Cache, 0, GE_VFILE_SEEKSET))
+		goto ExitWithError;
+
+	if (!geVFile_Write(Cache, &Header, sizeof(Header)))
+		goto ExitWithError;
+
+	return GE_TRUE;
+
+	ExitWithError:
+	{
+		geErrorLog_AddString(-1, "BSPCache_Save:  Could not write the cache.", NULL);
+		return GE_FALSE;
+	}
+}
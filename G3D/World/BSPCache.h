@@ -0,0 +1,64 @@
+/****************************************************************************************/
+/*  BSPCache.h                                                                          */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Baked copies of a loaded bsp, that load with one read                  */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef GE_BSPCACHE_H
+#define GE_BSPCACHE_H
+
+#include "BaseType.h"
+#include "VFile.h"
+#include "World.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Structure defines
+//=====================================================================================
+
+// What a cache has to match to be used in place of the bsp it was baked from
+typedef struct
+{
+	int32			Size;					// Bytes in the source, from where it was when the key was taken
+	uint32			CRC;					// CRC32 of those bytes
+} BSPCache_Key;
+
+//=====================================================================================
+//	Function ProtoTypes
+//=====================================================================================
+
+// Takes the key of File, from it's current position to the end.  Leaves File where it was.
+geBoolean BSPCache_GetKey(geVFile *File, BSPCache_Key *Key);
+
+// Returns a loaded bsp, with the SurfInfo and TexVerts Surf_BSPInit would give it, out of
+// Cache.  NULL if Cache isn't a good bake of the bsp with Key (nothing is added to the error
+// log for a stale cache).  The motions are still read out of File.
+World_BSP *BSPCache_Load(geVFile *Cache, geVFile *File, const BSPCache_Key *Key);
+
+// Bakes BSP into Cache (from the start, replacing whatever is there).  BSP has to be just
+// out of World_PrepBSP, with it's texdata still around.
+geBoolean BSPCache_Save(const World_BSP *BSP, geVFile *Cache, const BSPCache_Key *Key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -22,12 +22,14 @@
 #include <Assert.h>
 #include <Windows.h>
 #include <Math.h>
+#include <String.h>
 
 #include "Camera.h"
 #include "Frustum.h"
 #include "Surface.h"
 
 #include "Vec3d.h"
+#include "Drivers\SoftDrv2\CPUSimd.h"
 
 //#define RIGHT_HANDED
 
@@ -1112,6 +1114,265 @@ geBoolean Frustum_PointInFrustum(const Frustum_Info *Fi, const geVec3d *Point, g
 	return GE_TRUE;
 }
 
+//================================================================================
+//	Batched box culling
+//	Each plane in ClipFlags is set up once with the bounds arrays for the corner furthest
+//	in front of it, and the one furthest behind it, so the box loops can go straight down
+//	the arrays.  If the front corner is behind the plane the whole box is, and if the back
+//	corner is in front of it the whole box is.  The masks are kept as floats, so the wide versions can and/or them.
+//================================================================================
+typedef struct
+{
+	int32			NumPlanes;
+	uint32			Bit[MAX_FCP];
+	geFloat			BitMask[MAX_FCP];			// Bit, as the bits of a float
+	geFloat			Normal[MAX_FCP][3];
+	geFloat			Dist[MAX_FCP];
+	const geFloat	*Front[MAX_FCP][3];			// X, Y, Z bounds of the corner furthest in front of the plane
+	const geFloat	*Back[MAX_FCP][3];			// X, Y, Z bounds of the corner furthest behind it
+} Frustum_CullPlanes;
+
+// Culls boxes 0..n-1 in blocks, and returns n.  The rest are left for CullBox.
+typedef int32 Frustum_CullBlocksFunc(const Frustum_CullPlanes *P, uint32 ClipFlags, int32 NumBoxes, uint32 *Visible, uint32 *BoxClipFlags, uint32 *BoxOutside);
+
+static Frustum_CullBlocksFunc	*CullBlocks = NULL;
+
+//================================================================================
+//	SetupCullPlanes
+//================================================================================
+static void SetupCullPlanes(const Frustum_Info *Fi, uint32 ClipFlags, geFloat * const *Bounds, Frustum_CullPlanes *P)
+{
+	int32		i, k;
+	const int32	*Index;
+
+	P->NumPlanes = 0;
+
+	for (k=0; k< Fi->NumPlanes; k++)
+	{
+		if (!(ClipFlags & (1<<k)))
+			continue;
+
+		i = P->NumPlanes++;
+
+		P->Bit[i] = (1<<k);
+		memcpy(&P->BitMask[i], &P->Bit[i], sizeof(uint32));
+
+		P->Normal[i][0] = Fi->Planes[k].Normal.X;
+		P->Normal[i][1] = Fi->Planes[k].Normal.Y;
+		P->Normal[i][2] = Fi->Planes[k].Normal.Z;
+		P->Dist[i] = Fi->Planes[k].Dist;
+
+		Index = Fi->pFrustumBBoxIndexes[k];
+
+		P->Front[i][0] = Bounds[Index[0]];
+		P->Front[i][1] = Bounds[Index[1]];
+		P->Front[i][2] = Bounds[Index[2]];
+		P->Back[i][0] = Bounds[Index[3+0]];
+		P->Back[i][1] = Bounds[Index[3+1]];
+		P->Back[i][2] = Bounds[Index[3+2]];
+	}
+}
+
+//================================================================================
+//	CullBox
+//	One box, the same way RenderBSPFrontBack_r tests a node
+//================================================================================
+static void CullBox(const Frustum_CullPlanes *P, int32 i, uint32 *Outside, uint32 *Inside)
+{
+	int32		k;
+	geFloat		Dist;
+
+	*Outside = 0;
+	*Inside = 0;
+
+	for (k=0; k< P->NumPlanes; k++)
+	{
+		Dist = P->Front[k][0][i]*P->Normal[k][0] + P->Front[k][1][i]*P->Normal[k][1] + P->Front[k][2][i]*P->Normal[k][2];
+		Dist -= P->Dist[k];
+
+		if (Dist <= 0)
+			*Outside |= P->Bit[k];
+
+		Dist = P->Back[k][0][i]*P->Normal[k][0] + P->Back[k][1][i]*P->Normal[k][1] + P->Back[k][2][i]*P->Normal[k][2];
+		Dist -= P->Dist[k];
+
+		if (Dist >= 0)
+			*Inside |= P->Bit[k];
+	}
+}
+
+//================================================================================
+//	CullBlocks_C
+//================================================================================
+static int32 CullBlocks_C(const Frustum_CullPlanes *P, uint32 ClipFlags, int32 NumBoxes, uint32 *Visible, uint32 *BoxClipFlags, uint32 *BoxOutside)
+{
+	return 0;		// CullBox does them all
+}
+
+#ifdef GE_HAVE_SSE2
+//================================================================================
+//	CullBlocks_SSE2
+//	4 boxes at a time
+//================================================================================
+#define SSE2_DIST(Corner, k, i)																\
+	_mm_sub_ps(_mm_add_ps(_mm_add_ps(														\
+		_mm_mul_ps(_mm_loadu_ps(P->Corner[k][0]+i), _mm_set1_ps(P->Normal[k][0])),			\
+		_mm_mul_ps(_mm_loadu_ps(P->Corner[k][1]+i), _mm_set1_ps(P->Normal[k][1]))),			\
+		_mm_mul_ps(_mm_loadu_ps(P->Corner[k][2]+i), _mm_set1_ps(P->Normal[k][2]))),			\
+		_mm_set1_ps(P->Dist[k]))
+
+static int32 CullBlocks_SSE2(const Frustum_CullPlanes *P, uint32 ClipFlags, int32 NumBoxes, uint32 *Visible, uint32 *BoxClipFlags, uint32 *BoxOutside)
+{
+	__m128		Zero, Clip, Bit, Cmp, Out, In, AnyOut;
+	geFloat		ClipMask;
+	int32		i, k;
+
+	memcpy(&ClipMask, &ClipFlags, sizeof(uint32));
+
+	Zero = _mm_setzero_ps();
+	Clip = _mm_set1_ps(ClipMask);
+
+	for (i=0; i+4 <= NumBoxes; i+=4)
+	{
+		Out = Zero;
+		In = Zero;
+		AnyOut = Zero;
+
+		for (k=0; k< P->NumPlanes; k++)
+		{
+			Bit = _mm_set1_ps(P->BitMask[k]);
+
+			Cmp = _mm_cmple_ps(SSE2_DIST(Front, k, i), Zero);
+			AnyOut = _mm_or_ps(AnyOut, Cmp);
+			Out = _mm_or_ps(Out, _mm_and_ps(Cmp, Bit));
+
+			Cmp = _mm_cmpge_ps(SSE2_DIST(Back, k, i), Zero);
+			In = _mm_or_ps(In, _mm_and_ps(Cmp, Bit));
+		}
+
+		if (Visible)
+			Visible[i>>5] |= (uint32)(~_mm_movemask_ps(AnyOut) & 0xf) << (i&31);
+		if (BoxClipFlags)
+			_mm_storeu_ps((float*)(BoxClipFlags+i), _mm_andnot_ps(In, Clip));
+		if (BoxOutside)
+			_mm_storeu_ps((float*)(BoxOutside+i), Out);
+	}
+
+	return i;
+}
+#endif
+
+#ifdef GE_HAVE_AVX2
+//================================================================================
+//	CullBlocks_AVX2
+//	8 boxes at a time
+//================================================================================
+#define AVX2_DIST(Corner, k, i)																	\
+	_mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(													\
+		_mm256_mul_ps(_mm256_loadu_ps(P->Corner[k][0]+i), _mm256_set1_ps(P->Normal[k][0])),		\
+		_mm256_mul_ps(_mm256_loadu_ps(P->Corner[k][1]+i), _mm256_set1_ps(P->Normal[k][1]))),	\
+		_mm256_mul_ps(_mm256_loadu_ps(P->Corner[k][2]+i), _mm256_set1_ps(P->Normal[k][2]))),	\
+		_mm256_set1_ps(P->Dist[k]))
+
+static int32 CullBlocks_AVX2(const Frustum_CullPlanes *P, uint32 ClipFlags, int32 NumBoxes, uint32 *Visible, uint32 *BoxClipFlags, uint32 *BoxOutside)
+{
+	__m256		Zero, Clip, Bit, Cmp, Out, In, AnyOut;
+	geFloat		ClipMask;
+	int32		i, k;
+
+	memcpy(&ClipMask, &ClipFlags, sizeof(uint32));
+
+	Zero = _mm256_setzero_ps();
+	Clip = _mm256_set1_ps(ClipMask);
+
+	for (i=0; i+8 <= NumBoxes; i+=8)
+	{
+		Out = Zero;
+		In = Zero;
+		AnyOut = Zero;
+
+		for (k=0; k< P->NumPlanes; k++)
+		{
+			Bit = _mm256_set1_ps(P->BitMask[k]);
+
+			// Ordered compares, so a NaN fails them like it does in CullBox
+			Cmp = _mm256_cmp_ps(AVX2_DIST(Front, k, i), Zero, _CMP_LE_OQ);
+			AnyOut = _mm256_or_ps(AnyOut, Cmp);
+			Out = _mm256_or_ps(Out, _mm256_and_ps(Cmp, Bit));
+
+			Cmp = _mm256_cmp_ps(AVX2_DIST(Back, k, i), Zero, _CMP_GE_OQ);
+			In = _mm256_or_ps(In, _mm256_and_ps(Cmp, Bit));
+		}
+
+		if (Visible)
+			Visible[i>>5] |= (uint32)(~_mm256_movemask_ps(AnyOut) & 0xff) << (i&31);
+		if (BoxClipFlags)
+			_mm256_storeu_ps((float*)(BoxClipFlags+i), _mm256_andnot_ps(In, Clip));
+		if (BoxOutside)
+			_mm256_storeu_ps((float*)(BoxOutside+i), Out);
+	}
+
+	_mm256_zeroupper();
+
+	return i;
+}
+#endif
+
+//================================================================================
+//	PickCullBlocks
+//================================================================================
+static void PickCullBlocks(void)
+{
+	CullBlocks = CullBlocks_C;
+
+#ifdef GE_HAVE_SSE2
+	if (CPUInfo_TestForSSE2())
+		CullBlocks = CullBlocks_SSE2;
+#endif
+
+#ifdef GE_HAVE_AVX2
+	if (CPUInfo_TestForAVX2())
+		CullBlocks = CullBlocks_AVX2;
+#endif
+}
+
+//================================================================================
+//	Frustum_CullAABBs
+//================================================================================
+void Frustum_CullAABBs(const Frustum_Info *Fi, uint32 ClipFlags, geFloat * const *Bounds, int32 NumBoxes,
+						uint32 *Visible, uint32 *BoxClipFlags, uint32 *BoxOutside)
+{
+	Frustum_CullPlanes	Planes;
+	uint32				Outside, Inside;
+	int32				i;
+
+	assert(Fi);
+	assert(Bounds);
+	assert(NumBoxes >= 0);
+
+	if (!CullBlocks)
+		PickCullBlocks();
+
+	SetupCullPlanes(Fi, ClipFlags, Bounds, &Planes);
+
+	if (Visible)
+		memset(Visible, 0, ((NumBoxes+31)>>5)*sizeof(uint32));
+
+	i = CullBlocks(&Planes, ClipFlags, NumBoxes, Visible, BoxClipFlags, BoxOutside);
+
+	for (; i< NumBoxes; i++)
+	{
+		CullBox(&Planes, i, &Outside, &Inside);
+
+		if (Visible && !Outside)
+			Visible[i>>5] |= (1<<(i&31));
+		if (BoxClipFlags)
+			BoxClipFlags[i] = ClipFlags & ~Inside;
+		if (BoxOutside)
+			BoxOutside[i] = Outside;
+	}
+}
+
 //================================================================================
 //	Frustum_ClipAllPlanesL	(CB added)
 //================================================================================
@@ -384,6 +384,17 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 				return GE_FALSE;
 			}
 			BSP->NumGFXTexData = Chunk->Elements;
+
+			// The texture data is only read, while the world is being created out of this file,
+			// so if the file is mapped we use it right where it is
+			BSP->GFXTexData = (uint8*)geVFile_GetMappedView(f, sizeof(uint8)*BSP->NumGFXTexData);
+			if (BSP->GFXTexData)
+			{
+				BSP->GFXTexDataMapped = GE_TRUE;
+				break;
+			}
+
+			BSP->GFXTexDataMapped = GE_FALSE;
 			BSP->GFXTexData = (uint8*)geRam_Allocate(sizeof(uint8)*BSP->NumGFXTexData);
 			if (!ReadChunkData(Chunk, (void*)BSP->GFXTexData, f))
 				return GE_FALSE;
@@ -464,7 +475,13 @@ static geBoolean ReadChunk(GBSP_BSPData *BSP, GBSP_Chunk *Chunk, geVFile *f)
 
 		case GBSP_CHUNK_MOTIONS:
 		{
+			long	Position;
+
 //		printf("GBSP_CHUNK_MOTIONS\n");
+			// Remember where they are, so a baked copy of this file can get them back
+			if (geVFile_Tell(f, &Position) == GE_FALSE)
+				return GE_FALSE;
+			BSP->MotionsOffset = (int32)Position;
 			return LoadMotions(BSP, f);
 		}
 
@@ -506,6 +523,23 @@ BOOL GBSP_LoadGBSPFile(geVFile *File, GBSP_BSPData *BSP)
 	return TRUE;
 }
 
+//========================================================================================
+//	GBSP_LoadGBSPMotions
+//	Reads the motions chunk data, with File at BSP->MotionsOffset.  For when the rest of
+//	BSP didn't come from File.
+//========================================================================================
+geBoolean GBSP_LoadGBSPMotions(geVFile *File, GBSP_BSPData *BSP)
+{
+	assert(File);
+	assert(BSP);
+	assert(BSP->MotionsOffset > 0);
+
+	if (!geVFile_Seek(File, BSP->MotionsOffset, GE_VFILE_SEEKSET))
+		return GE_FALSE;
+
+	return LoadMotions(BSP, File);
+}
+
 //========================================================================================
 //	GBSP_FreeGBSPFile
 //========================================================================================
@@ -517,9 +551,40 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 		for	(i = 0; i < BSP->NumGFXModels; i++)
 			if (BSP->GFXModels[i].Motion != NULL)
 				geMotion_Destroy(&(BSP->GFXModels[i].Motion));
-		geRam_Free(BSP->GFXModels);
 	}
 
+	if (BSP->GFXBlob)
+	{
+		// Everything but the texdata is in the blob
+		geRam_Free(BSP->GFXBlob);
+
+		BSP->GFXModels = NULL;
+		BSP->GFXNodes = NULL;
+		BSP->GFXBNodes = NULL;
+		BSP->GFXLeafs = NULL;
+		BSP->GFXClusters = NULL;
+		BSP->GFXAreas = NULL;
+		BSP->GFXAreaPortals = NULL;
+		BSP->GFXPortals = NULL;
+		BSP->GFXPlanes = NULL;
+		BSP->GFXFaces = NULL;
+		BSP->GFXLeafFaces = NULL;
+		BSP->GFXLeafSides = NULL;
+		BSP->GFXVerts = NULL;
+		BSP->GFXVertIndexList = NULL;
+		BSP->GFXRGBVerts = NULL;
+		BSP->GFXTextures = NULL;
+		BSP->GFXTexInfo = NULL;
+		BSP->GFXPalettes = NULL;
+		BSP->GFXEntData = NULL;
+		BSP->GFXLightData = NULL;
+		BSP->GFXVisData = NULL;
+		BSP->GFXBlob = NULL;
+	}
+
+	if (BSP->GFXModels)
+		geRam_Free(BSP->GFXModels);
+
 	if (BSP->GFXNodes)
 		geRam_Free(BSP->GFXNodes);
 	if (BSP->GFXBNodes)
@@ -552,7 +617,7 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 		geRam_Free(BSP->GFXTextures);
 	if (BSP->GFXTexInfo)
 		geRam_Free(BSP->GFXTexInfo);
-	if (BSP->GFXTexData)
+	if (BSP->GFXTexData && !BSP->GFXTexDataMapped)
 		geRam_Free(BSP->GFXTexData);
 	if (BSP->GFXPalettes)
 		geRam_Free(BSP->GFXPalettes);
@@ -582,6 +647,7 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 	BSP->GFXTextures = NULL;
 	BSP->GFXTexInfo = NULL;
 	BSP->GFXTexData = NULL;
+	BSP->GFXTexDataMapped = GE_FALSE;
 	BSP->GFXPalettes = NULL;
 
 	BSP->GFXLightData = NULL;
@@ -612,6 +678,8 @@ BOOL GBSP_FreeGBSPFile(GBSP_BSPData *BSP)
 	BSP->NumGFXVisData = 0;
 	BSP->NumGFXPortals = 0;
 
+	BSP->MotionsOffset = 0;
+
 	return TRUE;
 }
 
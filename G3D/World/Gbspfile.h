@@ -312,12 +312,16 @@ typedef struct
 	GFX_Texture		*GFXTextures;		// Textures
 	GFX_TexInfo		*GFXTexInfo;		// TexInfo
 	uint8			*GFXTexData;		// TexData
+	geBoolean		GFXTexDataMapped;	// GFXTexData points into the file, and isn't ours to free
 	DRV_Palette		*GFXPalettes;		// Texture palettes
 
 	uint8			*GFXLightData;		// Lightmap data
 	uint8			*GFXVisData;		// Vis data
 	GFX_Portal		*GFXPortals;		// Portal data
 
+	uint8			*GFXBlob;			// If set, the arrays above all point into this (see BSPCache.c)
+	int32			MotionsOffset;		// Where the motions chunk data starts in the file, 0 if there isn't one
+
 	int32			NumGFXModels;
 	int32			NumGFXNodes;
 	int32			NumGFXBNodes;
@@ -347,6 +351,7 @@ typedef struct
 
 geBoolean GBSP_LoadGBSPFile(geVFile *File, GBSP_BSPData *BSP);
 geBoolean GBSP_FreeGBSPFile(GBSP_BSPData *BSP);
+geBoolean GBSP_LoadGBSPMotions(geVFile *File, GBSP_BSPData *BSP);
 
 #ifdef __cplusplus
 }
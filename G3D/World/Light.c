@@ -34,6 +34,7 @@
 #include "World.h"
 
 #include "Trace.h"
+#include "LightKernel.h"
 
 #define LIGHT_FRACT		8
 //=====================================================================================
@@ -53,6 +54,45 @@ static	int32			TempRGB32[MAX_LMAP_SIZE*MAX_LMAP_SIZE*3];
 static	DRV_RGB			TempRGBFog[MAX_LMAP_SIZE*MAX_LMAP_SIZE];
 static	int32			TempRGB32Fog[MAX_LMAP_SIZE*MAX_LMAP_SIZE*3];
 
+//
+//	Lightmap cache
+//	Light_SetupLightmap gets called for every visible lit face, every frame, but most
+//	styles only step at 10hz, and dlights don't move every frame.  So the last
+//	result is kept with everything that went into it, and only built again when
+//	something in there is different.
+//
+//	Shadowed dlights aren't cached, since their shadows come from models and doors
+//	that can move without anything in the key changing.  Fog isn't cached either,
+//	since it's traced from the eye and so changes whenever the camera moves.
+//
+#define LIGHT_CACHE_MAX_DLIGHTS		8		// Faces lit by more dlights than this are just built every time
+
+typedef struct
+{
+	geVec3d			Pos;
+	geFloat			Radius;
+	uint32			FColorR;
+	uint32			FColorG;
+	uint32			FColorB;
+} Light_CacheDLight;
+
+typedef struct
+{
+	int32			Intensities[4];			// LTypeIntensities of each style on the face
+	int32			NumDLights;
+	Light_CacheDLight	DLights[LIGHT_CACHE_MAX_DLIGHTS];
+} Light_LMapKey;
+
+typedef struct Light_LMapCache
+{
+	int32			LMapSize;
+
+	geBoolean		Valid;					// GE_TRUE if RGB was built from Key
+	Light_LMapKey	Key;
+	geBoolean		DLightHit;				// GE_TRUE if a dlight touched the lightmap
+	DRV_RGB			*RGB;					// Allocated the first time the face is built
+} Light_LMapCache;
+
 // Fast sqrt stuff
 // MOST_SIG_OFFSET gives the (int *) offset from the address of the double
 // to the part of the number containing the sign and exponent.
@@ -97,7 +137,7 @@ static void SetupColorLight2(DRV_RGB *light1, DRV_RGB *RGBM, int32 lw, int32 lh,
 static BOOL CombineDLightWithRGBMap(int32 *LightData, Light_DLight *Light, GFX_Face *Face, Surf_SurfInfo *SInfo);
 static BOOL CombineDLightWithRGBMapWithShadow(int32 *LightData, Light_DLight *Light, GFX_Face *Face, Surf_SurfInfo *SInfo);
 static void BuildLightLUTS(geEngine *Engine);
-static void SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 LNum, int32 Node);
+static geBoolean SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 Node, geBoolean WorldTree);
 
 static void AddLightType0(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh);
 static void AddLightType(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh, int32 Intensity);
@@ -107,6 +147,10 @@ static void AddLightTypeWavy(int32 *LightDest, uint8 *LightData, int32 lw, int32
 
 static void InitSqrtTab(void);
 static FastSqrtFloat FastSqrt(FastSqrtFloat f);
+
+static Light_LMapCache *GetLMapCache(int32 FaceNum, int32 LMapSize);
+static void FreeLMapCaches(Light_LightInfo *Info);
+static void FreeDLights(Light_LightInfo *Info);
 //=====================================================================================
 //	Global support functions
 //=====================================================================================
@@ -120,6 +164,8 @@ geBoolean Light_EngineInit(geEngine *Engine)
 
 	InitSqrtTab();
 
+	LightKernel_Init();
+
 	return GE_TRUE;
 }
 
@@ -165,6 +211,9 @@ void Light_WorldShutdown(geWorld *World)
 	if (!World->LightInfo)
 		return;
 
+	FreeLMapCaches(World->LightInfo);
+	FreeDLights(World->LightInfo);
+
 	geRam_Free(World->LightInfo);
 
 	World->LightInfo = NULL;
@@ -743,13 +792,148 @@ static geBoolean FogLightmap2(geFog *Fog, int32 *LightData, GFX_Face *Face, Surf
 	return Hit;
 }
 
+//=====================================================================================
+//	GetLMapCache
+//	Returns the cache for a face, making it if it's not there yet (NULL if out of memory)
+//=====================================================================================
+static Light_LMapCache *GetLMapCache(int32 FaceNum, int32 LMapSize)
+{
+	Light_LMapCache	*Cache;
+
+	assert(LightInfo != NULL);
+	assert(FaceNum >= 0 && FaceNum < BSPData->NumGFXFaces);
+
+	if (!LightInfo->LMapCache)
+	{
+		LightInfo->LMapCache = GE_RAM_ALLOCATE_ARRAY(Light_LMapCache*, BSPData->NumGFXFaces);
+
+		if (!LightInfo->LMapCache)
+			return NULL;
+
+		memset(LightInfo->LMapCache, 0, sizeof(Light_LMapCache*)*BSPData->NumGFXFaces);
+		LightInfo->NumLMapCache = BSPData->NumGFXFaces;
+	}
+
+	Cache = LightInfo->LMapCache[FaceNum];
+
+	if (Cache)
+	{
+		assert(Cache->LMapSize == LMapSize);
+		return Cache;
+	}
+
+	Cache = GE_RAM_ALLOCATE_STRUCT(Light_LMapCache);
+
+	if (!Cache)
+		return NULL;
+
+	memset(Cache, 0, sizeof(Light_LMapCache));
+
+	Cache->LMapSize = LMapSize;
+
+	LightInfo->LMapCache[FaceNum] = Cache;
+
+	return Cache;
+}
+
+//=====================================================================================
+//	FreeLMapCaches
+//=====================================================================================
+static void FreeLMapCaches(Light_LightInfo *Info)
+{
+	int32		i;
+
+	if (!Info->LMapCache)
+		return;
+
+	for (i=0; i< Info->NumLMapCache; i++)
+	{
+		Light_LMapCache	*Cache;
+
+		Cache = Info->LMapCache[i];
+
+		if (!Cache)
+			continue;
+
+		if (Cache->RGB)
+			geRam_Free(Cache->RGB);
+
+		geRam_Free(Cache);
+	}
+
+	geRam_Free(Info->LMapCache);
+
+	Info->LMapCache = NULL;
+	Info->NumLMapCache = 0;
+}
+
+//=====================================================================================
+//	BuildLMapKey
+//	Fills in everything the lightmap gets built from.  Returns GE_FALSE if the face
+//	can't be cached (wavy styles change every frame, too many dlights won't fit, and
+//	shadowed dlights depend on models that aren't in the key).
+//=====================================================================================
+static geBoolean BuildLMapKey(Light_LMapKey *Key, GFX_Face *Face, Surf_SurfInfo *SInfo, geBoolean HasDLight)
+{
+	int32			MapNum, SIndex, Ln;
+
+	// Zero it all, so keys can be compared with memcmp
+	memset(Key, 0, sizeof(Light_LMapKey));
+
+	if (Face->LightOfs >= 0)
+	{
+		for (MapNum = 0; MapNum < 4; MapNum++) 
+		{
+			SIndex = Face->LTypes[MapNum];
+			
+			if (SIndex == 255)
+				break;
+
+			if (SIndex == 11)
+				return GE_FALSE;
+
+			Key->Intensities[MapNum] = LightInfo->LTypeIntensities[SIndex];
+		}
+	}
+
+	if (HasDLight)
+	{
+		for (Ln = SInfo->DLights; Ln != -1; Ln = LightInfo->DLightRefs[Ln].Next)
+		{
+			Light_CacheDLight	*KeyLight;
+			Light_DLight		*DLights;
+
+			DLights = LightInfo->DLightRefs[Ln].Light;
+
+			if (!DLights->Active)			// Removed since the lists were built
+				continue;
+
+			if (DLights->CastShadow)
+				return GE_FALSE;
+
+			if (Key->NumDLights >= LIGHT_CACHE_MAX_DLIGHTS)
+				return GE_FALSE;
+
+			KeyLight = &Key->DLights[Key->NumDLights++];
+
+			KeyLight->Pos = DLights->Pos;
+			KeyLight->Radius = DLights->Radius;
+			KeyLight->FColorR = DLights->FColorR;
+			KeyLight->FColorG = DLights->FColorG;
+			KeyLight->FColorB = DLights->FColorB;
+		}
+	}
+
+	return GE_TRUE;
+}
+
 //=====================================================================================
 //	Light_SetupLightmap
 //=====================================================================================
 void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 {
 	int32			LightOffset;
-	geBoolean		IsDyn, HasDLight;
+	geBoolean		IsDyn, HasDLight, DLightHit;
 	int32			NumLTypes;
 	int32			i, Ln;
 	Surf_SurfInfo	*SInfo;
@@ -759,6 +943,8 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 	int32			lWidth, lHeight, LMapSize, MapNum, SIndex;
 	int32			*pRGB1;
 	DRV_RGB			*pRGB2;
+	Light_LMapCache	*Cache;
+	Light_LMapKey	Key;
 
 	assert (CBSP != NULL);
 	assert(BSPData != NULL);
@@ -778,7 +964,8 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 	lHeight = LInfo->Height;
 	LMapSize = lHeight * lWidth;
 
-	IsDyn = HasDLight = GE_FALSE;
+	IsDyn = HasDLight = DLightHit = GE_FALSE;
+	Cache = NULL;
 
 	if (SInfo->DLightFrame == CWorld->CurFrameDynamic)
 	if (LightInfo->NumDynamicLights > 0 && !(BSPData->GFXTexInfo[Face->TexInfo].Flags & TEXINFO_FULLBRIGHT)) 
@@ -794,6 +981,34 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 		goto FogOnly;
 	}
 
+	// Styles that stepped this frame still make the face dynamic, even if the last map is good
+	if (LightOffset >= 0)
+	{
+		for (MapNum = 0; MapNum < 4 && Face->LTypes[MapNum] != 255; MapNum++) 
+		{
+			if (LightInfo->LTypeDynamic[Face->LTypes[MapNum]])
+				IsDyn = GE_TRUE;
+		}
+	}
+
+	if (BuildLMapKey(&Key, Face, SInfo, HasDLight))
+	{
+		Cache = GetLMapCache(LInfo->Face, LMapSize);
+
+		// If nothing that goes into the lightmap is different, the last one is still good
+		if (Cache && Cache->Valid && !memcmp(&Cache->Key, &Key, sizeof(Key)))
+		{
+			if (Cache->DLightHit)
+				IsDyn = GE_TRUE;
+
+			LInfo->RGBLight[0] = Cache->RGB;
+			goto FogOnly;
+		}
+
+		if (Cache && !Cache->RGB)
+			Cache->RGB = GE_RAM_ALLOCATE_ARRAY(DRV_RGB, LMapSize);
+	}
+
 	CEngine->DebugInfo.LMap1++;
 
 	// If there is light data
@@ -847,14 +1062,13 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 	// Tack on dynamic lights
 	if (HasDLight)
 	{
-		Light_DLight	*DLights = LightInfo->DynamicLights;
-
-		for (Ln = 0; Ln <MAX_DYNAMIC_LIGHTS; Ln++, DLights++) 
+		for (Ln = SInfo->DLights; Ln != -1; Ln = LightInfo->DLightRefs[Ln].Next)
 		{
-			if (!DLights->Active) 
-				continue;
+			Light_DLight	*DLights;
+
+			DLights = LightInfo->DLightRefs[Ln].Light;
 
-			if (!(SInfo->DLights & (1<<Ln)))
+			if (!DLights->Active)			// Removed since the lists were built
 				continue;
 
 			CEngine->DebugInfo.NumDLights++;
@@ -862,48 +1076,35 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 			if (DLights->CastShadow)
 			{
 				if (CombineDLightWithRGBMapWithShadow(TempRGB32, DLights, Face, SInfo))
-					IsDyn = GE_TRUE;
+					DLightHit = GE_TRUE;
 			}
 			else
 			{
 				if (CombineDLightWithRGBMap(TempRGB32, DLights, Face, SInfo))
-					IsDyn = GE_TRUE;
+					DLightHit = GE_TRUE;
 			}
 		}
+
+		if (DLightHit)
+			IsDyn = GE_TRUE;
 	}
 
 	// Put the light into a driver compatible pointer, and clamp it 
 	pRGB1 = TempRGB32;
-	pRGB2 = TempRGB;
-	for (i=0; i< LMapSize; i++)
+	pRGB2 = (Cache && Cache->RGB) ? Cache->RGB : TempRGB;
+
+	// Point the lightmap to the data
+	LInfo->RGBLight[0] = pRGB2;
+
+	LightKernel_Clamp(pRGB2, pRGB1, LMapSize*3, LIGHT_FRACT);
+
+	if (Cache && Cache->RGB)
 	{
-		Intensity = (*pRGB1++) >> LIGHT_FRACT;
-		if (Intensity > 255)
-			Intensity = 255;
-		else if (Intensity < 0 )
-			Intensity = 0;
-		pRGB2->r = (uint8)Intensity;
-
-		Intensity = (*pRGB1++) >> LIGHT_FRACT;
-		if (Intensity > 255)
-			Intensity = 255;
-		else if (Intensity < 0 )
-			Intensity = 0;
-		pRGB2->g = (uint8)Intensity;
-
-		Intensity = (*pRGB1++) >> LIGHT_FRACT;
-		if (Intensity > 255)
-			Intensity = 255;
-		else if (Intensity < 0 )
-			Intensity = 0;
-		pRGB2->b = (uint8)Intensity;
-
-		pRGB2++;
+		Cache->Key = Key;
+		Cache->DLightHit = DLightHit;
+		Cache->Valid = GE_TRUE;
 	}
 	
-	// Point the lightmap to the data
-	LInfo->RGBLight[0] = TempRGB;
-
 	FogOnly:		// Jump to here, for fog lightmap only...
 
 	//
@@ -945,25 +1146,9 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 			// Put the light into a driver compatible pointer, and clamp it 
 			pRGB1 = TempRGB32Fog;
 			pRGB2 = TempRGBFog;
-			for (i=0; i< LMapSize; i++)
-			{
-				Intensity = (*pRGB1++) >> LIGHT_FRACT;
-				if (Intensity > 255)
-					Intensity = 255;
-				pRGB2->r = (uint8)Intensity;
-
-				Intensity = (*pRGB1++) >> LIGHT_FRACT;
-				if (Intensity > 255)
-					Intensity = 255;
-				pRGB2->g = (uint8)Intensity;
-
-				Intensity = (*pRGB1++) >> LIGHT_FRACT;
-				if (Intensity > 255)
-					Intensity = 255;
-				pRGB2->b = (uint8)Intensity;
-
-				pRGB2++;
-			}
+
+			LightKernel_ClampHigh(pRGB2, pRGB1, LMapSize*3, LIGHT_FRACT);
+
 			IsDyn = TRUE;			// Force this face to be dynamic
 			LInfo->RGBLight[1] = TempRGBFog;
 		}
@@ -981,17 +1166,10 @@ void Light_SetupLightmap(DRV_LInfo *LInfo, BOOL *Dynamic)
 //=====================================================================================
 static void AddLightType(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh, int32 Intensity)
 {	
-	int32	h;
-
 	assert(LightDest != NULL);
 	assert(LightData != NULL);
 
-	for (h = 0; h < lw*lh; h++)
-	{
-		*LightDest++ += *LightData++ * Intensity;
-		*LightDest++ += *LightData++ * Intensity;
-		*LightDest++ += *LightData++ * Intensity;
-	}
+	LightKernel_Add(LightDest, LightData, lw*lh*3, Intensity);
 }
 
 //=====================================================================================
@@ -999,17 +1177,10 @@ static void AddLightType(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh,
 //=====================================================================================
 static void AddLightType0(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh)
 {	
-	int32	h;
-
 	assert(LightDest != NULL);
 	assert(LightData != NULL);
 
-	for (h = 0; h < lw*lh; h++)
-	{
-		*LightDest++ = (*LightData++) << LIGHT_FRACT;
-		*LightDest++ = (*LightData++) << LIGHT_FRACT;
-		*LightDest++ = (*LightData++) << LIGHT_FRACT;
-	}
+	LightKernel_Set0(LightDest, LightData, lw*lh*3, LIGHT_FRACT);
 }
 
 //=====================================================================================
@@ -1017,17 +1188,10 @@ static void AddLightType0(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh
 //=====================================================================================
 static void AddLightType1(int32 *LightDest, uint8 *LightData, int32 lw, int32 lh, int32 Intensity)
 {	
-	int32	h;
-
 	assert(LightDest != NULL);
 	assert(LightData != NULL);
 
-	for (h = 0; h < lw*lh; h++)
-	{
-		*LightDest++ = *LightData++ * Intensity;
-		*LightDest++ = *LightData++ * Intensity;
-		*LightDest++ = *LightData++ * Intensity;
-	}
+	LightKernel_Set(LightDest, LightData, lw*lh*3, Intensity);
 }
 
 //=====================================================================================
@@ -1269,35 +1433,40 @@ geBoolean Light_SetupLights(geWorld *World)
 	// Update the intensity tables for dynamic ltyped lighting
 	UpdateLTypeTables(World);
 
-	DLights = LightInfo->DynamicLights;
-
-#if 0
-	Node = BSPData->GFXModels[0].RootNode[0];
-
-	for (i=0; i< MAX_DYNAMIC_LIGHTS; i++, DLights++)
-	{
-		if (!DLights->Active)
-			continue;
+	// Last frames lists are all stale now (the faces and leafs see it by their DLightFrame)
+	LightInfo->NumDLightRefs = 0;
 
-		SetupDynamicLight_r(DLights, &DLights->Pos, i, Node);
-	}
-#else
-	for (i=0; i< MAX_DYNAMIC_LIGHTS; i++, DLights++)
+	for (i=0; i< LightInfo->NumDynamicLights; i++)
 	{
 		int32		m;
 		geVec3d		NewPos;
 		geWorld_Model *Model;
 
-		if (!DLights->Active)
-			continue;
+		DLights = LightInfo->DynamicLights[i];
+
+		assert(DLights->Active);
+
+		// The world tree always gets walked, so every leaf the light reaches knows about it
+		Node = BSPData->GFXModels[0].RootNode[0];
+
+		if (!SetupDynamicLight_r(DLights, &DLights->Pos, Node, GE_TRUE))
+			return GE_FALSE;
 
-		Model = CBSP->Models;
+		Model = &CBSP->Models[1];
 
-		for (m=0; m< BSPData->NumGFXModels; m++, Model++)
+		for (m=1; m< BSPData->NumGFXModels; m++, Model++)
 		{
 			if (Model->VisFrame != World->CurFrameDynamic)
 				continue;
 
+			// Don't bother with models the light can't reach
+			if (DLights->Pos.X + DLights->Radius < Model->TMins.X || DLights->Pos.X - DLights->Radius > Model->TMaxs.X)
+				continue;
+			if (DLights->Pos.Y + DLights->Radius < Model->TMins.Y || DLights->Pos.Y - DLights->Radius > Model->TMaxs.Y)
+				continue;
+			if (DLights->Pos.Z + DLights->Radius < Model->TMins.Z || DLights->Pos.Z - DLights->Radius > Model->TMaxs.Z)
+				continue;
+
 			Node = BSPData->GFXModels[m].RootNode[0];
 			
 			geVec3d_Subtract(&DLights->Pos, &Model->Pivot, &NewPos);
@@ -1306,13 +1475,75 @@ geBoolean Light_SetupLights(geWorld *World)
 			
 			geVec3d_Add(&NewPos , &Model->Pivot, &NewPos);
 
-			SetupDynamicLight_r(DLights, &NewPos, i, Node);
+			if (!SetupDynamicLight_r(DLights, &NewPos, Node, GE_FALSE))
+				return GE_FALSE;
 		}
 	}
-#endif
 
 	return GE_TRUE;
 }
+
+//=====================================================================================
+//	Light_WorldGetFirstDLight
+//	Starts a walk of the dynamic lights that can reach Pos this frame (the ones binned
+//	into it's leaf by Light_SetupLights).  Every light the walk gives back still needs
+//	it's radius checked.
+//=====================================================================================
+Light_DLight *Light_WorldGetFirstDLight(geWorld *World, const geVec3d *Pos, int32 *Ref)
+{
+	Light_LightInfo	*LInfo;
+	geWorld_Leaf	*pLeaf;
+	int32			Leaf;
+
+	assert(World != NULL);
+	assert(Pos != NULL);
+	assert(Ref != NULL);
+
+	LInfo = World->LightInfo;
+
+	*Ref = -1;
+
+	if (!LInfo->NumDynamicLights || !World->CurrentBSP)
+		return NULL;
+
+	if (!geWorld_GetLeaf(World, Pos, &Leaf))
+		return NULL;
+
+	pLeaf = &World->CurrentBSP->LeafData[Leaf];
+
+	if (pLeaf->DLightFrame != World->CurFrameDynamic)
+		return NULL;
+
+	*Ref = pLeaf->DLights;
+
+	assert(*Ref >= 0 && *Ref < LInfo->NumDLightRefs);
+
+	return LInfo->DLightRefs[*Ref].Light;
+}
+
+//=====================================================================================
+//	Light_WorldGetNextDLight
+//=====================================================================================
+Light_DLight *Light_WorldGetNextDLight(geWorld *World, int32 *Ref)
+{
+	Light_LightInfo	*LInfo;
+
+	assert(World != NULL);
+	assert(Ref != NULL);
+
+	if (*Ref == -1)
+		return NULL;
+
+	LInfo = World->LightInfo;
+
+	*Ref = LInfo->DLightRefs[*Ref].Next;
+
+	if (*Ref == -1)
+		return NULL;
+
+	return LInfo->DLightRefs[*Ref].Light;
+}
+
 //=====================================================================================
 //	Light_WorldGetLTypeCurent
 //=====================================================================================
@@ -1361,6 +1592,85 @@ static void UpdateLTypeTables(geWorld *World)
 	}
 }   
 
+//=====================================================================================
+//	AddDLightBlock
+//	Makes room for LIGHT_DLIGHT_BLOCK more lights
+//=====================================================================================
+static geBoolean AddDLightBlock(Light_LightInfo *LInfo)
+{
+	Light_DLight	*Block, **NewBlocks, **NewLights;
+	int32			i, NumLights;
+
+	Block = GE_RAM_ALLOCATE_ARRAY(Light_DLight, LIGHT_DLIGHT_BLOCK);
+
+	if (!Block)
+		return GE_FALSE;
+
+	NumLights = (LInfo->NumDLightBlocks+1)*LIGHT_DLIGHT_BLOCK;
+
+	NewBlocks = geRam_Realloc(LInfo->DLightBlocks, sizeof(Light_DLight*)*(LInfo->NumDLightBlocks+1));
+
+	if (!NewBlocks)
+	{
+		geRam_Free(Block);
+		return GE_FALSE;
+	}
+
+	LInfo->DLightBlocks = NewBlocks;
+
+	// The packed list has room for every light there is, so it never needs to grow anywhere else
+	NewLights = geRam_Realloc(LInfo->DynamicLights, sizeof(Light_DLight*)*NumLights);
+
+	if (!NewLights)
+	{
+		geRam_Free(Block);
+		return GE_FALSE;
+	}
+
+	LInfo->DynamicLights = NewLights;
+	LInfo->DLightBlocks[LInfo->NumDLightBlocks++] = Block;
+
+	memset(Block, 0, sizeof(Light_DLight)*LIGHT_DLIGHT_BLOCK);
+
+	// Put them on the free list, so they get handed out in order
+	for (i=LIGHT_DLIGHT_BLOCK-1; i>= 0; i--)
+	{
+		Block[i].NextFree = LInfo->FreeDLights;
+		LInfo->FreeDLights = &Block[i];
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	FreeDLights
+//=====================================================================================
+static void FreeDLights(Light_LightInfo *LInfo)
+{
+	int32		i;
+
+	for (i=0; i< LInfo->NumDLightBlocks; i++)
+		geRam_Free(LInfo->DLightBlocks[i]);
+
+	if (LInfo->DLightBlocks)
+		geRam_Free(LInfo->DLightBlocks);
+
+	if (LInfo->DynamicLights)
+		geRam_Free(LInfo->DynamicLights);
+
+	if (LInfo->DLightRefs)
+		geRam_Free(LInfo->DLightRefs);
+
+	LInfo->DLightBlocks = NULL;
+	LInfo->NumDLightBlocks = 0;
+	LInfo->FreeDLights = NULL;
+	LInfo->DynamicLights = NULL;
+	LInfo->NumDynamicLights = 0;
+	LInfo->DLightRefs = NULL;
+	LInfo->NumDLightRefs = 0;
+	LInfo->MaxDLightRefs = 0;
+}
+
 //=====================================================================================
 //	Light_WorldAddLight
 //=====================================================================================
@@ -1368,7 +1678,6 @@ Light_DLight *Light_WorldAddLight(geWorld *World)
 {
 	Light_LightInfo	*LInfo;
 	Light_DLight	*DLights;
-	int32			i;
 
 	assert(World != NULL);
 
@@ -1376,26 +1685,25 @@ Light_DLight *Light_WorldAddLight(geWorld *World)
 
 	assert(LInfo);
 
-	DLights = LInfo->DynamicLights;
-
-	for (i=0; i< MAX_DYNAMIC_LIGHTS; i++, DLights++)
+	if (!LInfo->FreeDLights)
 	{
-		if (!DLights->Active)
-			break;
+		if (!AddDLightBlock(LInfo))
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return  NULL;
+		}
 	}
 
-	if (i >= MAX_DYNAMIC_LIGHTS)
-	{
-		geErrorLog_Add(GE_ERR_RENDERQ_OVERFLOW, NULL);
-		return  NULL;
-	}
+	DLights = LInfo->FreeDLights;
+	LInfo->FreeDLights = DLights->NextFree;
 
 	// Set it's attributes to some default...
 	memset(DLights, 0, sizeof(Light_DLight));
 
 	DLights->Active = GE_TRUE;
-	LInfo->NumDynamicLights++;
+	DLights->Index = LInfo->NumDynamicLights;
 	
+	LInfo->DynamicLights[LInfo->NumDynamicLights++] = DLights;
 
 	return DLights;
 }
@@ -1405,6 +1713,9 @@ Light_DLight *Light_WorldAddLight(geWorld *World)
 //=====================================================================================
 void Light_WorldRemoveLight(geWorld *World, Light_DLight *DLight)
 {
+	Light_LightInfo	*LInfo;
+	Light_DLight	*Last;
+
 	assert(World);
 	assert(World->LightInfo);
 	assert(DLight);
@@ -1413,8 +1724,20 @@ void Light_WorldRemoveLight(geWorld *World, Light_DLight *DLight)
 	if (!DLight->Active)
 		return;
 
+	LInfo = World->LightInfo;
+
+	assert(DLight->Index >= 0 && DLight->Index < LInfo->NumDynamicLights);
+	assert(LInfo->DynamicLights[DLight->Index] == DLight);
+
+	// Move the last one into it's slot
+	Last = LInfo->DynamicLights[--LInfo->NumDynamicLights];
+	LInfo->DynamicLights[DLight->Index] = Last;
+	Last->Index = DLight->Index;
+
 	DLight->Active = GE_FALSE;
-	World->LightInfo->NumDynamicLights--;
+	DLight->Index = -1;
+	DLight->NextFree = LInfo->FreeDLights;
+	LInfo->FreeDLights = DLight;
 }
 
 //=====================================================================================
@@ -1778,19 +2101,78 @@ static void BuildLightLUTS(geEngine *Engine)
 	}
 }
 
+//=====================================================================================
+//	AddDLightRef
+//	Puts Light on the front of a list, returns the new head, or -1 if out of memory
+//=====================================================================================
+static int32 AddDLightRef(Light_DLight *Light, int32 Next)
+{
+	Light_DLightRef	*Ref;
+
+	if (LightInfo->NumDLightRefs >= LightInfo->MaxDLightRefs)
+	{
+		Light_DLightRef	*NewRefs;
+		int32			NewMax;
+
+		NewMax = LightInfo->MaxDLightRefs ? LightInfo->MaxDLightRefs*2 : 1024;
+
+		NewRefs = geRam_Realloc(LightInfo->DLightRefs, sizeof(Light_DLightRef)*NewMax);
+
+		if (!NewRefs)
+		{
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+			return -1;
+		}
+
+		LightInfo->DLightRefs = NewRefs;
+		LightInfo->MaxDLightRefs = NewMax;
+	}
+
+	Ref = &LightInfo->DLightRefs[LightInfo->NumDLightRefs];
+
+	Ref->Light = Light;
+	Ref->Next = Next;
+
+	return LightInfo->NumDLightRefs++;
+}
+
 //=====================================================================================
 //	SetupDynamicLight_r
+//	Adds the light to the lists of the faces it touches.  On the world tree, it also goes
+//	into the list of every leaf it reaches, and faces are only done in visible nodes.
 //=====================================================================================
-static void SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 LNum, int32 Node)
+static geBoolean SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 Node, geBoolean WorldTree)
 {
 	geFloat			Dist;
 	GFX_Plane		*pPlane;
 	GFX_Node		*pNode;
 	Surf_SurfInfo	*pSInfo;
-	int32			i;
+	int32			i, Ref;
 
 	if (Node < 0)	// Hit a leaf no more searching
-		return;
+	{
+		geWorld_Leaf	*pLeaf;
+
+		if (!WorldTree)
+			return GE_TRUE;
+
+		pLeaf = &CBSP->LeafData[-(Node+1)];
+
+		if (pLeaf->DLightFrame != CWorld->CurFrameDynamic)
+		{
+			pLeaf->DLightFrame = CWorld->CurFrameDynamic;
+			pLeaf->DLights = -1;
+		}
+
+		Ref = AddDLightRef(pLight, pLeaf->DLights);
+
+		if (Ref == -1)
+			return GE_FALSE;
+
+		pLeaf->DLights = Ref;
+
+		return GE_TRUE;
+	}
 
 	pNode = &BSPData->GFXNodes[Node];
 	pPlane = &BSPData->GFXPlanes[pNode->PlaneNum];
@@ -1798,35 +2180,40 @@ static void SetupDynamicLight_r(Light_DLight *pLight, geVec3d *Pos, int32 LNum,
 	Dist = Plane_PlaneDistanceFast(pPlane, Pos);
 
 	if (Dist > pLight->Radius)
-	{
-		SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[0]);
-		return;
-	}
+		return SetupDynamicLight_r(pLight, Pos, BSPData->GFXNodes[Node].Children[0], WorldTree);
+	
 	if (Dist <-pLight->Radius)
-	{
-		SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[1]);
-		return;
-	}
+		return SetupDynamicLight_r(pLight, Pos, BSPData->GFXNodes[Node].Children[1], WorldTree);
 
 	// The light is within range of this plane, mark it and go down both sides
-	pSInfo = &CBSP->SurfInfo[pNode->FirstFace];
-	for (i=0; i< pNode->NumFaces; i++, pSInfo++)
+	// (nodes that won't be drawn this frame are skipped, like World.c does)
+	if (!WorldTree || !CWorld->VisInfo || CBSP->NodeVisFrame[Node] == CWorld->CurFrameStatic)
 	{
-		if (!Surf_InSurfBoundingBox(pSInfo, Pos, pLight->Radius) ) 
-			continue;
-		
-		if (pSInfo->DLightFrame != CWorld->CurFrameDynamic)
+		pSInfo = &CBSP->SurfInfo[pNode->FirstFace];
+		for (i=0; i< pNode->NumFaces; i++, pSInfo++)
 		{
-			pSInfo->DLightFrame = CWorld->CurFrameDynamic;
-			pSInfo->DLights = 0;
+			if (!Surf_InSurfBoundingBox(pSInfo, Pos, pLight->Radius) ) 
+				continue;
+			
+			if (pSInfo->DLightFrame != CWorld->CurFrameDynamic)
+			{
+				pSInfo->DLightFrame = CWorld->CurFrameDynamic;
+				pSInfo->DLights = -1;
+			}
+			
+			Ref = AddDLightRef(pLight, pSInfo->DLights);
+
+			if (Ref == -1)
+				return GE_FALSE;
+
+			pSInfo->DLights = Ref;
 		}
-		
-		// We might need to go to a linked list, if more than 32 lights are needed
-		pSInfo->DLights |= 1<<LNum;
 	}
 
-	SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[0]);
-	SetupDynamicLight_r(pLight, Pos, LNum, BSPData->GFXNodes[Node].Children[1]);
+	if (!SetupDynamicLight_r(pLight, Pos, BSPData->GFXNodes[Node].Children[0], WorldTree))
+		return GE_FALSE;
+
+	return SetupDynamicLight_r(pLight, Pos, BSPData->GFXNodes[Node].Children[1], WorldTree);
 }
 
 //=====================================================================================
@@ -37,13 +37,13 @@ extern "C" {
 //=====================================================================================
 //	Defines / Structure defines
 //=====================================================================================
-#define MAX_DYNAMIC_LIGHTS		64	// Maximum number of moving lights in map
+#define LIGHT_DLIGHT_BLOCK		64	// Dynamic lights are allocated this many at a time
 #define MAX_LTYPES				24	// Max number of ltypes
 //#define	MAX_LMAP_SIZE			128
 //#define	MAX_LMAP_SIZE			18
 #define	MAX_LMAP_SIZE			36
 
-typedef struct
+typedef struct Light_DLight
 {
 	geBoolean	Active;					// Is this light in use?
 	GE_RGBA		Color;					// Color of light (0...255.0f)
@@ -56,8 +56,20 @@ typedef struct
 	uint32		FColorB;
 
 	geBoolean	CastShadow;
+
+	int32		Index;					// Slot in Light_LightInfo::DynamicLights while active
+	struct Light_DLight	*NextFree;
 } Light_DLight;
 
+// One dynamic light in a faces, or leafs list of lights for this frame
+typedef struct
+{
+	Light_DLight	*Light;
+	int32			Next;				// Next ref in the list, -1 at the end
+} Light_DLightRef;
+
+typedef struct Light_LMapCache Light_LMapCache;
+
 typedef struct Light_LightInfo
 {
 	// Intensity tables, for animated styles
@@ -68,8 +80,22 @@ typedef struct Light_LightInfo
 	char			LTypeTable[MAX_LTYPES][70];
 	int32			IPos[MAX_LTYPES];                 // Ref position in ltype table
 
-	Light_DLight	DynamicLights[MAX_DYNAMIC_LIGHTS];
+	// Dynamic lights live in blocks that never move, so the pointers handed out stay good
+	Light_DLight	**DLightBlocks;
+	int32			NumDLightBlocks;
+	Light_DLight	*FreeDLights;
+
+	Light_DLight	**DynamicLights;				// Active lights, packed
 	int32			NumDynamicLights;
+
+	// Lists of the lights touching each face and leaf, rebuilt by Light_SetupLights every frame
+	Light_DLightRef	*DLightRefs;
+	int32			NumDLightRefs;
+	int32			MaxDLightRefs;
+
+	// Last lightmaps built by Light_SetupLightmap, one per face (allocated as they are needed)
+	Light_LMapCache	**LMapCache;
+	int32			NumLMapCache;
 } Light_LightInfo;
 
 typedef struct tag_light
@@ -93,6 +119,8 @@ geBoolean	Light_SetGBSP(World_BSP *BSP);
 
 Light_DLight *Light_WorldAddLight(geWorld *World);
 void		Light_WorldRemoveLight(geWorld *World, Light_DLight *DLight);
+Light_DLight *Light_WorldGetFirstDLight(geWorld *World, const geVec3d *Pos, int32 *Ref);
+Light_DLight *Light_WorldGetNextDLight(geWorld *World, int32 *Ref);
 geBoolean	 Light_SetupLights(geWorld *World);
 geBoolean	Light_SetAttributes(	Light_DLight *Light, 
 								const geVec3d *Pos, 
@@ -0,0 +1,592 @@
+/****************************************************************************************/
+/*  LightKernel.c                                                                       */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Inner loops for building lightmaps (SSE2/AVX2 when the cpu has them)   */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Assert.h>
+#include <Stdio.h>
+#include <String.h>
+
+#include "LightKernel.h"
+#include "Drivers\SoftDrv2\CPUSimd.h"
+
+//=====================================================================================
+//	Plain C versions
+//=====================================================================================
+static void Add_C(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity)
+{
+	int32	i;
+
+	for (i=0; i< Count; i++)
+		Dest[i] += Src[i] * Intensity;
+}
+
+static void Set_C(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity)
+{
+	int32	i;
+
+	for (i=0; i< Count; i++)
+		Dest[i] = Src[i] * Intensity;
+}
+
+static void Set0_C(int32 *Dest, const uint8 *Src, int32 Count, int32 Shift)
+{
+	int32	i;
+
+	for (i=0; i< Count; i++)
+		Dest[i] = Src[i] << Shift;
+}
+
+static void Clamp_C(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift)
+{
+	uint8	*pDest;
+	int32	i, Val;
+
+	pDest = (uint8*)Dest;
+
+	for (i=0; i< Count; i++)
+	{
+		Val = Src[i] >> Shift;
+
+		if (Val > 255)
+			Val = 255;
+		else if (Val < 0)
+			Val = 0;
+
+		pDest[i] = (uint8)Val;
+	}
+}
+
+static void ClampHigh_C(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift)
+{
+	uint8	*pDest;
+	int32	i, Val;
+
+	pDest = (uint8*)Dest;
+
+	for (i=0; i< Count; i++)
+	{
+		Val = Src[i] >> Shift;
+
+		if (Val > 255)
+			Val = 255;
+
+		pDest[i] = (uint8)Val;
+	}
+}
+
+LIGHTKERNEL_ADD		*LightKernel_Add = Add_C;
+LIGHTKERNEL_ADD		*LightKernel_Set = Set_C;
+LIGHTKERNEL_SET0	*LightKernel_Set0 = Set0_C;
+LIGHTKERNEL_CLAMP	*LightKernel_Clamp = Clamp_C;
+LIGHTKERNEL_CLAMP	*LightKernel_ClampHigh = ClampHigh_C;
+
+#ifdef GE_HAVE_SSE2
+//=====================================================================================
+//	SSE2 versions, 16 components at a time
+//=====================================================================================
+
+// Src * Intensity for 8 components (as int16), into 2 vectors of int32.  The 16 bit
+// multiplies give the low and high halfs of each product, and the unpacks join them.
+#define SSE2_MUL8(S16, K, P0, P1)								\
+{																\
+	__m128i	Lo, Hi;												\
+	Lo = _mm_mullo_epi16(S16, K);								\
+	Hi = _mm_mulhi_epi16(S16, K);								\
+	P0 = _mm_unpacklo_epi16(Lo, Hi);							\
+	P1 = _mm_unpackhi_epi16(Lo, Hi);							\
+}
+
+static void Add_SSE2(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity)
+{
+	__m128i		K, Zero, S, S16, P0, P1, P2, P3;
+	__m128i		*pDest;
+	int32		i;
+
+	// The multiply is done in 16 bits, so the intensity has to fit
+	if (Intensity < -32768 || Intensity > 32767)
+	{
+		Add_C(Dest, Src, Count, Intensity);
+		return;
+	}
+
+	K = _mm_set1_epi16((short)Intensity);
+	Zero = _mm_setzero_si128();
+
+	for (i=0; i+16 <= Count; i+=16)
+	{
+		S = _mm_loadu_si128((const __m128i*)(Src+i));
+
+		S16 = _mm_unpacklo_epi8(S, Zero);
+		SSE2_MUL8(S16, K, P0, P1);
+		S16 = _mm_unpackhi_epi8(S, Zero);
+		SSE2_MUL8(S16, K, P2, P3);
+
+		pDest = (__m128i*)(Dest+i);
+
+		_mm_storeu_si128(pDest+0, _mm_add_epi32(_mm_loadu_si128(pDest+0), P0));
+		_mm_storeu_si128(pDest+1, _mm_add_epi32(_mm_loadu_si128(pDest+1), P1));
+		_mm_storeu_si128(pDest+2, _mm_add_epi32(_mm_loadu_si128(pDest+2), P2));
+		_mm_storeu_si128(pDest+3, _mm_add_epi32(_mm_loadu_si128(pDest+3), P3));
+	}
+
+	Add_C(Dest+i, Src+i, Count-i, Intensity);
+}
+
+static void Set_SSE2(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity)
+{
+	__m128i		K, Zero, S, S16, P0, P1, P2, P3;
+	__m128i		*pDest;
+	int32		i;
+
+	if (Intensity < -32768 || Intensity > 32767)
+	{
+		Set_C(Dest, Src, Count, Intensity);
+		return;
+	}
+
+	K = _mm_set1_epi16((short)Intensity);
+	Zero = _mm_setzero_si128();
+
+	for (i=0; i+16 <= Count; i+=16)
+	{
+		S = _mm_loadu_si128((const __m128i*)(Src+i));
+
+		S16 = _mm_unpacklo_epi8(S, Zero);
+		SSE2_MUL8(S16, K, P0, P1);
+		S16 = _mm_unpackhi_epi8(S, Zero);
+		SSE2_MUL8(S16, K, P2, P3);
+
+		pDest = (__m128i*)(Dest+i);
+
+		_mm_storeu_si128(pDest+0, P0);
+		_mm_storeu_si128(pDest+1, P1);
+		_mm_storeu_si128(pDest+2, P2);
+		_mm_storeu_si128(pDest+3, P3);
+	}
+
+	Set_C(Dest+i, Src+i, Count-i, Intensity);
+}
+
+static void Set0_SSE2(int32 *Dest, const uint8 *Src, int32 Count, int32 Shift)
+{
+	__m128i		Zero, S, S16, Sh;
+	__m128i		*pDest;
+	int32		i;
+
+	Zero = _mm_setzero_si128();
+	Sh = _mm_cvtsi32_si128(Shift);
+
+	for (i=0; i+16 <= Count; i+=16)
+	{
+		S = _mm_loadu_si128((const __m128i*)(Src+i));
+
+		pDest = (__m128i*)(Dest+i);
+
+		S16 = _mm_unpacklo_epi8(S, Zero);
+		_mm_storeu_si128(pDest+0, _mm_sll_epi32(_mm_unpacklo_epi16(S16, Zero), Sh));
+		_mm_storeu_si128(pDest+1, _mm_sll_epi32(_mm_unpackhi_epi16(S16, Zero), Sh));
+		S16 = _mm_unpackhi_epi8(S, Zero);
+		_mm_storeu_si128(pDest+2, _mm_sll_epi32(_mm_unpacklo_epi16(S16, Zero), Sh));
+		_mm_storeu_si128(pDest+3, _mm_sll_epi32(_mm_unpackhi_epi16(S16, Zero), Sh));
+	}
+
+	Set0_C(Dest+i, Src+i, Count-i, Shift);
+}
+
+// The saturating packs do the clamping: int32 -> int16 keeps anything out of range out
+// of range, then int16 -> uint8 clamps to 0..255
+static void Clamp_SSE2(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift)
+{
+	__m128i		Sh, V0, V1, V2, V3;
+	const __m128i	*pSrc;
+	uint8		*pDest;
+	int32		i;
+
+	Sh = _mm_cvtsi32_si128(Shift);
+	pDest = (uint8*)Dest;
+
+	for (i=0; i+16 <= Count; i+=16)
+	{
+		pSrc = (const __m128i*)(Src+i);
+
+		V0 = _mm_sra_epi32(_mm_loadu_si128(pSrc+0), Sh);
+		V1 = _mm_sra_epi32(_mm_loadu_si128(pSrc+1), Sh);
+		V2 = _mm_sra_epi32(_mm_loadu_si128(pSrc+2), Sh);
+		V3 = _mm_sra_epi32(_mm_loadu_si128(pSrc+3), Sh);
+
+		V0 = _mm_packs_epi32(V0, V1);
+		V2 = _mm_packs_epi32(V2, V3);
+
+		_mm_storeu_si128((__m128i*)(pDest+i), _mm_packus_epi16(V0, V2));
+	}
+
+	Clamp_C((DRV_RGB*)(pDest+i), Src+i, Count-i, Shift);
+}
+
+// Only the top is clamped, anything under 0 just keeps it's low byte like the cast does
+static void ClampHigh_SSE2(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift)
+{
+	__m128i		Sh, Max, V[4], Over;
+	const __m128i	*pSrc;
+	uint8		*pDest;
+	int32		i, k;
+
+	Sh = _mm_cvtsi32_si128(Shift);
+	Max = _mm_set1_epi32(255);
+	pDest = (uint8*)Dest;
+
+	for (i=0; i+16 <= Count; i+=16)
+	{
+		pSrc = (const __m128i*)(Src+i);
+
+		for (k=0; k< 4; k++)
+		{
+			V[k] = _mm_sra_epi32(_mm_loadu_si128(pSrc+k), Sh);
+			Over = _mm_cmpgt_epi32(V[k], Max);
+			V[k] = _mm_or_si128(_mm_and_si128(Over, Max), _mm_andnot_si128(Over, V[k]));
+			V[k] = _mm_and_si128(V[k], Max);
+		}
+
+		V[0] = _mm_packs_epi32(V[0], V[1]);
+		V[2] = _mm_packs_epi32(V[2], V[3]);
+
+		_mm_storeu_si128((__m128i*)(pDest+i), _mm_packus_epi16(V[0], V[2]));
+	}
+
+	ClampHigh_C((DRV_RGB*)(pDest+i), Src+i, Count-i, Shift);
+}
+#endif
+
+#ifdef GE_HAVE_AVX2
+//=====================================================================================
+//	AVX2 versions, 32 components at a time
+//=====================================================================================
+static void Add_AVX2(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity)
+{
+	__m256i		K, S;
+	__m256i		*pDest;
+	int32		i, k;
+
+	K = _mm256_set1_epi32(Intensity);
+
+	for (i=0; i+32 <= Count; i+=32)
+	{
+		pDest = (__m256i*)(Dest+i);
+
+		for (k=0; k< 4; k++)
+		{
+			S = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(Src+i+k*8)));
+			_mm256_storeu_si256(pDest+k, _mm256_add_epi32(_mm256_loadu_si256(pDest+k), _mm256_mullo_epi32(S, K)));
+		}
+	}
+
+	Add_C(Dest+i, Src+i, Count-i, Intensity);
+}
+
+static void Set_AVX2(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity)
+{
+	__m256i		K, S;
+	__m256i		*pDest;
+	int32		i, k;
+
+	K = _mm256_set1_epi32(Intensity);
+
+	for (i=0; i+32 <= Count; i+=32)
+	{
+		pDest = (__m256i*)(Dest+i);
+
+		for (k=0; k< 4; k++)
+		{
+			S = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(Src+i+k*8)));
+			_mm256_storeu_si256(pDest+k, _mm256_mullo_epi32(S, K));
+		}
+	}
+
+	Set_C(Dest+i, Src+i, Count-i, Intensity);
+}
+
+static void Set0_AVX2(int32 *Dest, const uint8 *Src, int32 Count, int32 Shift)
+{
+	__m128i		Sh;
+	__m256i		S;
+	__m256i		*pDest;
+	int32		i, k;
+
+	Sh = _mm_cvtsi32_si128(Shift);
+
+	for (i=0; i+32 <= Count; i+=32)
+	{
+		pDest = (__m256i*)(Dest+i);
+
+		for (k=0; k< 4; k++)
+		{
+			S = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(Src+i+k*8)));
+			_mm256_storeu_si256(pDest+k, _mm256_sll_epi32(S, Sh));
+		}
+	}
+
+	Set0_C(Dest+i, Src+i, Count-i, Shift);
+}
+
+// The packs work inside each 128 bit half, so the result comes out with it's 4 byte
+// groups shuffled, and the permute puts them back in order
+#define AVX2_PACK32(V0, V1, V2, V3, Out)						\
+{																\
+	__m256i	P0, P1;												\
+	P0 = _mm256_packs_epi32(V0, V1);							\
+	P1 = _mm256_packs_epi32(V2, V3);							\
+	Out = _mm256_packus_epi16(P0, P1);							\
+	Out = _mm256_permutevar8x32_epi32(Out, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));	\
+}
+
+static void Clamp_AVX2(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift)
+{
+	__m128i		Sh;
+	__m256i		V[4], Out;
+	const __m256i	*pSrc;
+	uint8		*pDest;
+	int32		i, k;
+
+	Sh = _mm_cvtsi32_si128(Shift);
+	pDest = (uint8*)Dest;
+
+	for (i=0; i+32 <= Count; i+=32)
+	{
+		pSrc = (const __m256i*)(Src+i);
+
+		for (k=0; k< 4; k++)
+			V[k] = _mm256_sra_epi32(_mm256_loadu_si256(pSrc+k), Sh);
+
+		AVX2_PACK32(V[0], V[1], V[2], V[3], Out);
+
+		_mm256_storeu_si256((__m256i*)(pDest+i), Out);
+	}
+
+	Clamp_C((DRV_RGB*)(pDest+i), Src+i, Count-i, Shift);
+}
+
+static void ClampHigh_AVX2(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift)
+{
+	__m128i		Sh;
+	__m256i		Max, V[4], Out;
+	const __m256i	*pSrc;
+	uint8		*pDest;
+	int32		i, k;
+
+	Sh = _mm_cvtsi32_si128(Shift);
+	Max = _mm256_set1_epi32(255);
+	pDest = (uint8*)Dest;
+
+	for (i=0; i+32 <= Count; i+=32)
+	{
+		pSrc = (const __m256i*)(Src+i);
+
+		for (k=0; k< 4; k++)
+		{
+			V[k] = _mm256_sra_epi32(_mm256_loadu_si256(pSrc+k), Sh);
+			V[k] = _mm256_and_si256(_mm256_min_epi32(V[k], Max), Max);
+		}
+
+		AVX2_PACK32(V[0], V[1], V[2], V[3], Out);
+
+		_mm256_storeu_si256((__m256i*)(pDest+i), Out);
+	}
+
+	ClampHigh_C((DRV_RGB*)(pDest+i), Src+i, Count-i, Shift);
+}
+#endif
+
+//=====================================================================================
+//	LightKernel_Init
+//=====================================================================================
+void LightKernel_Init(void)
+{
+	LightKernel_Add = Add_C;
+	LightKernel_Set = Set_C;
+	LightKernel_Set0 = Set0_C;
+	LightKernel_Clamp = Clamp_C;
+	LightKernel_ClampHigh = ClampHigh_C;
+
+#ifdef GE_HAVE_SSE2
+	if (CPUInfo_TestForSSE2())
+	{
+		LightKernel_Add = Add_SSE2;
+		LightKernel_Set = Set_SSE2;
+		LightKernel_Set0 = Set0_SSE2;
+		LightKernel_Clamp = Clamp_SSE2;
+		LightKernel_ClampHigh = ClampHigh_SSE2;
+	}
+#endif
+
+#ifdef GE_HAVE_AVX2
+	if (CPUInfo_TestForAVX2())
+	{
+		LightKernel_Add = Add_AVX2;
+		LightKernel_Set = Set_AVX2;
+		LightKernel_Set0 = Set0_AVX2;
+		LightKernel_Clamp = Clamp_AVX2;
+		LightKernel_ClampHigh = ClampHigh_AVX2;
+	}
+#endif
+}
+
+#ifdef LIGHTKERNEL_BENCHMARK
+//=====================================================================================
+//	Benchmark
+//=====================================================================================
+#define BENCH_MAX_COUNT		(36*36*3)			// MAX_LMAP_SIZE squared, RGB
+#define BENCH_LOOPS			(20000)
+
+typedef struct
+{
+	const char			*Name;
+	LIGHTKERNEL_ADD		*Add;
+	LIGHTKERNEL_ADD		*Set;
+	LIGHTKERNEL_SET0	*Set0;
+	LIGHTKERNEL_CLAMP	*Clamp;
+	LIGHTKERNEL_CLAMP	*ClampHigh;
+} Bench_Kernels;
+
+static uint8		BenchSrc[BENCH_MAX_COUNT];
+static int32		BenchRef32[BENCH_MAX_COUNT], BenchDest32[BENCH_MAX_COUNT];
+static DRV_RGB		BenchRef8[BENCH_MAX_COUNT/3], BenchDest8[BENCH_MAX_COUNT/3];
+
+static geFloat BenchSeconds(LARGE_INTEGER *Start)
+{
+	LARGE_INTEGER	End, Freq;
+
+	QueryPerformanceCounter(&End);
+	QueryPerformanceFrequency(&Freq);
+
+	return (geFloat)(End.QuadPart - Start->QuadPart) / (geFloat)Freq.QuadPart;
+}
+
+// Runs one set of kernels the way Light_SetupLightmap does (3 styles, then the clamp),
+// and returns GE_FALSE if it doesn't come out the same as the C ones
+static geBoolean BenchRun(const Bench_Kernels *K, int32 Count, geFloat *Time)
+{
+	LARGE_INTEGER	Start;
+	int32			i;
+
+	// What the C kernels make
+	Set_C(BenchRef32, BenchSrc, Count, 187);
+	Add_C(BenchRef32, BenchSrc, Count, 246);
+	Add_C(BenchRef32, BenchSrc, Count, -2123);
+	Clamp_C(BenchRef8, BenchRef32, Count, 8);
+
+	QueryPerformanceCounter(&Start);
+
+	for (i=0; i< BENCH_LOOPS; i++)
+	{
+		K->Set(BenchDest32, BenchSrc, Count, 187);
+		K->Add(BenchDest32, BenchSrc, Count, 246);
+		K->Add(BenchDest32, BenchSrc, Count, -2123);
+		K->Clamp(BenchDest8, BenchDest32, Count, 8);
+	}
+
+	*Time = BenchSeconds(&Start);
+
+	if (memcmp(BenchRef32, BenchDest32, Count*sizeof(int32)) || memcmp(BenchRef8, BenchDest8, Count))
+		return GE_FALSE;
+
+	// The rest just get checked
+	Set0_C(BenchRef32, BenchSrc, Count, 8);
+	K->Set0(BenchDest32, BenchSrc, Count, 8);
+
+	if (memcmp(BenchRef32, BenchDest32, Count*sizeof(int32)))
+		return GE_FALSE;
+
+	for (i=0; i< Count; i++)
+		BenchRef32[i] = (BenchSrc[i] - 100) * 311;
+
+	ClampHigh_C(BenchRef8, BenchRef32, Count, 8);
+	K->ClampHigh(BenchDest8, BenchRef32, Count, 8);
+
+	if (memcmp(BenchRef8, BenchDest8, Count))
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
+void LightKernel_Benchmark(void)
+{
+	Bench_Kernels	Kernels[3];
+	int32			NumKernels, Sizes[] = {4, 8, 16, 23, 36};
+	int32			i, s, k;
+	char			Str[256];
+
+	Kernels[0].Name = "C";
+	Kernels[0].Add = Add_C;
+	Kernels[0].Set = Set_C;
+	Kernels[0].Set0 = Set0_C;
+	Kernels[0].Clamp = Clamp_C;
+	Kernels[0].ClampHigh = ClampHigh_C;
+	NumKernels = 1;
+
+#ifdef GE_HAVE_SSE2
+	if (CPUInfo_TestForSSE2())
+	{
+		Kernels[NumKernels].Name = "SSE2";
+		Kernels[NumKernels].Add = Add_SSE2;
+		Kernels[NumKernels].Set = Set_SSE2;
+		Kernels[NumKernels].Set0 = Set0_SSE2;
+		Kernels[NumKernels].Clamp = Clamp_SSE2;
+		Kernels[NumKernels].ClampHigh = ClampHigh_SSE2;
+		NumKernels++;
+	}
+#endif
+
+#ifdef GE_HAVE_AVX2
+	if (CPUInfo_TestForAVX2())
+	{
+		Kernels[NumKernels].Name = "AVX2";
+		Kernels[NumKernels].Add = Add_AVX2;
+		Kernels[NumKernels].Set = Set_AVX2;
+		Kernels[NumKernels].Set0 = Set0_AVX2;
+		Kernels[NumKernels].Clamp = Clamp_AVX2;
+		Kernels[NumKernels].ClampHigh = ClampHigh_AVX2;
+		NumKernels++;
+	}
+#endif
+
+	for (i=0; i< BENCH_MAX_COUNT; i++)
+		BenchSrc[i] = (uint8)((i*167 + (i>>3)*13) & 255);
+
+	for (s=0; s< sizeof(Sizes)/sizeof(Sizes[0]); s++)
+	{
+		int32		Count;
+
+		Count = Sizes[s]*Sizes[s]*3;
+
+		for (k=0; k< NumKernels; k++)
+		{
+			geFloat		Time;
+			geBoolean	Same;
+
+			Same = BenchRun(&Kernels[k], Count, &Time);
+
+			sprintf(Str, "LightKernel: %2ix%2i lightmap, %-4s  %.3fus per lightmap%s\n", Sizes[s], Sizes[s], Kernels[k].Name,
+				Time*1000000.0f/(geFloat)BENCH_LOOPS, Same ? "" : "  *** DOES NOT MATCH C ***");
+			OutputDebugString(Str);
+		}
+	}
+}
+#endif
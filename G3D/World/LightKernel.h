@@ -0,0 +1,59 @@
+/****************************************************************************************/
+/*  LightKernel.h                                                                       */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Inner loops for building lightmaps (SSE2/AVX2 when the cpu has them)   */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef GE_LIGHTKERNEL_H
+#define GE_LIGHTKERNEL_H
+
+#include "BaseType.h"
+#include "DCommon.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//=====================================================================================
+//	Function ProtoTypes
+//	Count is the number of components (3 per lightmap texel).  All the versions give
+//	the exact same results as the plain C ones.
+//=====================================================================================
+typedef void LIGHTKERNEL_ADD(int32 *Dest, const uint8 *Src, int32 Count, int32 Intensity);
+typedef void LIGHTKERNEL_SET0(int32 *Dest, const uint8 *Src, int32 Count, int32 Shift);
+typedef void LIGHTKERNEL_CLAMP(DRV_RGB *Dest, const int32 *Src, int32 Count, int32 Shift);
+
+extern LIGHTKERNEL_ADD		*LightKernel_Add;			// Dest += Src * Intensity
+extern LIGHTKERNEL_ADD		*LightKernel_Set;			// Dest  = Src * Intensity
+extern LIGHTKERNEL_SET0		*LightKernel_Set0;			// Dest  = Src << Shift
+extern LIGHTKERNEL_CLAMP	*LightKernel_Clamp;			// Dest  = Src >> Shift, clamped to 0..255
+extern LIGHTKERNEL_CLAMP	*LightKernel_ClampHigh;		// Dest  = Src >> Shift, clamped to 255 (and cast to uint8)
+
+// Points the kernels at the fastest versions the cpu can run
+void		LightKernel_Init(void);
+
+#ifdef LIGHTKERNEL_BENCHMARK
+// Checks every version against the C ones, and times them over real lightmap sizes
+void		LightKernel_Benchmark(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
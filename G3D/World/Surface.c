@@ -111,16 +111,12 @@ geBoolean Surf_SetGBSP(World_BSP *BSP)
 void CalcSurfVectors (World_BSP *BSP);
 
 //================================================================================
-//	Surf_WorldInit
+//	Surf_BSPInit
+//	Builds the TexVerts and SurfInfo for BSP.  Only touches BSP, so it can run
+//	while another world is being rendered.
 //================================================================================
-geBoolean Surf_WorldInit(geWorld *World)
+geBoolean Surf_BSPInit(World_BSP *BSP)
 {
-	World_BSP	*BSP;
-
-	assert(World != NULL);
-	
-	BSP = World->CurrentBSP;
-
 	assert(BSP != NULL);
 
 	// Make sure we free the old ones...
@@ -134,6 +130,12 @@ geBoolean Surf_WorldInit(geWorld *World)
 	BSP->TexVerts = GE_RAM_ALLOCATE_ARRAY(Surf_TexVert, BSP->BSPData.NumGFXVertIndexList);
 	BSP->SurfInfo = GE_RAM_ALLOCATE_ARRAY(Surf_SurfInfo, BSP->BSPData.NumGFXFaces);
 	
+	if ((!BSP->TexVerts && BSP->BSPData.NumGFXVertIndexList) || (!BSP->SurfInfo && BSP->BSPData.NumGFXFaces))
+	{
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		return GE_FALSE;
+	}
+
 	// Fill in info needed to render this tree
 	if (!GetTexVerts(BSP))			// Calc texture uv's at vertices...
 		return GE_FALSE;
@@ -141,9 +143,6 @@ geBoolean Surf_WorldInit(geWorld *World)
 	if (!GetSurfInfo(BSP))			// Get surface info
 		return GE_FALSE;
 
-	Light_SetWorld(World);
-	Light_SetGBSP(BSP);
-
 	if (!GetRGBVerts(BSP))			// Calc RGB values at vertices
 		return GE_FALSE;
 
@@ -152,6 +151,27 @@ geBoolean Surf_WorldInit(geWorld *World)
 	return GE_TRUE;
 }
 
+//================================================================================
+//	Surf_WorldInit
+//	Surf_BSPInit must have been called on the worlds bsp
+//================================================================================
+geBoolean Surf_WorldInit(geWorld *World)
+{
+	World_BSP	*BSP;
+
+	assert(World != NULL);
+	
+	BSP = World->CurrentBSP;
+
+	assert(BSP != NULL);
+	assert(BSP->SurfInfo != NULL || BSP->BSPData.NumGFXFaces == 0);
+
+	Light_SetWorld(World);
+	Light_SetGBSP(BSP);
+
+	return GE_TRUE;
+}
+
 //================================================================================
 //	Surf_WorldShutdown
 //================================================================================
@@ -166,10 +186,14 @@ void Surf_WorldShutdown(geWorld *World)
 	if (!BSP)
 		return;
 
-	if (BSP->TexVerts)
-		geRam_Free(BSP->TexVerts);
-	if (BSP->SurfInfo)
-		geRam_Free(BSP->SurfInfo);
+	// A baked bsp keeps these in it's GFXBlob, and GBSP_FreeGBSPFile frees them
+	if (!BSP->BSPData.GFXBlob)
+	{
+		if (BSP->TexVerts)
+			geRam_Free(BSP->TexVerts);
+		if (BSP->SurfInfo)
+			geRam_Free(BSP->SurfInfo);
+	}
 
 	BSP->TexVerts = NULL;
 	BSP->SurfInfo = NULL;
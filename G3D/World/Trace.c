@@ -30,6 +30,9 @@
 #include "Trace.h"
 #include "ExtBox.h"
 #include "Actor.h"
+#include "ActorTree.h"
+#include "Ram.h"
+#include "WorkPool.h"
 
 #define ON_EPSILON	(0.1f)
 
@@ -38,14 +41,12 @@
 //=====================================================================================
 
 // Globals returned in the bsp subdivision code
+// (the world collision code keeps all this in a Trace_Query instead, so it can be threaded)
 static	int32			GPlaneNum;
 static	GFX_Plane		GlobalPlane;
-static	int32			GlobalNode;
 static	int32			GlobalSide;
 static	geVec3d			GlobalI;
 static	geFloat			GRatio;
-static	int32			GlobalLeaf;
-static	int32			GlobalLeaf;
 
 static	GBSP_BSPData	*BSPData;
 
@@ -64,18 +65,58 @@ int32	NumGetContents;
 //=====================================================================================
 //	Local Static Function Prototypes
 //=====================================================================================
-static geBoolean BSPIntersect(geVec3d *Front, geVec3d *Back, int32 Node);
+static geBoolean BSPIntersect(Trace_Query *Q, geVec3d *Front, geVec3d *Back, int32 Node);
+static geBoolean QueryCollisionExact(Trace_Query *Q, geWorld *World, const geVec3d *Front, const geVec3d *Back, uint32 Flags, geVec3d *Impact, GFX_Plane *Plane, geWorld_Model **Model, Mesh_RenderQ **Mesh, geActor **Actor, uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context);
+static geBoolean QueryCollisionBBox(Trace_Query *Q, geWorld *World, const geVec3d *Mins, const geVec3d *Maxs, const geVec3d *Front, const geVec3d *Back, uint32 Flags, geVec3d *I, GFX_Plane *P, geWorld_Model **Model, Mesh_RenderQ **Mesh, geActor **Actor, uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context);
 
 
 
-static geActor *Trace_ActorCollide(geWorld *World,
+//=====================================================================================
+//	Actor candidates
+//	The actors the tree finds, kept in World->ActorArray order so ties go to the same
+//	actor they always did
+//=====================================================================================
+#define TRACE_MAX_ACTOR_CANDIDATES		256
+
+typedef struct
+{
+	int32		Indexes[TRACE_MAX_ACTOR_CANDIDATES];
+	int32		NumIndexes;
+	geBoolean	Overflow;
+} Trace_ActorCandidates;
+
+static geBoolean Trace_AddActorCandidate(const ActorTree_Proxy *Proxy, void *Context)
+{
+	Trace_ActorCandidates	*Cands;
+	int32					i;
+
+	Cands = (Trace_ActorCandidates*)Context;
+
+	if (Cands->NumIndexes >= TRACE_MAX_ACTOR_CANDIDATES)
+	{
+		Cands->Overflow = GE_TRUE;
+		return GE_FALSE;
+	}
+
+	for (i=Cands->NumIndexes; i> 0 && Cands->Indexes[i-1] > Proxy->ActorIndex; i--)
+		Cands->Indexes[i] = Cands->Indexes[i-1];
+
+	Cands->Indexes[i] = Proxy->ActorIndex;
+	Cands->NumIndexes++;
+
+	return GE_TRUE;
+}
+
+static geActor *Trace_ActorCollide(Trace_Query *Q, geWorld *World,
 								   const geVec3d *Mins, const geVec3d *Maxs,
 								   const geVec3d *Front,const geVec3d *Back, 
 								   geVec3d *CollisionPoint,GFX_Plane *BestPlane,
 								   uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context, geFloat *BestD  )
 {
-	int i,Count;
+	int c,i,Count;
 	World_Actor *WA;
+	const ActorTree_Proxy *Proxy;
+	Trace_ActorCandidates Cands;
 	geVec3d RayDirection;
 	geFloat RayLength;
 	geFloat Dist;
@@ -94,15 +135,32 @@ static geActor *Trace_ActorCollide(geWorld *World,
 	geVec3d_Subtract(Back,Front,&RayDirection);
 	RayLength = geVec3d_Normalize(&RayDirection);
 
-	Count = World->ActorCount;
-	WA = &(World->ActorArray[0]);
+	if (World->ActorCount == 0)
+		return NULL;
+
+	// The callers bring the tree up to date before the query starts (see Trace_UpdateActors)
+	assert(ActorTree_IsUpToDate(World->ActorTree));
 
 	Trace_GetMoveBox(Mins, Maxs, Front, Back, &OMins, &OMaxs);
 
-	for (i=0; i<Count; i++, WA++)
+	Cands.NumIndexes = 0;
+	Cands.Overflow = GE_FALSE;
+
+	ActorTree_QueryBox(World->ActorTree, &OMins, &OMaxs, Trace_AddActorCandidate, &Cands);
+
+	// If the move touches too many, it's going to be slow no matter what, so just look at them all
+	if (Cands.Overflow)
+		Count = World->ActorCount;
+	else
+		Count = Cands.NumIndexes;
+
+	for (c=0; c<Count; c++)
 	{
 		geExtBox B;
 		geVec3d Normal;
+
+		i = Cands.Overflow ? c : Cands.Indexes[c];
+		WA = &(World->ActorArray[i]);
 		
 		// Reject if not active or if userflags don't accept...
 		if (!(WA->Flags & GE_ACTOR_COLLIDE) || !(WA->UserFlags & UserFlags) )
@@ -111,8 +169,12 @@ static geActor *Trace_ActorCollide(geWorld *World,
 		if (CollisionCB && !CollisionCB(NULL, WA->Actor, Context))
 			continue;
 
-		if (!geActor_GetExtBox(WA->Actor, &B))
+		Proxy = ActorTree_GetProxy(World->ActorTree, WA->Proxy);
+
+		if (!Proxy->Valid)
 			continue;
+
+		B = Proxy->Box;
 							
 		for (k=0; k<3; k++)
 		{
@@ -158,11 +220,67 @@ static geActor *Trace_ActorCollide(geWorld *World,
 
 
 
+//=====================================================================================
+//	Trace_UpdateActors
+//	Getting an actors box can update its pose, so the tree is brought up to date before a
+//	query, never inside one.  That way the queries only read it, and can run on any thread.
+//=====================================================================================
+static geBoolean Trace_UpdateActors(geWorld *World, uint32 CollideFlags)
+{
+	if (!(CollideFlags & GE_COLLIDE_ACTORS) || World->ActorCount == 0)
+		return GE_TRUE;
+
+	return ActorTree_Update(World->ActorTree, World);
+}
+
 //=====================================================================================
 //	Trace_GEWorldCollision
 //	Function specially designed for GE UI...
 //=====================================================================================
 geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVec3d *Maxs, const geVec3d *Front, const geVec3d *Back, uint32 Contents, uint32 CollideFlags, uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context, GE_Collision *Col)
+{
+	Trace_Query	Query;
+	geBoolean	Hit;
+
+	assert(World != NULL);
+	assert(World->CurrentBSP != NULL);
+
+	// The rest of this file still picks these up from the last collision...
+	gContents = Contents;
+	BSPData = &World->CurrentBSP->BSPData;
+
+	if (Mins && Maxs)
+		NumBBoxCast++;
+	else
+		NumExactCast++;
+
+	Trace_UpdateActors(World, CollideFlags);
+
+	Trace_InitQuery(&Query);
+	Query.Ratio = GRatio;			// Hits on actors only never set the ratio, so it has always been the last one
+
+	Hit = Trace_QueryWorldCollision(&Query, World, Mins, Maxs, Front, Back, Contents, CollideFlags, UserFlags, CollisionCB, Context, Col);
+
+	GRatio = Query.Ratio;
+
+	return Hit;
+}
+
+//=====================================================================================
+//	Trace_InitQuery
+//=====================================================================================
+void Trace_InitQuery(Trace_Query *Query)
+{
+	assert(Query != NULL);
+
+	memset(Query, 0, sizeof(*Query));
+}
+
+//=====================================================================================
+//	Trace_QueryWorldCollision
+//	Same as Trace_GEWorldCollision, but all the state lives in Query
+//=====================================================================================
+geBoolean Trace_QueryWorldCollision(Trace_Query *Query, geWorld *World, const geVec3d *Mins, const geVec3d *Maxs, const geVec3d *Front, const geVec3d *Back, uint32 Contents, uint32 CollideFlags, uint32 UserFlags, GE_CollisionCB *CollisionCB, void *Context, GE_Collision *Col)
 {
 	geVec3d		I;
 	GFX_Plane	Plane;
@@ -170,16 +288,17 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 	Mesh_RenderQ	*Mesh;
 	geActor     *Actor;
 
+	assert(Query != NULL);
 	assert(World != NULL);
 	assert(World->CurrentBSP != NULL);
 	assert(Front != NULL);
 	assert(Back!= NULL);
 	assert(Contents);			// It does not make sense to collide with nothing!!!
 	
-	// Set the global contents to collide with
-	gContents = Contents;
+	// Set the contents to collide with
+	Query->Contents = Contents;
 
-	BSPData = &World->CurrentBSP->BSPData;
+	Query->BSPData = &World->CurrentBSP->BSPData;
 
 	// Reset all the collision feedback pointers
 	Model = NULL;
@@ -192,8 +311,7 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 
 	if (Mins && Maxs)
 	{
-		NumBBoxCast++;
-		if (Trace_WorldCollisionBBox(World, Mins, Maxs, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
+		if (QueryCollisionBBox(Query, World, Mins, Maxs, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
 		{
 			
 			Col->Impact = I;
@@ -204,15 +322,13 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 			Col->Mesh = (geMesh*)Mesh;
 			Col->Actor = Actor;
 
-			Col->Ratio = GRatio;
+			Col->Ratio = Query->Ratio;
 			return GE_TRUE;
 		}
 	}
 	else 
 	{
-		NumExactCast++;
-
-		if (Trace_WorldCollisionExact(World, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
+		if (QueryCollisionExact(Query, World, Front, Back, CollideFlags, &I, &Plane, &Model, &Mesh, &Actor, UserFlags, CollisionCB, Context))
 		{
 			Col->Impact = I;
 			Col->Plane.Normal = Plane.Normal;
@@ -222,7 +338,7 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 			Col->Mesh = (geMesh*)Mesh;
 			Col->Actor = Actor;
 
-			Col->Ratio = GRatio;
+			Col->Ratio = Query->Ratio;
 
 			return GE_TRUE;
 		}
@@ -230,6 +346,94 @@ geBoolean Trace_GEWorldCollision(geWorld *World, const geVec3d *Mins, const geVe
 	return GE_FALSE;
 }
 
+//=====================================================================================
+//	Batched collision
+//=====================================================================================
+#define TRACE_BATCH_PER_THREAD		16				// Not worth starting a thread for less
+#define TRACE_BATCH_NO_RATIO		(-1.0f)			// The collision code never sets a ratio below 0
+
+typedef struct
+{
+	geWorld				*World;
+	GE_CollisionQuery	*Queries;
+	int32				NumQueries;
+	volatile LONG		NextQuery;
+} Trace_Batch;
+
+//=====================================================================================
+//	Trace_RunBatch
+//	Takes queries off the batch until there are none left
+//=====================================================================================
+static void Trace_RunBatch(void *Context)
+{
+	Trace_Batch			*Batch;
+	Trace_Query			Query;
+	GE_CollisionQuery	*Q;
+	LONG				i;
+
+	Batch = (Trace_Batch*)Context;
+
+	while ((i = InterlockedIncrement(&Batch->NextQuery)-1) < Batch->NumQueries)
+	{
+		Q = &Batch->Queries[i];
+
+		Trace_InitQuery(&Query);
+		Query.Ratio = TRACE_BATCH_NO_RATIO;
+
+		Q->Hit = Trace_QueryWorldCollision(&Query, Batch->World, Q->Mins, Q->Maxs, &Q->Front, &Q->Back, Q->Contents, Q->CollideFlags, Q->UserFlags, Q->CollisionCB, Q->Context, &Q->Col);
+
+		// Hit or not, Trace_CollisionBatch needs to know if this one set the ratio
+		Q->Col.Ratio = Query.Ratio;
+	}
+}
+
+//=====================================================================================
+//	Trace_CollisionBatch
+//=====================================================================================
+geBoolean Trace_CollisionBatch(geWorld *World, GE_CollisionQuery *Queries, int32 NumQueries, int32 NumThreads)
+{
+	Trace_Batch		Batch;
+	int32			i;
+
+	assert(World != NULL);
+	assert(World->CurrentBSP != NULL);
+	assert(Queries != NULL || NumQueries == 0);
+
+	if (NumQueries <= 0)
+		return GE_TRUE;
+
+	NumThreads = WorkPool_NumThreads(NumThreads, NumQueries, TRACE_BATCH_PER_THREAD);
+
+	Batch.World = World;
+	Batch.Queries = Queries;
+	Batch.NumQueries = NumQueries;
+	Batch.NextQuery = 0;
+
+	// Up front, on this thread, so the queries only read the tree
+	if (!Trace_UpdateActors(World, GE_COLLIDE_ACTORS))
+		return GE_FALSE;
+
+	WorkPool_Run(Trace_RunBatch, &Batch, NumThreads);
+
+	// Hits on actors only never set the ratio, so geWorld_Collision gives back the one from
+	//	the last collision that did (see Trace_GEWorldCollision).  Hand them out the same way,
+	//	as if the queries had been run one after another.
+	for (i=0; i< NumQueries; i++)
+	{
+		if (Queries[i].Col.Ratio == TRACE_BATCH_NO_RATIO)
+			Queries[i].Col.Ratio = GRatio;
+		else
+			GRatio = Queries[i].Col.Ratio;
+
+		if (Queries[i].Mins && Queries[i].Maxs)
+			NumBBoxCast++;
+		else
+			NumExactCast++;
+	}
+
+	return GE_TRUE;
+}
+
 //=====================================================================================
 //	Trace_WorldCollisionExact
 //=====================================================================================
@@ -245,6 +449,45 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 									uint32 UserFlags,
 									GE_CollisionCB *CollisionCB,
 									void *Context)
+{
+	Trace_Query	Query;
+	geBoolean	Hit;
+
+	assert(World != NULL);
+	assert(World->CurrentBSP != NULL);
+
+	BSPData = &World->CurrentBSP->BSPData;
+
+	Trace_UpdateActors(World, Flags);
+
+	Trace_InitQuery(&Query);
+	Query.Contents = gContents;
+	Query.BSPData = BSPData;
+	Query.Ratio = GRatio;
+
+	Hit = QueryCollisionExact(&Query, World, Front, Back, Flags, Impact, Plane, Model, Mesh, Actor, UserFlags, CollisionCB, Context);
+
+	GRatio = Query.Ratio;
+
+	return Hit;
+}
+
+//=====================================================================================
+//	QueryCollisionExact
+//=====================================================================================
+static geBoolean QueryCollisionExact(Trace_Query *Q,
+									geWorld *World, 
+									const geVec3d *Front, 
+									const geVec3d *Back, 
+									uint32 Flags,
+									geVec3d *Impact,
+									GFX_Plane *Plane,
+									geWorld_Model **Model,
+									Mesh_RenderQ **Mesh, 
+									geActor **Actor,
+									uint32 UserFlags,
+									GE_CollisionCB *CollisionCB,
+									void *Context)
 {
 	int32			i, b;
 	geVec3d			NewFront1, NewBack1;
@@ -264,7 +507,6 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 	assert(Front != NULL);
 	assert(Back!= NULL);
 	
-	BSPData = &World->CurrentBSP->BSPData;
 	Models = World->CurrentBSP->Models;
 	
 	// Clear mesh/model collision pointers
@@ -282,7 +524,7 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 
 	if (Flags & GE_COLLIDE_ACTORS)
 	{
-		BestActor = Trace_ActorCollide(World,NULL, NULL, Front,Back,&Impact2, &Plane2, UserFlags, CollisionCB, Context, &BestD);
+		BestActor = Trace_ActorCollide(Q, World,NULL, NULL, Front,Back,&Impact2, &Plane2, UserFlags, CollisionCB, Context, &BestD);
 		if (BestActor != NULL)
 		{
 			BestI = Impact2;
@@ -296,7 +538,7 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 
 	Trace_GetMoveBox(&MMins, &MMaxs, Front, Back, &OMins, &OMaxs);
 
-	for (i = 0; i < BSPData->NumGFXModels; i++, Models++)
+	for (i = 0; i < Q->BSPData->NumGFXModels; i++, Models++)
 	{
 		// First, give the caller a chance to reject the model
 		if (CollisionCB && !CollisionCB(Models, NULL, Context))
@@ -325,31 +567,31 @@ geBoolean Trace_WorldCollisionExact(geWorld *World,
 		geVec3d_Add(&NewFront2, &Models->Pivot, &NewFront1);
 		geVec3d_Add(&NewBack2 , &Models->Pivot, &NewBack1);
 		
-		HitSet = FALSE;
+		Q->HitSet = GE_FALSE;
 
-		if (BSPIntersect(&NewFront1, &NewBack1, BSPData->GFXModels[i].RootNode[0]))
+		if (BSPIntersect(Q, &NewFront1, &NewBack1, Q->BSPData->GFXModels[i].RootNode[0]))
 		{
 			// Rotate the impact plane
-			geXForm3d_Rotate(&Models->XForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+			geXForm3d_Rotate(&Models->XForm, &Q->Plane.Normal, &Q->Plane.Normal);
 			
 			// Rotate the impact point
-			geVec3d_Subtract(&GlobalI, &Models->Pivot, &GlobalI);
-			geXForm3d_Transform(&Models->XForm, &GlobalI, &GlobalI);
-			geVec3d_Add(&GlobalI, &Models->Pivot, &GlobalI);
+			geVec3d_Subtract(&Q->I, &Models->Pivot, &Q->I);
+			geXForm3d_Transform(&Models->XForm, &Q->I, &Q->I);
+			geVec3d_Add(&Q->I, &Models->Pivot, &Q->I);
 			
 			// Find the new plane distance based on the new impact point with the new plane
-			GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+			Q->Plane.Dist = geVec3d_DotProduct(&Q->Plane.Normal, &Q->I);
 
-			geVec3d_Subtract(&GlobalI, Front, &Vect);
+			geVec3d_Subtract(&Q->I, Front, &Vect);
 			Dist = geVec3d_Length(&Vect);
 
 			if (Dist < BestD)
 			{
 				BestD = Dist;
-				BestI = GlobalI;
+				BestI = Q->I;
 			
-				BestPlane = GlobalPlane;
-				if (GlobalSide)
+				BestPlane = Q->Plane;
+				if (Q->Side)
 				{
 					geVec3d_Inverse(&BestPlane.Normal);
 					BestPlane.Dist = -BestPlane.Dist;
@@ -405,6 +647,7 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 	geVec3d			NewFront1, NewBack1;
 	geVec3d			NewFront2, NewBack2;
 	geWorld_Model		*Models;
+	Trace_Query			Query;
 
 	assert(World != NULL);
 	assert(World->CurrentBSP != NULL);
@@ -414,10 +657,13 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 	BSPData = &World->CurrentBSP->BSPData;
 	Models = World->CurrentBSP->Models;
 	
-	GPlaneNum = -1;
-
 	gContents = GE_CONTENTS_SOLID_CLIP;
 
+	Trace_InitQuery(&Query);
+	Query.BSPData = BSPData;
+	Query.Contents = GE_CONTENTS_SOLID_CLIP;
+	Query.PlaneNum = -1;
+
 	for (i = 0; i < BSPData->NumGFXModels; i++)
 	{
 		
@@ -433,17 +679,17 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 		geVec3d_Add(&NewFront2, &Models[i].Pivot, &NewFront1);
 		geVec3d_Add(&NewBack2 , &Models[i].Pivot, &NewBack1);
 		
-		HitSet = FALSE;
+		Query.HitSet = GE_FALSE;
 		
-		if (BSPIntersect(&NewFront1, &NewBack1, BSPData->GFXModels[i].RootNode[0]))
+		if (BSPIntersect(&Query, &NewFront1, &NewBack1, BSPData->GFXModels[i].RootNode[0]))
 		{
-			if (GPlaneNum == -1)
+			if (Query.PlaneNum == -1)
 				return FALSE;
 
-			if (Impact) *Impact = GlobalI;
-			if (Node) *Node = GlobalNode;
-			if (Plane) *Plane = GPlaneNum;
-			if (Side) *Side = GlobalSide;
+			if (Impact) *Impact = Query.I;
+			if (Node) *Node = Query.Node;
+			if (Plane) *Plane = Query.PlaneNum;
+			if (Side) *Side = Query.Side;
 
 			return GE_TRUE;
 		}
@@ -460,7 +706,7 @@ geBoolean Trace_WorldCollisionExact2(	geWorld *World,
 //	BSPIntersect
 //	Shoot a ray through the tree finding out what solid leafs it passed through
 //=====================================================================================
-static geBoolean BSPIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
+static geBoolean BSPIntersect(Trace_Query *Q, geVec3d *Front, geVec3d *Back, int32 Node)
 {
     geFloat		Fd, Bd, Dist;
     int32		Side;
@@ -470,23 +716,23 @@ static geBoolean BSPIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
 
 	if (Node < 0)
 	{
-		Contents = BSPData->GFXLeafs[-(Node+1)].Contents;
+		Contents = Q->BSPData->GFXLeafs[-(Node+1)].Contents;
 
-		if (Contents & gContents)
+		if (Contents & Q->Contents)
 		    return GE_TRUE;						// Ray collided with solid space
 
 		return GE_FALSE;
 	}
 
-	Plane = &BSPData->GFXPlanes[BSPData->GFXNodes[Node].PlaneNum];
+	Plane = &Q->BSPData->GFXPlanes[Q->BSPData->GFXNodes[Node].PlaneNum];
 
     Fd = Plane_PlaneDistanceFast(Plane, Front);
     Bd = Plane_PlaneDistanceFast(Plane, Back);
 
     if (Fd >= 0 && Bd >= 0) 
-        return(BSPIntersect(Front, Back, BSPData->GFXNodes[Node].Children[0]));
+        return(BSPIntersect(Q, Front, Back, Q->BSPData->GFXNodes[Node].Children[0]));
     if (Fd < 0 && Bd < 0)
-        return(BSPIntersect(Front, Back, BSPData->GFXNodes[Node].Children[1]));
+        return(BSPIntersect(Q, Front, Back, Q->BSPData->GFXNodes[Node].Children[1]));
 
     Side = Fd < 0;
     Dist = Fd / (Fd - Bd);
@@ -499,19 +745,19 @@ static geBoolean BSPIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
 	// is no more collisions, we can assume that we have the front portion of the
 	// ray that is in empty space.  Once we find this, and see that the back half is in
 	// solid space, then we found the front intersection point...
-	if (BSPIntersect(Front, &I, BSPData->GFXNodes[Node].Children[Side]))
+	if (BSPIntersect(Q, Front, &I, Q->BSPData->GFXNodes[Node].Children[Side]))
         return GE_TRUE;
-    else if (BSPIntersect(&I, Back, BSPData->GFXNodes[Node].Children[!Side]))
+    else if (BSPIntersect(Q, &I, Back, Q->BSPData->GFXNodes[Node].Children[!Side]))
 	{
-		if (!HitSet)
+		if (!Q->HitSet)
 		{
-			GPlaneNum = BSPData->GFXNodes[Node].PlaneNum;
-			GlobalPlane = BSPData->GFXPlanes[GPlaneNum];
-			GlobalSide = Side;
-			GlobalI = I;
-			GlobalNode = Node;
-			GRatio = Dist;
-			HitSet = TRUE;
+			Q->PlaneNum = Q->BSPData->GFXNodes[Node].PlaneNum;
+			Q->Plane = Q->BSPData->GFXPlanes[Q->PlaneNum];
+			Q->Side = Side;
+			Q->I = I;
+			Q->Node = Node;
+			Q->Ratio = Dist;
+			Q->HitSet = GE_TRUE;
 		}
 		return GE_TRUE;
 	}
@@ -530,9 +776,7 @@ static GFX_LeafSide		*MiscSides;
 
 static geVec3d			GMins1, GMaxs1;
 static geVec3d			GMins2, GMaxs2;
-static geVec3d			GFront, GBack;
 static BOOL				LeafHit;
-static geFloat			BestDist;
 
 static geBoolean BSPIntersectMisc(geVec3d *Front, geVec3d *Back, int32 Node)
 {
@@ -860,48 +1104,53 @@ static geBoolean PointInLeafSides(const geVec3d *Pos, const GFX_Leaf *Leaf)
 //=====================================================================================
 //	IntersectLeafSides
 //=====================================================================================
-BOOL IntersectLeafSides_r(geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side, int32 PSide)
+static BOOL IntersectLeafSides_r(Trace_Query *Q, geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side, int32 PSide)
 {
 	geFloat		Fd, Bd, Dist;
 	GFX_Plane	Plane;
 	int32		RSide, Side2;
 	geVec3d		I, Vec;
+	GFX_Leaf	*Leafs;
+	GFX_LeafSide	*Sides;
 
 	if (!PSide)
 		return FALSE;
 
-	if (Side >= MiscLeafs[Leaf].NumSides)
+	Leafs = Q->BSPData->GFXLeafs;
+	Sides = Q->BSPData->GFXLeafSides;
+
+	if (Side >= Leafs[Leaf].NumSides)
 		return TRUE;		// if it lands behind all planes, it is inside
 
-	RSide = MiscLeafs[Leaf].FirstSide + Side;
+	RSide = Leafs[Leaf].FirstSide + Side;
 
-	Plane = MiscPlanes[MiscSides[RSide].PlaneNum];
+	Plane = Q->BSPData->GFXPlanes[Sides[RSide].PlaneNum];
 	Plane.Type = PLANE_ANY;
 	
-	if (MiscSides[RSide].PlaneSide)
+	if (Sides[RSide].PlaneSide)
 	{
 		geVec3d_Inverse(&Plane.Normal);
 		Plane.Dist = -Plane.Dist;
 	}
 	
 	// Simulate the point having a box, by pushing the plane out by the box size
-	Trace_ExpandPlaneForBox(&Plane, &GMins1, &GMaxs1);
+	Trace_ExpandPlaneForBox(&Plane, &Q->Mins1, &Q->Maxs1);
 
 	Fd = Plane_PlaneDistanceFast(&Plane, Front);
 	Bd = Plane_PlaneDistanceFast(&Plane, Back);
 
 #if 1
 	if (Fd >= 0 && Bd >= 0)	// Leaf sides are convex hulls, so front side is totally outside
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 0);
+		return IntersectLeafSides_r(Q, Front, Back, Leaf, Side+1, 0);
 
 	if (Fd < 0 && Bd < 0)
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 1);
+		return IntersectLeafSides_r(Q, Front, Back, Leaf, Side+1, 1);
 #else
 	if ((Fd >= ON_EPSILON && Bd >= ON_EPSILON) || (Bd > Fd && Fd >= 0) )
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 0);
+		return IntersectLeafSides_r(Q, Front, Back, Leaf, Side+1, 0);
 
 	if ((Fd < -ON_EPSILON && Bd < -ON_EPSILON) || (Bd < Fd && Fd <= 0))
-		return IntersectLeafSides_r(Front, Back, Leaf, Side+1, 1);
+		return IntersectLeafSides_r(Q, Front, Back, Leaf, Side+1, 1);
 #endif
 
 	// We have an intersection
@@ -926,27 +1175,27 @@ BOOL IntersectLeafSides_r(geVec3d *Front, geVec3d *Back, int32 Leaf, int32 Side,
     I.Z = Front->Z + Dist * (Back->Z - Front->Z);
 
 	// Only go down the back side, since the front side is empty in a convex tree
-	if (IntersectLeafSides_r(Front, &I, Leaf, Side+1, Side2))
+	if (IntersectLeafSides_r(Q, Front, &I, Leaf, Side+1, Side2))
 	{
-		LeafHit = TRUE;
+		Q->LeafHit = GE_TRUE;
 		return TRUE;
 	}
-	else if (IntersectLeafSides_r(&I, Back, Leaf, Side+1, !Side2))
+	else if (IntersectLeafSides_r(Q, &I, Back, Leaf, Side+1, !Side2))
 	{
-		geVec3d_Subtract(&I, &GFront, &Vec);
+		geVec3d_Subtract(&I, &Q->Front, &Vec);
 		Dist = geVec3d_Length(&Vec);
 
 		// Record the intersection closest to the start of ray
-		if (Dist < BestDist && !HitSet)
+		if (Dist < Q->BestDist && !Q->HitSet)
 		{
-			GlobalI = I;
-			GlobalLeaf = Leaf;
-			BestDist = Dist;
-			GlobalPlane = Plane;
-			GRatio = Dist;
-			HitSet = TRUE;
+			Q->I = I;
+			Q->Leaf = Leaf;
+			Q->BestDist = Dist;
+			Q->Plane = Plane;
+			Q->Ratio = Dist;
+			Q->HitSet = GE_TRUE;
 		}
-		LeafHit = TRUE;
+		Q->LeafHit = GE_TRUE;
 		return TRUE;
 	}
 	
@@ -985,38 +1234,38 @@ BOOL IntersectLeafSides2(geVec3d *Pos, int32 Leaf)
 //=====================================================================================
 //	FindClosestLeafIntersection_r
 //=====================================================================================
-static	void FindClosestLeafIntersection_r(int32 Node)
+static	void FindClosestLeafIntersection_r(Trace_Query *Q, int32 Node)
 {
 	int32		Leaf, Side, Contents;
 
 	if (Node < 0)
 	{
 		Leaf = -(Node+1);
-		Contents = MiscLeafs[Leaf].Contents;
+		Contents = Q->BSPData->GFXLeafs[Leaf].Contents;
 
 		//if (Contents != BSP_CONTENTS_SOLID && Contents != BSP_CONTENTS_WINDOW)
-		if (!(Contents & gContents))
+		if (!(Contents & Q->Contents))
 			return;		// Only solid leafs contain side info...
 
-		HitSet = FALSE;
+		Q->HitSet = GE_FALSE;
 		
-		if (!MiscLeafs[Leaf].NumSides)
+		if (!Q->BSPData->GFXLeafs[Leaf].NumSides)
 			return;
 
-		IntersectLeafSides_r(&GFront, &GBack, Leaf, 0, 1);
+		IntersectLeafSides_r(Q, &Q->Front, &Q->Back, Leaf, 0, 1);
 		//IntersectLeafSides2(&GBack, Leaf);
 
 		return;
 	}
 
-	Side = Trace_BoxOnPlaneSide(&GMins2, &GMaxs2, &MiscPlanes[MiscNodes[Node].PlaneNum]);
+	Side = Trace_BoxOnPlaneSide(&Q->Mins2, &Q->Maxs2, &Q->BSPData->GFXPlanes[Q->BSPData->GFXNodes[Node].PlaneNum]);
 
 	// Go down the sides that the box lands in
 	if (Side & PSIDE_FRONT)
-		FindClosestLeafIntersection_r(MiscNodes[Node].Children[0]);
+		FindClosestLeafIntersection_r(Q, Q->BSPData->GFXNodes[Node].Children[0]);
 
 	if (Side & PSIDE_BACK)
-		FindClosestLeafIntersection_r(MiscNodes[Node].Children[1]);
+		FindClosestLeafIntersection_r(Q, Q->BSPData->GFXNodes[Node].Children[1]);
 }
 
 #define SIDE_SPACE		0.1f
@@ -1036,6 +1285,49 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 									uint32 UserFlags,
 									GE_CollisionCB *CollisionCB,
 									void *Context)
+{
+	Trace_Query	Query;
+	geBoolean	Hit;
+
+	assert(World != NULL);
+	assert(World->CurrentBSP != NULL);
+
+	BSPData = &World->CurrentBSP->BSPData;
+
+	MiscNodes = BSPData->GFXNodes;
+	MiscPlanes = BSPData->GFXPlanes;
+	MiscLeafs = BSPData->GFXLeafs;
+	MiscSides = BSPData->GFXLeafSides;
+
+	Trace_UpdateActors(World, Flags);
+
+	Trace_InitQuery(&Query);
+	Query.Contents = gContents;
+	Query.BSPData = BSPData;
+	Query.Ratio = GRatio;
+
+	Hit = QueryCollisionBBox(&Query, World, Mins, Maxs, Front, Back, Flags, I, P, Model, Mesh, Actor, UserFlags, CollisionCB, Context);
+
+	GRatio = Query.Ratio;
+
+	return Hit;
+}
+
+//=====================================================================================
+//	QueryCollisionBBox
+//=====================================================================================
+static geBoolean QueryCollisionBBox(Trace_Query	*Q,
+									geWorld	*World,
+									const	geVec3d *Mins, const geVec3d *Maxs, 
+									const	geVec3d *Front, const geVec3d *Back,
+									uint32	Flags,
+									geVec3d *I, GFX_Plane *P,
+									geWorld_Model **Model,
+									Mesh_RenderQ **Mesh,
+									geActor **Actor,
+									uint32 UserFlags,
+									GE_CollisionCB *CollisionCB,
+									void *Context)
 {
 	geWorld_Model	*Models;
 	geVec3d			NewFront, NewBack, OMins, OMaxs, BestI, Vect;
@@ -1087,7 +1379,7 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 	
 	if (Flags & GE_COLLIDE_ACTORS)
 		{
-			BestActor = Trace_ActorCollide(World, Mins,Maxs, Front,Back,&Impact,&Plane2,UserFlags, CollisionCB, Context, &BestD);
+			BestActor = Trace_ActorCollide(Q, World, Mins,Maxs, Front,Back,&Impact,&Plane2,UserFlags, CollisionCB, Context, &BestD);
 			if (BestActor != NULL)
 				{
 					BestI = Impact;
@@ -1097,25 +1389,19 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 		}
 
 	
-	// GMins1/GMaxs1 is what is used to exapand the plane out with
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	// Mins1/Maxs1 is what is used to exapand the plane out with
+	Q->Mins1 = *Mins;
+	Q->Maxs1 = *Maxs;
 	
-	GFront = *Front;
-	GBack = *Back;
+	Q->Front = *Front;
+	Q->Back = *Back;
 
-	BSPData = &World->CurrentBSP->BSPData;
 	Models = World->CurrentBSP->Models;
 
-	MiscNodes = BSPData->GFXNodes;
-	MiscPlanes = BSPData->GFXPlanes;
-	MiscLeafs = BSPData->GFXLeafs;
-	MiscSides = BSPData->GFXLeafSides;
-
-	assert(MiscNodes != NULL);
-	assert(MiscPlanes != NULL);
-	assert(MiscLeafs != NULL);
-	assert(MiscSides != NULL);
+	assert(Q->BSPData->GFXNodes != NULL);
+	assert(Q->BSPData->GFXPlanes != NULL);
+	assert(Q->BSPData->GFXLeafs != NULL);
+	assert(Q->BSPData->GFXLeafSides != NULL);
 
 	if (!(Flags & GE_COLLIDE_MODELS))
 		goto NoModels;
@@ -1124,7 +1410,7 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 
 	// Then test the world bsp(all models are the world bsp)
 	// Go through each model, and find out what leafs we hit, keeping the closest intersection
-	for (i = 0; i < BSPData->NumGFXModels; i++, Models++)
+	for (i = 0; i < Q->BSPData->NumGFXModels; i++, Models++)
 	{
 		
 		// First, see if the user wants to reject it...
@@ -1144,49 +1430,49 @@ geBoolean Trace_WorldCollisionBBox(	geWorld	*World,
 		
 
 		// Reset flags
-		BestDist = 9999.0f;
-		LeafHit = FALSE;
+		Q->BestDist = 9999.0f;
+		Q->LeafHit = GE_FALSE;
 		
-		geVec3d_Subtract(Front, &Models->Pivot, &GFront);
-		geVec3d_Subtract(Back , &Models->Pivot, &GBack);
+		geVec3d_Subtract(Front, &Models->Pivot, &Q->Front);
+		geVec3d_Subtract(Back , &Models->Pivot, &Q->Back);
 
 		// InverseTransform the point about models center of rotation
-		geXForm3d_TransposeTransform(&Models->XForm, &GFront, &NewFront);
-		geXForm3d_TransposeTransform(&Models->XForm, &GBack , &NewBack);
+		geXForm3d_TransposeTransform(&Models->XForm, &Q->Front, &NewFront);
+		geXForm3d_TransposeTransform(&Models->XForm, &Q->Back , &NewBack);
 
 		// push back into world
-		geVec3d_Add(&NewFront, &Models->Pivot, &GFront);
-		geVec3d_Add(&NewBack , &Models->Pivot, &GBack);
+		geVec3d_Add(&NewFront, &Models->Pivot, &Q->Front);
+		geVec3d_Add(&NewBack , &Models->Pivot, &Q->Back);
 		
 		// Make out box out of this move so we only check the leafs it intersected with...
 
-		Trace_GetMoveBox(Mins, Maxs, &GFront, &GBack, &GMins2, &GMaxs2);
+		Trace_GetMoveBox(Mins, Maxs, &Q->Front, &Q->Back, &Q->Mins2, &Q->Maxs2);
 
-		FindClosestLeafIntersection_r(BSPData->GFXModels[i].RootNode[0]);
+		FindClosestLeafIntersection_r(Q, Q->BSPData->GFXModels[i].RootNode[0]);
 
-		if (LeafHit)
+		if (Q->LeafHit)
 		{
 			
 			// Rotate the impact plane
-			geXForm3d_Rotate(&Models->XForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+			geXForm3d_Rotate(&Models->XForm, &Q->Plane.Normal, &Q->Plane.Normal);
 			
 			// Rotate the impact point
-			geVec3d_Subtract(&GlobalI, &Models->Pivot, &GlobalI);
-			geXForm3d_Transform(&Models->XForm, &GlobalI, &NewFront);
-			//geXForm3d_Rotate(&Models->XForm, &GlobalI, &NewFront);
-			geVec3d_Add(&NewFront, &Models->Pivot, &GlobalI);
+			geVec3d_Subtract(&Q->I, &Models->Pivot, &Q->I);
+			geXForm3d_Transform(&Models->XForm, &Q->I, &NewFront);
+			//geXForm3d_Rotate(&Models->XForm, &Q->I, &NewFront);
+			geVec3d_Add(&NewFront, &Models->Pivot, &Q->I);
 			
 			// Find the new plane distance based on the new impact point with the new plane
-			GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+			Q->Plane.Dist = geVec3d_DotProduct(&Q->Plane.Normal, &Q->I);
 
-			geVec3d_Subtract(&GlobalI, Front, &Vect);
+			geVec3d_Subtract(&Q->I, Front, &Vect);
 
 			Dist = geVec3d_Length(&Vect);
 			if (Dist < BestD)
 			{
 				BestD = Dist;
-				BestI = GlobalI;
-				BestPlane = GlobalPlane;
+				BestI = Q->I;
+				BestPlane = Q->Plane;
 				BestModel = Models;
 				BestMesh = NULL;			// Reset the mesh flag...
 				BestActor = NULL;
@@ -1229,6 +1515,7 @@ geBoolean Trace_TestModelMove(	geWorld			*World,
 								const geVec3d	*In, geVec3d *Out)
 {
 	geVec3d		NewFront, NewBack, Original;
+	Trace_Query	Query;
 
 	assert(World != NULL);
 	assert(Model != NULL);
@@ -1245,58 +1532,62 @@ geBoolean Trace_TestModelMove(	geWorld			*World,
 	assert(MiscLeafs != NULL);
 	assert(MiscSides != NULL);
 
+	Trace_InitQuery(&Query);
+	Query.BSPData = BSPData;
+	Query.Contents = gContents;		// Whatever the last collision used
+
 	Original = *In;		// Save original
 
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	Query.Mins1 = *Mins;
+	Query.Maxs1 = *Maxs;
 	
 	// Put point about models origin
-	geVec3d_Subtract(In, &Model->Pivot, &GFront);
-	GBack = GFront;
+	geVec3d_Subtract(In, &Model->Pivot, &Query.Front);
+	Query.Back = Query.Front;
 
 	// InverseTransform the points about models center of rotation
-	geXForm3d_TransposeTransform(&Model->XForm, &GFront, &NewFront);
+	geXForm3d_TransposeTransform(&Model->XForm, &Query.Front, &NewFront);
 	// The back gets applied by the dest XForm
-	geXForm3d_TransposeTransform(DXForm, &GBack, &NewBack);
+	geXForm3d_TransposeTransform(DXForm, &Query.Back, &NewBack);
 
 	// push back into world
-	geVec3d_Add(&NewFront, &Model->Pivot, &GFront);
-	geVec3d_Add(&NewBack , &Model->Pivot, &GBack);
+	geVec3d_Add(&NewFront, &Model->Pivot, &Query.Front);
+	geVec3d_Add(&NewBack , &Model->Pivot, &Query.Back);
 
 	// Make out box out of this move so we only check the leafs it intersected with...
-	Trace_GetMoveBox(Mins, Maxs, &GFront, &GBack, &GMins2, &GMaxs2);
+	Trace_GetMoveBox(Mins, Maxs, &Query.Front, &Query.Back, &Query.Mins2, &Query.Maxs2);
 	
-	BestDist = 9999.0f;
-	LeafHit = FALSE;
+	Query.BestDist = 9999.0f;
+	Query.LeafHit = GE_FALSE;
 
-	FindClosestLeafIntersection_r(BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
+	FindClosestLeafIntersection_r(&Query, BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
 
-	if (LeafHit)
+	if (Query.LeafHit)
 	{
 		GE_Collision	Collision;
 
 		// Rotate the impact plane
-		geXForm3d_Rotate(DXForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+		geXForm3d_Rotate(DXForm, &Query.Plane.Normal, &Query.Plane.Normal);
 			
 		// Rotate the impact point
-		geVec3d_Subtract(&GlobalI, &Model->Pivot, &NewFront);
-		geXForm3d_Transform(DXForm, &NewFront, &GlobalI);
-		geVec3d_Add(&GlobalI, &Model->Pivot, &NewFront);
-		GlobalI = NewFront;
+		geVec3d_Subtract(&Query.I, &Model->Pivot, &NewFront);
+		geXForm3d_Transform(DXForm, &NewFront, &Query.I);
+		geVec3d_Add(&Query.I, &Model->Pivot, &NewFront);
+		Query.I = NewFront;
 
 		// Find the new plane distance based on the new impact point with the new plane
-		GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
+		Query.Plane.Dist = geVec3d_DotProduct(&Query.Plane.Normal, &Query.I);
 
-		geVec3d_MA(&GlobalI, ON_EPSILON, &GlobalPlane.Normal, &GlobalI);
+		geVec3d_MA(&Query.I, ON_EPSILON, &Query.Plane.Normal, &Query.I);
 		
 		// If the point gets pushed into the world as a result of the move, then cancel it out...
-		if (Trace_GEWorldCollision(World, Mins, Maxs, In, &GlobalI, GE_CONTENTS_SOLID_CLIP, GE_COLLIDE_ALL, 0xffffffff, NULL, NULL, &Collision))
+		if (Trace_GEWorldCollision(World, Mins, Maxs, In, &Query.I, GE_CONTENTS_SOLID_CLIP, GE_COLLIDE_ALL, 0xffffffff, NULL, NULL, &Collision))
 		{
 			*Out = Original;
 			return GE_FALSE;
 		}
 
-		*Out = GlobalI;
+		*Out = Query.I;
 
 		return GE_TRUE;
 	}
@@ -1310,7 +1601,8 @@ geBoolean Trace_TestModelMove(	geWorld			*World,
 // Trace_ModelCollisionBBox
 //=====================================================================================
 static
-geBoolean Trace_ModelCollisionBBox(geWorld *World, 
+geBoolean Trace_ModelCollisionBBox(Trace_Query *Q,
+								   geWorld *World, 
 								   geWorld_Model *Model, 
 								   const geXForm3d *DXForm, 
 								   const geVec3d *Mins, const geVec3d *Maxs,
@@ -1323,56 +1615,52 @@ geBoolean Trace_ModelCollisionBBox(geWorld *World,
 	//MRB END
 	assert(World != NULL);
 	assert(Model != NULL);
-	BSPData = &World->CurrentBSP->BSPData;
-	MiscNodes = BSPData->GFXNodes;
-	MiscPlanes = BSPData->GFXPlanes;
-	MiscLeafs = BSPData->GFXLeafs;
-	MiscSides = BSPData->GFXLeafSides;
-	assert(MiscNodes != NULL);
-	assert(MiscPlanes != NULL);
-	assert(MiscLeafs != NULL);
-	assert(MiscSides != NULL);
+	Q->BSPData = &World->CurrentBSP->BSPData;
+	assert(Q->BSPData->GFXNodes != NULL);
+	assert(Q->BSPData->GFXPlanes != NULL);
+	assert(Q->BSPData->GFXLeafs != NULL);
+	assert(Q->BSPData->GFXLeafSides != NULL);
 	//MRB BEGIN
 	// Original = *In; // Save original
 	//MRB END
-	GMins1 = *Mins;
-	GMaxs1 = *Maxs;
+	Q->Mins1 = *Mins;
+	Q->Maxs1 = *Maxs;
 	
 	// Put point about models origin
-	geVec3d_Subtract(In, &Model->Pivot, &GFront);
-	GBack = GFront;
+	geVec3d_Subtract(In, &Model->Pivot, &Q->Front);
+	Q->Back = Q->Front;
 	// InverseTransform the points about models center of rotation
-	geXForm3d_TransposeTransform(&Model->XForm, &GFront, &NewFront);
+	geXForm3d_TransposeTransform(&Model->XForm, &Q->Front, &NewFront);
 	// The back gets applied by the dest XForm
-	geXForm3d_TransposeTransform(DXForm, &GBack, &NewBack);
+	geXForm3d_TransposeTransform(DXForm, &Q->Back, &NewBack);
 	// push back into world
-	geVec3d_Add(&NewFront, &Model->Pivot, &GFront);
-	geVec3d_Add(&NewBack , &Model->Pivot, &GBack);
+	geVec3d_Add(&NewFront, &Model->Pivot, &Q->Front);
+	geVec3d_Add(&NewBack , &Model->Pivot, &Q->Back);
 	// Make out box out of this move so we only check the leafs it intersected with...
-	Trace_GetMoveBox(Mins, Maxs, &GFront, &GBack, &GMins2, &GMaxs2);
+	Trace_GetMoveBox(Mins, Maxs, &Q->Front, &Q->Back, &Q->Mins2, &Q->Maxs2);
 	
-	BestDist = 9999.0f;
-	LeafHit = FALSE;
-	FindClosestLeafIntersection_r(BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
-	if (LeafHit)
+	Q->BestDist = 9999.0f;
+	Q->LeafHit = GE_FALSE;
+	FindClosestLeafIntersection_r(Q, Q->BSPData->GFXModels[Model->GFXModelNum].RootNode[0]);
+	if (Q->LeafHit)
 	{
 		// Rotate the impact plane
-		geXForm3d_Rotate(DXForm, &GlobalPlane.Normal, &GlobalPlane.Normal);
+		geXForm3d_Rotate(DXForm, &Q->Plane.Normal, &Q->Plane.Normal);
 		
 		// Rotate the impact point
 		//MRB BEGIN
-		// geVec3d_Subtract(&GlobalI, &Model->Pivot, &NewFront);
-		// geXForm3d_Transform(DXForm, &NewFront, &GlobalI);
-		// geVec3d_Add(&GlobalI, &Model->Pivot, &NewFront);
-		// GlobalI = NewFront;
-		geVec3d_Subtract(&GlobalI, &Model->Pivot, &GlobalI);
-		geXForm3d_Transform(DXForm, &GlobalI, &NewFront);
-		geVec3d_Add(&NewFront, &Model->Pivot, &GlobalI);
+		// geVec3d_Subtract(&Q->I, &Model->Pivot, &NewFront);
+		// geXForm3d_Transform(DXForm, &NewFront, &Q->I);
+		// geVec3d_Add(&Q->I, &Model->Pivot, &NewFront);
+		// Q->I = NewFront;
+		geVec3d_Subtract(&Q->I, &Model->Pivot, &Q->I);
+		geXForm3d_Transform(DXForm, &Q->I, &NewFront);
+		geVec3d_Add(&NewFront, &Model->Pivot, &Q->I);
 		//MRB END
 		// Find the new plane distance based on the new impact point with the new plane
-		GlobalPlane.Dist = geVec3d_DotProduct(&GlobalPlane.Normal, &GlobalI);
-		geVec3d_MA(&GlobalI, ON_EPSILON, &GlobalPlane.Normal, &GlobalI);
-		*ImpactPoint = GlobalI;
+		Q->Plane.Dist = geVec3d_DotProduct(&Q->Plane.Normal, &Q->I);
+		geVec3d_MA(&Q->I, ON_EPSILON, &Q->Plane.Normal, &Q->I);
+		*ImpactPoint = Q->I;
 		return GE_TRUE;
 	}
 	return GE_FALSE;
@@ -1389,11 +1677,14 @@ geBoolean Trace_ModelCollision(geWorld *World,
 	geExtBox ExtBox;
 	geVec3d Pos;
 	geXForm3d myXForm;
+	Trace_Query Query;
 #ifdef MESHES
 	Mesh_RenderQ * CollidableMesh;
 	Mesh_CollidableMeshIterator Iter;
 #endif
   gContents = GE_CONTENTS_SOLID_CLIP;		// eaa3 from G3D BBS posting 01/29/2001
+	Trace_InitQuery(&Query);
+	Query.Contents = GE_CONTENTS_SOLID_CLIP;
 	memset(Collision, 0, sizeof(GE_Collision));
 	// Fixed bug that mike pointed out. I was using 0, instead of 0xffffffff
 #ifdef MESHES
@@ -1402,7 +1693,7 @@ geBoolean Trace_ModelCollision(geWorld *World,
 	{
 		Mesh_MeshGetBox(World, CollidableMesh->MeshDef, &Mins, &Maxs);
 		Mesh_MeshGetPosition(CollidableMesh, &Pos);
-		if (Trace_ModelCollisionBBox(World, Model, DXForm, &Mins, &Maxs, &Pos, ImpactPoint))
+		if (Trace_ModelCollisionBBox(&Query, World, Model, DXForm, &Mins, &Maxs, &Pos, ImpactPoint))
 		{
 			Collision->Mesh = (geMesh *)CollidableMesh;
 			return GE_TRUE;
@@ -1440,16 +1731,16 @@ geBoolean Trace_ModelCollision(geWorld *World,
 				geVec3d_Subtract(&ExtBox.Max, &Pos, &ExtBox.Max);
 				// end eaa3 01/29/2001
 				// if (Trace_ModelCollisionBBox(World, Model, DXForm, &(ExtBox.Min), &(ExtBox.Max), &Pos, ImpactPoint))
-				if (Trace_ModelCollisionBBox(World, Model, DXForm, &(ExtBox.Min), &(ExtBox.Max), &Pos, &PossibleImpactPoint))
+				if (Trace_ModelCollisionBBox(&Query, World, Model, DXForm, &(ExtBox.Min), &(ExtBox.Max), &Pos, &PossibleImpactPoint))
 				{
 					// Collision->Actor = WA->Actor;
-					if (GlobalPlane.Dist < BestActorDist)
+					if (Query.Plane.Dist < BestActorDist)
 					{
-						BestActorDist = GlobalPlane.Dist;
+						BestActorDist = Query.Plane.Dist;
 						BestActor = WA->Actor;
 						(*ImpactPoint) = PossibleImpactPoint;
-						Collision->Plane.Normal = GlobalPlane.Normal;
-						Collision->Plane.Dist = GlobalPlane.Dist;
+						Collision->Plane.Normal = Query.Plane.Normal;
+						Collision->Plane.Dist = Query.Plane.Dist;
 						Collision->Ratio = geVec3d_DistanceBetween(&DXForm->Translation, &Model->XForm.Translation);
 					}
 					// return GE_TRUE;
@@ -1839,6 +2130,7 @@ geBoolean Trace_IntersectWorldBSP(geVec3d *Front, geVec3d *Back, int32 Node)
     geVec3d		I;
 	GFX_Plane	*Plane;
 	int32		Contents;
+	Trace_Query	Query;
 
 	gContents = GE_CONTENTS_SOLID_CLIP;
 
@@ -1853,13 +2145,17 @@ geBoolean Trace_IntersectWorldBSP(geVec3d *Front, geVec3d *Back, int32 Node)
 
 	Plane = &TreePlanes[TreeNodes[Node].PlaneNum];
 
+	Trace_InitQuery(&Query);
+	Query.BSPData = BSPData;
+	Query.Contents = gContents;
+
     Fd = Plane_PlaneDistanceFast(Plane, Front);
     Bd = Plane_PlaneDistanceFast(Plane, Back);
 
     if (Fd >= 0 && Bd >= 0) 
-        return(BSPIntersect(Front, Back, TreeNodes[Node].Children[0]));
+        return(BSPIntersect(&Query, Front, Back, TreeNodes[Node].Children[0]));
     if (Fd < 0 && Bd < 0)
-        return(BSPIntersect(Front, Back, TreeNodes[Node].Children[1]));
+        return(BSPIntersect(&Query, Front, Back, TreeNodes[Node].Children[1]));
 
     Side = Fd < 0;
     Dist = Fd / (Fd - Bd);
@@ -1872,9 +2168,9 @@ geBoolean Trace_IntersectWorldBSP(geVec3d *Front, geVec3d *Back, int32 Node)
 	// is no more collisions, we can assume that we have the front portion of the
 	// ray that is in empty space.  Once we find this, and see that the back half is in
 	// solid space, then we found the front intersection point...
-	if (BSPIntersect(Front, &I, TreeNodes[Node].Children[Side]))
+	if (BSPIntersect(&Query, Front, &I, TreeNodes[Node].Children[Side]))
         return GE_TRUE;
-    else if (BSPIntersect(&I, Back, TreeNodes[Node].Children[!Side]))
+    else if (BSPIntersect(&Query, &I, Back, TreeNodes[Node].Children[!Side]))
 	{
 		return GE_TRUE;
 	}
@@ -43,6 +43,9 @@
 static void MarkVisibleParents(geWorld *World, int32 Leaf);
 static void FindParents(World_BSP *Bsp);
 static void VisFog(geEngine *Engine, geWorld *World, const geCamera *Camera, Frustum_Info *Fi, int32 Area);
+static geBoolean AllocVisNodes(World_BSP *Bsp);
+static void FreeVisNodes(World_BSP *Bsp);
+static void BuildVisNodes(geWorld *World);
 
 //=====================================================================================
 //	Vis_WorldInit
@@ -90,6 +93,9 @@ geBoolean Vis_WorldInit(geWorld *World)
 	
 	FindParents(World->CurrentBSP);
 
+	if (!AllocVisNodes(BSP))
+		goto Error;
+
 	// Set the identity on the AreaMatrix
 	for (i=0; i<256; i++)
 		World->CurrentBSP->AreaConnections[i][i] = 1;
@@ -106,6 +112,8 @@ geBoolean Vis_WorldInit(geWorld *World)
 		if (BSP->NodeParents)
 			geRam_Free(BSP->NodeParents);
 
+		FreeVisNodes(BSP);
+
 		BSP->NodeVisFrame = NULL;
 		BSP->ClusterVisFrame = NULL;
 		BSP->AreaVisFrame = NULL;
@@ -136,6 +144,8 @@ void Vis_WorldShutdown(geWorld *World)
 	if (BSP->NodeParents)
 		geRam_Free(BSP->NodeParents);
 
+	FreeVisNodes(BSP);
+
 	BSP->NodeVisFrame = NULL;
 	BSP->ClusterVisFrame = NULL;
 	BSP->AreaVisFrame = NULL;
@@ -237,6 +247,7 @@ geBoolean Vis_VisWorld(geEngine *Engine, geWorld *World, const geCamera *Camera,
 	if (Cluster == -1 || GFXClusters[Cluster].VisOfs == -1)
 	{
 		World->VisInfo = GE_FALSE;
+		BuildVisNodes(World);
 		return GE_TRUE;
 	}
 
@@ -290,6 +301,9 @@ geBoolean Vis_VisWorld(geEngine *Engine, geWorld *World, const geCamera *Camera,
 		}
 	}
 
+	// Keep the visible part of the tree, so rendering doesn't have to find it again until the leaf changes
+	BuildVisNodes(World);
+
 	LeafDidNotChange:
 
 	// The world is always visible as a model
@@ -447,6 +461,160 @@ static void MarkVisibleParents(geWorld *World, int32 Leaf)
 	}
 }
 
+//=====================================================================================
+//	AllocVisNodes
+//	Makes room for every node and face, so building them never has to allocate
+//=====================================================================================
+static geBoolean AllocVisNodes(World_BSP *Bsp)
+{
+	World_VisNodes	*VisNodes;
+	int32			i, NumNodes;
+
+	VisNodes = &Bsp->VisNodes;
+
+	memset(VisNodes, 0, sizeof(*VisNodes));
+
+	VisNodes->Frame = -1;
+
+	NumNodes = Bsp->BSPData.NumGFXNodes;
+
+	if (NumNodes < 1)
+		NumNodes = 1;
+
+	VisNodes->Nodes = GE_RAM_ALLOCATE_ARRAY(World_VisNode, NumNodes);
+	VisNodes->Faces = GE_RAM_ALLOCATE_ARRAY(int32, Bsp->BSPData.NumGFXFaces ? Bsp->BSPData.NumGFXFaces : 1);
+
+	if (!VisNodes->Nodes || !VisNodes->Faces)
+		return GE_FALSE;
+
+	for (i=0; i<= MAX_MIRROR_RECURSION; i++)
+	{
+		VisNodes->Outside[i] = GE_RAM_ALLOCATE_ARRAY(uint32, NumNodes);
+		VisNodes->ClipFlags[i] = GE_RAM_ALLOCATE_ARRAY(uint32, NumNodes);
+
+		if (!VisNodes->Outside[i] || !VisNodes->ClipFlags[i])
+			return GE_FALSE;
+	}
+
+	for (i=0; i< 6; i++)
+	{
+		VisNodes->Bounds[i] = GE_RAM_ALLOCATE_ARRAY(geFloat, NumNodes);
+
+		if (!VisNodes->Bounds[i])
+			return GE_FALSE;
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	FreeVisNodes
+//=====================================================================================
+static void FreeVisNodes(World_BSP *Bsp)
+{
+	World_VisNodes	*VisNodes;
+	int32			i;
+
+	VisNodes = &Bsp->VisNodes;
+
+	if (VisNodes->Nodes)
+		geRam_Free(VisNodes->Nodes);
+	if (VisNodes->Faces)
+		geRam_Free(VisNodes->Faces);
+
+	for (i=0; i<= MAX_MIRROR_RECURSION; i++)
+	{
+		if (VisNodes->Outside[i])
+			geRam_Free(VisNodes->Outside[i]);
+		if (VisNodes->ClipFlags[i])
+			geRam_Free(VisNodes->ClipFlags[i]);
+	}
+
+	for (i=0; i< 6; i++)
+	{
+		if (VisNodes->Bounds[i])
+			geRam_Free(VisNodes->Bounds[i]);
+	}
+
+	memset(VisNodes, 0, sizeof(*VisNodes));
+
+	VisNodes->Frame = -1;
+}
+
+//=====================================================================================
+//	BuildVisNodes_r
+//	Copies out the nodes the renderer would visit, and the faces on them it would draw
+//=====================================================================================
+static int32 BuildVisNodes_r(geWorld *World, int32 Node)
+{
+	World_BSP		*Bsp;
+	World_VisNodes	*VisNodes;
+	World_VisNode	*pVisNode;
+	GFX_Node		*pNode;
+	Surf_SurfInfo	*pSurfInfo;
+	geFloat			*MinMaxs;
+	int32			i, Index;
+
+	if (Node < 0)		// Leafs are kept as they are
+		return Node;
+
+	Bsp = World->CurrentBSP;
+
+	if (Bsp->NodeVisFrame[Node] != World->CurFrameStatic && World->VisInfo)
+		return WORLD_VISNODE_SKIP;
+
+	VisNodes = &Bsp->VisNodes;
+
+	Index = VisNodes->NumNodes++;
+
+	pVisNode = &VisNodes->Nodes[Index];
+	pNode = &Bsp->BSPData.GFXNodes[Node];
+
+	pVisNode->Node = Node;
+	pVisNode->FirstFace = VisNodes->NumFaces;
+
+	pSurfInfo = &Bsp->SurfInfo[pNode->FirstFace];
+
+	for (i=0; i< pNode->NumFaces; i++, pSurfInfo++)
+	{
+		if (pSurfInfo->VisFrame != World->CurFrameStatic && World->VisInfo)
+			continue;
+
+		VisNodes->Faces[VisNodes->NumFaces++] = pNode->FirstFace + i;
+	}
+
+	pVisNode->NumFaces = VisNodes->NumFaces - pVisNode->FirstFace;
+
+	MinMaxs = (geFloat*)&pNode->Mins;
+
+	for (i=0; i< 6; i++)
+		VisNodes->Bounds[i][Index] = MinMaxs[i];
+
+	pVisNode->Children[0] = BuildVisNodes_r(World, pNode->Children[0]);
+	pVisNode->Children[1] = BuildVisNodes_r(World, pNode->Children[1]);
+
+	return Index;
+}
+
+//=====================================================================================
+//	BuildVisNodes
+//=====================================================================================
+static void BuildVisNodes(geWorld *World)
+{
+	World_VisNodes	*VisNodes;
+
+	VisNodes = &World->CurrentBSP->VisNodes;
+
+	if (!VisNodes->Nodes)
+		return;
+
+	VisNodes->NumNodes = 0;
+	VisNodes->NumFaces = 0;
+
+	VisNodes->Root = BuildVisNodes_r(World, World->CurrentBSP->BSPData.GFXModels[0].RootNode[0]);
+	VisNodes->Frame = World->CurFrameStatic;
+}
+
 // FIXME:  Put the fog in Fog.c
 //=====================================================================================
 //	VisFog
@@ -48,6 +48,12 @@ typedef struct geWBitmap
 	int32			VisFrame;
 
 	uint32			Flags;
+
+	// Only while the pool is locked (see geWBitmap_Pool_CreateLocked)
+	geBitmap		*Lock;					// Mip 0 of Bitmap, locked for write
+	uint8			*Bits;					// Lock's bits
+	int32			Stride;					// Lock's stride, in pixels
+	geBoolean		UseColorKey;			// A face that uses it is transparent
 } geWBitmap;
 
 typedef struct geWBitmap_Pool
@@ -96,6 +102,35 @@ geWBitmap_Pool *geWBitmap_Pool_Create(GBSP_BSPData *BSPData)
 	}
 }
 
+//=====================================================================================
+//	geWBitmap_Pool_CreateLocked
+//=====================================================================================
+geWBitmap_Pool *geWBitmap_Pool_CreateLocked(GBSP_BSPData *BSPData)
+{
+	geWBitmap_Pool		*Pool;
+
+	assert(BSPData);
+
+	Pool = GE_RAM_ALLOCATE_STRUCT(geWBitmap_Pool);
+
+	if (!Pool)
+	{
+		geErrorLog_AddString(-1, "geWBitmap_Pool_CreateLocked:  Could not create the Pool.  Out of memory.", NULL);
+		return NULL;
+	}
+
+	ZeroMem(Pool);				
+
+	if (!geWBitmap_Pool_LockAllWBitmaps(Pool, BSPData))
+	{
+		geErrorLog_AddString(-1, "geWBitmap_Pool_CreateLocked:  geWBitmap_Pool_LockAllWBitmaps failed.", NULL);
+		geWBitmap_Pool_Destroy(Pool);
+		return NULL;
+	}
+
+	return Pool;
+}
+
 //=====================================================================================
 //	geWBitmap_Pool_Destroy
 //=====================================================================================
@@ -192,14 +227,30 @@ geBitmap *geWBitmap_Pool_GetBitmapByName(geWBitmap_Pool *Pool, const char *Bitma
 //	geWBitmap_Pool_CreateAllWBitmaps
 //=====================================================================================
 geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *BSPData)
+{
+	int32		i;
+
+	if (!geWBitmap_Pool_LockAllWBitmaps(Pool, BSPData))
+		return GE_FALSE;
+
+	for (i=0; i< Pool->NumWBitmaps; i++)
+		geWBitmap_Pool_FillWBitmap(Pool, BSPData, i);
+
+	return geWBitmap_Pool_UnLockAllWBitmaps(Pool, BSPData);
+}
+
+//=====================================================================================
+//	geWBitmap_Pool_LockAllWBitmaps
+//	Creates a geBitmap for every texture in the bsp, and locks it for write, so the
+//	texels can be filled in by geWBitmap_Pool_FillWBitmap.
+//=====================================================================================
+geBoolean geWBitmap_Pool_LockAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *BSPData)
 {
 	int32		i;
 	geWBitmap	*pWBitmap;
 	GFX_Texture	*pGFXTexture;
 	uint8		*BitmapIsTransparent;
 	GFX_Face	*pFace;
-	geBoolean	UseColorKey;
-	uint32		ColorKey;
 
 	assert(Pool);
 	assert(BSPData);
@@ -218,7 +269,7 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 	if (!BitmapIsTransparent)
 	{
-		geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  Could not create the BitmapIsTransparent array.  Out of memory.", NULL);
+		geErrorLog_AddString(-1, "geWBitmap_Pool_LockAllWBitmaps:  Could not create the BitmapIsTransparent array.  Out of memory.", NULL);
 		goto ExitWithError;
 	}
 
@@ -245,7 +296,7 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 	if (!Pool->WBitmaps)
 	{
-		geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  Could not create the Pool bitmaps.  Out of memory.", NULL);
+		geErrorLog_AddString(-1, "geWBitmap_Pool_LockAllWBitmaps:  Could not create the Pool bitmaps.  Out of memory.", NULL);
 		goto ExitWithError;
 	}
 
@@ -258,28 +309,11 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 	for (i=0; i< BSPData->NumGFXTextures; i++, pGFXTexture++, pWBitmap++)
 	{
-		geBitmap	*Mips[MAX_MIPS_ALLOWED];
-		int32		NumMips, m, Width, Height, Stride;
-		uint8		*pSrc;
+		geBitmap		*Mips[MAX_MIPS_ALLOWED];
+		geBitmap_Info	Info;
+		int32			NumMips, Width, Height;
 
-		if (BitmapIsTransparent[i])
-		{
-			UseColorKey = GE_TRUE;
-         //Start Dec2001DCS - ColorKey = 24 bit version of bright magenta.  NOTE: Blue value is 254 (0xfe)
-         //                                                                       because I couldn't make a 24 bit bitmap
-         //                                                                       with MSPaint using the color 
-         //                                                                       255 0 255.  Even though Paint said it
-         //                                                                       was the right value, by the time the 
-         //                                                                       bitmap got to Genesis it was read as
-         //                                                                       255 0 254 ???
-			ColorKey = 0xffff00fe;
-         //End Dec2001DCS
-		}
-		else
-		{
-			UseColorKey = GE_FALSE;
-			ColorKey = 0;
-		}
+		pWBitmap->UseColorKey = BitmapIsTransparent[i] ? GE_TRUE : GE_FALSE;
 
 		strcpy(pWBitmap->Name, pGFXTexture->Name);
 
@@ -304,7 +338,7 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 		if (!pWBitmap->Bitmap)
 		{
-			geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  Could not create geBitmap.", NULL);
+			geErrorLog_AddString(-1, "geWBitmap_Pool_LockAllWBitmaps:  Could not create geBitmap.", NULL);
 			goto ExitWithError;
 		}
 
@@ -318,68 +352,141 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 			geBitmap_SetDriverFlags(pWBitmap->Bitmap, RDRIVER_PF_3D | RDRIVER_PF_COMBINE_LIGHTMAP);
 		}
 
-		//<> 
-		NumMips = 1;
-		// Lock all the miplevels
-		if (!geBitmap_LockForWrite(pWBitmap->Bitmap, Mips, 0, NumMips-1))
+		//<> Only the first miplevel is filled in
+		if (!geBitmap_LockForWrite(pWBitmap->Bitmap, Mips, 0, 0))
 		{
-			geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_LockForWrite failed.", NULL);
+			geErrorLog_AddString(-1, "geWBitmap_Pool_LockAllWBitmaps:  geBitmap_LockForWrite failed.", NULL);
 			goto ExitWithError;
 		}
 
-		// Get the src from the .bsp texture data
-		pSrc = &BSPData->GFXTexData[pGFXTexture->Offset];
+		pWBitmap->Lock = Mips[0];
 
-		// Fill all the mip levels
-		for (m=0; m< NumMips; m++)
+		if (!geBitmap_GetInfo(pWBitmap->Lock, &Info, NULL))
 		{
-			uint8			*pDest;
-			geBitmap_Info	Info;
+			geErrorLog_AddString(-1, "geWBitmap_Pool_LockAllWBitmaps:  geBitmap_GetInfo failed.", NULL);
+			goto ExitWithError;
+		}
 
-			if (!geBitmap_GetInfo(Mips[m], &Info, NULL))
-			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_GetInfo failed.", NULL);
-				goto ExitWithError;
-			}
+		pWBitmap->Bits = geBitmap_GetBits(pWBitmap->Lock);
+		assert( pWBitmap->Bits );
 
-			pDest = geBitmap_GetBits(Mips[m]);
-			assert( pDest );
+		pWBitmap->Stride = Info.Stride;
 
-			Stride = Info.Stride;
-			Width  = Info.Width;
-			Height = Info.Height;
+		assert(Info.Stride >= Info.Width);
+		assert(Info.Width == Width && Info.Height == Height);
+	}
 
-			assert(Stride >= Width);
+	// added to stop a leak		
+	if (BitmapIsTransparent)
+	{
+		geRam_Free(BitmapIsTransparent);
+		BitmapIsTransparent = NULL;
+	}
 
-			if ( Stride == Width )
-			{
-            //Start Dec2001DCS - Added * 4 since textures are now 32 bit
-			// added transparent textures
-			   memcpy(pDest,pSrc,Width*Height*4);
-            //End Dec2001DCS
-			}
-			else
-			{
-			int h;
-				for (h=Height;h--;)
-				{
-               //Start Dec2001DCS - Added * 4 since textures are now 32 bit
-				// added transparent textures
-               memcpy(pDest,pSrc,Width*4);
-               //End Dec2001DCS
-					pSrc += Width*4;
-					pDest += Stride*4;
-				}
-			}
+	return GE_TRUE;
 
-			// Unlock this mip level, it is filled with the data
-			if (!geBitmap_UnLock(Mips[m]))
-			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_Unlock failed.", NULL);
-				goto ExitWithError;
-			}
+	// Error
+	ExitWithError:
+	{
+		if (Pool->WBitmaps)
+		{
+			geWBitmap_Pool_DestroyAllWBitmaps(Pool);
+			Pool->WBitmaps = NULL;
+		}
+
+		if (BitmapIsTransparent)
+		{
+			geRam_Free(BitmapIsTransparent);
+			BitmapIsTransparent = NULL;
 		}
 
+		return GE_FALSE;
+	}
+}
+
+//=====================================================================================
+//	geWBitmap_Pool_FillWBitmap
+//	Copies the texels for WBitmap Index out of the bsp texture data.  Only touches that
+//	WBitmaps bits, so different WBitmaps can be filled in on different threads.
+//=====================================================================================
+void geWBitmap_Pool_FillWBitmap(geWBitmap_Pool *Pool, const GBSP_BSPData *BSPData, int32 Index)
+{
+	geWBitmap		*pWBitmap;
+	GFX_Texture		*pGFXTexture;
+	uint8			*pSrc, *pDest;
+	int32			Width, Height, Stride;
+
+	assert(Pool);
+	assert(BSPData);
+	assert(Index >= 0 && Index < Pool->NumWBitmaps);
+
+	pWBitmap = &Pool->WBitmaps[Index];
+	pGFXTexture = &BSPData->GFXTextures[Index];
+
+	assert(pWBitmap->Lock);
+
+	// Get the src from the .bsp texture data
+	pSrc = &BSPData->GFXTexData[pGFXTexture->Offset];
+	pDest = pWBitmap->Bits;
+
+	Stride = pWBitmap->Stride;
+	Width  = pGFXTexture->Width;
+	Height = pGFXTexture->Height;
+
+	if ( Stride == Width )
+	{
+	//Start Dec2001DCS - Added * 4 since textures are now 32 bit
+	// added transparent textures
+	   memcpy(pDest,pSrc,Width*Height*4);
+	//End Dec2001DCS
+	}
+	else
+	{
+	int h;
+		for (h=Height;h--;)
+		{
+	   //Start Dec2001DCS - Added * 4 since textures are now 32 bit
+		// added transparent textures
+	   memcpy(pDest,pSrc,Width*4);
+	   //End Dec2001DCS
+			pSrc += Width*4;
+			pDest += Stride*4;
+		}
+	}
+}
+
+//=====================================================================================
+//	geWBitmap_Pool_UnLockAllWBitmaps
+//	Unlocks the filled in WBitmaps, and gives them their palettes and color keys
+//=====================================================================================
+geBoolean geWBitmap_Pool_UnLockAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *BSPData)
+{
+	int32		i;
+	geWBitmap	*pWBitmap;
+	GFX_Texture	*pGFXTexture;
+	uint32		ColorKey;
+
+	assert(Pool);
+	assert(BSPData);
+	assert(Pool->NumWBitmaps == BSPData->NumGFXTextures);
+
+	pWBitmap = Pool->WBitmaps;
+	pGFXTexture = BSPData->GFXTextures;
+
+	for (i=0; i< Pool->NumWBitmaps; i++, pGFXTexture++, pWBitmap++)
+	{
+		assert(pWBitmap->Lock);
+
+		// Unlock this mip level, it is filled with the data
+		if (!geBitmap_UnLock(pWBitmap->Lock))
+		{
+			geErrorLog_AddString(-1, "geWBitmap_Pool_UnLockAllWBitmaps:  geBitmap_Unlock failed.", NULL);
+			goto ExitWithError;
+		}
+
+		pWBitmap->Lock = NULL;
+		pWBitmap->Bits = NULL;
+
 		// Create the palette...
 		{
 			geBitmap_Palette		*Pal;
@@ -393,14 +500,15 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 			if (!Pal)
 			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_Palette_Create failed.", NULL);
-				return GE_FALSE;
+				geErrorLog_AddString(-1, "geWBitmap_Pool_UnLockAllWBitmaps:  geBitmap_Palette_Create failed.", NULL);
+				goto ExitWithError;
 			}
 			
 			if (!geBitmap_Palette_Lock(Pal, &DstPalData, &Format, &PalSize))
 			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_Palette_Lock failed.", NULL);
-				return GE_FALSE;
+				geErrorLog_AddString(-1, "geWBitmap_Pool_UnLockAllWBitmaps:  geBitmap_Palette_Lock failed.", NULL);
+				geBitmap_Palette_Destroy(&Pal);
+				goto ExitWithError;
 			}
 
 			//cnt = sizeof(DRV_Palette); 
@@ -420,34 +528,46 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 
 			if (!geBitmap_Palette_UnLock(Pal))
 			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_Palette_UnLock failed.", NULL);
-				return GE_FALSE;
+				geErrorLog_AddString(-1, "geWBitmap_Pool_UnLockAllWBitmaps:  geBitmap_Palette_UnLock failed.", NULL);
+				geBitmap_Palette_Destroy(&Pal);
+				goto ExitWithError;
 			}
 
  			if (!geBitmap_SetPalette(pWBitmap->Bitmap, Pal))
 			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_SetPalette failed.", NULL);
-				return GE_FALSE;
+				geErrorLog_AddString(-1, "geWBitmap_Pool_UnLockAllWBitmaps:  geBitmap_SetPalette failed.", NULL);
+				geBitmap_Palette_Destroy(&Pal);
+				goto ExitWithError;
 			}
 
 			geBitmap_Palette_Destroy(&Pal);
 		} //done making the palette
 
-		if (!geBitmap_SetColorKey(pWBitmap->Bitmap, UseColorKey, ColorKey, GE_TRUE))
+		if (pWBitmap->UseColorKey)
+		{
+         //Start Dec2001DCS - ColorKey = 24 bit version of bright magenta.  NOTE: Blue value is 254 (0xfe)
+         //                                                                       because I couldn't make a 24 bit bitmap
+         //                                                                       with MSPaint using the color 
+         //                                                                       255 0 255.  Even though Paint said it
+         //                                                                       was the right value, by the time the 
+         //                                                                       bitmap got to Genesis it was read as
+         //                                                                       255 0 254 ???
+			ColorKey = 0xffff00fe;
+         //End Dec2001DCS
+		}
+		else
+		{
+			ColorKey = 0;
+		}
+
+		if (!geBitmap_SetColorKey(pWBitmap->Bitmap, pWBitmap->UseColorKey, ColorKey, GE_TRUE))
 			{
-				geErrorLog_AddString(-1, "geWBitmap_Pool_CreateAllWBitmaps:  geBitmap_SetColorKey failed.", NULL);
+				geErrorLog_AddString(-1, "geWBitmap_Pool_UnLockAllWBitmaps:  geBitmap_SetColorKey failed.", NULL);
 				goto ExitWithError;
 			}
 
 	}
 
-	// added to stop a leak		
-	if (BitmapIsTransparent)
-	{
-		geRam_Free(BitmapIsTransparent);
-		BitmapIsTransparent = NULL;
-	}
-
 	return GE_TRUE;
 
 	// Error
@@ -459,12 +579,6 @@ geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *B
 			Pool->WBitmaps = NULL;
 		}
 
-		if (BitmapIsTransparent)
-		{
-			geRam_Free(BitmapIsTransparent);
-			BitmapIsTransparent = NULL;
-		}
-
 		return GE_FALSE;
 	}
 }
@@ -485,6 +599,13 @@ void geWBitmap_Pool_DestroyAllWBitmaps(geWBitmap_Pool *Pool)
 		
 		for (i=0; i< Pool->NumWBitmaps; i++, pWBitmap++)
 		{
+			// Hand back a lock that never got filled in
+			if (pWBitmap->Lock)
+			{
+				geBitmap_UnLock(pWBitmap->Lock);
+				pWBitmap->Lock = NULL;
+			}
+
 			// Destroy the geBitmap 
 			if (pWBitmap->Bitmap)
 			{
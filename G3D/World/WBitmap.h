@@ -69,6 +69,14 @@ geWBitmap *geWBitmap_Pool_GetWBitmapByIndex(geWBitmap_Pool *Pool, int32 Index);
 geBitmap *geWBitmap_Pool_GetBitmapByIndex(geWBitmap_Pool *Pool, int32 Index);
 geBitmap *geWBitmap_Pool_GetBitmapByName(geWBitmap_Pool *Pool, const char *BitmapName);
 geBoolean geWBitmap_Pool_CreateAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *BSPData);
+
+// geWBitmap_Pool_CreateAllWBitmaps in stages, so the texels can be filled in on other threads.
+// Lock and UnLock create and finish the geBitmaps, so they stay on the thread that owns bitmaps.
+geWBitmap_Pool *geWBitmap_Pool_CreateLocked(GBSP_BSPData *BSPData);
+geBoolean geWBitmap_Pool_LockAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *BSPData);
+void geWBitmap_Pool_FillWBitmap(geWBitmap_Pool *Pool, const GBSP_BSPData *BSPData, int32 Index);
+geBoolean geWBitmap_Pool_UnLockAllWBitmaps(geWBitmap_Pool *Pool, GBSP_BSPData *BSPData);
+
 void geWBitmap_Pool_DestroyAllWBitmaps(geWBitmap_Pool *Pool);
 uint32 geWBitmap_GetFlags(geWBitmap *WBitmap);
 geBitmap *geWBitmap_GetBitmap(geWBitmap *WBitmap);
@@ -42,6 +42,8 @@
 #include "VFile.h"
 
 #include "Trace.h"
+#include "WorkPool.h"
+#include "BSPCache.h"
 
 #include "list.h"
 
@@ -208,18 +210,46 @@ geBoolean GList_RenderOperations(geCamera *Camera)
 	return GE_TRUE;
 }
 
+// Boxes gathered for one Frustum_CullAABBs call.  There is a set for each mirror level,
+// since a mirror can start a new scene while the last one is still going through it's boxes.
+typedef struct
+{
+	int32		MaxItems;
+	int32		NumItems;
+	int32		*Items;							// What got gathered (model, actor, or sprite index)
+	int32		*ItemBoxes;						// Box for each item, -1 if it has none (always drawn)
+
+	int32		NumBoxes;
+	geFloat		*Bounds[6];						// Laid out like GFX_Node Mins/Maxs
+	uint32		*Visible;						// Bit per box
+	uint32		*ClipFlags;						// Planes each box still needs clipping to
+
+	const geActor **Actors;						// Visible actors, for geActor_RenderPrepBatch
+} World_CullBoxes;
+
+static World_CullBoxes	CullBoxes[MAX_MIRROR_RECURSION+1];
+
+#define CULLBOXES_VISIBLE(Boxes, b)		((Boxes)->Visible[(b)>>5] & (1<<((b)&31)))
+
 //=====================================================================================
 //	Local Static Functions
 //=====================================================================================
+static geBoolean CullBoxes_Begin(World_CullBoxes *Boxes, int32 MaxItems);
+static void CullBoxes_Add(World_CullBoxes *Boxes, int32 Item, const geExtBox *Box);
+static void CullBoxes_Cull(World_CullBoxes *Boxes, const Frustum_Info *Fi);
+static void CullBoxes_Free(World_CullBoxes *Boxes);
 static void CalcBSPModelInfo(World_BSP *BSP);
 static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera, Frustum_Info *FrustumInfo);
 static void RenderBSPFrontBack_r(int32 Node, const geWorld_RenderInfo *RenderInfo, int32 ClipFlags);
+static void CullVisNodes(World_VisNodes *VisNodes, const Frustum_Info *Fi, uint32 ClipFlags);
+static void RenderVisNodes_r(int32 VisNode, const geWorld_RenderInfo *RenderInfo, int32 ClipFlags);
 static void RenderBSPFrontBackMirror_r(int32 Node, geCamera *Camera, Frustum_Info *Fi, int32 ClipFlags);
 static void RenderFace(int32 Face, const geWorld_RenderInfo *RenderInfo, int32 ClipFlags);
 static geBoolean RenderWorldModel(geCamera *Camera, Frustum_Info *FrustumInfo, geWorld_SkyBoxTData *SkyTData);
 static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, geWorld_SkyBoxTData *SkyTData);
 static geBoolean WorldSetGBSP(geWorld *World, World_BSP *BSP);
 static World_BSP *CreateGBSP(geVFile *File);
+static World_BSP *World_LoadBSP(geVFile *File, geErrorLog_ErrorIDEnumType *Error);
 
 static geBoolean CreateStaticFogList(geWorld *World);
 
@@ -242,6 +272,11 @@ geBoolean World_EngineInit(geEngine *Engine)
 //=====================================================================================
 void World_EngineShutdown(geEngine *Engine)
 {
+	int32		i;
+
+	for (i=0; i<= MAX_MIRROR_RECURSION; i++)
+		CullBoxes_Free(&CullBoxes[i]);
+
 	CEngine = NULL;
 	CWorld = NULL;
 	BSPData = NULL;
@@ -352,13 +387,13 @@ World_BSP *World_CreateBSPFromBox(const geVec3d *Mins, const geVec3d *Maxs)
 }
 
 //=====================================================================================
-//	geWorld_Create
+//	World_Allocate
+//	An empty world, with a ref on it, so geWorld_Free will clean up whatever gets
+//	created into it
 //=====================================================================================
-GENESISAPI geWorld *geWorld_Create(geVFile *File)
+static geWorld *World_Allocate(void)
 {
 	geWorld			*NewWorld;
-	int32			i;
-	geWorld_Model	*Models;
 
 	NewWorld = GE_RAM_ALLOCATE_STRUCT(geWorld);
 
@@ -374,64 +409,80 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 	geWorld_CreateRef(NewWorld);
 
 	if ( ! List_Start() )
-		goto Error;
-
-	if (!File)
 	{
-		geVec3d	TMins = {-1000.0f, -1000.0f, -1000.0f};
-		geVec3d	TMaxs = { 1000.0f,  1000.0f,  1000.0f};
-
-		NewWorld->CurrentBSP = World_CreateBSPFromBox(&TMins, &TMaxs);
+		geWorld_Free(NewWorld);
+		return NULL;
 	}
-	else
-	{
-		assert(File != NULL);
 
-		NewWorld->CurrentBSP = CreateGBSP(File);
-	}
+	return NewWorld;
+}
 
-	// The world has changed
-	NewWorld->Changed = GE_TRUE;
+//=====================================================================================
+//	World_CreateLeafData
+//=====================================================================================
+static geBoolean World_CreateLeafData(World_BSP *BSP)
+{
+	assert(BSP->BSPData.NumGFXLeafs > 0);
 
-	if (!NewWorld->CurrentBSP)
-		goto Error;
+	// Create the leafdata array
+	BSP->LeafData = GE_RAM_ALLOCATE_ARRAY(geWorld_Leaf, BSP->BSPData.NumGFXLeafs);
 
-	assert(NewWorld->CurrentBSP->BSPData.NumGFXLeafs > 0);
+	if (!BSP->LeafData)
+		return GE_FALSE;
 
-	// Create the leafdata array
-	NewWorld->CurrentBSP->LeafData = GE_RAM_ALLOCATE_ARRAY(geWorld_Leaf, NewWorld->CurrentBSP->BSPData.NumGFXLeafs);
+	memset(BSP->LeafData, 0, sizeof(geWorld_Leaf)*BSP->BSPData.NumGFXLeafs);
 
-	if (!NewWorld->CurrentBSP->LeafData)
-		goto Error;
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	World_PrepBSP
+//	The part of creating a world that only touches the new bsp (can run on a loader thread)
+//=====================================================================================
+static geBoolean World_PrepBSP(World_BSP *BSP)
+{
+	if (!World_CreateLeafData(BSP))
+		return GE_FALSE;
+
+	if (!Surf_BSPInit(BSP))
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
 
-	memset(NewWorld->CurrentBSP->LeafData, 0, sizeof(geWorld_Leaf)*NewWorld->CurrentBSP->BSPData.NumGFXLeafs);
+//=====================================================================================
+//	World_Finish
+//	The rest of creating a world, once the bsp is prepped and the WBitmapPool is made.
+//	Sets up module and engine globals, so it has to be on the thread that owns the engine.
+//=====================================================================================
+static geBoolean World_Finish(geWorld *NewWorld)
+{
+	int32			i;
+	geWorld_Model	*Models;
 
 	if (!Light_WorldInit(NewWorld))
-		goto Error;
+		return GE_FALSE;
 
 	if (!Ent_WorldInit(NewWorld))
-		goto Error;
+		return GE_FALSE;
 
 	if (!Vis_WorldInit(NewWorld))
-		goto Error;
+		return GE_FALSE;
 
 	if (!Surf_WorldInit(NewWorld))
-		goto Error;
-
-	// Create the wbitmaps out of the GFXTexData
-	NewWorld->CurrentBSP->WBitmapPool = geWBitmap_Pool_Create(&NewWorld->CurrentBSP->BSPData);
-
-	if (!NewWorld->CurrentBSP->WBitmapPool)
-		goto Error;
+		return GE_FALSE;
 
 	#if 1
 		// HACK
 		// We can now free the texturedata in the BSP that was loaded off disk.
 		// Eventually, the BSP disk format will be bitmaps, and no conversion will be needed, JP.
+		// If it was read in place, it's the callers file, and we just stop pointing at it.
 		if (NewWorld->CurrentBSP->BSPData.GFXTexData)	// Not all worlds have tex data!!!
 		{
-			geRam_Free(NewWorld->CurrentBSP->BSPData.GFXTexData);
+			if (!NewWorld->CurrentBSP->BSPData.GFXTexDataMapped)
+				geRam_Free(NewWorld->CurrentBSP->BSPData.GFXTexData);
 			NewWorld->CurrentBSP->BSPData.GFXTexData = NULL;	// This is to assure that FreeGBSPFile does not touch this again
+			NewWorld->CurrentBSP->BSPData.GFXTexDataMapped = GE_FALSE;
 			NewWorld->CurrentBSP->BSPData.NumGFXTexData = 0;
 		}
 	#endif
@@ -445,7 +496,7 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 
 	// Init user stuff
 	if (!User_WorldInit(NewWorld))
-		goto Error;
+		return GE_FALSE;
 	
 	Models = NewWorld->CurrentBSP->Models;
 
@@ -462,13 +513,18 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 	CalcBSPModelInfo(NewWorld->CurrentBSP);
 
 	if (!BuildSkyBox(&NewWorld->SkyBox, &NewWorld->CurrentBSP->BSPData.GFXSkyData))
-		goto Error;
+		return GE_FALSE;
 
 	NewWorld->CurrentLeaf = -1;			// Make sure the level gets vised for the first time...
 
 	NewWorld->ActorCount = 0;
 	NewWorld->ActorArray = NULL;
 
+	NewWorld->ActorTree = ActorTree_Create();
+
+	if (!NewWorld->ActorTree)
+		return GE_FALSE;
+
 //MRB BEGIN
 //geSprite
 	NewWorld->SpriteCount = 0;
@@ -478,8 +534,121 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 	if (!CreateStaticFogList(NewWorld))
 	{
 		geErrorLog_AddString(-1,"Failed to create static FogList", NULL);
+		return GE_FALSE;
+	}
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	geWorld_Create
+//=====================================================================================
+GENESISAPI geWorld *geWorld_Create(geVFile *File)
+{
+	geWorld			*NewWorld;
+
+	NewWorld = World_Allocate();
+
+	if (!NewWorld)
+		return NULL;
+
+	if (!File)
+	{
+		geVec3d	TMins = {-1000.0f, -1000.0f, -1000.0f};
+		geVec3d	TMaxs = { 1000.0f,  1000.0f,  1000.0f};
+
+		NewWorld->CurrentBSP = World_CreateBSPFromBox(&TMins, &TMaxs);
+	}
+	else
+	{
+		assert(File != NULL);
+
+		NewWorld->CurrentBSP = CreateGBSP(File);
+	}
+
+	// The world has changed
+	NewWorld->Changed = GE_TRUE;
+
+	if (!NewWorld->CurrentBSP)
+		goto Error;
+
+	if (!World_PrepBSP(NewWorld->CurrentBSP))
+		goto Error;
+
+	// Create the wbitmaps out of the GFXTexData
+	NewWorld->CurrentBSP->WBitmapPool = geWBitmap_Pool_Create(&NewWorld->CurrentBSP->BSPData);
+
+	if (!NewWorld->CurrentBSP->WBitmapPool)
+		goto Error;
+
+	if (!World_Finish(NewWorld))
 		goto Error;
+
+	return NewWorld;
+
+	Error:;
+		geWorld_Free(NewWorld);
+
+	return NULL;
+}
+
+//=====================================================================================
+//	geWorld_CreateCached
+//	Like geWorld_Create, but tries Cache (a baked copy of File, see BSPCache.c) first.  If
+//	Cache is stale, File is loaded the normal way, and baked into Cache for next time.
+//=====================================================================================
+GENESISAPI geWorld *geWorld_CreateCached(geVFile *File, geVFile *Cache)
+{
+	geWorld			*NewWorld;
+	BSPCache_Key	Key;
+	geBoolean		HaveKey;
+
+	assert(File != NULL);
+
+	if (!Cache)
+		return geWorld_Create(File);
+
+	NewWorld = World_Allocate();
+
+	if (!NewWorld)
+		return NULL;
+
+	// The world has changed
+	NewWorld->Changed = GE_TRUE;
+
+	HaveKey = BSPCache_GetKey(File, &Key);
+
+	if (HaveKey)
+		NewWorld->CurrentBSP = BSPCache_Load(Cache, File, &Key);
+
+	if (NewWorld->CurrentBSP)
+	{
+		if (!World_CreateLeafData(NewWorld->CurrentBSP))
+			goto Error;
 	}
+	else
+	{
+		NewWorld->CurrentBSP = CreateGBSP(File);
+
+		if (!NewWorld->CurrentBSP)
+			goto Error;
+
+		if (!World_PrepBSP(NewWorld->CurrentBSP))
+			goto Error;
+
+		// Not being able to write it only costs the next load
+		if (HaveKey)
+			BSPCache_Save(NewWorld->CurrentBSP, Cache, &Key);
+	}
+
+	// Create the wbitmaps out of the GFXTexData
+	NewWorld->CurrentBSP->WBitmapPool = geWBitmap_Pool_Create(&NewWorld->CurrentBSP->BSPData);
+
+	if (!NewWorld->CurrentBSP->WBitmapPool)
+		goto Error;
+
+	if (!World_Finish(NewWorld))
+		goto Error;
 
 	return NewWorld;
 
@@ -489,6 +658,310 @@ GENESISAPI geWorld *geWorld_Create(geVFile *File)
 	return NULL;
 }
 
+//=====================================================================================
+//	Async loading
+//	The loader thread reads the chunks, then builds the surface info.  As soon as the
+//	chunks are in, the owning thread (in geWorld_LoaderPoll/Finish) creates the bitmaps
+//	locked, and decode threads fill in the texels alongside the surface info.  Anything
+//	that touches engine or module globals is left for geWorld_LoaderFinish.  The other
+//	threads don't log their failures; they leave them in the loader, and Poll/Finish
+//	log them on the owning thread.
+//=====================================================================================
+#define WORLD_LOADER_MAX_THREADS	(MAXIMUM_WAIT_OBJECTS)
+
+#if (WORKPOOL_MAX_THREADS-1 > WORLD_LOADER_MAX_THREADS)
+#error World_LoaderStartDecode could start more threads than there are handles for
+#endif
+
+typedef struct geWorld_Loader
+{
+	geVFile			*File;
+	geWorld			*World;
+
+	HANDLE			Thread;								// Loader thread (NULL if it was run in place)
+	HANDLE			ChunksRead;							// Set once World->CurrentBSP is loaded (or failed to)
+	geBoolean		Failed;								// Set by the loader thread
+	geErrorLog_ErrorIDEnumType	FailedError;			// What failed, for the error log
+	const char		*FailedString;
+	geBoolean		FailedLogged;
+
+	geBoolean		DecodeStarted;
+	geWBitmap_Pool	*WBitmapPool;						// Locked, till it's handed to the world
+	volatile LONG	NextTexture;
+	int32			NumDecodeThreads;
+	HANDLE			DecodeThreads[WORLD_LOADER_MAX_THREADS];
+} geWorld_Loader;
+
+//=====================================================================================
+//	World_LoaderThread
+//=====================================================================================
+static void World_LoaderFail(geWorld_Loader *Loader, geErrorLog_ErrorIDEnumType Error, const char *String)
+{
+	Loader->FailedError = Error;
+	Loader->FailedString = String;
+	Loader->Failed = GE_TRUE;
+}
+
+//=====================================================================================
+//	World_LoaderLogFailure
+//	On the owning thread, once the other threads are done
+//=====================================================================================
+static void World_LoaderLogFailure(geWorld_Loader *Loader)
+{
+	if (!Loader->Failed || Loader->FailedLogged)
+		return;
+
+	geErrorLog_AddString(Loader->FailedError, Loader->FailedString, NULL);
+	Loader->FailedLogged = GE_TRUE;
+}
+
+//=====================================================================================
+//	World_LoaderThread
+//=====================================================================================
+static DWORD WINAPI World_LoaderThread(LPVOID Param)
+{
+	geWorld_Loader	*Loader;
+	geWorld			*World;
+	geErrorLog_ErrorIDEnumType	Error;
+
+	Loader = (geWorld_Loader*)Param;
+	World = Loader->World;
+
+	World->CurrentBSP = World_LoadBSP(Loader->File, &Error);
+
+	if (!World->CurrentBSP)
+		World_LoaderFail(Loader, Error, "World_LoaderThread:  Loading the bsp failed.");
+
+	SetEvent(Loader->ChunksRead);
+
+	if (Loader->Failed)
+		return 0;
+
+	if (!World_PrepBSP(World->CurrentBSP))
+		World_LoaderFail(Loader, GE_ERR_GBSP_LOAD_FAILURE, "World_LoaderThread:  World_PrepBSP failed.");
+
+	return 0;
+}
+
+//=====================================================================================
+//	World_LoaderDecode
+//	Takes textures off the loader until there are none left
+//=====================================================================================
+static void World_LoaderDecode(geWorld_Loader *Loader)
+{
+	GBSP_BSPData	*BSPData;
+	LONG			i;
+
+	BSPData = &Loader->World->CurrentBSP->BSPData;
+
+	while ((i = InterlockedIncrement(&Loader->NextTexture)-1) < BSPData->NumGFXTextures)
+		geWBitmap_Pool_FillWBitmap(Loader->WBitmapPool, BSPData, i);
+}
+
+//=====================================================================================
+//	World_LoaderDecodeThread
+//=====================================================================================
+static DWORD WINAPI World_LoaderDecodeThread(LPVOID Param)
+{
+	World_LoaderDecode((geWorld_Loader*)Param);
+	return 0;
+}
+
+//=====================================================================================
+//	World_LoaderStartDecode
+//	Once the chunks are in.  Creates the bitmaps, and starts filling them in.
+//=====================================================================================
+static void World_LoaderStartDecode(geWorld_Loader *Loader)
+{
+	GBSP_BSPData	*BSPData;
+	DWORD			ThreadID;
+	int32			NumThreads;
+
+	assert(!Loader->DecodeStarted);
+
+	Loader->DecodeStarted = GE_TRUE;
+
+	if (Loader->Failed || !Loader->World->CurrentBSP)
+		return;
+
+	BSPData = &Loader->World->CurrentBSP->BSPData;
+
+	Loader->WBitmapPool = geWBitmap_Pool_CreateLocked(BSPData);
+
+	if (!Loader->WBitmapPool)
+		return;
+
+	// The loader thread is still busy with the surface info, so it counts as one of them
+	NumThreads = 0;
+
+	if (BSPData->NumGFXTextures > 0)
+	{
+		NumThreads = WorkPool_NumThreads(0, BSPData->NumGFXTextures+1, 1) - 1;
+
+		if (NumThreads < 1)
+			NumThreads = 1;
+	}
+
+	for (Loader->NumDecodeThreads = 0; Loader->NumDecodeThreads < NumThreads; Loader->NumDecodeThreads++)
+	{
+		Loader->DecodeThreads[Loader->NumDecodeThreads] = CreateThread(NULL, 0, World_LoaderDecodeThread, Loader, 0, &ThreadID);
+
+		if (!Loader->DecodeThreads[Loader->NumDecodeThreads])
+			break;				// geWorld_LoaderFinish will pick up whatever they don't get to
+	}
+}
+
+//=====================================================================================
+//	geWorld_CreateAsync
+//=====================================================================================
+GENESISAPI geWorld_Loader *geWorld_CreateAsync(geVFile *File)
+{
+	geWorld_Loader	*Loader;
+	DWORD			ThreadID;
+
+	assert(File != NULL);
+
+	Loader = GE_RAM_ALLOCATE_STRUCT(geWorld_Loader);
+
+	if (!Loader)
+	{
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		return NULL;
+	}
+
+	memset(Loader, 0, sizeof(geWorld_Loader));
+
+	Loader->File = File;
+
+	Loader->World = World_Allocate();
+
+	if (!Loader->World)
+		goto ExitWithError;
+
+	// The world has changed
+	Loader->World->Changed = GE_TRUE;
+
+	Loader->ChunksRead = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+	if (!Loader->ChunksRead)
+	{
+		geErrorLog_AddString(-1, "geWorld_CreateAsync:  CreateEvent failed.", NULL);
+		goto ExitWithError;
+	}
+
+	Loader->Thread = CreateThread(NULL, 0, World_LoaderThread, Loader, 0, &ThreadID);
+
+	if (!Loader->Thread)
+		World_LoaderThread(Loader);		// Still works, just not in the background
+
+	return Loader;
+
+	ExitWithError:
+	{
+		if (Loader->ChunksRead)
+			CloseHandle(Loader->ChunksRead);
+
+		if (Loader->World)
+			geWorld_Free(Loader->World);
+
+		geRam_Free(Loader);
+
+		return NULL;
+	}
+}
+
+//=====================================================================================
+//	geWorld_LoaderPoll
+//=====================================================================================
+GENESISAPI geBoolean geWorld_LoaderPoll(geWorld_Loader *Loader)
+{
+	assert(Loader != NULL);
+
+	if (!Loader->DecodeStarted)
+	{
+		if (WaitForSingleObject(Loader->ChunksRead, 0) != WAIT_OBJECT_0)
+			return GE_FALSE;
+
+		World_LoaderStartDecode(Loader);
+	}
+
+	if (Loader->Thread && WaitForSingleObject(Loader->Thread, 0) != WAIT_OBJECT_0)
+		return GE_FALSE;
+
+	if (Loader->NumDecodeThreads && WaitForMultipleObjects(Loader->NumDecodeThreads, Loader->DecodeThreads, TRUE, 0) != WAIT_OBJECT_0)
+		return GE_FALSE;
+
+	World_LoaderLogFailure(Loader);
+
+	return GE_TRUE;
+}
+
+//=====================================================================================
+//	geWorld_LoaderFinish
+//=====================================================================================
+GENESISAPI geWorld *geWorld_LoaderFinish(geWorld_Loader *Loader)
+{
+	geWorld		*NewWorld;
+	geBoolean	Failed;
+	int32		i;
+
+	assert(Loader != NULL);
+
+	WaitForSingleObject(Loader->ChunksRead, INFINITE);
+
+	if (!Loader->DecodeStarted)
+		World_LoaderStartDecode(Loader);
+
+	// Help fill in whatever textures are left
+	if (Loader->WBitmapPool)
+		World_LoaderDecode(Loader);
+
+	if (Loader->NumDecodeThreads)
+	{
+		WaitForMultipleObjects(Loader->NumDecodeThreads, Loader->DecodeThreads, TRUE, INFINITE);
+
+		for (i=0; i< Loader->NumDecodeThreads; i++)
+			CloseHandle(Loader->DecodeThreads[i]);
+	}
+
+	if (Loader->Thread)
+	{
+		WaitForSingleObject(Loader->Thread, INFINITE);
+		CloseHandle(Loader->Thread);
+	}
+
+	CloseHandle(Loader->ChunksRead);
+
+	World_LoaderLogFailure(Loader);
+
+	NewWorld = Loader->World;
+	Failed = (Loader->Failed || !Loader->WBitmapPool);
+
+	if (!Failed)
+	{
+		NewWorld->CurrentBSP->WBitmapPool = Loader->WBitmapPool;
+		Loader->WBitmapPool = NULL;
+
+		if (!geWBitmap_Pool_UnLockAllWBitmaps(NewWorld->CurrentBSP->WBitmapPool, &NewWorld->CurrentBSP->BSPData))
+			Failed = GE_TRUE;
+		else if (!World_Finish(NewWorld))
+			Failed = GE_TRUE;
+	}
+
+	if (Loader->WBitmapPool)
+		geWBitmap_Pool_Destroy(Loader->WBitmapPool);
+
+	geRam_Free(Loader);
+
+	if (Failed)
+	{
+		geWorld_Free(NewWorld);
+		return NULL;
+	}
+
+	return NewWorld;
+}
+
 //=====================================================================================
 //	geWorld_Free
 //=====================================================================================
@@ -517,6 +990,8 @@ if (World->CurrentBSP)
 			assert( World->ActorArray != NULL );
 			for (i=0; i< World->ActorCount; i++)
 				{
+				// The actor can outlive the world, so it has to stop telling the tree about changes
+				ActorTree_RemoveActor(World->ActorTree, World->ActorArray[i].Proxy, World->ActorArray[i].Actor);
 				if(!geActor_Destroy( &( World->ActorArray[i].Actor ) ))
 					geErrorLog_AddString(-1, "geWorld_Free:  geActor_Destroy failed.", NULL);
 				}
@@ -533,6 +1008,8 @@ if (World->CurrentBSP)
 			geRam_Free( World->ActorArray );
 			World->ActorArray = NULL;
 		}
+	if (World->ActorTree != NULL)
+		ActorTree_Destroy(&World->ActorTree);
 
 //MRB BEGIN
 //geSprite
@@ -874,37 +1351,152 @@ GENESISAPI geBoolean GENESISCC geWorld_IsActorPotentiallyVisible(const geWorld *
 
 }
 
-//MRB BEGIN
-//geSprite
-GENESISAPI geBoolean GENESISCC geWorld_IsSpritePotentiallyVisible(const geWorld *World, const geSprite *Sprite, const geCamera *Camera)
+//MRB BEGIN
+//geSprite
+GENESISAPI geBoolean GENESISCC geWorld_IsSpritePotentiallyVisible(const geWorld *World, const geSprite *Sprite, const geCamera *Camera)
+{
+	#pragma message ("This is a fairly poor test: ")
+		// mirrors aren't checked.
+		// this doesn't check the extents of the sprite, just the center point.
+	geVec3d			Center;
+	const geXForm3d	*CameraTransform;
+	int32			Leaf,CameraLeaf;
+		
+	assert( World != NULL );
+	assert( geSprite_IsValid(Sprite)!= GE_FALSE );
+	assert( Camera != NULL );
+
+	geSprite_GetPosition ( Sprite, &Center );
+
+	// NOTE - We are not taking into acount that a sprite may live in more than one leaf...
+	geWorld_GetLeaf(World, &Center, &Leaf);
+
+	CameraTransform = geCamera_GetWorldSpaceVisXForm( Camera );
+	geWorld_GetLeaf(World, &(CameraTransform->Translation), &CameraLeaf);
+
+	#pragma message ("geWorld_MightSeeLeaf would be WAY FASTER here, but would be a frame behind...")
+	if (geWorld_LeafMightSeeLeaf(World, Leaf, CameraLeaf, 0 )==GE_FALSE)
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+//MRB END
+
+
+//=====================================================================================
+//	CullBoxes_Begin
+//	Empties Boxes, and makes room for MaxItems
+//=====================================================================================
+static geBoolean CullBoxes_Begin(World_CullBoxes *Boxes, int32 MaxItems)
+{
+	int32		i, NumWords;
+
+	Boxes->NumItems = 0;
+	Boxes->NumBoxes = 0;
+
+	if (MaxItems <= Boxes->MaxItems)
+		return GE_TRUE;
+
+	CullBoxes_Free(Boxes);
+
+	MaxItems += 64;				// Don't grow one at a time
+	NumWords = (MaxItems+31)>>5;
+
+	Boxes->Items = GE_RAM_ALLOCATE_ARRAY(int32, MaxItems);
+	Boxes->ItemBoxes = GE_RAM_ALLOCATE_ARRAY(int32, MaxItems);
+	Boxes->Visible = GE_RAM_ALLOCATE_ARRAY(uint32, NumWords);
+	Boxes->ClipFlags = GE_RAM_ALLOCATE_ARRAY(uint32, MaxItems);
+	Boxes->Actors = GE_RAM_ALLOCATE_ARRAY(const geActor*, MaxItems);
+
+	if (!Boxes->Items || !Boxes->ItemBoxes || !Boxes->Visible || !Boxes->ClipFlags || !Boxes->Actors)
+		goto ExitWithError;
+
+	for (i=0; i< 6; i++)
+	{
+		Boxes->Bounds[i] = GE_RAM_ALLOCATE_ARRAY(geFloat, MaxItems);
+
+		if (!Boxes->Bounds[i])
+			goto ExitWithError;
+	}
+
+	Boxes->MaxItems = MaxItems;
+
+	return GE_TRUE;
+
+	ExitWithError:
+	{
+		CullBoxes_Free(Boxes);
+		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		return GE_FALSE;
+	}
+}
+
+//=====================================================================================
+//	CullBoxes_Add
+//	Adds Item, and it's box if it has one
+//=====================================================================================
+static void CullBoxes_Add(World_CullBoxes *Boxes, int32 Item, const geExtBox *Box)
 {
-	#pragma message ("This is a fairly poor test: ")
-		// mirrors aren't checked.
-		// this doesn't check the extents of the sprite, just the center point.
-	geVec3d			Center;
-	const geXForm3d	*CameraTransform;
-	int32			Leaf,CameraLeaf;
-		
-	assert( World != NULL );
-	assert( geSprite_IsValid(Sprite)!= GE_FALSE );
-	assert( Camera != NULL );
+	int32		b;
 
-	geSprite_GetPosition ( Sprite, &Center );
+	assert(Boxes->NumItems < Boxes->MaxItems);
 
-	// NOTE - We are not taking into acount that a sprite may live in more than one leaf...
-	geWorld_GetLeaf(World, &Center, &Leaf);
+	Boxes->Items[Boxes->NumItems] = Item;
 
-	CameraTransform = geCamera_GetWorldSpaceVisXForm( Camera );
-	geWorld_GetLeaf(World, &(CameraTransform->Translation), &CameraLeaf);
+	if (!Box)
+	{
+		Boxes->ItemBoxes[Boxes->NumItems++] = -1;
+		return;
+	}
 
-	#pragma message ("geWorld_MightSeeLeaf would be WAY FASTER here, but would be a frame behind...")
-	if (geWorld_LeafMightSeeLeaf(World, Leaf, CameraLeaf, 0 )==GE_FALSE)
-		return GE_FALSE;
+	b = Boxes->NumBoxes++;
 
-	return GE_TRUE;
+	Boxes->ItemBoxes[Boxes->NumItems++] = b;
+
+	Boxes->Bounds[0][b] = Box->Min.X;
+	Boxes->Bounds[1][b] = Box->Min.Y;
+	Boxes->Bounds[2][b] = Box->Min.Z;
+	Boxes->Bounds[3][b] = Box->Max.X;
+	Boxes->Bounds[4][b] = Box->Max.Y;
+	Boxes->Bounds[5][b] = Box->Max.Z;
 }
-//MRB END
 
+//=====================================================================================
+//	CullBoxes_Cull
+//=====================================================================================
+static void CullBoxes_Cull(World_CullBoxes *Boxes, const Frustum_Info *Fi)
+{
+	assert(Fi->NumPlanes < 32);
+
+	Frustum_CullAABBs(Fi, (1<<Fi->NumPlanes)-1, Boxes->Bounds, Boxes->NumBoxes, Boxes->Visible, Boxes->ClipFlags, NULL);
+}
+
+//=====================================================================================
+//	CullBoxes_Free
+//=====================================================================================
+static void CullBoxes_Free(World_CullBoxes *Boxes)
+{
+	int32		i;
+
+	if (Boxes->Items)
+		geRam_Free(Boxes->Items);
+	if (Boxes->ItemBoxes)
+		geRam_Free(Boxes->ItemBoxes);
+	if (Boxes->Visible)
+		geRam_Free(Boxes->Visible);
+	if (Boxes->ClipFlags)
+		geRam_Free(Boxes->ClipFlags);
+	if (Boxes->Actors)
+		geRam_Free(Boxes->Actors);
+
+	for (i=0; i< 6; i++)
+	{
+		if (Boxes->Bounds[i])
+			geRam_Free(Boxes->Bounds[i]);
+	}
+
+	memset(Boxes, 0, sizeof(*Boxes));
+}
 
 //=====================================================================================
 //	RenderScene
@@ -951,12 +1543,15 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 	//	Render the actors
 	//
 	{	
-		int i;
+		int i, n;
 		World_Actor		*WActor;
+		World_CullBoxes	*Boxes;
+		const ActorTree_Proxy *Proxy;
 
 //MRB BEGIN
 //geSprite
 		World_Sprite *WSprite;
+		geExtBox		SpriteBox;
 //MRB END
 
 		//geXForm3d		XForm;
@@ -974,6 +1569,14 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 			return GE_FALSE;
 		}
 
+		// Takes the boxes (and leafs) of any actors that changed since the last time
+		ActorTree_Update(World->ActorTree, World);
+
+		Boxes = &CullBoxes[MirrorRecursion];
+
+		if (!CullBoxes_Begin(Boxes, World->ActorCount))
+			return GE_FALSE;
+
 		// We were using the actor array alot, so I though I'd move it out...
 		// There were also going to be a lot of nested if's, so they are continues now...
 		WActor = World->ActorArray;
@@ -985,24 +1588,50 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 				if (MirrorRecursion > 0 && !(WActor->Flags & (GE_ACTOR_RENDER_MIRRORS | GE_ACTOR_RENDER_ALWAYS)))
 					continue;		// Not visible in mirros, skip it
 
+				if	(WActor->Flags & GE_ACTOR_RENDER_ALWAYS)
 				{
-					geExtBox Box;
-					geBoolean Enabled;
-					geActor_GetRenderHintExtBox(WActor->Actor,&Box,&Enabled);
-					if (Enabled == GE_TRUE)
-						{
-							geExtBox_GetTranslation ( &Box, &Center );
-							if	(!(WActor->Flags & GE_ACTOR_RENDER_ALWAYS))
-								{
-									// NOTE - We are not taking into acount that a actor may live in more than one leaf...
-									geWorld_GetLeaf(World, &Center, &Leaf);
-					
-									if (World->CurrentBSP->LeafData[Leaf].VisFrame != World->CurFrameStatic)
-										continue;		// Not in PVS, skip it
-								}
-						}
+					CullBoxes_Add(Boxes, i, NULL);
+					continue;
 				}
 
+				// NOTE - We are not taking into acount that a actor may live in more than one leaf...
+				Proxy = ActorTree_GetProxy(World->ActorTree, WActor->Proxy);
+				Leaf = Proxy->RenderLeaf;
+			
+				if (Leaf >= 0 && World->CurrentBSP->LeafData[Leaf].VisFrame != World->CurFrameStatic)
+					continue;		// Not in PVS, skip it
+
+				// Actors with a render hint box get it tested against the frustum with the rest
+				CullBoxes_Add(Boxes, i, (Leaf >= 0) ? &Proxy->RenderBox : NULL);
+			}
+
+		CullBoxes_Cull(Boxes, &ActorFrustum);
+
+		// Pose and skin all the visible actors up front, spread across the cpus.  Only for
+		// the main view, since mirrors go through geActor_RenderThroughFrustum.
+		if (MirrorRecursion == 0)
+		{
+			int32		NumActors = 0;
+
+			for (n=0; n< Boxes->NumItems; n++)
+			{
+				if (Boxes->ItemBoxes[n] >= 0 && !CULLBOXES_VISIBLE(Boxes, Boxes->ItemBoxes[n]))
+					continue;
+
+				Boxes->Actors[NumActors++] = World->ActorArray[Boxes->Items[n]].Actor;
+			}
+
+			if (!geActor_RenderPrepBatch(Boxes->Actors, NumActors, Camera, 0))
+				return GE_FALSE;
+		}
+
+		for (n=0; n< Boxes->NumItems; n++)
+			{
+				if (Boxes->ItemBoxes[n] >= 0 && !CULLBOXES_VISIBLE(Boxes, Boxes->ItemBoxes[n]))
+					continue;		// Out of the frustum, skip it
+
+				WActor = &World->ActorArray[Boxes->Items[n]];
+
 				if (MirrorRecursion == 0)
 				{
 					geActor_Render( WActor->Actor, Engine, World, Camera);
@@ -1020,6 +1649,9 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 
 //MRB BEGIN
 //geSprite
+		if (!CullBoxes_Begin(Boxes, World->SpriteCount))
+			return GE_FALSE;
+
 		WSprite = World->SpriteArray;
 
 		for (i = 0; i < World->SpriteCount; i++, WSprite++)
@@ -1032,22 +1664,37 @@ static geBoolean RenderScene(geEngine *Engine, geWorld *World, geCamera *Camera,
 			if ( (MirrorRecursion > 0) && !(WSprite->Flags & (GE_SPRITE_RENDER_MIRRORS | GE_SPRITE_RENDER_ALWAYS)) )
 				continue;
 
-			// if it is not always rendered, then make sure it is in a visible leaf
-			if (!(WSprite->Flags & GE_SPRITE_RENDER_ALWAYS))
+			// if it is always rendered, it doesn't get culled
+			if (WSprite->Flags & GE_SPRITE_RENDER_ALWAYS)
 			{
-				// get the position of the sprite
-				geSprite_GetPosition( WSprite->Sprite, &Center );
+				CullBoxes_Add(Boxes, i, NULL);
+				continue;
+			}
 
-				// NOTE - We are not taking into acount that a sprite may live in more than one leaf...
-				geWorld_GetLeaf(World, &Center, &Leaf);
+			// get the position of the sprite
+			geSprite_GetPosition( WSprite->Sprite, &Center );
 
-				// Not in PVS, skip it
-				if (World->CurrentBSP->LeafData[Leaf].VisFrame != World->CurFrameStatic)
-					continue;		
-			}
+			// NOTE - We are not taking into acount that a sprite may live in more than one leaf...
+			geWorld_GetLeaf(World, &Center, &Leaf);
+
+			// Not in PVS, skip it
+			if (World->CurrentBSP->LeafData[Leaf].VisFrame != World->CurFrameStatic)
+				continue;		
+
+			// Then it gets tested against the frustum with the rest
+			geSprite_GetRenderExtBox(WSprite->Sprite, &SpriteBox);
+			CullBoxes_Add(Boxes, i, &SpriteBox);
+		}
+
+		CullBoxes_Cull(Boxes, &ActorFrustum);
+
+		for (n = 0; n < Boxes->NumItems; n++)
+		{
+			if (Boxes->ItemBoxes[n] >= 0 && !CULLBOXES_VISIBLE(Boxes, Boxes->ItemBoxes[n]))
+				continue;
 
 			// render the sprite through the frustum
-			geSprite_RenderThroughFrustum(WSprite->Sprite, Engine, World, Camera, &ActorFrustum);
+			geSprite_RenderThroughFrustum(World->SpriteArray[Boxes->Items[n]].Sprite, Engine, World, Camera, &ActorFrustum);
 		}
 //MRB END
 
@@ -1257,6 +1904,162 @@ static void RenderBSPFrontBack_r(int32 Node, const geWorld_RenderInfo *RenderInf
 	RenderBSPFrontBack_r(pNode->Children[!Side], RenderInfo, ClipFlags);
 }
 
+//=====================================================================================
+//	CullVisNodes
+//	Tests every visible node box against the frustum in one batch.  The result is what
+//	RenderBSPFrontBack_r would find for each node and plane.  It goes in this mirror
+//	recursion levels masks, so a mirror doesn't wipe out the ones of the view it's in.
+//=====================================================================================
+static void CullVisNodes(World_VisNodes *VisNodes, const Frustum_Info *Fi, uint32 ClipFlags)
+{
+	Frustum_CullAABBs(Fi, ClipFlags, VisNodes->Bounds, VisNodes->NumNodes, NULL, 
+						VisNodes->ClipFlags[MirrorRecursion], VisNodes->Outside[MirrorRecursion]);
+}
+
+//=====================================================================================
+//	RenderVisNodes_r2
+//	Same as RenderBSPFrontBack_r2, through the visible node list
+//=====================================================================================
+static void RenderVisNodes_r2(int32 VisNode, geCamera *Camera)
+{
+	World_VisNode	*pVisNode;
+	GFX_Node		*pNode;
+	geFloat			Dist1;
+	int32			Side;
+
+	if (VisNode == WORLD_VISNODE_SKIP)
+		return;
+
+	if (VisNode < 0)		// At leaf, no more recursing
+	{
+		int32		Leaf;
+		gePoly		*PolyList;
+
+		Leaf = -(VisNode+1);
+
+		assert(Leaf >= 0 && Leaf < CWorld->CurrentBSP->BSPData.NumGFXLeafs);
+
+		PolyList = CWorld->CurrentBSP->LeafData[Leaf].PolyList;
+
+		if (PolyList)
+		{
+			CDebugInfo->NumLeafsWithUserPolys++;
+			GList_AddOperation(1, (uint32)PolyList);
+		}
+
+		CDebugInfo->NumLeafsHit2++;
+		
+		return;
+	}
+
+	CDebugInfo->NumNodesTraversed2++;
+
+	pVisNode = &CBSP->VisNodes.Nodes[VisNode];
+	pNode = &BSPData->GFXNodes[pVisNode->Node];
+	
+	Dist1 = Plane_PlaneDistanceFast(&BSPData->GFXPlanes[pNode->PlaneNum], geCamera_GetPov(Camera));
+
+	if (Dist1 < 0)
+		Side = 1;
+	else
+		Side = 0;
+	
+	RenderVisNodes_r2(pVisNode->Children[Side], Camera);
+	RenderVisNodes_r2(pVisNode->Children[!Side], Camera);
+}
+
+//=====================================================================================
+//	RenderVisNodes_r
+//	Same as RenderBSPFrontBack_r, through the visible node list.  Nodes and faces that
+//	aren't visible are already gone, and the frustum tests come from CullVisNodes.
+//=====================================================================================
+static void RenderVisNodes_r(int32 VisNode, const geWorld_RenderInfo *RenderInfo, int32 ClipFlags)
+{
+	World_VisNodes	*VisNodes;
+	World_VisNode	*pVisNode;
+	GFX_Node		*pNode;
+	geFloat			Dist1;
+	int32			i, f, Side;
+	int32			*pFaces;
+
+	if (VisNode == WORLD_VISNODE_SKIP)
+		return;
+
+	if (VisNode < 0)		// At leaf, no more recursing
+	{
+		int32		Leaf;
+		gePoly		*PolyList;
+
+		Leaf = -(VisNode+1);
+
+		assert(Leaf >= 0 && Leaf < CWorld->CurrentBSP->BSPData.NumGFXLeafs);
+
+		PolyList = CWorld->CurrentBSP->LeafData[Leaf].PolyList;
+
+		if (PolyList)
+		{
+			CDebugInfo->NumLeafsWithUserPolys++;
+			GList_AddOperation(1, (uint32)PolyList);
+		}
+
+		CDebugInfo->NumLeafsHit1++;
+
+		return;
+	}
+
+	CDebugInfo->NumNodesTraversed1++;
+
+	VisNodes = &CBSP->VisNodes;
+
+	pVisNode = &VisNodes->Nodes[VisNode];
+	pNode = &BSPData->GFXNodes[pVisNode->Node];
+	
+	if (ClipFlags)	
+	{
+		if (ClipFlags & VisNodes->Outside[MirrorRecursion][VisNode])
+		{
+			// We have no more visible nodes from this POV, so just traverse to leafs from here
+			RenderVisNodes_r2(VisNode, RenderInfo->Camera);
+			return;
+		}
+
+		ClipFlags &= VisNodes->ClipFlags[MirrorRecursion][VisNode];		// Don't need to clip to the planes it's in front of anymore
+	}
+	
+	// Get the distance that the eye is from this plane
+	Dist1 = Plane_PlaneDistanceFast(&BSPData->GFXPlanes[pNode->PlaneNum], geCamera_GetPov(RenderInfo->Camera));
+
+	if (Dist1 < 0)
+		Side = 1;		// Back side first
+	else
+		Side = 0;		// Front side first
+
+	// Render the side of the node we are on first
+	RenderVisNodes_r(pVisNode->Children[Side], RenderInfo, ClipFlags);
+		
+	// Setup the global driver info about this plane (all the faces share it for this run)
+	GlobalInfo.PlaneNormal = BSPData->GFXPlanes[pNode->PlaneNum].Normal;
+	GlobalInfo.PlaneDist = BSPData->GFXPlanes[pNode->PlaneNum].Dist;
+	geXForm3d_Rotate(geCamera_GetCameraSpaceXForm(RenderInfo->Camera), &GlobalInfo.PlaneNormal, &GlobalInfo.RPlaneNormal);
+
+	// Render the visible faces on this node
+	pFaces = &VisNodes->Faces[pVisNode->FirstFace];
+
+	for (i = 0; i < pVisNode->NumFaces; i++)
+	{
+		f = pFaces[i];
+			
+		if (BSPData->GFXFaces[f].PlaneSide != Side)
+			continue;
+		
+		CEngine->DebugInfo.TraversedPolys++;
+		RenderFace(f, RenderInfo, ClipFlags);
+	}
+
+	// Render faces on the other side of the node
+	RenderVisNodes_r(pVisNode->Children[!Side], RenderInfo, ClipFlags);
+}
+
 void GENESISCC geXForm3d_SetLeft(geXForm3d *M, const geVec3d *Left)
 	// Gets a vector that is 'left' in the frame of reference of M (facing -Z)
 {
@@ -1719,10 +2522,21 @@ static geBoolean RenderWorldModel(geCamera *Camera, Frustum_Info *FrustumInfo, g
 	RenderInfo.Frustum = &WorldSpaceFrustum;
 	RenderInfo.SkyTData = SkyTData;
 
-	// Render the tree through the frustum
-	RenderBSPFrontBack_r(	BSPData->GFXModels[0].RootNode[0], 
-							&RenderInfo,
-							StartClipFlags);
+	// Render the tree through the frustum.  While the camera stays in the same leaf, only
+	// the visible nodes kept by Vis get looked at.  Mirrors re-enter from RenderFace in
+	// the middle of the traversal, but each recursion level culls into it's own masks.
+	if (CBSP->VisNodes.Frame == CWorld->CurFrameStatic)
+	{
+		CullVisNodes(&CBSP->VisNodes, &WorldSpaceFrustum, StartClipFlags);
+
+		RenderVisNodes_r(CBSP->VisNodes.Root, &RenderInfo, StartClipFlags);
+	}
+	else
+	{
+		RenderBSPFrontBack_r(	BSPData->GFXModels[0].RootNode[0], 
+								&RenderInfo,
+								StartClipFlags);
+	}
 
 	// Restore the camera
 	geCamera_SetWorldSpaceXForm(Camera, &OldXForm);
@@ -1741,13 +2555,15 @@ static geBoolean RenderWorldModel(geCamera *Camera, Frustum_Info *FrustumInfo, g
 //=====================================================================================
 static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, geWorld_SkyBoxTData *SkyTData)
 {
-	int32				i;
+	int32				i, n, b;
 	BOOL				OldVis;
 	geWorld_Model		*Model;
 	geXForm3d			OldXForm, NewXForm, CXForm;
-	Frustum_Info		ModelSpaceFrustum;
+	Frustum_Info		ModelSpaceFrustum, WorldSpaceFrustum;
 	uint32				StartClipFlags;
 	geWorld_RenderInfo	RenderInfo;
+	World_CullBoxes		*Boxes;
+	geExtBox			Box;
 
 
 	if (!RDriver->BeginModels())
@@ -1759,17 +2575,18 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 	assert(CWorld != NULL);			// Assert that some globals are true (hopefully)...
 	assert(CBSP != NULL);
 	
-	OldVis = CWorld->VisInfo;		// Save old vis info flag
+	// A mirror on a model starts a new scene while we are still going through the boxes,
+	// so each mirror level has it's own
+	Boxes = &CullBoxes[MirrorRecursion];
+
+	if (!CullBoxes_Begin(Boxes, BSPData->NumGFXModels))
+		return GE_FALSE;
 
-	CWorld->VisInfo = FALSE;		// Fake no vis info so ALL model faces/modes will draw
-	
 	Model = &CBSP->Models[1];		// Start with the model (skip the world, Models[0])
 	
-	// Render all sub models
+	// Gather the world space boxes of the models that are in the PVS
 	for (i=1; i< BSPData->NumGFXModels; i++, Model++)
 	{
-		g_CurrentModel = Model;
-
 		if (Model->VisFrame != CWorld->CurFrameDynamic)
 			continue;
 		if (MirrorRecursion == 0 && !(Model->Flags & (GE_MODEL_RENDER_NORMAL | GE_MODEL_RENDER_ALWAYS)))
@@ -1779,6 +2596,36 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 
 		CEngine->DebugInfo.NumModels++;
 
+		Box.Min = Model->TMins;
+		Box.Max = Model->TMaxs;
+
+		CullBoxes_Add(Boxes, i, &Box);
+	}
+
+	// Test them all against the frustum at once
+	Frustum_TransformToWorldSpace(FrustumInfo, Camera, &WorldSpaceFrustum);
+
+	CullBoxes_Cull(Boxes, &WorldSpaceFrustum);
+
+	OldVis = CWorld->VisInfo;		// Save old vis info flag
+
+	CWorld->VisInfo = FALSE;		// Fake no vis info so ALL model faces/modes will draw
+	
+	// Render all sub models
+	for (n=0; n< Boxes->NumItems; n++)
+	{
+		b = Boxes->ItemBoxes[n];
+
+		// Out of the frustum.  The model leafs never hold user polys, so there is nothing
+		// for RenderBSPFrontBack_r2 to find in there either.
+		if (!CULLBOXES_VISIBLE(Boxes, b))
+			continue;
+
+		i = Boxes->Items[n];
+		Model = &CBSP->Models[i];
+
+		g_CurrentModel = Model;
+
 		OldXForm = *geCamera_GetWorldSpaceXForm(Camera);//Camera->MXForm;	// Save old camera for this model
 
 		NewXForm = OldXForm;
@@ -1804,8 +2651,9 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 
 		geCamera_FillDriverInfo(Camera);
 	
-		// Make a ClipFlags bits for for each side of the frustum...
-		StartClipFlags = (1<<ModelSpaceFrustum.NumPlanes)-1;
+		// The planes the whole model is in front of don't need clipping to (the model space 
+		// frustum has the same planes, in the same order)
+		StartClipFlags = Boxes->ClipFlags[b];
 
 		RenderInfo.Camera = Camera;
 		RenderInfo.Frustum = &ModelSpaceFrustum;
@@ -1834,17 +2682,41 @@ static geBoolean RenderSubModels(geCamera *Camera, Frustum_Info *FrustumInfo, ge
 //	CreateGBSP
 //========================================================================================
 static World_BSP *CreateGBSP(geVFile *File)	
+{
+	World_BSP	*NewBSP;
+	geErrorLog_ErrorIDEnumType	Error;
+
+	NewBSP = World_LoadBSP(File, &Error);
+
+	if (!NewBSP)
+	{
+		if (Error == GE_ERR_OUT_OF_MEMORY)
+			geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		else
+			geErrorLog_Add(GE_ERR_GBSP_LOAD_FAILURE, NULL);
+		return NULL;
+	}
+
+	return NewBSP;
+}
+
+//========================================================================================
+//	World_LoadBSP
+//	CreateGBSP without the error log (the loader thread calls it).  Error gets what failed.
+//========================================================================================
+static World_BSP *World_LoadBSP(geVFile *File, geErrorLog_ErrorIDEnumType *Error)
 {
 	World_BSP	*NewBSP;
 
 	assert(File != NULL);
+	assert(Error != NULL);
 
 	// Create a new bsp World
 	NewBSP = GE_RAM_ALLOCATE_STRUCT(World_BSP);
 
 	if (!NewBSP)
 	{
-		geErrorLog_Add(GE_ERR_OUT_OF_MEMORY, NULL);
+		*Error = GE_ERR_OUT_OF_MEMORY;
 		return NULL;
 	}
 	
@@ -1852,7 +2724,10 @@ static World_BSP *CreateGBSP(geVFile *File)
 	
 	if (!GBSP_LoadGBSPFile(File, &NewBSP->BSPData))
 	{
-		geErrorLog_Add(GE_ERR_GBSP_LOAD_FAILURE, NULL);
+		// Free whatever chunks made it in before the failure
+		GBSP_FreeGBSPFile(&NewBSP->BSPData);
+		geRam_Free(NewBSP);
+		*Error = GE_ERR_GBSP_LOAD_FAILURE;
 		return NULL;
 	}
 
@@ -2306,6 +3181,12 @@ GENESISAPI geBoolean geWorld_AddActor( geWorld *World, geActor *Actor, uint32 Fl
 			geErrorLog_AddString(-1,"Failed to prepare the actor for rendering", NULL);
 			return GE_FALSE;
 		}
+	World->ActorArray[World->ActorCount].Proxy = ActorTree_AddActor(World->ActorTree, World->ActorCount, Actor);
+	if (World->ActorArray[World->ActorCount].Proxy < 0)
+		{
+			geErrorLog_AddString(-1,"Failed to add the actor to the actor tree", NULL);
+			return GE_FALSE;
+		}
 	World->ActorCount++;
 	geActor_CreateRef(Actor);
 
@@ -2344,10 +3225,14 @@ GENESISAPI geBoolean geWorld_RemoveActor(geWorld *World, geActor *Actor)
 		{
 			if (World->ActorArray[i].Actor == Actor)
 				{
+					ActorTree_RemoveActor(World->ActorTree, World->ActorArray[i].Proxy, Actor);
 					geActor_Destroy( &Actor );
 					World->ActorArray[i] = World->ActorArray[Count-1];
+					if (i < Count-1)
+						ActorTree_SetActorIndex(World->ActorTree, World->ActorArray[i].Proxy, i);
 					World->ActorArray[Count-1].Actor = NULL;
 					World->ActorArray[Count-1].Flags = 0;
+					World->ActorArray[Count-1].Proxy = -1;
 					World->ActorCount--;
 					return GE_TRUE;
 				}
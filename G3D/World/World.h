@@ -36,6 +36,7 @@
 #include "Bitmaplist.h"
 
 #include "Actor.h"			
+#include "ActorTree.h"
 
 //MRB BEGIN
 //geSprite
@@ -84,6 +85,9 @@ typedef struct geWorld_Leaf
 	int32			Parent;								// Parent nodes of all leafs
 
 	gePoly			*PolyList;							// List of poly fragments to render for this leaf (geWorld_AddPoly)
+
+	int32			DLightFrame;						// == World->CurFrameDynamic if a dlight reaches this leaf
+	int32			DLights;							// First Light_DLightRef reaching this leaf
 } geWorld_Leaf;
 
 #define MAX_VISIBLE_FOG		12	// Hope to God there is not this much visible at a time!!!
@@ -101,6 +105,39 @@ typedef struct
 	geWorld			*World;
 } geWorld_FogData;
 
+// The visible part of the world models tree, rebuilt by Vis when the camera leaf changes
+#define WORLD_VISNODE_SKIP		0x7fffffff			// Child that is not visible, and never gets traversed
+
+typedef struct
+{
+	int32			Node;								// GFX node
+	int32			Children[2];						// World_VisNode, leaf (-(Leaf+1)), or WORLD_VISNODE_SKIP
+	int32			FirstFace;							// Visible faces on this node, in World_VisNodes::Faces
+	int32			NumFaces;
+} World_VisNode;
+
+typedef struct
+{
+	int32			Frame;								// == World->CurFrameStatic when up to date
+	int32			Root;								// Same encoding as World_VisNode::Children
+
+	World_VisNode	*Nodes;
+	int32			NumNodes;
+
+	int32			*Faces;
+	int32			NumFaces;
+
+	// Node boxes, laid out like GFX_Node Mins/Maxs (MinX, MinY, MinZ, MaxX, MaxY, MaxZ),
+	// so a frustum plane can be tested against all of them in one pass
+	geFloat			*Bounds[6];
+
+	// From Frustum_CullAABBs each frame: the planes a node is all the way behind, and the
+	// planes it still needs clipping to.  One set per mirror recursion level, since mirrors
+	// render the world again from the middle of the traversal.
+	uint32			*Outside[MAX_MIRROR_RECURSION+1];
+	uint32			*ClipFlags[MAX_MIRROR_RECURSION+1];
+} World_VisNodes;
+
 typedef struct World_BSP
 {
 	char			FileName[200];
@@ -123,6 +160,8 @@ typedef struct World_BSP
 
 	int32			*NodeParents;						// Parent nodes of all leafs
 
+	World_VisNodes	VisNodes;
+
 } World_BSP;
 
 typedef struct
@@ -162,7 +201,7 @@ typedef struct World_Actor
 	uint32			Flags;				// GE_ACTOR_RENDER_NORMAL, GE_ACTOR_RENDER_MIRRORS, GE_ACTOR_COLLIDE
 	uint32			UserFlags;
 
-	//int32			Leaf;				// Current leaf the actor is in (currently used for PVS occlusion)
+	int32			Proxy;				// Proxy in World->ActorTree (it keeps the leaf the actor is in)
 } World_Actor;
 
 //MRB BEGIN
@@ -227,6 +266,7 @@ typedef struct geWorld
 	
 	int32				ActorCount;							// Number of actors in world
 	World_Actor			*ActorArray;						// Array of actors
+	ActorTree			*ActorTree;							// Broadphase for the actors in ActorArray
 
 //MRB BEGIN
 //geSprite
@@ -263,6 +303,10 @@ typedef struct geWorld
 //=====================================================================================
 GENESISAPI		geWorld *geWorld_Create(geVFile *File);
 GENESISAPI		void geWorld_Free(geWorld *World);
+GENESISAPI		geWorld *geWorld_CreateCached(geVFile *File, geVFile *Cache);
+GENESISAPI		geWorld_Loader *geWorld_CreateAsync(geVFile *File);
+GENESISAPI		geBoolean geWorld_LoaderPoll(geWorld_Loader *Loader);
+GENESISAPI		geWorld *geWorld_LoaderFinish(geWorld_Loader *Loader);
 geBoolean		geWorld_CreateRef(geWorld *World);
 
 geBoolean	World_EngineInit(geEngine *Engine);
@@ -49,7 +49,9 @@ typedef struct geSprite_DynamicLight
 	geFloat		Radius;
 } geSprite_DynamicLight;
 
-static geSprite_DynamicLight geSpriteDynamicLights[MAX_DYNAMIC_LIGHTS];
+#define SPRITE_MAX_DYNAMIC_LIGHTS	64	// the closest this many lights in range are considered
+
+static geSprite_DynamicLight geSpriteDynamicLights[SPRITE_MAX_DYNAMIC_LIGHTS];
 
 
 // frustum clipping arrays are reused between sprites
@@ -585,69 +587,79 @@ __inline static void geSprite_UpdateLighting(geSprite *S, geWorld *World)
 
 	if (S->MaximumDynamicLightsToUse > 0)
 	{
-		// a pointer to make things easier
-		Light_DLight *DynamicLights = World->LightInfo->DynamicLights;
-		
+		Light_DLight *DLight;
+		int32 Ref;
+
 		// start out with no dynamic lights available for lighting
 		int32 DLCount = 0;
 
-		// get all the dynamic lights that are active
-		for (i = 0; i < MAX_DYNAMIC_LIGHTS; i++)
+		// the farthest light in the array, for when it fills up
+		int32 Farthest = 0;
+
+		// get the dynamic lights that can reach the sprites leaf
+		for (DLight = Light_WorldGetFirstDLight(World, &(S->Position), &Ref); DLight; DLight = Light_WorldGetNextDLight(World, &Ref))
 		{
-			if (DynamicLights[i].Active)
+			// the normal is a vector distance
+			geVec3d Normal;
+			geFloat Distance;
+
+			// removed since the lists were built
+			if (!DLight->Active)
+				continue;
+
+			geVec3d_Subtract(&(S->Position), &(DLight->Pos), &Normal);
+
+			// which is why it can be used to calculate distance (squared)
+			Distance = (Normal.X * Normal.X) + (Normal.Y * Normal.Y) + (Normal.Z * Normal.Z);
+
+			// if the sprite is outside the dynamic light's radius, skip it
+			if (Distance >= (DLight->Radius * DLight->Radius))
+				continue;
+
+			// when the array is full, only a light closer than the farthest one gets in
+			if (DLCount == SPRITE_MAX_DYNAMIC_LIGHTS)
 			{
-				// the normal is a vector distance
-				geVec3d Normal;
-				geVec3d_Subtract(&(S->Position), &(DynamicLights[i].Pos), &Normal);
+				if (Distance >= geSpriteDynamicLights[Farthest].Distance)
+					continue;
+				i = Farthest;
+			}
+			else
+				i = DLCount++;
 
-				// which is why it can be used to calculate distance (squared)
-				geSpriteDynamicLights[DLCount].Distance = (Normal.X * Normal.X) + 
-																									(Normal.Y * Normal.Y) + 
-																									(Normal.Z * Normal.Z);
+			geSpriteDynamicLights[i].Distance = Distance;
+			geSpriteDynamicLights[i].Color.r = DLight->Color.r;
+			geSpriteDynamicLights[i].Color.g = DLight->Color.g;
+			geSpriteDynamicLights[i].Color.b = DLight->Color.b;
+			geSpriteDynamicLights[i].Radius = DLight->Radius;
+			// this normal will be normalized later
+			geSpriteDynamicLights[i].Normal = Normal;
 
-				// if the sprite is inside the active dynamic light's radius, then add it to the array
-				if (geSpriteDynamicLights[DLCount].Distance < (DynamicLights[i].Radius * DynamicLights[i].Radius))
+			if (DLCount == SPRITE_MAX_DYNAMIC_LIGHTS)
+			{
+				for (j = 0, Farthest = 0; j < DLCount; j++)
 				{
-					geSpriteDynamicLights[DLCount].Color.r = DynamicLights[i].Color.r;
-					geSpriteDynamicLights[DLCount].Color.g = DynamicLights[i].Color.g;
-					geSpriteDynamicLights[DLCount].Color.b = DynamicLights[i].Color.b;
-					geSpriteDynamicLights[DLCount].Radius = DynamicLights[i].Radius;
-					// this normal will be normalized later
-					geSpriteDynamicLights[DLCount].Normal = Normal;
-					DLCount++;
+					if (geSpriteDynamicLights[j].Distance > geSpriteDynamicLights[Farthest].Distance)
+						Farthest = j;
 				}
 			}
 		}
 
-		// try to eliminate some easy out possibilities
-		if (DLCount > 1)
+		// move the closest lights to the front, in order, only as far as they will be used
+		for (i = 0; i < S->MaximumDynamicLightsToUse && i < (DLCount - 1); i++)
 		{
-			// if there is only one light needed, just make sure the closest
-			// is in the first location
-			if ( (S->MaximumDynamicLightsToUse == 1) )
+			int32 Closest = i;
+
+			for (j = i + 1; j < DLCount; j++)
 			{
-				for (i = 1; i < DLCount; i++)
-				{
-					if (geSpriteDynamicLights[i].Distance < geSpriteDynamicLights[0].Distance)
-						geSpriteDynamicLights[0] = geSpriteDynamicLights[i];
-				}
+				if (geSpriteDynamicLights[j].Distance < geSpriteDynamicLights[Closest].Distance)
+					Closest = j;
 			}
-			// if there is not just one light to get out of the array, then
-			// sort the active dynamic lights by distance (squared)
-			else
+
+			if (Closest != i)
 			{
-				for (i = 0; i < DLCount; i++)
-				{
-					for (j = 0; j < (DLCount - 1); j++)
-					{
-						if (geSpriteDynamicLights[j].Distance > geSpriteDynamicLights[j+1].Distance)
-						{
-							TempSwap = geSpriteDynamicLights[j];
-							geSpriteDynamicLights[j] = geSpriteDynamicLights[j+1];
-							geSpriteDynamicLights[j+1] = TempSwap;
-						}
-					}
-				}
+				TempSwap = geSpriteDynamicLights[i];
+				geSpriteDynamicLights[i] = geSpriteDynamicLights[Closest];
+				geSpriteDynamicLights[Closest] = TempSwap;
 			}
 		}
 
@@ -1295,6 +1307,27 @@ GENESISAPI void GENESISCC geSprite_SetUserData(geSprite *S, void *UserData)
 }
 
 
+void GENESISCC geSprite_GetRenderExtBox(const geSprite *S, geExtBox *Box)
+{
+	geFloat Radius;
+
+	assert( geSprite_IsValid(S) != GE_FALSE );
+	assert( Box != NULL );
+
+	// the corners can end up anywhere on a sphere around the external transform, pushed
+	// out by the internal translation (the transforms don't scale)
+	Radius = (geFloat)sqrt( (S->ScaleX * S->ScaleX) + (S->ScaleY * S->ScaleY) ) * 0.5f;
+
+	if (S->InternalTransformUsed)
+		Radius += geVec3d_Length(&(S->InternalTransform.Translation));
+
+	geExtBox_Set( Box, -Radius, -Radius, -Radius, Radius, Radius, Radius );
+	geExtBox_Translate( Box, S->Transform.Translation.X,
+							 S->Transform.Translation.Y,
+							 S->Transform.Translation.Z );
+}
+
+
 geBoolean GENESISCC geSprite_RenderPrep(geSprite *S, geWorld *World)
 {
 	assert( geSprite_IsValid(S) );
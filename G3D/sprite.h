@@ -197,6 +197,9 @@ GENESISAPI void GENESISCC geSprite_SetUserData(geSprite *S, void *UserData);
 	// Must be called prior to render/pose/setworldtransform 
 geBoolean GENESISCC geSprite_RenderPrep( geSprite *A, geWorld *World);
 
+	// Gets a world space box that holds the sprite however it ends up facing
+void GENESISCC geSprite_GetRenderExtBox(const geSprite *S, geExtBox *Box);
+
 	// Draws the geSprite.  (RenderPrep must be called first)
 geBoolean GENESISCC geSprite_RenderThroughFrustum(geSprite *S, geEngine *Engine, geWorld *World, geCamera *Camera, Frustum_Info *FInfo);
 #endif
@@ -152,6 +152,13 @@ MAP_Brush *LoadMapBrush(geVFile *VFile)
 
 		PlaneNum = FindPlane(&Plane, &PlaneSide);
 
+		if (PlaneNum == -1)
+		{
+			GHook.Error("LoadMapBrush:  Could not create the plane.\n");
+			FreeMapBrush(Brush);
+			return NULL;
+		}
+
 		Side = Brush->OriginalSides;
 		for (s = 0; s<NumSides; s++, Side++)
 		{
@@ -526,6 +533,8 @@ GBSP_Brush *CopyBrush(GBSP_Brush *Brush)
 
 	memcpy (NewBrush, Brush, Size);
 
+	NewBrush->KeyValid = GE_FALSE;		// Copies usually get their sides changed
+
 	for (i=0 ; i<Brush->NumSides ; i++)
 	{
 		if (!Brush->Sides[i].Poly)
@@ -740,6 +749,13 @@ GBSP_Brush *BrushFromBounds (geVec3d *Mins, geVec3d *Maxs)
 		Plane.Dist = -(VectorToSUB(*Mins, i)-1);
 		b->Sides[i+3].PlaneNum = FindPlane(&Plane, &Side);
 		b->Sides[i+3].PlaneSide = (uint8)Side;
+
+		if (b->Sides[i].PlaneNum == -1 || b->Sides[i+3].PlaneNum == -1)
+		{
+			GHook.Error("BrushFromBounds:  Could not create the planes.\n");
+			FreeBrush(b);
+			return NULL;
+		}
 	}
 
 	CreateBrushPolys(b);
@@ -223,6 +223,7 @@ extern int32		NumBSPModels;
 extern geBoolean	Verbose;
 extern geBoolean	OriginalVerbose;
 extern geBoolean	EntityVerbose;
+extern int32		NumBSPThreads;		// Threads to build the trees with
 
 #define MAX_WELDED_VERTS			64000*2
 
@@ -261,6 +262,7 @@ geFloat		RoundInt(geFloat In);
 void		SnapPlane(geVec3d *Normal, geFloat *Dist);
 void		PlaneInverse(GBSP_Plane *Plane);
 int32		FindPlane(GBSP_Plane *Plane, int32 *Side);
+void		FreezePlanes(geBoolean Freeze);
 void		PlaneInverse(GBSP_Plane *Plane);
 geFloat		_fastcall Plane_PointDistanceFast(GBSP_Plane *Plane, geVec3d *Point);
 
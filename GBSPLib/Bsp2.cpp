@@ -32,6 +32,8 @@
 #include "Texture.h"
 #include "Fill.h"
 #include "Brush2.h"
+#include "TreeCache.h"
+#include "Thread.h"
 
 #include "Vec3d.h"
 #include "Ram.h"
@@ -51,6 +53,9 @@ int32	NumMakeFaces = 0;
 
 #define PLANESIDE_EPSILON	0.001f
 
+#define SPLIT_THREAD_WORK		(256*256)		// Candidates*brushes before a node is scored on all threads
+#define TREE_TASKS_PER_THREAD	8				// Subtrees handed to each thread (roughly)
+
 //=======================================================================================
 //	VisibleContents
 //=======================================================================================
@@ -488,30 +493,187 @@ geBoolean CheckPlaneAgainstVolume (int32 PNum, GBSP_Node *Node)
 }
 
 //=======================================================================================
-//	SelectSplitSide
+//	Split candidates
+//	Every side that could split a node gets scored, but only the first side found on
+//	each plane (the others would score the same, and lose the tie).  Scoring reads the
+//	brushes without touching them, so the candidates of a big node can be scored on
+//	the worker threads, and the best is still the one the old serial loop would find.
 //=======================================================================================
-GBSP_Side *SelectSplitSide(GBSP_Brush *Brushes, GBSP_Node *Node)
+typedef struct
 {
-	int32		Value, BestValue;
-	GBSP_Brush	*Brush, *Test;
-	GBSP_Side	*Side, *BestSide;
-	int32		i, j, Pass, NumPasses;
+	GBSP_Side	*Side;
+	int32		Pass;
+	geBoolean	Skip;					// Not the first side on it's plane
+	geBoolean	Valid;					// Passed the volume check
+	int32		Value;
+} BSP_SplitCandidate;
+
+typedef struct
+{
+	int32		PlaneNum;
+	int32		Candidate;
+} BSP_CandidatePlane;
+
+typedef struct
+{
+	GBSP_Brush			*Brushes;
+	GBSP_Node			*Node;
+	BSP_SplitCandidate	*Candidates;
+} BSP_ScoreContext;
+
+//=======================================================================================
+//	ScoreSplitSide
+//=======================================================================================
+static void ScoreSplitSide(BSP_SplitCandidate *Candidate, GBSP_Brush *Brushes, GBSP_Node *Node)
+{
+	GBSP_Brush	*Test;
+	GBSP_Side	*Side;
 	int32		PNum, PSide;
-	int32		s;
+	int32		s, Value;
 	int32		Front, Back, Both, Facing, Splits;
 	int32		BSplits;
-	int32		BestSplits;
 	int32		EpsilonBrush;
 	geBoolean	HintSplit;
 
+	Side = Candidate->Side;
+
+	PNum = Side->PlaneNum;
+	PSide = Side->PlaneSide;
+				
+	assert(CheckPlaneAgainstParents (PNum, Node) == GE_TRUE);
+
+	Candidate->Valid = GE_FALSE;
+				
+#ifdef USE_VOLUMES
+	if (!CheckPlaneAgainstVolume (PNum, Node))
+		return;
+#endif
+				
+	Front = 0;
+	Back = 0;
+	Both = 0;
+	Facing = 0;
+	Splits = 0;
+	EpsilonBrush = 0;
+	HintSplit = GE_FALSE;
+
+	for (Test = Brushes ; Test ; Test=Test->Next)
+	{
+		s = TestBrushToPlane(Test, PNum, PSide, &BSplits, &HintSplit, &EpsilonBrush);
+
+		Splits += BSplits;
+
+		if (BSplits && (s&PSIDE_FACING) )
+			GHook.Error("PSIDE_FACING with splits\n");
+
+		if (s & PSIDE_FACING)
+			Facing++;
+		if (s & PSIDE_FRONT)
+			Front++;
+		if (s & PSIDE_BACK)
+			Back++;
+		if (s == PSIDE_BOTH)
+			Both++;
+	}
+
+	Value = 5*Facing - 5*Splits - abs(Front-Back);
+				
+	if (Planes[PNum].Type < 3)
+		Value+=5;				
+				
+	Value -= EpsilonBrush*1000;	
+
+	if (HintSplit && !(Side->Flags & SIDE_HINT) )
+		Value = -999999;
+
+	Candidate->Value = Value;
+	Candidate->Valid = GE_TRUE;
+}
+
+//=======================================================================================
+//	ScoreSplitSideThread
+//=======================================================================================
+static geBoolean ScoreSplitSideThread(int32 Work, int32 ThreadNum, void *Context)
+{
+	BSP_ScoreContext	*Score;
+
+	Score = (BSP_ScoreContext*)Context;
+
+	if (!Score->Candidates[Work].Skip)
+		ScoreSplitSide(&Score->Candidates[Work], Score->Brushes, Score->Node);
+
+	return GE_TRUE;
+}
+
+//=======================================================================================
+//	ComparePlanes
+//=======================================================================================
+static int ComparePlanes(const void *a, const void *b)
+{
+	const BSP_CandidatePlane	*A, *B;
+
+	A = (const BSP_CandidatePlane*)a;
+	B = (const BSP_CandidatePlane*)b;
+
+	if (A->PlaneNum != B->PlaneNum)
+		return (A->PlaneNum < B->PlaneNum) ? -1 : 1;
+
+	return (A->Candidate < B->Candidate) ? -1 : (A->Candidate > B->Candidate) ? 1 : 0;
+}
+
+//=======================================================================================
+//	SelectSplitSide
+//	Big nodes are scored with NumThreads threads (1 = on this thread only).
+//	NonVis is set if the side came from the non visible passes.
+//=======================================================================================
+GBSP_Side *SelectSplitSide(GBSP_Brush *Brushes, GBSP_Node *Node, int32 NumThreads, geBoolean *NonVis)
+{
+	int32				BestValue;
+	GBSP_Brush			*Brush, *Test;
+	GBSP_Side			*Side, *BestSide;
+	int32				i, c, Pass, NumPasses;
+	int32				NumBrushes, NumSides, NumCandidates, PassStart, PassEnd;
+	int32				Splits, EpsilonBrush;
+	geBoolean			HintSplit;
+	BSP_SplitCandidate	*Candidates;
+	BSP_CandidatePlane	*CandidatePlanes;
+	BSP_ScoreContext	Score;
+
+	*NonVis = GE_FALSE;
+
 	if (CancelRequest)
 		return NULL;
 
-	BestSide = NULL;
-	BestValue = -999999;
-	BestSplits = 0;
+	NumBrushes = 0;
+	NumSides = 0;
+
+	for (Brush = Brushes ; Brush ; Brush=Brush->Next)
+	{
+		NumBrushes++;
+		NumSides += Brush->NumSides;
+	}
+
+	// A side can only be a candidate in 2 of the passes (visible, and non visible)
+	Candidates = GE_RAM_ALLOCATE_ARRAY(BSP_SplitCandidate, NumSides*2 + 1);
+	CandidatePlanes = GE_RAM_ALLOCATE_ARRAY(BSP_CandidatePlane, NumSides*2 + 1);
+
+	if (!Candidates || !CandidatePlanes)
+	{
+		GHook.Error("SelectSplitSide:  Out of memory for candidates.\n");
+		CancelRequest = GE_TRUE;
+
+		if (Candidates)
+			geRam_Free(Candidates);
+		if (CandidatePlanes)
+			geRam_Free(CandidatePlanes);
+
+		return NULL;
+	}
 
 	NumPasses = 4;
+	NumCandidates = 0;
+
+	// Gather the candidates in the order the passes will get to them
 	for (Pass = 0 ; Pass < NumPasses ; Pass++)
 	{
 		for (Brush = Brushes ; Brush ; Brush=Brush->Next)
@@ -532,82 +694,79 @@ GBSP_Side *SelectSplitSide(GBSP_Brush *Brushes, GBSP_Node *Node)
  				if (!(Side->Flags&SIDE_VISIBLE) && Pass<2)
 					continue;	
 
-				PNum = Side->PlaneNum;
-				PSide = Side->PlaneSide;
-				
-				assert(CheckPlaneAgainstParents (PNum, Node) == GE_TRUE);
-				
-			#ifdef USE_VOLUMES
-				if (!CheckPlaneAgainstVolume (PNum, Node))
-					continue;	
-			#endif
-				
-				Front = 0;
-				Back = 0;
-				Both = 0;
-				Facing = 0;
-				Splits = 0;
-				EpsilonBrush = 0;
-
-				for (Test = Brushes ; Test ; Test=Test->Next)
-				{
-					s = TestBrushToPlane(Test, PNum, PSide, &BSplits, &HintSplit, &EpsilonBrush);
-
-					Splits += BSplits;
-
-					if (BSplits && (s&PSIDE_FACING) )
-						GHook.Error("PSIDE_FACING with splits\n");
-
-					Test->TestSide = s;
-
-					if (s & PSIDE_FACING)
-					{
-						Facing++;
-						for (j=0 ; j<Test->NumSides ; j++)
-						{
-							if (Test->Sides[j].PlaneNum == PNum)
-								Test->Sides[j].Flags |= SIDE_TESTED;
-						}
-					}
-					if (s & PSIDE_FRONT)
-						Front++;
-					if (s & PSIDE_BACK)
-						Back++;
-					if (s == PSIDE_BOTH)
-						Both++;
-				}
-
-				Value = 5*Facing - 5*Splits - abs(Front-Back);
-				
-				if (Planes[PNum].Type < 3)
-					Value+=5;				
-				
-				Value -= EpsilonBrush*1000;	
+				Candidates[NumCandidates].Side = Side;
+				Candidates[NumCandidates].Pass = Pass;
+				Candidates[NumCandidates].Skip = GE_FALSE;
+				Candidates[NumCandidates].Valid = GE_FALSE;
 
-				if (HintSplit && !(Side->Flags & SIDE_HINT) )
-					Value = -999999;
+				CandidatePlanes[NumCandidates].PlaneNum = Side->PlaneNum;
+				CandidatePlanes[NumCandidates].Candidate = NumCandidates;
 
-				if (Value > BestValue)
-				{
-					BestValue = Value;
-					BestSide = Side;
-					BestSplits = Splits;
-					for (Test = Brushes ; Test ; Test=Test->Next)
-						Test->Side = Test->TestSide;
-				}
+				NumCandidates++;
 			}
+		}
+	}
+
+	// Only the first candidate on each plane gets scored
+	qsort(CandidatePlanes, NumCandidates, sizeof(BSP_CandidatePlane), ComparePlanes);
+
+	for (c=1; c< NumCandidates; c++)
+	{
+		if (CandidatePlanes[c].PlaneNum == CandidatePlanes[c-1].PlaneNum)
+			Candidates[CandidatePlanes[c].Candidate].Skip = GE_TRUE;
+	}
+
+	geRam_Free(CandidatePlanes);
+
+	BestSide = NULL;
+	BestValue = -999999;
+
+	Score.Brushes = Brushes;
+	Score.Node = Node;
+
+	for (PassStart = 0; PassStart < NumCandidates; PassStart = PassEnd)
+	{
+		Pass = Candidates[PassStart].Pass;
 
-		#if 0
-			if (BestSide)		// Just take the first side...
+		for (PassEnd = PassStart; PassEnd < NumCandidates; PassEnd++)
+		{
+			if (Candidates[PassEnd].Pass != Pass)
 				break;
-		#endif
+		}
+
+		if (NumThreads > 1 && (PassEnd-PassStart)*NumBrushes >= SPLIT_THREAD_WORK)
+		{
+			Score.Candidates = &Candidates[PassStart];
+
+			if (!Thread_RunOnEach(NumThreads, PassEnd-PassStart, ScoreSplitSideThread, &Score, GE_FALSE))
+				break;
+		}
+		else
+		{
+			for (c=PassStart; c< PassEnd; c++)
+			{
+				if (!Candidates[c].Skip)
+					ScoreSplitSide(&Candidates[c], Brushes, Node);
+			}
+		}
 
+		// First best one wins, just like the candidates were scored one after another
+		for (c=PassStart; c< PassEnd; c++)
+		{
+			if (!Candidates[c].Valid)
+				continue;
+
+			if (Candidates[c].Value > BestValue)
+			{
+				BestValue = Candidates[c].Value;
+				BestSide = Candidates[c].Side;
+			}
 		}
 
 		if (BestSide)
 		{
 			if (Pass > 1)
-				NumNonVisNodes++;
+				*NonVis = GE_TRUE;
 			
 			if (Pass > 0)
 			{
@@ -620,10 +779,18 @@ GBSP_Side *SelectSplitSide(GBSP_Brush *Brushes, GBSP_Node *Node)
 		}
 	}
 
-	for (Brush = Brushes ; Brush ; Brush=Brush->Next)
+	geRam_Free(Candidates);
+
+	if (CancelRequest)
+		return NULL;
+
+	// Leave the side of the best plane on each brush, for SplitBrushList
+	if (BestSide)
 	{
-		for (i=0 ; i<Brush->NumSides ; i++)
-			Brush->Sides[i].Flags &= ~SIDE_TESTED;
+		EpsilonBrush = 0;
+
+		for (Test = Brushes ; Test ; Test=Test->Next)
+			Test->Side = TestBrushToPlane(Test, BestSide->PlaneNum, BestSide->PlaneSide, &Splits, &HintSplit, &EpsilonBrush);
 	}
 
 	return BestSide;
@@ -747,19 +914,153 @@ void LeafNode (GBSP_Node *Node, GBSP_Brush *Brushes)
 }
 
 //=======================================================================================
-//	BuildTree_r
+//	ReplaySplitSide
+//	Puts Node back the way SelectSplitSide left it when it picked Split
 //=======================================================================================
-GBSP_Node *BuildTree_r (GBSP_Node *Node, GBSP_Brush *Brushes)
+static geBoolean ReplaySplitSide(const TreeCache_Split *Split, GBSP_Brush *Brushes, GBSP_Node *Node, GBSP_Side **BestSide, geBoolean *NonVis)
+{
+	GBSP_Brush	*Brush, *Test;
+	GBSP_Side	*Side;
+	int32		i, Splits, EpsilonBrush;
+	geBoolean	HintSplit;
+
+	*NonVis = GE_FALSE;
+
+	if (Split->Brush == TREECACHE_LEAF)
+	{
+		*BestSide = NULL;
+		return GE_TRUE;
+	}
+
+	for (Brush = Brushes, i=0; Brush && i < Split->Brush; Brush = Brush->Next, i++);
+
+	if (!Brush || Split->Side < 0 || Split->Side >= Brush->NumSides)
+		return GE_FALSE;
+
+	Side = &Brush->Sides[Split->Side];
+
+	if (!Side->Poly)
+		return GE_FALSE;
+
+	EpsilonBrush = 0;
+
+	for (Test = Brushes ; Test ; Test=Test->Next)
+		Test->Side = TestBrushToPlane(Test, Side->PlaneNum, Side->PlaneSide, &Splits, &HintSplit, &EpsilonBrush);
+
+	if (Split->Flags & TREECACHE_NONVIS)
+		*NonVis = GE_TRUE;
+
+	if (Split->Flags & TREECACHE_DETAIL)
+	{
+		Node->Detail = GE_TRUE;
+		if (Side->Flags & SIDE_HINT)
+			GHook.Printf("*** Hint as Detail!!! ***\n");
+	}
+
+	*BestSide = Side;
+
+	return GE_TRUE;
+}
+
+//=======================================================================================
+//	ChooseSplitSide
+//	SelectSplitSide, but takes the split the last compile picked for the same volume
+//	and brushes when the tree cache has it
+//=======================================================================================
+static GBSP_Side *ChooseSplitSide(GBSP_Brush *Brushes, GBSP_Node *Node, int32 NumThreads)
+{
+	TreeCache_Key			Key;
+	const TreeCache_Split	*Split;
+	GBSP_Side				*BestSide, *CachedSide;
+	GBSP_Brush				*Brush;
+	int32					BrushNum, SideNum;
+	geBoolean				Cached, CachedDetail, NonVis, CachedNonVis;
+	uint32					Flags;
+
+	if (!TreeCache_IsActive())
+	{
+		BestSide = SelectSplitSide(Brushes, Node, NumThreads, &NonVis);
+
+		if (NonVis)
+			InterlockedIncrement(&NumNonVisNodes);
+
+		return BestSide;
+	}
+
+	TreeCache_MakeKey(Node->Volume, Brushes, &Key);
+
+	Split = TreeCache_Find(&Key);
+
+	Cached = (Split && ReplaySplitSide(Split, Brushes, Node, &CachedSide, &CachedNonVis));
+
+	if (!Cached)
+		BestSide = SelectSplitSide(Brushes, Node, NumThreads, &NonVis);
+	else if (TreeCache_IsVerifying())
+	{
+		// Pick it again from scratch, and make sure it comes out the same
+		CachedDetail = Node->Detail;
+		Node->Detail = GE_FALSE;
+
+		BestSide = SelectSplitSide(Brushes, Node, NumThreads, &NonVis);
+
+		if (BestSide != CachedSide || Node->Detail != CachedDetail || NonVis != CachedNonVis)
+			TreeCache_Mismatch();
+	}
+	else
+	{
+		BestSide = CachedSide;
+		NonVis = CachedNonVis;
+	}
+
+	if (NonVis)
+		InterlockedIncrement(&NumNonVisNodes);
+
+	// Record it for the next compile
+	BrushNum = TREECACHE_LEAF;
+	SideNum = 0;
+
+	if (BestSide)
+	{
+		for (Brush = Brushes, BrushNum = 0; Brush; Brush = Brush->Next, BrushNum++)
+		{
+			if (BestSide >= Brush->Sides && BestSide < Brush->Sides + Brush->NumSides)
+				break;
+		}
+
+		if (!Brush)
+			return BestSide;		// Not from the list (can't happen), so nothing to record
+
+		SideNum = (int32)(BestSide - Brush->Sides);
+	}
+
+	Flags = 0;
+
+	if (Node->Detail)
+		Flags |= TREECACHE_DETAIL;
+	if (NonVis)
+		Flags |= TREECACHE_NONVIS;
+
+	if (!CancelRequest)
+		TreeCache_Add(&Key, BrushNum, SideNum, Flags);
+
+	return BestSide;
+}
+
+//=======================================================================================
+//	BuildNode
+//	Picks the split for Node, and splits it's brushes and volume to the children.
+//	Returns GE_FALSE if Node was made a leaf.
+//=======================================================================================
+static geBoolean BuildNode(GBSP_Node *Node, GBSP_Brush *Brushes, int32 NumThreads, GBSP_Brush **Children)
 {
 	GBSP_Node	*NewNode;
 	GBSP_Side	*BestSide;
 	int32		i;
-	GBSP_Brush	*Children[2];
 
-	NumVisNodes++;
+	InterlockedIncrement(&NumVisNodes);
 
 	// find the best plane to use as a splitter
-	BestSide = SelectSplitSide (Brushes, Node);
+	BestSide = ChooseSplitSide (Brushes, Node, NumThreads);
 	
 	if (!BestSide)
 	{
@@ -771,7 +1072,7 @@ GBSP_Node *BuildTree_r (GBSP_Node *Node, GBSP_Brush *Brushes)
 	#ifdef USE_VOLUMES
 		FreeBrush(Node->Volume);
 	#endif
-		return Node;
+		return GE_FALSE;
 	}
 
 	// This is a splitplane node
@@ -800,6 +1101,20 @@ GBSP_Node *BuildTree_r (GBSP_Node *Node, GBSP_Brush *Brushes)
 	FreeBrush(Node->Volume);
 #endif	
 
+	return GE_TRUE;
+}
+
+//=======================================================================================
+//	BuildTree_r
+//=======================================================================================
+GBSP_Node *BuildTree_r (GBSP_Node *Node, GBSP_Brush *Brushes)
+{
+	int32		i;
+	GBSP_Brush	*Children[2];
+
+	if (!BuildNode(Node, Brushes, 1, Children))
+		return Node;
+
 	// Recursively process children
 	for (i=0 ; i<2 ; i++)
 		Node->Children[i] = BuildTree_r (Node->Children[i], Children[i]);
@@ -807,6 +1122,133 @@ GBSP_Node *BuildTree_r (GBSP_Node *Node, GBSP_Brush *Brushes)
 	return Node;
 }
 
+//=======================================================================================
+//	Threaded tree building
+//	The top of the tree is built on this thread, with the split candidates of each
+//	node scored across all the threads.  Once a node is down to a small enough piece
+//	of the brushes, it's subtree is left as a task, and the tasks are built with
+//	BuildTree_r on the work stealing threads.  Every node still gets the split the
+//	serial build would give it (the choice only depends on the node), and the planes
+//	are frozen the whole time, so no thread can add one, and the tree and the plane
+//	numbers are the same.
+//=======================================================================================
+typedef struct
+{
+	GBSP_Node	*Node;
+	GBSP_Brush	*Brushes;
+	geBoolean	Done;
+} BSP_TreeTask;
+
+static BSP_TreeTask	*TreeTasks;
+static int32		NumTreeTasks;
+static int32		MaxTreeTasks;
+static int32		TreeTaskBrushes;			// Nodes with this many brushes or less become tasks
+
+//=======================================================================================
+//	AddTreeTask
+//=======================================================================================
+static geBoolean AddTreeTask(GBSP_Node *Node, GBSP_Brush *Brushes)
+{
+	if (NumTreeTasks >= MaxTreeTasks)
+	{
+		int32			NewMax;
+		BSP_TreeTask	*NewTasks;
+
+		NewMax = MaxTreeTasks ? MaxTreeTasks*2 : 256;
+
+		NewTasks = GE_RAM_REALLOC_ARRAY(TreeTasks, BSP_TreeTask, NewMax);
+
+		if (!NewTasks)
+		{
+			GHook.Error("AddTreeTask:  Out of memory for tasks.\n");
+			return GE_FALSE;
+		}
+
+		TreeTasks = NewTasks;
+		MaxTreeTasks = NewMax;
+	}
+
+	TreeTasks[NumTreeTasks].Node = Node;
+	TreeTasks[NumTreeTasks].Brushes = Brushes;
+	TreeTasks[NumTreeTasks].Done = GE_FALSE;
+	NumTreeTasks++;
+
+	return GE_TRUE;
+}
+
+//=======================================================================================
+//	BuildTreeTop_r
+//=======================================================================================
+static void BuildTreeTop_r(GBSP_Node *Node, GBSP_Brush *Brushes)
+{
+	int32		i;
+	GBSP_Brush	*Children[2];
+
+	if (CountBrushList(Brushes) <= TreeTaskBrushes)
+	{
+		if (!AddTreeTask(Node, Brushes))
+			BuildTree_r(Node, Brushes);		// Just do it here then
+		return;
+	}
+
+	if (!BuildNode(Node, Brushes, NumBSPThreads, Children))
+		return;
+
+	for (i=0 ; i<2 ; i++)
+		BuildTreeTop_r(Node->Children[i], Children[i]);
+}
+
+//=======================================================================================
+//	BuildTreeTaskThread
+//=======================================================================================
+static geBoolean BuildTreeTaskThread(int32 Work, int32 ThreadNum, void *Context)
+{
+	BuildTree_r(TreeTasks[Work].Node, TreeTasks[Work].Brushes);
+
+	TreeTasks[Work].Done = GE_TRUE;
+
+	return GE_TRUE;
+}
+
+//=======================================================================================
+//	BuildTreeThreaded
+//=======================================================================================
+static GBSP_Node *BuildTreeThreaded(GBSP_Node *Node, GBSP_Brush *Brushes)
+{
+	int32		i;
+
+	TreeTaskBrushes = CountBrushList(Brushes) / (NumBSPThreads*TREE_TASKS_PER_THREAD);
+
+	FreezePlanes(GE_TRUE);
+
+	TreeTasks = NULL;
+	NumTreeTasks = 0;
+	MaxTreeTasks = 0;
+
+	BuildTreeTop_r(Node, Brushes);
+
+	if (!Thread_RunStealing(NumBSPThreads, NumTreeTasks, BuildTreeTaskThread, NULL))
+	{
+		// Cancelled, so whatever is left just turns into leafs, and the tree can be freed
+		for (i=0; i< NumTreeTasks; i++)
+		{
+			if (!TreeTasks[i].Done)
+				BuildTree_r(TreeTasks[i].Node, TreeTasks[i].Brushes);
+		}
+	}
+
+	FreezePlanes(GE_FALSE);
+
+	if (TreeTasks)
+		geRam_Free(TreeTasks);
+
+	TreeTasks = NULL;
+	NumTreeTasks = 0;
+	MaxTreeTasks = 0;
+
+	return Node;
+}
+
 
 //=======================================================================================
 //	BuildBSP
@@ -873,11 +1315,20 @@ GBSP_Node *BuildBSP(GBSP_Brush *BrushList)
 #ifdef USE_VOLUMES
 	Node->Volume = BrushFromBounds (&Mins, &Maxs);
 
+	if (!Node->Volume)
+	{
+		FreeNode(Node);
+		return NULL;
+	}
+
 	if (BrushVolume(Node->Volume) < 1.0f)
 		GHook.Printf("**WARNING** BuildBSP: BAD world volume.\n");
 #endif
 
-	Node = BuildTree_r (Node, BrushList);
+	if (NumBSPThreads > 1)
+		Node = BuildTreeThreaded (Node, BrushList);
+	else
+		Node = BuildTree_r (Node, BrushList);
 
 	// Top node is always valid, this way portals can use top node to get box of entire bsp...
 	Node->Mins = Mins;
@@ -1216,6 +1667,13 @@ geBoolean ProcessWorldModel(GBSP_Model *Model, MAP_Brush *MapBrushes)
 	// Build the bsp
 	Node = BuildBSP(Brushes);
 
+	if (!Node)
+	{
+		GHook.Error("ProcessWorldModel:  Could not build the bsp.\n");
+		FreeBrushList(Brushes);
+		return GE_FALSE;
+	}
+
 	Model->Mins = TreeMins;
 	Model->Maxs = TreeMaxs;
 	
@@ -1260,6 +1718,13 @@ geBoolean ProcessWorldModel(GBSP_Model *Model, MAP_Brush *MapBrushes)
 	// Build the bsp
 	Node = BuildBSP(Brushes);
 
+	if (!Node)
+	{
+		GHook.Error("ProcessWorldModel:  Could not build the bsp.\n");
+		FreeBrushList(Brushes);
+		return GE_FALSE;
+	}
+
 	Model->Mins = TreeMins;
 	Model->Maxs = TreeMaxs;
 
@@ -1319,6 +1784,13 @@ geBoolean ProcessSubModel(GBSP_Model *Model, MAP_Brush *MapBrushes)
 	// Build the bsp
 	Node = BuildBSP(Brushes);
 
+	if (!Node)
+	{
+		GHook.Error("ProcessSubModel:  Could not build the bsp.\n");
+		FreeBrushList(Brushes);
+		return GE_FALSE;
+	}
+
 	Model->Mins = TreeMins;
 	Model->Maxs = TreeMaxs;
 
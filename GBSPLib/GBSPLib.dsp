@@ -43,7 +43,7 @@ RSC=rc.exe
 # PROP Ignore_Export_Lib 0
 # PROP Target_Dir ""
 # ADD BASE CPP /nologo /MT /W3 /GX /O2 /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /YX /FD /c
-# ADD CPP /nologo /G5 /MT /W3 /GX /Ot /Ow /Og /Oi /Op /Ob2 /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /YX /FD /c
+# ADD CPP /nologo /G5 /MT /W3 /GX /Ot /Ow /Og /Oi /Op /Ob2 /I "..\G3D\Math" /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /YX /FD /c
 # SUBTRACT CPP /X
 # ADD BASE MTL /nologo /D "NDEBUG" /mktyplib203 /win32
 # ADD MTL /nologo /D "NDEBUG" /mktyplib203 /win32
@@ -71,7 +71,7 @@ LINK32=link.exe
 # PROP Ignore_Export_Lib 0
 # PROP Target_Dir ""
 # ADD BASE CPP /nologo /MTd /W3 /Gm /GX /ZI /Od /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /YX /FD /GZ /c
-# ADD CPP /nologo /G5 /MTd /W3 /Gm /GX /ZI /Od /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /YX /FD /GZ /c
+# ADD CPP /nologo /G5 /MTd /W3 /Gm /GX /ZI /Od /I "..\G3D\Math" /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /YX /FD /GZ /c
 # SUBTRACT CPP /X
 # ADD BASE MTL /nologo /D "_DEBUG" /mktyplib203 /win32
 # ADD MTL /nologo /D "_DEBUG" /mktyplib203 /win32
@@ -116,6 +116,14 @@ SOURCE=.\Bsp2.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\G3D\Engine\Drivers\SoftDrv2\CPUInfo.c
+# End Source File
+# Begin Source File
+
+SOURCE=..\G3D\Math\crc32.c
+# End Source File
+# Begin Source File
+
 SOURCE=.\Fill.Cpp
 # End Source File
 # Begin Source File
@@ -188,6 +196,14 @@ SOURCE=.\Poly.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Pool.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\Pool.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Portals.cpp
 # End Source File
 # Begin Source File
@@ -204,6 +220,14 @@ SOURCE=.\Rad.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\RayTrace.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\RayTrace.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Texture.cpp
 # End Source File
 # Begin Source File
@@ -212,10 +236,26 @@ SOURCE=.\Texture.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\Thread.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\Thread.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\TJunct.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\TreeCache.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\TreeCache.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\Utils.cpp
 # End Source File
 # Begin Source File
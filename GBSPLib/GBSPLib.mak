@@ -44,6 +44,8 @@ CLEAN :
 	-@erase "$(INTDIR)\Brush2.obj"
 	-@erase "$(INTDIR)\Bsp.obj"
 	-@erase "$(INTDIR)\Bsp2.obj"
+	-@erase "$(INTDIR)\CPUInfo.obj"
+	-@erase "$(INTDIR)\crc32.obj"
 	-@erase "$(INTDIR)\Fill.obj"
 	-@erase "$(INTDIR)\Gbspfile.obj"
 	-@erase "$(INTDIR)\Gbsplib.obj"
@@ -53,11 +55,15 @@ CLEAN :
 	-@erase "$(INTDIR)\Map.obj"
 	-@erase "$(INTDIR)\Mathlib.obj"
 	-@erase "$(INTDIR)\Poly.obj"
+	-@erase "$(INTDIR)\Pool.obj"
 	-@erase "$(INTDIR)\Portals.obj"
 	-@erase "$(INTDIR)\PortFile.obj"
 	-@erase "$(INTDIR)\Rad.obj"
+	-@erase "$(INTDIR)\RayTrace.obj"
 	-@erase "$(INTDIR)\Texture.obj"
+	-@erase "$(INTDIR)\Thread.obj"
 	-@erase "$(INTDIR)\TJunct.obj"
+	-@erase "$(INTDIR)\TreeCache.obj"
 	-@erase "$(INTDIR)\Utils.obj"
 	-@erase "$(INTDIR)\vc60.idb"
 	-@erase "$(INTDIR)\Vis.obj"
@@ -69,7 +75,7 @@ CLEAN :
 "$(OUTDIR)" :
     if not exist "$(OUTDIR)/$(NULL)" mkdir "$(OUTDIR)"
 
-CPP_PROJ=/nologo /MT /W3 /GX /O2 /X /I "..\\" /I "SDKShare\Include" /I "..\..\MSDev60\Include" /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /Fp"$(INTDIR)\GBSPLib.pch" /YX /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
+CPP_PROJ=/nologo /MT /W3 /GX /O2 /X /I "..\\" /I "SDKShare\Include" /I "..\..\MSDev60\Include" /I "..\G3D\Math" /D "WIN32" /D "NDEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /Fp"$(INTDIR)\GBSPLib.pch" /YX /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /c 
 MTL_PROJ=/nologo /D "NDEBUG" /mktyplib203 /win32 
 BSC32=bscmake.exe
 BSC32_FLAGS=/nologo /o"$(OUTDIR)\GBSPLib.bsc" 
@@ -81,6 +87,8 @@ LINK32_OBJS= \
 	"$(INTDIR)\Brush2.obj" \
 	"$(INTDIR)\Bsp.obj" \
 	"$(INTDIR)\Bsp2.obj" \
+	"$(INTDIR)\CPUInfo.obj" \
+	"$(INTDIR)\crc32.obj" \
 	"$(INTDIR)\Fill.obj" \
 	"$(INTDIR)\Gbspfile.obj" \
 	"$(INTDIR)\Gbsplib.obj" \
@@ -90,11 +98,15 @@ LINK32_OBJS= \
 	"$(INTDIR)\Map.obj" \
 	"$(INTDIR)\Mathlib.obj" \
 	"$(INTDIR)\Poly.obj" \
+	"$(INTDIR)\Pool.obj" \
 	"$(INTDIR)\Portals.obj" \
 	"$(INTDIR)\PortFile.obj" \
 	"$(INTDIR)\Rad.obj" \
+	"$(INTDIR)\RayTrace.obj" \
 	"$(INTDIR)\Texture.obj" \
+	"$(INTDIR)\Thread.obj" \
 	"$(INTDIR)\TJunct.obj" \
+	"$(INTDIR)\TreeCache.obj" \
 	"$(INTDIR)\Utils.obj" \
 	"$(INTDIR)\Vis.obj" \
 	"$(INTDIR)\Visflood.obj" \
@@ -130,6 +142,8 @@ CLEAN :
 	-@erase "$(INTDIR)\Brush2.obj"
 	-@erase "$(INTDIR)\Bsp.obj"
 	-@erase "$(INTDIR)\Bsp2.obj"
+	-@erase "$(INTDIR)\CPUInfo.obj"
+	-@erase "$(INTDIR)\crc32.obj"
 	-@erase "$(INTDIR)\Fill.obj"
 	-@erase "$(INTDIR)\Gbspfile.obj"
 	-@erase "$(INTDIR)\Gbsplib.obj"
@@ -139,11 +153,15 @@ CLEAN :
 	-@erase "$(INTDIR)\Map.obj"
 	-@erase "$(INTDIR)\Mathlib.obj"
 	-@erase "$(INTDIR)\Poly.obj"
+	-@erase "$(INTDIR)\Pool.obj"
 	-@erase "$(INTDIR)\Portals.obj"
 	-@erase "$(INTDIR)\PortFile.obj"
 	-@erase "$(INTDIR)\Rad.obj"
+	-@erase "$(INTDIR)\RayTrace.obj"
 	-@erase "$(INTDIR)\Texture.obj"
+	-@erase "$(INTDIR)\Thread.obj"
 	-@erase "$(INTDIR)\TJunct.obj"
+	-@erase "$(INTDIR)\TreeCache.obj"
 	-@erase "$(INTDIR)\Utils.obj"
 	-@erase "$(INTDIR)\vc60.idb"
 	-@erase "$(INTDIR)\vc60.pdb"
@@ -158,7 +176,7 @@ CLEAN :
 "$(OUTDIR)" :
     if not exist "$(OUTDIR)/$(NULL)" mkdir "$(OUTDIR)"
 
-CPP_PROJ=/nologo /MTd /W3 /Gm /GX /ZI /Od /X /I "..\\" /I "SDKShare\Include" /I "..\..\MSDev60\Include" /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /Fp"$(INTDIR)\GBSPLib.pch" /YX /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /GZ /c 
+CPP_PROJ=/nologo /MTd /W3 /Gm /GX /ZI /Od /X /I "..\\" /I "SDKShare\Include" /I "..\..\MSDev60\Include" /I "..\G3D\Math" /D "WIN32" /D "_DEBUG" /D "_WINDOWS" /D "_MBCS" /D "_USRDLL" /D "GBSPLIB_EXPORTS" /Fp"$(INTDIR)\GBSPLib.pch" /YX /Fo"$(INTDIR)\\" /Fd"$(INTDIR)\\" /FD /GZ /c 
 MTL_PROJ=/nologo /D "_DEBUG" /mktyplib203 /win32 
 BSC32=bscmake.exe
 BSC32_FLAGS=/nologo /o"$(OUTDIR)\GBSPLib.bsc" 
@@ -170,6 +188,8 @@ LINK32_OBJS= \
 	"$(INTDIR)\Brush2.obj" \
 	"$(INTDIR)\Bsp.obj" \
 	"$(INTDIR)\Bsp2.obj" \
+	"$(INTDIR)\CPUInfo.obj" \
+	"$(INTDIR)\crc32.obj" \
 	"$(INTDIR)\Fill.obj" \
 	"$(INTDIR)\Gbspfile.obj" \
 	"$(INTDIR)\Gbsplib.obj" \
@@ -179,11 +199,15 @@ LINK32_OBJS= \
 	"$(INTDIR)\Map.obj" \
 	"$(INTDIR)\Mathlib.obj" \
 	"$(INTDIR)\Poly.obj" \
+	"$(INTDIR)\Pool.obj" \
 	"$(INTDIR)\Portals.obj" \
 	"$(INTDIR)\PortFile.obj" \
 	"$(INTDIR)\Rad.obj" \
+	"$(INTDIR)\RayTrace.obj" \
 	"$(INTDIR)\Texture.obj" \
+	"$(INTDIR)\Thread.obj" \
 	"$(INTDIR)\TJunct.obj" \
+	"$(INTDIR)\TreeCache.obj" \
 	"$(INTDIR)\Utils.obj" \
 	"$(INTDIR)\Vis.obj" \
 	"$(INTDIR)\Visflood.obj" \
@@ -262,6 +286,18 @@ SOURCE=.\Bsp2.cpp
 "$(INTDIR)\Bsp2.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=..\G3D\Engine\Drivers\SoftDrv2\CPUInfo.c
+
+"$(INTDIR)\CPUInfo.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
+SOURCE=..\G3D\Math\crc32.c
+
+"$(INTDIR)\crc32.obj" : $(SOURCE) "$(INTDIR)"
+	$(CPP) $(CPP_PROJ) $(SOURCE)
+
+
 SOURCE=.\Fill.Cpp
 
 "$(INTDIR)\Fill.obj" : $(SOURCE) "$(INTDIR)"
@@ -307,6 +343,11 @@ SOURCE=.\Poly.cpp
 "$(INTDIR)\Poly.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\Pool.cpp
+
+"$(INTDIR)\Pool.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\Portals.cpp
 
 "$(INTDIR)\Portals.obj" : $(SOURCE) "$(INTDIR)"
@@ -322,16 +363,31 @@ SOURCE=.\Rad.cpp
 "$(INTDIR)\Rad.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\RayTrace.cpp
+
+"$(INTDIR)\RayTrace.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\Texture.cpp
 
 "$(INTDIR)\Texture.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\Thread.cpp
+
+"$(INTDIR)\Thread.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\TJunct.cpp
 
 "$(INTDIR)\TJunct.obj" : $(SOURCE) "$(INTDIR)"
 
 
+SOURCE=.\TreeCache.cpp
+
+"$(INTDIR)\TreeCache.obj" : $(SOURCE) "$(INTDIR)"
+
+
 SOURCE=.\Utils.cpp
 
 "$(INTDIR)\Utils.obj" : $(SOURCE) "$(INTDIR)"
@@ -26,6 +26,7 @@
 #include "Vis.h"
 #include "Light.h"
 #include "Map.h"
+#include "Pool.h"
 
 #define HANDLE_EXCEPTIONS
 
@@ -151,6 +152,7 @@ void GBSP_FreeBSP(void)
 {
 	FreeAllGBSPData();
 	FreeAllEntities();
+	Pool_Release();
 
 #ifdef SHOW_DEBUG_STATS
 	GHook.Printf("------------------------\n");
@@ -269,6 +271,9 @@ DllExport GBSP_FuncHook *GBSP_Init(GBSP_Hook *Hook)
 {
 	GHook = *Hook;
 
+	if (!Pool_Init())
+		GHook.Printf("*WARNING* GBSP_Init:  Could not set up the memory pools, using the heap.\n");
+
 	return &GBSP_FHook;
 }
 
@@ -28,7 +28,7 @@
 
 #include "Vec3d.h"
 
-#define GBSP_VERSION_MAJOR	6
+#define GBSP_VERSION_MAJOR	7
 #define GBSP_VERSION_MINOR	0
 
 //#define SHOW_DEBUG_STATS
@@ -46,6 +46,9 @@ typedef struct
 {
 	geBoolean	Verbose;
 	geBoolean	EntityVerbose;
+	geBoolean	Incremental;		// Reuse the splits from the last compile of this map, wherever nothing changed
+	geBoolean	VerifyIncremental;	// Also pick every reused split from scratch, and warn if any differ
+	int32		NumThreads;			// Threads to build the trees with (0 = one per cpu, 1 = serial)
 
 } BspParms;
 
@@ -61,6 +64,8 @@ typedef struct
 	geFloat		ReflectiveScale;
 
 	geVec3d	MinLight;			// R,G,B (XYZ) min color for each faces lightmap
+	int32		NumThreads;			// Threads to light faces with (0 = one per cpu, 1 = serial)
+	geFloat		BounceThreshold;	// Stop early when a bounce sends less than this fraction of the start energy (0 = off)
 
 } LightParms;
 
@@ -69,6 +74,7 @@ typedef struct
 	geBoolean	Verbose;
 	geBoolean	FullVis;
 	geBoolean	SortPortals;
+	int32		NumThreads;			// Threads to flood portals with (0 = one per cpu, 1 = serial)
 
 } VisParms;
 
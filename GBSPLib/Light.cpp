@@ -31,6 +31,9 @@
 #include "Texture.h"
 #include "Utils.h"
 #include "BSP.h"
+#include "Thread.h"
+#include "Pool.h"
+#include "RayTrace.h"
 
 #include "Vec3d.h"
 #include "XForm3d.h"
@@ -50,6 +53,7 @@ geBoolean	LVerbose				= GE_TRUE;
 geBoolean	DoRadiosity				= GE_TRUE;
 float		PatchSize				= 128.0f;
 int32		NumBounce				= 8;
+float		BounceThreshold			= 0.0f;
 geBoolean	FastPatch				= GE_TRUE;
 geBoolean	ExtraLightCorrection	= GE_TRUE;
 float		ReflectiveScale			= 1.0f;
@@ -85,11 +89,9 @@ void		FreeDirectLights(void);
 geBoolean	StartWriting(geVFile *f);
 geBoolean	FinishWriting(geVFile *f);
 
-// For RayIntersect
-int32		GlobalPlane;
-int32		GlobalNode;
-int32		GlobalSide;
-geVec3d		GlobalI;
+int32		NumLightThreads = 1;
+
+void		BenchmarkRayCollision(void);
 
 #define MAX_DIRECT_CLUSTER_LIGHTS		25000
 #define MAX_DIRECT_LIGHTS				5000
@@ -178,9 +180,11 @@ geBoolean LightGBSPFile(char *FileName, LightParms *Parms)
 	EntityScale = Parms->LightScale;
 	DoRadiosity = Parms->Radiosity;
 	NumBounce = Parms->NumBounce;
+	BounceThreshold = Parms->BounceThreshold;
 	PatchSize = Parms->PatchSize;
 	FastPatch = Parms->FastPatch;
 	ReflectiveScale = Parms->ReflectiveScale;
+	NumLightThreads = Thread_ClampCount(Parms->NumThreads);
 
 	MinLight = Parms->MinLight;
 
@@ -232,6 +236,14 @@ geBoolean LightGBSPFile(char *FileName, LightParms *Parms)
 	}
 
 	GHook.Printf("Num Faces            : %5i\n", NumGFXFaces);
+	GHook.Printf("Num Threads          : %5i\n", NumLightThreads);
+
+	// Pack the tree for the shadow rays (the recursive caster is used if this fails)
+	if (RayTrace_Build(GFXModels[0].RootNode[0]))
+	{
+		if (Parms->Verbose)
+			BenchmarkRayCollision();
+	}
 
 	// Build the patches (before direct lights are created)
 	if (DoRadiosity)
@@ -287,6 +299,11 @@ geBoolean LightGBSPFile(char *FileName, LightParms *Parms)
 
 	GHook.Printf("Num Light Maps       : %5i\n", RGBMaps);
 
+	if (Parms->Verbose)
+		Pool_Report("Light");
+
+	Pool_Release();
+
 	return GE_TRUE;
 
 	ExitWithError:
@@ -310,6 +327,7 @@ void CleanupLight(void)
 	FreePatches();
 	FreeLightmaps();
 	FreeReceivers();	
+	RayTrace_Free();
 
 	if (VertNormals)
 	{
@@ -509,15 +527,105 @@ void ApplyLightmapToPatches(int32 Face)
 float UOfs[5] = { 0.0f,-0.5f, 0.5f, 0.5f,-0.5f};
 float VOfs[5] = { 0.0f,-0.5f,-0.5f, 0.5f, 0.5f};
 
+//====================================================================================
+//	LightFace
+//	Lights a single face.  Everything written here belongs to this face only
+//	(it's FaceInfo, Lightmap, RGB verts, and patches), so faces can be lit in any order.
+//====================================================================================
+geBoolean LightFace(int32 i, int a_GouraudShading)
+{
+	int32		s;
+
+	GetFacePlane(i, &FaceInfo[i].Plane);
+	FaceInfo[i].Face = i;
+
+#if RWM_GOURAUD
+	if( a_GouraudShading )
+	{
+		// always RGB (also for LM faces)
+		if (!GouraudShadeFace(i))
+		{
+			GHook.Error("LightFaces:  GouraudShadeFace failed...\n");
+			return GE_FALSE;
+		}
+	}
+	
+	if (DoRadiosity)
+		TransferLightToPatches(i);
+#else
+	// only RGB coloring for Gouraud shaded faces
+	if (GFXTexInfo[GFXFaces[i].TexInfo].Flags & TEXINFO_GOURAUD)
+	{
+		if (!GouraudShadeFace(i))
+		{
+			GHook.Error("LightFaces:  GouraudShadeFace failed...\n");
+			return GE_FALSE;
+		}
+		
+		if (DoRadiosity)
+			TransferLightToPatches(i);
+		
+		return GE_TRUE; // NOTE: (!)
+	}
+#endif
+	
+	/*
+	if (GFXTexInfo[GFXFaces[i].TexInfo].Flags & TEXINFO_FLAT)
+	{
+		FlatShadeFace(i);
+		return GE_TRUE;
+	}
+	*/
+
+	if (GFXTexInfo[GFXFaces[i].TexInfo].Flags & TEXINFO_NO_LIGHTMAP)
+		return GE_TRUE;		// Faces with no lightmap don't need to light them 
+
+
+	if (!CalcFaceInfo(&FaceInfo[i], &Lightmaps[i]))
+	{
+		return GE_FALSE;
+	}
+
+	int32 Size = (Lightmaps[i].LSize[0]+1)*(Lightmaps[i].LSize[1]+1);
+	FaceInfo[i].Points = GE_RAM_ALLOCATE_ARRAY(geVec3d, Size);
+
+	if (!FaceInfo[i].Points)
+	{
+		GHook.Error("LightFaces:  Out of memory for face points.\n");
+		return GE_FALSE;
+	}
+	
+	for (s=0; s< NumSamples; s++)
+	{
+		//Hook.Printf("Sample  : %3i of %3i\n", s+1, NumSamples);
+		CalcFacePoints(&FaceInfo[i], &Lightmaps[i], UOfs[s], VOfs[s]);
+
+		if (!ApplyLightsToFace(&FaceInfo[i], &Lightmaps[i], 1 / (float)NumSamples))
+			return GE_FALSE;
+	}
+	
+	if (DoRadiosity)
+	{
+		// Update patches for this face
+		ApplyLightmapToPatches(i);
+	}
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	LightFaceThread
+//====================================================================================
+static geBoolean LightFaceThread(int32 Work, int32 ThreadNum, void *Context)
+{
+	return LightFace(Work, *(int*)Context);
+}
+
 //====================================================================================
 //	LightFaces
 //====================================================================================
 geBoolean LightFaces(int a_GouraudShading)
 {
-	int32		i, s;
-	geBoolean	Hit;
-	int32		Perc;
-
 #if DEBUG_RWM_GOURAUD
 	if( a_GouraudShading )
 	{
@@ -550,97 +658,13 @@ geBoolean LightFaces(int a_GouraudShading)
 
 	NumLMaps = 0;
 
-	Perc = NumGFXFaces / 20;
-
-	for (i=0; i< NumGFXFaces; i++)
+	// Each face is lit on it's own, so share them out across the threads
+	if (!Thread_RunOnEach(NumLightThreads, NumGFXFaces, LightFaceThread, &a_GouraudShading, GE_TRUE))
 	{
-		Hit = GE_FALSE;
-
 		if (CancelRequest)
-		{
 			GHook.Printf("Cancel requested...\n");
-			return GE_FALSE;
-		}
 
-		if (Perc)
-		{
-			if (!(i%Perc) && (i/Perc) <= 20)
-				GHook.Printf(".%i", (i/Perc));
-		}
-		
-		GetFacePlane(i, &FaceInfo[i].Plane);
-		FaceInfo[i].Face = i;
-
-#if RWM_GOURAUD
-		if( a_GouraudShading )
-		{
-			// always RGB (also for LM faces)
-			if (!GouraudShadeFace(i))
-			{
-				GHook.Error("LightFaces:  GouraudShadeFace failed...\n");
-				return GE_FALSE;
-			}
-		}
-		
-		if (DoRadiosity)
-			TransferLightToPatches(i);
-#else
-		// only RGB coloring for Gouraud shaded faces
-		if (GFXTexInfo[GFXFaces[i].TexInfo].Flags & TEXINFO_GOURAUD)
-		{
-			if (!GouraudShadeFace(i))
-			{
-				GHook.Error("LightFaces:  GouraudShadeFace failed...\n");
-				return GE_FALSE;
-			}
-			
-			if (DoRadiosity)
-				TransferLightToPatches(i);
-			
-			continue; // NOTE: (!)
-		}
-#endif
-		
-		/*
-		if (GFXTexInfo[GFXFaces[i].TexInfo].Flags & TEXINFO_FLAT)
-		{
-			FlatShadeFace(i);
-			continue;
-		}
-		*/
-
-		if (GFXTexInfo[GFXFaces[i].TexInfo].Flags & TEXINFO_NO_LIGHTMAP)
-			continue;		// Faces with no lightmap don't need to light them 
-
-
-		if (!CalcFaceInfo(&FaceInfo[i], &Lightmaps[i]))
-		{
-			return GE_FALSE;
-		}
-	
-		int32 Size = (Lightmaps[i].LSize[0]+1)*(Lightmaps[i].LSize[1]+1);
-		FaceInfo[i].Points = GE_RAM_ALLOCATE_ARRAY(geVec3d, Size);
-
-		if (!FaceInfo[i].Points)
-		{
-			GHook.Error("LightFaces:  Out of memory for face points.\n");
-			return GE_FALSE;
-		}
-		
-		for (s=0; s< NumSamples; s++)
-		{
-			//Hook.Printf("Sample  : %3i of %3i\n", s+1, NumSamples);
-			CalcFacePoints(&FaceInfo[i], &Lightmaps[i], UOfs[s], VOfs[s]);
-
-			if (!ApplyLightsToFace(&FaceInfo[i], &Lightmaps[i], 1 / (float)NumSamples))
-				return GE_FALSE;
-		}
-		
-		if (DoRadiosity)
-		{
-			// Update patches for this face
-			ApplyLightmapToPatches(i);
-		}
+		return GE_FALSE;
 	}
 	
 	GHook.Printf("\n");
@@ -730,6 +754,9 @@ static void DebugWriteVertex( const geVec3d* a_Vert, const geVec3d* a_Normal,
 	const char* name = MODULE_VertexFileName ;
 	FILE* fp ;
 	
+	// Faces may be lit from several threads, so only one gets to append at a time
+	Thread_Lock() ;
+
 	if (firstTime) {
 		firstTime = false ;
 		fp = fopen( name, "w" ) ;
@@ -765,6 +792,8 @@ static void DebugWriteVertex( const geVec3d* a_Vert, const geVec3d* a_Normal,
 		fclose( fp ) ;
 		fp = NULL ;
 	}
+
+	Thread_Unlock() ;
 }
 #endif
 
@@ -1753,12 +1782,10 @@ float PlaneDistanceFast(geVec3d *Point, GFX_Plane *Plane)
     return Dist;
 }
 
-static geBoolean HitLeaf;
-
 //====================================================================================
 //	RayIntersect
 //====================================================================================
-geBoolean RayIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
+static geBoolean RayIntersect(geVec3d *Front, geVec3d *Back, int32 Node, RayTrace_Hit *Hit)
 {
     float	Fd, Bd, Dist;
     uint8	Side;
@@ -1778,9 +1805,9 @@ geBoolean RayIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
     Bd = PlaneDistanceFast(Back , &GFXPlanes[GFXNodes[Node].PlaneNum]);
 
     if (Fd >= -1 && Bd >= -1) 
-        return(RayIntersect(Front, Back, GFXNodes[Node].Children[0]));
+        return(RayIntersect(Front, Back, GFXNodes[Node].Children[0], Hit));
     if (Fd < 1 && Bd < 1)
-        return(RayIntersect(Front, Back, GFXNodes[Node].Children[1]));
+        return(RayIntersect(Front, Back, GFXNodes[Node].Children[1], Hit));
 
     Side = Fd < 0;
     Dist = Fd / (Fd - Bd);
@@ -1793,17 +1820,17 @@ geBoolean RayIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
 	// is no more collisions, we can assume that we have the front portion of the
 	// ray that is in empty space.  Once we find this, and see that the back half is in
 	// solid space, then we found the front intersection point...
-	if (RayIntersect(Front, &I, GFXNodes[Node].Children[Side]))
+	if (RayIntersect(Front, &I, GFXNodes[Node].Children[Side], Hit))
         return GE_TRUE;
-    else if (RayIntersect(&I, Back, GFXNodes[Node].Children[!Side]))
+    else if (RayIntersect(&I, Back, GFXNodes[Node].Children[!Side], Hit))
 	{
-		if (!HitLeaf)
+		if (!Hit->HitLeaf)
 		{
-			GlobalPlane = GFXNodes[Node].PlaneNum;
-			GlobalSide = Side;
-			GlobalI = I;
-			GlobalNode = Node;
-			HitLeaf = GE_TRUE;
+			Hit->Plane = GFXNodes[Node].PlaneNum;
+			Hit->Side = Side;
+			Hit->I = I;
+			Hit->Node = Node;
+			Hit->HitLeaf = GE_TRUE;
 		}
 		return GE_TRUE;
 	}
@@ -1811,13 +1838,28 @@ geBoolean RayIntersect(geVec3d *Front, geVec3d *Back, int32 Node)
 	return GE_FALSE;
 }
 
+//====================================================================================
+//	CastRay
+//	Uses the flat ray caster when it's built, the recursive one when not
+//====================================================================================
+static geBoolean CastRay(geVec3d *Front, geVec3d *Back, RayTrace_Hit *Hit)
+{
+	if (RayTrace_IsBuilt())
+		return RayTrace_Collision(Front, Back, Hit);
+
+	return RayIntersect(Front, Back, GFXModels[0].RootNode[0], Hit);
+}
+
 geBoolean RayCollision(geVec3d *Front, geVec3d *Back, geVec3d *I)
 {
-	HitLeaf = GE_FALSE;
-	if (RayIntersect(Front, Back, GFXModels[0].RootNode[0]))
+	RayTrace_Hit	Hit;
+
+	Hit.HitLeaf = GE_FALSE;
+	Hit.I = *Front;				// In case the ray starts out in solid
+	if (CastRay(Front, Back, &Hit))
 	{
 		if (I) 
-			*I = GlobalI;			// Set the intersection point
+			*I = Hit.I;				// Set the intersection point
 		return GE_TRUE;
 	}
 
@@ -1828,17 +1870,20 @@ geBoolean RayCollision(geVec3d *Front, geVec3d *Back, geVec3d *I)
 #define COLLISION_BOX 1.0f
 geBoolean RayCollisionButSky(geVec3d *Front, geVec3d *Back, geVec3d *I)
 {
-   HitLeaf = GE_FALSE;
-   if (RayIntersect(Front, Back, GFXModels[0].RootNode[0]))
+   RayTrace_Hit	Hit;
+
+   Hit.HitLeaf = GE_FALSE;
+   geVec3d_Clear(&Hit.I);		// Hit.I is only set when a leaf is hit
+   if (CastRay(Front, Back, &Hit))
    {
-	   if(HitLeaf)
+	   if(Hit.HitLeaf)
 		{
 			GFX_Node *pNode;
 		   	GFX_Face *pFace;
 		   	int32 i, k, v, *pIndex;
 		   	geVec3d VMins, VMaxs;
 		   	geVec3d Vert;
-	 		pNode = &GFXNodes[GlobalNode];
+	 		pNode = &GFXNodes[Hit.Node];
 		   	pFace = &GFXFaces[pNode->FirstFace];
 	 		//this code retrieves the face that we hit
 		   	//by calculating its coords and testing if the impact point is in
@@ -1868,9 +1913,9 @@ geBoolean RayCollisionButSky(geVec3d *Front, geVec3d *Back, geVec3d *I)
 		   		}
 	 			//Mins & Maxs are calculated for this face
 		   		//is the Impact on it?
-		   		if (GlobalI.X + COLLISION_BOX >= VMins.X && GlobalI.X - COLLISION_BOX    <= VMaxs.X)
-		   		if (GlobalI.Y + COLLISION_BOX >= VMins.Y && GlobalI.Y - COLLISION_BOX    <= VMaxs.Y)
-		   		if (GlobalI.Z + COLLISION_BOX >= VMins.Z && GlobalI.Z - COLLISION_BOX    <= VMaxs.Z)
+		   		if (Hit.I.X + COLLISION_BOX >= VMins.X && Hit.I.X - COLLISION_BOX    <= VMaxs.X)
+		   		if (Hit.I.Y + COLLISION_BOX >= VMins.Y && Hit.I.Y - COLLISION_BOX    <= VMaxs.Y)
+		   		if (Hit.I.Z + COLLISION_BOX >= VMins.Z && Hit.I.Z - COLLISION_BOX    <= VMaxs.Z)
 		   		{ //yes! It's our face 
 		   			if(GFXTexInfo[pFace->TexInfo].Flags & TEXINFO_SKY) { //is it face marked    sky?
 		   				return GE_FALSE; //undo the collision: sunlight must pass
@@ -1880,12 +1925,164 @@ geBoolean RayCollisionButSky(geVec3d *Front, geVec3d *Back, geVec3d *I)
 		}
 
 		if (I) 
-	   		*I = GlobalI; // Set the intersection point
+	   		*I = Hit.I; // Set the intersection point
    	return GE_TRUE;
   	}
 return GE_FALSE;
 }
 
+//====================================================================================
+//	RayCollisionPacket
+//	Returns a bitmask of the rays in Packet that are blocked
+//====================================================================================
+uint32 RayCollisionPacket(RayTrace_Packet *Packet, int32 NumRays)
+{
+	uint32		Hits;
+	int32		i;
+	geVec3d		Front, Back;
+
+	if (RayTrace_IsBuilt())
+		return RayTrace_CollisionPacket(Packet, NumRays);
+
+	Hits = 0;
+
+	for (i=0; i< NumRays; i++)
+	{
+		geVec3d_Set(&Front, Packet->FrontX[i], Packet->FrontY[i], Packet->FrontZ[i]);
+		geVec3d_Set(&Back, Packet->BackX[i], Packet->BackY[i], Packet->BackZ[i]);
+
+		if (RayCollision(&Front, &Back, NULL))
+			Hits |= (1<<i);
+	}
+
+	return Hits;
+}
+
+//====================================================================================
+//	BenchmarkRayCollision
+//	Casts the same rays through the recursive caster, the flat one, and the flat one
+//	in packets, and prints how long each took (and if any answers differed).  The rays
+//	go between the centers of random empty leafs, 4 from each start point, like the
+//	shadow rays from a patch.
+//====================================================================================
+#define BENCH_NUM_RAYS		(64*1024)
+
+void BenchmarkRayCollision(void)
+{
+	LARGE_INTEGER	Freq, Start, End;
+	geVec3d			*Fronts, *Backs;
+	uint8			*Results;
+	int32			*EmptyLeafs, NumEmptyLeafs;
+	int32			i, k, Mismatch1, Mismatch2;
+	uint32			Seed, Hits;
+	double			Time0, Time1, Time2;
+	RayTrace_Hit	Hit;
+	RayTrace_Packet	Packet;
+
+	if (!RayTrace_IsBuilt() || !QueryPerformanceFrequency(&Freq))
+		return;
+
+	Fronts = GE_RAM_ALLOCATE_ARRAY(geVec3d, BENCH_NUM_RAYS);
+	Backs = GE_RAM_ALLOCATE_ARRAY(geVec3d, BENCH_NUM_RAYS);
+	Results = GE_RAM_ALLOCATE_ARRAY(uint8, BENCH_NUM_RAYS);
+	EmptyLeafs = GE_RAM_ALLOCATE_ARRAY(int32, NumGFXLeafs);
+
+	if (!Fronts || !Backs || !Results || !EmptyLeafs)
+		goto Done;
+
+	NumEmptyLeafs = 0;
+
+	for (i=0; i< NumGFXLeafs; i++)
+	{
+		if (!(GFXLeafs[i].Contents & BSP_CONTENTS_SOLID2))
+			EmptyLeafs[NumEmptyLeafs++] = i;
+	}
+
+	if (!NumEmptyLeafs)
+		goto Done;
+
+	// Same rays every time, so runs can be compared
+	Seed = 1;
+
+	for (i=0; i< BENCH_NUM_RAYS; i++)
+	{
+		GFX_Leaf	*pLeaf;
+
+		Seed = Seed * 1103515245 + 12345;
+
+		if (!(i&3))
+		{
+			pLeaf = &GFXLeafs[EmptyLeafs[(Seed>>8) % NumEmptyLeafs]];
+			geVec3d_Add(&pLeaf->Mins, &pLeaf->Maxs, &Fronts[i]);
+			geVec3d_Scale(&Fronts[i], 0.5f, &Fronts[i]);
+			Seed = Seed * 1103515245 + 12345;
+		}
+		else
+			Fronts[i] = Fronts[i-1];
+
+		pLeaf = &GFXLeafs[EmptyLeafs[(Seed>>8) % NumEmptyLeafs]];
+		geVec3d_Add(&pLeaf->Mins, &pLeaf->Maxs, &Backs[i]);
+		geVec3d_Scale(&Backs[i], 0.5f, &Backs[i]);
+	}
+
+	// Recursive
+	QueryPerformanceCounter(&Start);
+	for (i=0; i< BENCH_NUM_RAYS; i++)
+	{
+		Hit.HitLeaf = GE_FALSE;
+		Results[i] = (uint8)RayIntersect(&Fronts[i], &Backs[i], GFXModels[0].RootNode[0], &Hit);
+	}
+	QueryPerformanceCounter(&End);
+	Time0 = (double)(End.QuadPart - Start.QuadPart) * 1000.0 / (double)Freq.QuadPart;
+
+	// Flat
+	Mismatch1 = 0;
+	QueryPerformanceCounter(&Start);
+	for (i=0; i< BENCH_NUM_RAYS; i++)
+	{
+		if ((uint8)RayTrace_Collision(&Fronts[i], &Backs[i], NULL) != Results[i])
+			Mismatch1++;
+	}
+	QueryPerformanceCounter(&End);
+	Time1 = (double)(End.QuadPart - Start.QuadPart) * 1000.0 / (double)Freq.QuadPart;
+
+	// Flat, in packets
+	Mismatch2 = 0;
+	QueryPerformanceCounter(&Start);
+	for (i=0; i< BENCH_NUM_RAYS; i+= RAYTRACE_PACKET_SIZE)
+	{
+		for (k=0; k< RAYTRACE_PACKET_SIZE; k++)
+			RayTrace_SetPacketRay(&Packet, k, &Fronts[i+k], &Backs[i+k]);
+
+		Hits = RayTrace_CollisionPacket(&Packet, RAYTRACE_PACKET_SIZE);
+
+		for (k=0; k< RAYTRACE_PACKET_SIZE; k++)
+		{
+			if (((Hits>>k)&1) != Results[i+k])
+				Mismatch2++;
+		}
+	}
+	QueryPerformanceCounter(&End);
+	Time2 = (double)(End.QuadPart - Start.QuadPart) * 1000.0 / (double)Freq.QuadPart;
+
+	GHook.Printf("Ray Benchmark        : %i rays\n", BENCH_NUM_RAYS);
+	GHook.Printf("   Recursive         : %8.2f ms\n", Time0);
+	GHook.Printf("   Flat              : %8.2f ms, %i differ\n", Time1, Mismatch1);
+	GHook.Printf("   Flat, packets     : %8.2f ms, %i differ\n", Time2, Mismatch2);
+
+	Done:
+	{
+		if (Fronts)
+			geRam_Free(Fronts);
+		if (Backs)
+			geRam_Free(Backs);
+		if (Results)
+			geRam_Free(Results);
+		if (EmptyLeafs)
+			geRam_Free(EmptyLeafs);
+	}
+}
+
 //================================================================================
 //	StartWriting
 //================================================================================
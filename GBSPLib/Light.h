@@ -28,8 +28,9 @@
 #include "GBSPfile.h"
 #include "GBSPLib.h"				// Lightparms
 #include "BSP.h"
+#include "RayTrace.h"
 
-#define MAX_PATCHES		65000*2		// eaa3 using int32 for lights, so pushed the size up
+#define MAX_PATCHES		(1024*1024)	// Receivers index patches with 32 bits, so this is just a sanity limit
 
 #define MAX_LTYPES		4
 #define MAX_LTYPE_INDEX	12
@@ -48,14 +49,17 @@ extern geBoolean	LVerbose;
 extern geBoolean	DoRadiosity;
 extern geFloat		PatchSize;
 extern int32		NumBounce;
+extern geFloat		BounceThreshold;
 extern geBoolean	FastPatch;
 extern geFloat		ReflectiveScale;
+extern int32		NumLightThreads;
 
 extern geVec3d		MinLight;
 
 int32 FindGFXLeaf(int32 Node, geVec3d *Vert);
 geBoolean RayCollision(geVec3d *Front, geVec3d *Back, geVec3d *I);
 geBoolean RayCollisionButSky(geVec3d *Front, geVec3d *Back, geVec3d *I);
+uint32 RayCollisionPacket(RayTrace_Packet *Packet, int32 NumRays);
 
 typedef struct
 {
@@ -129,7 +133,6 @@ typedef struct _RAD_Receiver
 
 extern pRAD_Patch	*FacePatches;
 extern pRAD_Patch	*PatchList;
-extern geFloat		*RecAmount;
 
 extern int32		NumPatches;
 extern int32		NumReceivers;
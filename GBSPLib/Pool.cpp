@@ -0,0 +1,466 @@
+/****************************************************************************************/
+/*  Pool.cpp                                                                            */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Pooled allocations for polys, faces and portals                        */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <String.h>
+
+#include "GBSPLib.h"
+#include "Pool.h"
+
+#include "Ram.h"
+
+//========================================================================================
+//	Pools
+//	Polys, faces and portals get made and thrown away constantly while compiling (every
+//	split makes new polys), so they come out of size classed free lists instead of
+//	going to the heap every time.  Each thread keeps it's own lists, and only takes the
+//	lock to trade a batch of blocks with the shared lists.  New blocks are carved out
+//	of big chunks, which go back to the heap once nothing in them is in use.
+//========================================================================================
+#define POOL_NUM_CLASSES		17
+#define POOL_MAX_SIZE			12288					// Biggest class (a 1000 vert poly fits)
+#define POOL_BATCH				64						// Blocks traded with the shared lists at a time
+#define POOL_CACHE_MAX			(POOL_BATCH*2)			// Blocks a thread keeps in a class before giving some back
+#define POOL_CHUNK_SIZE			(256*1024)
+
+#define POOL_CLASS_LARGE		0xffff					// Straight from the heap
+
+// Sizes are what the caller gets, the block header comes on top
+static int32 ClassSizes[POOL_NUM_CLASSES] = 
+{
+	32, 48, 64, 80, 96, 128, 160, 192, 256, 384, 512, 768, 1024, 2048, 4096, 8192, POOL_MAX_SIZE
+};
+
+typedef struct Pool_Block
+{
+	Pool_Block	*Next;									// While it's on a free list
+	uint16		Class;
+	uint16		Type;
+} Pool_Block;
+
+typedef struct
+{
+	int32		Allocs;
+	int32		Frees;
+	int32		NewBlocks;								// Carved out of a chunk
+	int32		Large;									// Too big for the classes
+} Pool_Stats;
+
+typedef struct
+{
+	Pool_Block	*Free[POOL_NUM_CLASSES];
+	int32		NumFree[POOL_NUM_CLASSES];
+	Pool_Stats	Stats[POOL_NUM_TYPES];
+} Pool_Cache;
+
+static geBoolean		PoolInited = GE_FALSE;
+static CRITICAL_SECTION	PoolLock;
+static DWORD			PoolTls;
+
+static uint8			SizeToClass[POOL_MAX_SIZE/16+1];
+
+static Pool_Block		*SharedFree[POOL_NUM_CLASSES];
+static int32			NumSharedFree[POOL_NUM_CLASSES];
+
+static uint8			*Chunks;								// Each chunk starts with a pointer to the next
+static uint8			*ChunkPos, *ChunkEnd;
+static int32			NumChunks;
+
+static Pool_Stats		Totals[POOL_NUM_TYPES];				// Everything given back by the threads so far
+static Pool_Stats		Reported[POOL_NUM_TYPES];			// Totals at the last report
+
+static char				*TypeNames[POOL_NUM_TYPES] = {"Polys", "Faces", "Portals"};
+
+//========================================================================================
+//	Pool_Init
+//========================================================================================
+geBoolean Pool_Init(void)
+{
+	int32		i, Class;
+
+	if (PoolInited)
+		return GE_TRUE;
+
+	PoolTls = TlsAlloc();
+
+	if (PoolTls == TLS_OUT_OF_INDEXES)
+		return GE_FALSE;				// Everything just goes to the heap then
+
+	InitializeCriticalSection(&PoolLock);
+
+	Class = 0;
+
+	for (i=0; i<= POOL_MAX_SIZE/16; i++)
+	{
+		while (ClassSizes[Class] < i*16)
+			Class++;
+
+		SizeToClass[i] = (uint8)Class;
+	}
+
+	PoolInited = GE_TRUE;
+
+	return GE_TRUE;
+}
+
+//========================================================================================
+//	GetCache
+//========================================================================================
+static Pool_Cache *GetCache(void)
+{
+	Pool_Cache	*Cache;
+
+	if (!PoolInited)
+		return NULL;
+
+	Cache = (Pool_Cache*)TlsGetValue(PoolTls);
+
+	if (Cache)
+		return Cache;
+
+	Cache = GE_RAM_ALLOCATE_STRUCT(Pool_Cache);
+
+	if (!Cache)
+		return NULL;
+
+	memset(Cache, 0, sizeof(Pool_Cache));
+
+	TlsSetValue(PoolTls, Cache);
+
+	return Cache;
+}
+
+//========================================================================================
+//	CarveBlocks
+//	Makes up to POOL_BATCH new blocks of Class, from the chunks.  PoolLock must be held.
+//========================================================================================
+static int32 CarveBlocks(Pool_Cache *Cache, int32 Class)
+{
+	int32		n, BlockSize;
+	uint8		*Chunk;
+	Pool_Block	*Block;
+
+	BlockSize = sizeof(Pool_Block) + ClassSizes[Class];
+
+	for (n=0; n< POOL_BATCH; n++)
+	{
+		if (ChunkPos + BlockSize > ChunkEnd)
+		{
+			if (n > 0)
+				break;			// Take what we got, the rest of the chunk can go to a smaller class
+
+			Chunk = (uint8*)geRam_Allocate(POOL_CHUNK_SIZE);
+
+			if (!Chunk)
+				break;
+
+			*(uint8**)Chunk = Chunks;
+			Chunks = Chunk;
+			NumChunks++;
+
+			ChunkPos = Chunk + sizeof(Pool_Block);		// Keeps the blocks aligned like the header
+			ChunkEnd = Chunk + POOL_CHUNK_SIZE;
+		}
+
+		Block = (Pool_Block*)ChunkPos;
+		ChunkPos += BlockSize;
+
+		Block->Class = (uint16)Class;
+		Block->Next = Cache->Free[Class];
+		Cache->Free[Class] = Block;
+		Cache->NumFree[Class]++;
+	}
+
+	return n;
+}
+
+//========================================================================================
+//	RefillCache
+//========================================================================================
+static void RefillCache(Pool_Cache *Cache, int32 Class, Pool_Type Type)
+{
+	Pool_Block	*Block;
+	int32		n;
+
+	EnterCriticalSection(&PoolLock);
+
+	for (n=0; n< POOL_BATCH && SharedFree[Class]; n++)
+	{
+		Block = SharedFree[Class];
+		SharedFree[Class] = Block->Next;
+		NumSharedFree[Class]--;
+
+		Block->Next = Cache->Free[Class];
+		Cache->Free[Class] = Block;
+		Cache->NumFree[Class]++;
+	}
+
+	if (!n)
+		Cache->Stats[Type].NewBlocks += CarveBlocks(Cache, Class);
+
+	LeaveCriticalSection(&PoolLock);
+}
+
+//========================================================================================
+//	GiveBlocks
+//	Moves Count blocks of Class from Cache to the shared lists.  PoolLock must be held.
+//========================================================================================
+static void GiveBlocks(Pool_Cache *Cache, int32 Class, int32 Count)
+{
+	Pool_Block	*Block;
+
+	while (Count-- > 0 && Cache->Free[Class])
+	{
+		Block = Cache->Free[Class];
+		Cache->Free[Class] = Block->Next;
+		Cache->NumFree[Class]--;
+
+		Block->Next = SharedFree[Class];
+		SharedFree[Class] = Block;
+		NumSharedFree[Class]++;
+	}
+}
+
+//========================================================================================
+//	Pool_Allocate
+//========================================================================================
+void *Pool_Allocate(Pool_Type Type, int32 Size)
+{
+	Pool_Cache	*Cache;
+	Pool_Block	*Block;
+	int32		Class;
+
+	Cache = GetCache();
+
+	if (!Cache || Size > POOL_MAX_SIZE)
+	{
+		Block = (Pool_Block*)geRam_Allocate(sizeof(Pool_Block) + Size);
+
+		if (!Block)
+			return NULL;
+
+		Block->Class = POOL_CLASS_LARGE;
+		Block->Type = (uint16)Type;
+
+		if (Cache)
+		{
+			Cache->Stats[Type].Allocs++;
+			Cache->Stats[Type].Large++;
+		}
+
+		return Block+1;
+	}
+
+	Class = SizeToClass[(Size+15)/16];
+
+	if (!Cache->Free[Class])
+	{
+		RefillCache(Cache, Class, Type);
+
+		if (!Cache->Free[Class])
+			return NULL;
+	}
+
+	Block = Cache->Free[Class];
+	Cache->Free[Class] = Block->Next;
+	Cache->NumFree[Class]--;
+
+	Block->Type = (uint16)Type;
+
+	Cache->Stats[Type].Allocs++;
+
+	return Block+1;
+}
+
+//========================================================================================
+//	Pool_Free
+//========================================================================================
+void Pool_Free(void *Mem)
+{
+	Pool_Cache	*Cache;
+	Pool_Block	*Block;
+	int32		Class;
+
+	Block = (Pool_Block*)Mem - 1;
+
+	Cache = GetCache();
+
+	if (Cache)
+		Cache->Stats[Block->Type].Frees++;
+
+	if (Block->Class == POOL_CLASS_LARGE)
+	{
+		geRam_Free(Block);
+		return;
+	}
+
+	Class = Block->Class;
+
+	if (!Cache)
+	{
+		// Out of memory for the threads cache, so it goes straight back to everyone
+		EnterCriticalSection(&PoolLock);
+		Block->Next = SharedFree[Class];
+		SharedFree[Class] = Block;
+		NumSharedFree[Class]++;
+		LeaveCriticalSection(&PoolLock);
+		return;
+	}
+
+	Block->Next = Cache->Free[Class];
+	Cache->Free[Class] = Block;
+	Cache->NumFree[Class]++;
+
+	if (Cache->NumFree[Class] > POOL_CACHE_MAX)
+	{
+		EnterCriticalSection(&PoolLock);
+		GiveBlocks(Cache, Class, POOL_BATCH);
+		LeaveCriticalSection(&PoolLock);
+	}
+}
+
+//========================================================================================
+//	TakeStats
+//	Adds the threads counters into the totals.  PoolLock must be held.
+//========================================================================================
+static void TakeStats(Pool_Cache *Cache)
+{
+	int32		i;
+
+	for (i=0; i< POOL_NUM_TYPES; i++)
+	{
+		Totals[i].Allocs += Cache->Stats[i].Allocs;
+		Totals[i].Frees += Cache->Stats[i].Frees;
+		Totals[i].NewBlocks += Cache->Stats[i].NewBlocks;
+		Totals[i].Large += Cache->Stats[i].Large;
+	}
+
+	memset(Cache->Stats, 0, sizeof(Cache->Stats));
+}
+
+//========================================================================================
+//	Pool_ThreadDone
+//========================================================================================
+void Pool_ThreadDone(void)
+{
+	Pool_Cache	*Cache;
+	int32		i;
+
+	if (!PoolInited)
+		return;
+
+	Cache = (Pool_Cache*)TlsGetValue(PoolTls);
+
+	if (!Cache)
+		return;
+
+	EnterCriticalSection(&PoolLock);
+
+	for (i=0; i< POOL_NUM_CLASSES; i++)
+		GiveBlocks(Cache, i, Cache->NumFree[i]);
+
+	TakeStats(Cache);
+
+	LeaveCriticalSection(&PoolLock);
+
+	TlsSetValue(PoolTls, NULL);
+	geRam_Free(Cache);
+}
+
+//========================================================================================
+//	Pool_Report
+//========================================================================================
+void Pool_Report(char *Stage)
+{
+	Pool_Cache	*Cache;
+	Pool_Stats	Stats;
+	int32		i;
+
+	if (!PoolInited)
+		return;
+
+	Cache = GetCache();
+
+	EnterCriticalSection(&PoolLock);
+
+	if (Cache)
+		TakeStats(Cache);
+
+	GHook.Printf("--- %s Pools ---\n", Stage);
+
+	for (i=0; i< POOL_NUM_TYPES; i++)
+	{
+		Stats.Allocs = Totals[i].Allocs - Reported[i].Allocs;
+		Stats.NewBlocks = Totals[i].NewBlocks - Reported[i].NewBlocks;
+		Stats.Large = Totals[i].Large - Reported[i].Large;
+
+		GHook.Printf("%-8s: %8i allocs, %7i new blocks, %5i from the heap\n", TypeNames[i], Stats.Allocs, Stats.NewBlocks, Stats.Large);
+	}
+
+	GHook.Printf("Chunks  : %8i (%i KB)\n", NumChunks, NumChunks*(POOL_CHUNK_SIZE/1024));
+
+	memcpy(Reported, Totals, sizeof(Reported));
+
+	LeaveCriticalSection(&PoolLock);
+}
+
+//========================================================================================
+//	Pool_Release
+//	Called at the end of each stage, on the thread that ran it.  The worker threads have
+//	already called Pool_ThreadDone, so once this thread does too, every free block is
+//	on the shared lists, and all the counters are in the totals.
+//========================================================================================
+void Pool_Release(void)
+{
+	uint8		*Chunk, *Next;
+	int32		i;
+
+	if (!PoolInited)
+		return;
+
+	Pool_ThreadDone();
+
+	EnterCriticalSection(&PoolLock);
+
+	for (i=0; i< POOL_NUM_TYPES; i++)
+	{
+		if (Totals[i].Allocs != Totals[i].Frees)
+		{
+			LeaveCriticalSection(&PoolLock);
+			return;					// Still in use
+		}
+	}
+
+	for (Chunk = Chunks; Chunk; Chunk = Next)
+	{
+		Next = *(uint8**)Chunk;
+		geRam_Free(Chunk);
+	}
+
+	Chunks = NULL;
+	ChunkPos = ChunkEnd = NULL;
+	NumChunks = 0;
+
+	memset(SharedFree, 0, sizeof(SharedFree));
+	memset(NumSharedFree, 0, sizeof(NumSharedFree));
+
+	LeaveCriticalSection(&PoolLock);
+}
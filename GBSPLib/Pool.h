@@ -0,0 +1,58 @@
+/****************************************************************************************/
+/*  Pool.h                                                                              */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Pooled allocations for polys, faces and portals                        */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef POOL_H
+#define POOL_H
+
+#include <Windows.h>
+
+#include "Basetype.h"
+
+// What the memory is for (each gets it's own counters)
+typedef enum
+{
+	POOL_POLY,
+	POOL_FACE,
+	POOL_PORTAL,
+
+	POOL_NUM_TYPES
+} Pool_Type;
+
+geBoolean	Pool_Init(void);
+
+//
+//	Size picks one of the size classes.  Blocks are kept on free lists, per thread
+//	first, so the same sizes get handed back out without going to the heap.
+//	Anything too big for the classes goes straight to the heap.
+//
+void		*Pool_Allocate(Pool_Type Type, int32 Size);
+void		Pool_Free(void *Mem);
+
+// Gives the calling threads cached blocks back to everyone (call before a worker thread exits)
+void		Pool_ThreadDone(void);
+
+// Prints the counters since the last report
+void		Pool_Report(char *Stage);
+
+// Gives the pooled memory back to the heap, if none of it is in use
+void		Pool_Release(void);
+
+#endif
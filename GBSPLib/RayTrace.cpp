@@ -0,0 +1,474 @@
+/****************************************************************************************/
+/*  RayTrace.cpp                                                                        */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Flattened BSP ray caster for the light compiler                        */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Stdio.h>
+#include <Assert.h>
+
+#include "GBSPLib.h"
+#include "GBSPFile.h"
+#include "MathLib.h"
+#include "RayTrace.h"
+
+#include "Ram.h"
+
+// The packet compares are done 8 at a time with AVX2, or 4 at a time with SSE2, when the
+// compiler has them (GE_HAVE_AVX2 / GE_HAVE_SSE2) and the cpu says it does too (see RayTrace_Build)
+#include "..\G3D\Engine\Drivers\SoftDrv2\CPUSimd.h"
+
+typedef enum
+{
+	RAYTRACE_SIMD_NONE,
+	RAYTRACE_SIMD_SSE2,
+	RAYTRACE_SIMD_AVX2
+} RayTrace_Simd;
+
+#define RAYTRACE_EMPTY		(-1)				// Child is an empty leaf
+#define RAYTRACE_SOLID		(-2)				// Child is a solid leaf
+
+//
+//	A node, with it's plane packed in, 32 bytes (2 to a cache line).
+//	Indexed the same as GFXNodes.  Axial planes get an exact unit axis, so the dot product
+//	comes out the same as PlaneDistanceFast's X - Dist.
+//
+typedef struct
+{
+	geFloat		Normal[3];
+	geFloat		Dist;
+	int32		Children[2];					// >= 0 is a node, else RAYTRACE_EMPTY/RAYTRACE_SOLID
+	int32		PlaneNum;
+	int32		Pad;
+} RayTrace_Node;
+
+// The back half of a split ray, waiting to be walked
+typedef struct
+{
+	int32		Node;
+	int32		SplitNode;						// Node that split it off
+	int32		SplitSide;
+	geVec3d		Front;
+	geVec3d		Back;
+} RayTrace_StackEntry;
+
+static RayTrace_Node	*Nodes;
+static int32			NumNodes;
+static int32			RootNode;
+static RayTrace_Simd	PacketSimd;
+
+//====================================================================================
+//	LeafChild
+//====================================================================================
+static int32 LeafChild(int32 Child)
+{
+	if (Child >= 0)
+		return Child;
+
+	if (GFXLeafs[-(Child+1)].Contents & BSP_CONTENTS_SOLID2)
+		return RAYTRACE_SOLID;
+
+	return RAYTRACE_EMPTY;
+}
+
+//====================================================================================
+//	TreeDepth_r
+//====================================================================================
+static int32 TreeDepth_r(int32 Node)
+{
+	int32		d0, d1;
+
+	if (Node < 0)
+		return 0;
+
+	d0 = TreeDepth_r(GFXNodes[Node].Children[0]);
+	d1 = TreeDepth_r(GFXNodes[Node].Children[1]);
+
+	return 1 + (d0 > d1 ? d0 : d1);
+}
+
+//====================================================================================
+//	RayTrace_Build
+//====================================================================================
+geBoolean RayTrace_Build(int32 Root)
+{
+	RayTrace_Node	*pNode;
+	GFX_Plane		*pPlane;
+	int32			i, Depth;
+
+	RayTrace_Free();
+
+	Depth = TreeDepth_r(Root);
+
+	if (Depth > RAYTRACE_MAX_STACK)
+	{
+		GHook.Printf("*WARNING* RayTrace_Build:  Tree too deep (%i), using the slow ray caster.\n", Depth);
+		return GE_FALSE;
+	}
+
+	Nodes = GE_RAM_ALLOCATE_ARRAY(RayTrace_Node, NumGFXNodes > 0 ? NumGFXNodes : 1);
+
+	if (!Nodes)
+	{
+		GHook.Printf("*WARNING* RayTrace_Build:  Out of memory, using the slow ray caster.\n");
+		return GE_FALSE;
+	}
+
+	NumNodes = NumGFXNodes;
+
+	for (i=0, pNode = Nodes; i< NumNodes; i++, pNode++)
+	{
+		pPlane = &GFXPlanes[GFXNodes[i].PlaneNum];
+
+		switch (pPlane->Type)
+		{
+			case PLANE_X:
+				pNode->Normal[0] = 1.0f;
+				pNode->Normal[1] = 0.0f;
+				pNode->Normal[2] = 0.0f;
+				break;
+			case PLANE_Y:
+				pNode->Normal[0] = 0.0f;
+				pNode->Normal[1] = 1.0f;
+				pNode->Normal[2] = 0.0f;
+				break;
+			case PLANE_Z:
+				pNode->Normal[0] = 0.0f;
+				pNode->Normal[1] = 0.0f;
+				pNode->Normal[2] = 1.0f;
+				break;
+			default:
+				pNode->Normal[0] = pPlane->Normal.X;
+				pNode->Normal[1] = pPlane->Normal.Y;
+				pNode->Normal[2] = pPlane->Normal.Z;
+				break;
+		}
+
+		pNode->Dist = pPlane->Dist;
+		pNode->Children[0] = LeafChild(GFXNodes[i].Children[0]);
+		pNode->Children[1] = LeafChild(GFXNodes[i].Children[1]);
+		pNode->PlaneNum = GFXNodes[i].PlaneNum;
+		pNode->Pad = 0;
+	}
+
+	RootNode = LeafChild(Root);
+
+	PacketSimd = RAYTRACE_SIMD_NONE;
+
+#ifdef GE_HAVE_SSE2
+	if (CPUInfo_TestForSSE2())
+		PacketSimd = RAYTRACE_SIMD_SSE2;
+#endif
+#ifdef GE_HAVE_AVX2
+	if (CPUInfo_TestForAVX2())
+		PacketSimd = RAYTRACE_SIMD_AVX2;
+#endif
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	RayTrace_Free
+//====================================================================================
+void RayTrace_Free(void)
+{
+	if (Nodes)
+		geRam_Free(Nodes);
+
+	Nodes = NULL;
+	NumNodes = 0;
+	RootNode = RAYTRACE_EMPTY;
+}
+
+//====================================================================================
+//	RayTrace_IsBuilt
+//====================================================================================
+geBoolean RayTrace_IsBuilt(void)
+{
+	return (Nodes != NULL);
+}
+
+//====================================================================================
+//	TraceFromNode
+//	Walks the ray front to back, splitting where it crosses a plane.  The front half is
+//	walked right away, the back half goes on the stack.  The first solid leaf reached is
+//	the hit, and the split that started the piece of ray we are on is the plane it hit.
+//	This gives the same answers as the recursive RayIntersect in Light.cpp.
+//====================================================================================
+static geBoolean TraceFromNode(int32 Node, const geVec3d *Front, const geVec3d *Back, RayTrace_Hit *Hit)
+{
+	RayTrace_StackEntry	Stack[RAYTRACE_MAX_STACK];
+	RayTrace_StackEntry	*pEntry;
+	RayTrace_Node		*pNode;
+	int32				NumStack, SplitNode, SplitSide, Side;
+	geFloat				Fd, Bd, Dist;
+	geVec3d				F, B, I;
+
+	F = *Front;
+	B = *Back;
+	SplitNode = -1;
+	SplitSide = 0;
+	NumStack = 0;
+
+	while (1)
+	{
+		while (Node >= 0)
+		{
+			pNode = &Nodes[Node];
+
+			Fd = F.X*pNode->Normal[0] + F.Y*pNode->Normal[1] + F.Z*pNode->Normal[2] - pNode->Dist;
+			Bd = B.X*pNode->Normal[0] + B.Y*pNode->Normal[1] + B.Z*pNode->Normal[2] - pNode->Dist;
+
+			if (Fd >= -1 && Bd >= -1)
+			{
+				Node = pNode->Children[0];
+				continue;
+			}
+			if (Fd < 1 && Bd < 1)
+			{
+				Node = pNode->Children[1];
+				continue;
+			}
+
+			Side = Fd < 0;
+			Dist = Fd / (Fd - Bd);
+
+			I.X = F.X + Dist * (B.X - F.X);
+			I.Y = F.Y + Dist * (B.Y - F.Y);
+			I.Z = F.Z + Dist * (B.Z - F.Z);
+
+			assert(NumStack < RAYTRACE_MAX_STACK);		// RayTrace_Build checked the depth
+
+			pEntry = &Stack[NumStack++];
+			pEntry->Node = pNode->Children[!Side];
+			pEntry->SplitNode = Node;
+			pEntry->SplitSide = Side;
+			pEntry->Front = I;
+			pEntry->Back = B;
+
+			B = I;
+			Node = pNode->Children[Side];
+		}
+
+		if (Node == RAYTRACE_SOLID)
+		{
+			if (Hit)
+			{
+				if (SplitNode >= 0)
+				{
+					Hit->HitLeaf = GE_TRUE;
+					Hit->Plane = Nodes[SplitNode].PlaneNum;
+					Hit->Node = SplitNode;
+					Hit->Side = SplitSide;
+					Hit->I = F;
+				}
+				else
+					Hit->HitLeaf = GE_FALSE;		// Started out in solid
+			}
+			return GE_TRUE;
+		}
+
+		if (!NumStack)
+			return GE_FALSE;
+
+		pEntry = &Stack[--NumStack];
+
+		Node = pEntry->Node;
+		SplitNode = pEntry->SplitNode;
+		SplitSide = pEntry->SplitSide;
+		F = pEntry->Front;
+		B = pEntry->Back;
+	}
+}
+
+//====================================================================================
+//	RayTrace_Collision
+//====================================================================================
+geBoolean RayTrace_Collision(const geVec3d *Front, const geVec3d *Back, RayTrace_Hit *Hit)
+{
+	assert(Nodes);
+
+	return TraceFromNode(RootNode, Front, Back, Hit);
+}
+
+//====================================================================================
+//	RayTrace_SetPacketRay
+//====================================================================================
+void RayTrace_SetPacketRay(RayTrace_Packet *Packet, int32 Ray, const geVec3d *Front, const geVec3d *Back)
+{
+	assert(Ray >= 0 && Ray < RAYTRACE_PACKET_SIZE);
+
+	Packet->FrontX[Ray] = Front->X;
+	Packet->FrontY[Ray] = Front->Y;
+	Packet->FrontZ[Ray] = Front->Z;
+	Packet->BackX[Ray] = Back->X;
+	Packet->BackY[Ray] = Back->Y;
+	Packet->BackZ[Ray] = Back->Z;
+}
+
+//====================================================================================
+//	PacketChild
+//	Gets the child every ray in the packet goes down without being split.  Returns
+//	GE_FALSE if they go different ways.
+//====================================================================================
+static geBoolean PacketChild(const RayTrace_Node *pNode, const RayTrace_Packet *Packet, uint32 RayMask, int32 *Child)
+{
+	uint32		Go0, Go1;
+	int32		i;
+
+#ifdef GE_HAVE_AVX2
+	if (PacketSimd == RAYTRACE_SIMD_AVX2)
+	{
+		__m256	Nx, Ny, Nz, D, Fd, Bd, One, NegOne, m0, m1;
+
+		Nx = _mm256_set1_ps(pNode->Normal[0]);
+		Ny = _mm256_set1_ps(pNode->Normal[1]);
+		Nz = _mm256_set1_ps(pNode->Normal[2]);
+		D = _mm256_set1_ps(pNode->Dist);
+		One = _mm256_set1_ps(1.0f);
+		NegOne = _mm256_set1_ps(-1.0f);
+
+		Fd = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(Packet->FrontX), Nx), _mm256_mul_ps(_mm256_loadu_ps(Packet->FrontY), Ny));
+		Fd = _mm256_sub_ps(_mm256_add_ps(Fd, _mm256_mul_ps(_mm256_loadu_ps(Packet->FrontZ), Nz)), D);
+		Bd = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(Packet->BackX), Nx), _mm256_mul_ps(_mm256_loadu_ps(Packet->BackY), Ny));
+		Bd = _mm256_sub_ps(_mm256_add_ps(Bd, _mm256_mul_ps(_mm256_loadu_ps(Packet->BackZ), Nz)), D);
+
+		m0 = _mm256_and_ps(_mm256_cmp_ps(Fd, NegOne, _CMP_GE_OQ), _mm256_cmp_ps(Bd, NegOne, _CMP_GE_OQ));
+		m1 = _mm256_andnot_ps(m0, _mm256_and_ps(_mm256_cmp_ps(Fd, One, _CMP_LT_OQ), _mm256_cmp_ps(Bd, One, _CMP_LT_OQ)));
+
+		Go0 = (uint32)_mm256_movemask_ps(m0) & RayMask;
+		Go1 = (uint32)_mm256_movemask_ps(m1) & RayMask;
+
+		_mm256_zeroupper();
+	}
+	else
+#endif
+#ifdef GE_HAVE_SSE2
+	if (PacketSimd == RAYTRACE_SIMD_SSE2)
+	{
+		__m128	Nx, Ny, Nz, D, Fd, Bd, One, NegOne, m0, m1;
+
+		Nx = _mm_set1_ps(pNode->Normal[0]);
+		Ny = _mm_set1_ps(pNode->Normal[1]);
+		Nz = _mm_set1_ps(pNode->Normal[2]);
+		D = _mm_set1_ps(pNode->Dist);
+		One = _mm_set1_ps(1.0f);
+		NegOne = _mm_set1_ps(-1.0f);
+
+		Go0 = Go1 = 0;
+
+		// 4 rays at a time
+		for (i=0; i< RAYTRACE_PACKET_SIZE; i+=4)
+		{
+			if (!((RayMask>>i) & 15))
+				break;			// The rays are packed from the front
+
+			Fd = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&Packet->FrontX[i]), Nx), _mm_mul_ps(_mm_loadu_ps(&Packet->FrontY[i]), Ny));
+			Fd = _mm_sub_ps(_mm_add_ps(Fd, _mm_mul_ps(_mm_loadu_ps(&Packet->FrontZ[i]), Nz)), D);
+			Bd = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&Packet->BackX[i]), Nx), _mm_mul_ps(_mm_loadu_ps(&Packet->BackY[i]), Ny));
+			Bd = _mm_sub_ps(_mm_add_ps(Bd, _mm_mul_ps(_mm_loadu_ps(&Packet->BackZ[i]), Nz)), D);
+
+			m0 = _mm_and_ps(_mm_cmpge_ps(Fd, NegOne), _mm_cmpge_ps(Bd, NegOne));
+			m1 = _mm_andnot_ps(m0, _mm_and_ps(_mm_cmplt_ps(Fd, One), _mm_cmplt_ps(Bd, One)));
+
+			Go0 |= (uint32)_mm_movemask_ps(m0) << i;
+			Go1 |= (uint32)_mm_movemask_ps(m1) << i;
+		}
+
+		Go0 &= RayMask;
+		Go1 &= RayMask;
+	}
+	else
+#endif
+	{
+		geFloat		Fd, Bd;
+
+		Go0 = Go1 = 0;
+
+		for (i=0; i< RAYTRACE_PACKET_SIZE; i++)
+		{
+			if (!(RayMask & (1<<i)))
+				continue;
+
+			Fd = Packet->FrontX[i]*pNode->Normal[0] + Packet->FrontY[i]*pNode->Normal[1] + Packet->FrontZ[i]*pNode->Normal[2] - pNode->Dist;
+			Bd = Packet->BackX[i]*pNode->Normal[0] + Packet->BackY[i]*pNode->Normal[1] + Packet->BackZ[i]*pNode->Normal[2] - pNode->Dist;
+
+			if (Fd >= -1 && Bd >= -1)
+				Go0 |= (1<<i);
+			else if (Fd < 1 && Bd < 1)
+				Go1 |= (1<<i);
+		}
+	}
+
+	if (Go0 == RayMask)
+		*Child = pNode->Children[0];
+	else if (Go1 == RayMask)
+		*Child = pNode->Children[1];
+	else
+		return GE_FALSE;
+
+	return GE_TRUE;
+}
+
+//====================================================================================
+//	RayTrace_CollisionPacket
+//	The packet walks down together as long as none of it's rays get split, then each ray
+//	finishes on it's own from the node where they parted.  Rays that share a start point
+//	(shadow rays from one patch, etc) stay together a long way down the tree.
+//====================================================================================
+uint32 RayTrace_CollisionPacket(const RayTrace_Packet *Packet, int32 NumRays)
+{
+	uint32		RayMask, Hits;
+	int32		Node, i;
+	geVec3d		Front, Back;
+
+	assert(Nodes);
+	assert(NumRays > 0 && NumRays <= RAYTRACE_PACKET_SIZE);
+
+	RayMask = (1<<NumRays)-1;
+	Node = RootNode;
+
+	while (Node >= 0)
+	{
+		if (!PacketChild(&Nodes[Node], Packet, RayMask, &Node))
+			break;
+	}
+
+	if (Node == RAYTRACE_SOLID)
+		return RayMask;
+	if (Node == RAYTRACE_EMPTY)
+		return 0;
+
+	Hits = 0;
+
+	for (i=0; i< NumRays; i++)
+	{
+		Front.X = Packet->FrontX[i];
+		Front.Y = Packet->FrontY[i];
+		Front.Z = Packet->FrontZ[i];
+		Back.X = Packet->BackX[i];
+		Back.Y = Packet->BackY[i];
+		Back.Z = Packet->BackZ[i];
+
+		if (TraceFromNode(Node, &Front, &Back, NULL))
+			Hits |= (1<<i);
+	}
+
+	return Hits;
+}
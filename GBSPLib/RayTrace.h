@@ -0,0 +1,71 @@
+/****************************************************************************************/
+/*  RayTrace.h                                                                          */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Flattened BSP ray caster for the light compiler                        */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef RAYTRACE_H
+#define RAYTRACE_H
+
+#include <Windows.h>
+
+#include "Basetype.h"
+#include "Vec3d.h"
+
+#define RAYTRACE_MAX_STACK		256				// Deepest tree the flat caster will take
+#define RAYTRACE_PACKET_SIZE	8				// Rays in a packet (one AVX register, or two SSE ones)
+
+// What a ray hit (same answers as the old recursive RayIntersect)
+typedef struct
+{
+	geBoolean	HitLeaf;						// GE_FALSE if the ray started out in solid
+	int32		Plane;							// GFXPlanes index of the plane hit
+	int32		Node;							// GFXNodes index of the node hit
+	int32		Side;
+	geVec3d		I;								// Impact point
+} RayTrace_Hit;
+
+// RAYTRACE_PACKET_SIZE rays, laid out so each component loads as one vector
+typedef struct
+{
+	geFloat		FrontX[RAYTRACE_PACKET_SIZE];
+	geFloat		FrontY[RAYTRACE_PACKET_SIZE];
+	geFloat		FrontZ[RAYTRACE_PACKET_SIZE];
+	geFloat		BackX[RAYTRACE_PACKET_SIZE];
+	geFloat		BackY[RAYTRACE_PACKET_SIZE];
+	geFloat		BackZ[RAYTRACE_PACKET_SIZE];
+} RayTrace_Packet;
+
+//
+//	Packs the GFXNodes/GFXPlanes/GFXLeafs under RootNode into a flat array, for the calls below.
+//	Returns GE_FALSE if the tree is too deep (or out of memory), in which case the caller should
+//	keep using the recursive caster.
+//
+geBoolean	RayTrace_Build(int32 RootNode);
+void		RayTrace_Free(void);
+geBoolean	RayTrace_IsBuilt(void);
+
+// Returns GE_TRUE if the ray from Front to Back hits solid.  Hit is optional.
+geBoolean	RayTrace_Collision(const geVec3d *Front, const geVec3d *Back, RayTrace_Hit *Hit);
+
+// Casts the first NumRays rays in Packet.  Returns a bitmask of the rays that hit solid.
+uint32		RayTrace_CollisionPacket(const RayTrace_Packet *Packet, int32 NumRays);
+
+void		RayTrace_SetPacketRay(RayTrace_Packet *Packet, int32 Ray, const geVec3d *Front, const geVec3d *Back);
+
+#endif
@@ -0,0 +1,411 @@
+/****************************************************************************************/
+/*  Thread.cpp                                                                          */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Worker threads for the compile stages                                  */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Stdio.h>
+#include <StdArg.h>
+
+#include "GBSPLib.h"
+#include "Thread.h"
+#include "Pool.h"
+
+#include "Ram.h"
+
+static CRITICAL_SECTION	ThreadCritical;
+static geBoolean		Threaded = GE_FALSE;
+
+static int32			Dispatch;
+static int32			WorkCount;
+static geBoolean		WorkFailed;
+static geBoolean		WorkPacifier;
+static THREAD_WORK_CB	*WorkFunc;
+static void				*WorkContext;
+
+static GBSP_Hook		OldHook;			// Callers hook, while the threaded one is installed
+
+//====================================================================================
+//	Thread_GetNumCPUs
+//====================================================================================
+int32 Thread_GetNumCPUs(void)
+{
+	SYSTEM_INFO		Info;
+
+	GetSystemInfo(&Info);
+
+	if (Info.dwNumberOfProcessors < 1)
+		return 1;
+
+	return (int32)Info.dwNumberOfProcessors;
+}
+
+//====================================================================================
+//	Thread_ClampCount
+//====================================================================================
+int32 Thread_ClampCount(int32 NumThreads)
+{
+	if (NumThreads <= 0)
+		NumThreads = Thread_GetNumCPUs();
+
+	if (NumThreads > MAX_THREADS)
+		NumThreads = MAX_THREADS;
+
+	return NumThreads;
+}
+
+//====================================================================================
+//	Thread_Lock
+//====================================================================================
+void Thread_Lock(void)
+{
+	if (!Threaded)
+		return;
+
+	EnterCriticalSection(&ThreadCritical);
+}
+
+//====================================================================================
+//	Thread_Unlock
+//====================================================================================
+void Thread_Unlock(void)
+{
+	if (!Threaded)
+		return;
+
+	LeaveCriticalSection(&ThreadCritical);
+}
+
+//====================================================================================
+//	Thread_Printf
+//	Installed into GHook while threads are running, so callers callbacks never get
+//	entered from two threads at once
+//====================================================================================
+static void Thread_Printf(char *String, ...)
+{
+	va_list		ArgPtr;
+	char		Buffer[1024];
+
+	va_start(ArgPtr, String);
+	_vsnprintf(Buffer, sizeof(Buffer)-1, String, ArgPtr);
+	va_end(ArgPtr);
+
+	Buffer[sizeof(Buffer)-1] = 0;
+
+	Thread_Lock();
+	OldHook.Printf("%s", Buffer);
+	Thread_Unlock();
+}
+
+//====================================================================================
+//	Thread_Error
+//====================================================================================
+static void Thread_Error(char *String, ...)
+{
+	va_list		ArgPtr;
+	char		Buffer[1024];
+
+	va_start(ArgPtr, String);
+	_vsnprintf(Buffer, sizeof(Buffer)-1, String, ArgPtr);
+	va_end(ArgPtr);
+
+	Buffer[sizeof(Buffer)-1] = 0;
+
+	Thread_Lock();
+	OldHook.Error("%s", Buffer);
+	Thread_Unlock();
+}
+
+//====================================================================================
+//	GetThreadWork
+//	Hands out the next work item, in order.  Returns -1 when there is nothing left.
+//====================================================================================
+static int32 GetThreadWork(void)
+{
+	int32		Work, Perc;
+
+	Thread_Lock();
+
+	if (WorkFailed || CancelRequest || Dispatch >= WorkCount)
+	{
+		Thread_Unlock();
+		return -1;
+	}
+
+	Work = Dispatch++;
+
+	if (WorkPacifier)
+	{
+		Perc = WorkCount / 20;
+
+		if (Perc)
+		{
+			if (!(Work%Perc) && (Work/Perc) <= 20)
+				GHook.Printf(".%i", (Work/Perc));
+		}
+	}
+
+	Thread_Unlock();
+
+	return Work;
+}
+
+//====================================================================================
+//	ThreadWorker
+//====================================================================================
+static DWORD WINAPI ThreadWorker(LPVOID Param)
+{
+	int32		Work, ThreadNum;
+
+	ThreadNum = (int32)Param;
+
+	while ((Work = GetThreadWork()) != -1)
+	{
+		if (!WorkFunc(Work, ThreadNum, WorkContext))
+		{
+			Thread_Lock();
+			WorkFailed = GE_TRUE;
+			Thread_Unlock();
+			break;
+		}
+	}
+
+	if (Threaded)
+		Pool_ThreadDone();		// Hand its pooled blocks back before the thread goes away
+
+	return 0;
+}
+
+//====================================================================================
+//	RunThreads
+//	Starts NumThreads copies of Worker, and waits for them all to finish
+//====================================================================================
+static void RunThreads(int32 NumThreads, LPTHREAD_START_ROUTINE Worker)
+{
+	HANDLE		Handles[MAX_THREADS];
+	DWORD		ThreadID;
+	int32		i, NumHandles;
+
+	InitializeCriticalSection(&ThreadCritical);
+	Threaded = GE_TRUE;
+
+	OldHook = GHook;
+	GHook.Printf = Thread_Printf;
+	GHook.Error = Thread_Error;
+
+	NumHandles = 0;
+
+	for (i=0; i< NumThreads; i++)
+	{
+		Handles[NumHandles] = CreateThread(NULL, THREAD_STACK_SIZE, Worker, (LPVOID)i, 0, &ThreadID);
+
+		if (!Handles[NumHandles])
+		{
+			GHook.Printf("*WARNING* RunThreads:  Could not create thread %i.\n", i);
+			continue;
+		}
+
+		NumHandles++;
+	}
+
+	// If no threads could be created at all, do the work ourselves
+	if (!NumHandles)
+		Worker((LPVOID)0);
+	else
+		WaitForMultipleObjects(NumHandles, Handles, TRUE, INFINITE);
+
+	for (i=0; i< NumHandles; i++)
+		CloseHandle(Handles[i]);
+
+	GHook = OldHook;
+
+	Threaded = GE_FALSE;
+	DeleteCriticalSection(&ThreadCritical);
+}
+
+//====================================================================================
+//	Thread_RunOnEach
+//====================================================================================
+geBoolean Thread_RunOnEach(int32 NumThreads, int32 NumWork, THREAD_WORK_CB *Func, void *Context, geBoolean Pacifier)
+{
+	Dispatch = 0;
+	WorkCount = NumWork;
+	WorkFailed = GE_FALSE;
+	WorkPacifier = Pacifier;
+	WorkFunc = Func;
+	WorkContext = Context;
+
+	NumThreads = Thread_ClampCount(NumThreads);
+
+	if (NumThreads > NumWork)
+		NumThreads = NumWork;
+
+	if (NumThreads <= 1)
+		ThreadWorker((LPVOID)0);			// Just run it on this thread, exactly like the old loops did
+	else
+		RunThreads(NumThreads, ThreadWorker);
+
+	return (!WorkFailed && !CancelRequest);
+}
+
+//====================================================================================
+//	Work stealing
+//	Each thread gets it's own queue of work, dealt out round robin in work order.
+//	A thread takes from the front of it's own queue (earliest work first), and when
+//	it runs dry, steals from the back of someone elses (the latest work they have).
+//====================================================================================
+typedef struct
+{
+	CRITICAL_SECTION	Lock;
+	int32				*Work;
+	int32				Head;				// Next to take from the front
+	int32				Tail;				// One past the last to steal from the back
+} Thread_Queue;
+
+static Thread_Queue		Queues[MAX_THREADS];
+static int32			NumQueues;
+
+//====================================================================================
+//	PopQueueWork
+//====================================================================================
+static int32 PopQueueWork(int32 ThreadNum)
+{
+	Thread_Queue	*Queue;
+	int32			i, Work;
+
+	if (WorkFailed || CancelRequest)
+		return -1;
+
+	// Our own queue first
+	Queue = &Queues[ThreadNum];
+
+	EnterCriticalSection(&Queue->Lock);
+
+	if (Queue->Head < Queue->Tail)
+	{
+		Work = Queue->Work[Queue->Head++];
+		LeaveCriticalSection(&Queue->Lock);
+		return Work;
+	}
+
+	LeaveCriticalSection(&Queue->Lock);
+
+	// Then go steal from the others
+	for (i=1; i< NumQueues; i++)
+	{
+		Queue = &Queues[(ThreadNum+i)%NumQueues];
+
+		EnterCriticalSection(&Queue->Lock);
+
+		if (Queue->Head < Queue->Tail)
+		{
+			Work = Queue->Work[--Queue->Tail];
+			LeaveCriticalSection(&Queue->Lock);
+			return Work;
+		}
+
+		LeaveCriticalSection(&Queue->Lock);
+	}
+
+	return -1;		// Everyone is dry (work is never added once started)
+}
+
+//====================================================================================
+//	StealingWorker
+//====================================================================================
+static DWORD WINAPI StealingWorker(LPVOID Param)
+{
+	int32		Work, ThreadNum;
+
+	ThreadNum = (int32)Param;
+
+	while ((Work = PopQueueWork(ThreadNum)) != -1)
+	{
+		if (!WorkFunc(Work, ThreadNum, WorkContext))
+		{
+			Thread_Lock();
+			WorkFailed = GE_TRUE;
+			Thread_Unlock();
+			break;
+		}
+	}
+
+	if (Threaded)
+		Pool_ThreadDone();		// Hand its pooled blocks back before the thread goes away
+
+	return 0;
+}
+
+//====================================================================================
+//	Thread_RunStealing
+//====================================================================================
+geBoolean Thread_RunStealing(int32 NumThreads, int32 NumWork, THREAD_WORK_CB *Func, void *Context)
+{
+	int32		*QueueWork;
+	int32		i, k, Count;
+
+	NumThreads = Thread_ClampCount(NumThreads);
+
+	if (NumThreads > NumWork)
+		NumThreads = NumWork;
+
+	if (NumThreads <= 1)
+		return Thread_RunOnEach(1, NumWork, Func, Context, GE_FALSE);
+
+	QueueWork = GE_RAM_ALLOCATE_ARRAY(int32, NumWork);
+
+	if (!QueueWork)
+	{
+		GHook.Error("Thread_RunStealing:  Out of memory for work queues.\n");
+		return GE_FALSE;
+	}
+
+	WorkFailed = GE_FALSE;
+	WorkFunc = Func;
+	WorkContext = Context;
+
+	// Deal the work out, so every queue starts with the earliest work it can
+	NumQueues = NumThreads;
+	Count = 0;
+
+	for (i=0; i< NumQueues; i++)
+	{
+		InitializeCriticalSection(&Queues[i].Lock);
+
+		Queues[i].Work = &QueueWork[Count];
+		Queues[i].Head = 0;
+		Queues[i].Tail = 0;
+
+		for (k=i; k< NumWork; k+=NumQueues)
+			Queues[i].Work[Queues[i].Tail++] = k;
+
+		Count += Queues[i].Tail;
+	}
+
+	RunThreads(NumThreads, StealingWorker);
+
+	for (i=0; i< NumQueues; i++)
+		DeleteCriticalSection(&Queues[i].Lock);
+
+	NumQueues = 0;
+
+	geRam_Free(QueueWork);
+
+	return (!WorkFailed && !CancelRequest);
+}
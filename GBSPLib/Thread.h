@@ -0,0 +1,58 @@
+/****************************************************************************************/
+/*  Thread.h                                                                            */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Worker threads for the compile stages                                  */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <Windows.h>
+
+#include "Basetype.h"
+
+#define MAX_THREADS			64					// MAXIMUM_WAIT_OBJECTS
+#define THREAD_STACK_SIZE	(4*1024*1024)		// The compile routines recurse deep, with big stack frames
+
+// Called once per work item.  Return GE_FALSE to stop handing out work.
+typedef geBoolean THREAD_WORK_CB(int32 Work, int32 ThreadNum, void *Context);
+
+int32		Thread_GetNumCPUs(void);
+int32		Thread_ClampCount(int32 NumThreads);		// 0 = one thread per cpu
+
+//
+//	Runs Func once for every Work in 0..NumWork-1, spread across NumThreads.
+//	Work is handed out in order.  If Pacifier is set, the ".%i" progress ticks are
+//	printed as work is handed out, exactly like the serial loops do.
+//	While threads are running, GHook.Printf/Error are serialized.
+//	Returns GE_FALSE if any work failed, or a cancel was requested.
+//
+geBoolean	Thread_RunOnEach(int32 NumThreads, int32 NumWork, THREAD_WORK_CB *Func, void *Context, geBoolean Pacifier);
+
+//
+//	Same as above, but each thread works through it's own queue (earliest work first),
+//	and steals from the back of the others queues when it runs out.  For big work items
+//	that vary a lot in cost.  No progress ticks.
+//
+geBoolean	Thread_RunStealing(int32 NumThreads, int32 NumWork, THREAD_WORK_CB *Func, void *Context);
+
+// Guards data shared between work items (no-op when not running threaded)
+void		Thread_Lock(void);
+void		Thread_Unlock(void);
+
+#endif
@@ -0,0 +1,527 @@
+/****************************************************************************************/
+/*  TreeCache.cpp                                                                       */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Split choices kept between compiles                                    */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#include <Windows.h>
+#include <Stdio.h>
+#include <StdLib.h>
+#include <String.h>
+
+#include "TreeCache.h"
+#include "GBSPFile.h"
+#include "Utils.h"
+#include "Thread.h"
+
+#include "crc32.h"
+#include "Ram.h"
+
+//========================================================================================
+//	The tree cache
+//	SelectSplitSide is where most of a BSP compile goes, and what it picks for a node
+//	only depends on the node volume, and the brushes that made it down to the node (in
+//	order).  So each choice is saved under a key made from those, and the next compile
+//	of the same map can take the old choice for any node whose key it finds again.
+//	Editing a brush only changes the keys of the nodes that brush reaches, so the rest
+//	of the tree comes back from the cache, and ends up exactly as a full compile would
+//	have made it (the brushes are still split for real, only the choosing is skipped).
+//	Nothing is recorded or written unless the compile is incremental.
+//	The whole file is checked with a CRC, so a bad file is just ignored.
+//========================================================================================
+#define TREECACHE_FILE_ID		(('B'<<24) | ('T'<<16) | ('C'<<8) | 'F')
+#define TREECACHE_FILE_VERSION	2
+
+#define TREECACHE_HASH_START	2166136261				// FNV-1a
+#define TREECACHE_HASH_PRIME	16777619
+
+typedef struct
+{
+	uint32		Id;							// TREECACHE_FILE_ID
+	int32		Version;					// TREECACHE_FILE_VERSION
+	int32		GBSPVersion;				// GBSP_VERSION
+	int32		NumSplits;
+} TreeCache_Header;
+
+static geBoolean		Active = GE_FALSE;
+static geBoolean		VerifySplits;
+static char				CacheFile[MAX_PATH];
+
+static TreeCache_Split	*OldSplits;				// Loaded from the last compile, sorted on the key
+static int32			NumOldSplits;
+
+static TreeCache_Split	*NewSplits;				// Recorded this compile
+static int32			NumNewSplits;
+static int32			MaxNewSplits;
+
+static int32			NumLookups;
+static int32			NumFound;
+static int32			NumMismatched;
+
+static void FreeSplits(void);
+static geBoolean LoadSplits(void);
+static geBoolean SaveSplits(void);
+
+//========================================================================================
+//	TreeCache_Begin
+//========================================================================================
+geBoolean TreeCache_Begin(char *MapFile, geBoolean Incremental, geBoolean Verify)
+{
+	TreeCache_End(GE_FALSE);
+
+	// Only incremental compiles record splits, so a normal compile never leaves a .BTC
+	if (!Incremental)
+		return GE_TRUE;
+
+	strncpy(CacheFile, MapFile, MAX_PATH-5);
+	CacheFile[MAX_PATH-5] = 0;
+
+	StripExtension(CacheFile);
+	DefaultExtension(CacheFile, ".BTC");
+
+	VerifySplits = Verify;
+
+	NumLookups = 0;
+	NumFound = 0;
+	NumMismatched = 0;
+
+	Active = GE_TRUE;
+
+	if (!LoadSplits())
+	{
+		FreeSplits();
+		Active = GE_FALSE;
+		return GE_FALSE;
+	}
+
+	return GE_TRUE;
+}
+
+//========================================================================================
+//	TreeCache_End
+//========================================================================================
+geBoolean TreeCache_End(geBoolean Save)
+{
+	geBoolean	Ret;
+
+	if (!Active)
+		return GE_TRUE;
+
+	Ret = GE_TRUE;
+
+	if (Save)
+	{
+		if (NumOldSplits && Verbose)
+			GHook.Printf("Splits reused          : %5i of %5i\n", NumFound - NumMismatched, NumLookups);
+
+		if (NumMismatched)
+			GHook.Printf("*WARNING* TreeCache_End:  %i reused splits did not match a full compile.\n", NumMismatched);
+		else if (VerifySplits && NumFound && Verbose)
+			GHook.Printf("All reused splits matched a full compile.\n");
+
+		Ret = SaveSplits();
+	}
+
+	FreeSplits();
+
+	Active = GE_FALSE;
+
+	return Ret;
+}
+
+//========================================================================================
+//	TreeCache_IsActive
+//========================================================================================
+geBoolean TreeCache_IsActive(void)
+{
+	return Active;
+}
+
+//========================================================================================
+//	TreeCache_IsVerifying
+//========================================================================================
+geBoolean TreeCache_IsVerifying(void)
+{
+	return Active && VerifySplits;
+}
+
+//========================================================================================
+//	KeyBlock
+//========================================================================================
+static void KeyBlock(TreeCache_Key *Key, const void *Data, int32 Size)
+{
+	const uint8		*pData;
+
+	pData = (const uint8*)Data;
+
+	Key->Crc = CRC32_AddArray(Key->Crc, pData, Size);
+
+	while (Size-- > 0)
+		Key->Hash = (Key->Hash ^ *pData++) * TREECACHE_HASH_PRIME;
+}
+
+//========================================================================================
+//	KeySides
+//	Planes go in by value, so it doesn't matter if the plane numbers move around
+//========================================================================================
+static void KeySides(TreeCache_Key *Key, GBSP_Brush *Brush)
+{
+	GBSP_Side	*Side;
+	GBSP_Plane	*Plane;
+	int32		i, NumVerts;
+	uint8		Flags;
+
+	KeyBlock(Key, &Brush->NumSides, sizeof(int32));
+	KeyBlock(Key, &Brush->Mins, sizeof(geVec3d));
+	KeyBlock(Key, &Brush->Maxs, sizeof(geVec3d));
+
+	for (Side = Brush->Sides, i=0; i< Brush->NumSides; i++, Side++)
+	{
+		Plane = &Planes[Side->PlaneNum];
+
+		KeyBlock(Key, &Plane->Normal, sizeof(geVec3d));
+		KeyBlock(Key, &Plane->Dist, sizeof(geFloat));
+		KeyBlock(Key, &Side->PlaneSide, sizeof(uint8));
+
+		Flags = (uint8)(Side->Flags & ~SIDE_TESTED);
+		KeyBlock(Key, &Flags, sizeof(uint8));
+
+		NumVerts = Side->Poly ? Side->Poly->NumVerts : -1;
+		KeyBlock(Key, &NumVerts, sizeof(int32));
+
+		if (NumVerts > 0)
+			KeyBlock(Key, Side->Poly->Verts, sizeof(geVec3d)*NumVerts);
+	}
+}
+
+//========================================================================================
+//	KeyBrush
+//	Adds the key of Brush's sides, which is only made once per brush.  Brushes aren't
+//	changed once they're handed down to a node (splitting makes new ones), so the key
+//	stays good for every node the brush reaches.
+//========================================================================================
+static void KeyBrush(TreeCache_Key *Key, GBSP_Brush *Brush)
+{
+	TreeCache_Key	BrushKey;
+
+	if (!Brush->KeyValid)
+	{
+		BrushKey.Crc = CRC32_Start();
+		BrushKey.Hash = TREECACHE_HASH_START;
+
+		KeySides(&BrushKey, Brush);
+
+		Brush->KeyCrc = CRC32_Finish(BrushKey.Crc);
+		Brush->KeyHash = BrushKey.Hash;
+		Brush->KeyValid = GE_TRUE;
+	}
+
+	KeyBlock(Key, &Brush->KeyCrc, sizeof(uint32));
+	KeyBlock(Key, &Brush->KeyHash, sizeof(uint32));
+}
+
+//========================================================================================
+//	TreeCache_MakeKey
+//========================================================================================
+void TreeCache_MakeKey(GBSP_Brush *Volume, GBSP_Brush *Brushes, TreeCache_Key *Key)
+{
+	GBSP_Brush	*Brush;
+	int32		Marker;
+
+	Key->Crc = CRC32_Start();
+	Key->Hash = TREECACHE_HASH_START;
+	Key->NumBrushes = 0;
+
+	if (Volume)
+		KeyBrush(Key, Volume);
+	else
+	{
+		Marker = -1;
+		KeyBlock(Key, &Marker, sizeof(int32));
+	}
+
+	for (Brush = Brushes; Brush; Brush = Brush->Next)
+	{
+		KeyBlock(Key, &Brush->Original->Contents, sizeof(int32));
+		KeyBrush(Key, Brush);
+
+		Key->NumBrushes++;
+	}
+
+	Key->Crc = CRC32_Finish(Key->Crc);
+}
+
+//========================================================================================
+//	CompareSplits
+//========================================================================================
+static int CompareSplits(const void *a, const void *b)
+{
+	const TreeCache_Key	*A, *B;
+
+	A = &((const TreeCache_Split*)a)->Key;
+	B = &((const TreeCache_Split*)b)->Key;
+
+	if (A->Crc != B->Crc)
+		return (A->Crc < B->Crc) ? -1 : 1;
+	if (A->Hash != B->Hash)
+		return (A->Hash < B->Hash) ? -1 : 1;
+	if (A->NumBrushes != B->NumBrushes)
+		return (A->NumBrushes < B->NumBrushes) ? -1 : 1;
+
+	return 0;
+}
+
+//========================================================================================
+//	TreeCache_Find
+//========================================================================================
+const TreeCache_Split *TreeCache_Find(const TreeCache_Key *Key)
+{
+	TreeCache_Split		Test, *Split;
+
+	if (!NumOldSplits)
+		return NULL;
+
+	InterlockedIncrement(&NumLookups);
+
+	Test.Key = *Key;
+
+	Split = (TreeCache_Split*)bsearch(&Test, OldSplits, NumOldSplits, sizeof(TreeCache_Split), CompareSplits);
+
+	if (Split)
+		InterlockedIncrement(&NumFound);
+
+	return Split;
+}
+
+//========================================================================================
+//	TreeCache_Add
+//	Can be called from the tree building threads
+//========================================================================================
+geBoolean TreeCache_Add(const TreeCache_Key *Key, int32 Brush, int32 Side, uint32 Flags)
+{
+	TreeCache_Split		*Split;
+
+	if (!Active)
+		return GE_TRUE;
+
+	Thread_Lock();
+
+	if (NumNewSplits >= MaxNewSplits)
+	{
+		int32				NewMax;
+		TreeCache_Split		*NewArray;
+
+		NewMax = MaxNewSplits ? MaxNewSplits*2 : 4096;
+
+		NewArray = GE_RAM_REALLOC_ARRAY(NewSplits, TreeCache_Split, NewMax);
+
+		if (!NewArray)
+		{
+			Thread_Unlock();
+			GHook.Error("TreeCache_Add:  Out of memory for splits.\n");
+			return GE_FALSE;
+		}
+
+		NewSplits = NewArray;
+		MaxNewSplits = NewMax;
+	}
+
+	Split = &NewSplits[NumNewSplits++];
+
+	Split->Key = *Key;
+	Split->Brush = Brush;
+	Split->Side = Side;
+	Split->Flags = Flags;
+
+	Thread_Unlock();
+
+	return GE_TRUE;
+}
+
+//========================================================================================
+//	TreeCache_Mismatch
+//========================================================================================
+void TreeCache_Mismatch(void)
+{
+	InterlockedIncrement(&NumMismatched);
+}
+
+//========================================================================================
+//	FreeSplits
+//========================================================================================
+static void FreeSplits(void)
+{
+	if (OldSplits)
+		geRam_Free(OldSplits);
+	if (NewSplits)
+		geRam_Free(NewSplits);
+
+	OldSplits = NULL;
+	NumOldSplits = 0;
+
+	NewSplits = NULL;
+	NumNewSplits = 0;
+	MaxNewSplits = 0;
+}
+
+//========================================================================================
+//	LoadSplits
+//	A missing, old or bad file just means nothing gets reused
+//========================================================================================
+static geBoolean LoadSplits(void)
+{
+	FILE				*f;
+	int32				Size;
+	uint32				Crc, FileCrc;
+	TreeCache_Header	Header;
+
+	f = fopen(CacheFile, "rb");
+
+	if (!f)
+		return GE_TRUE;
+
+	fseek(f, 0, SEEK_END);
+	Size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	if (fread(&Header, sizeof(TreeCache_Header), 1, f) != 1)
+		goto BadFile;
+
+	if (Header.Id != TREECACHE_FILE_ID || Header.Version != TREECACHE_FILE_VERSION || Header.GBSPVersion != GBSP_VERSION)
+	{
+		GHook.Printf("*WARNING*  LoadSplits:  Versions do not match, skipping...\n");
+		fclose(f);
+		return GE_TRUE;
+	}
+
+	if (Header.NumSplits <= 0 || 
+		(uint32)Size != sizeof(TreeCache_Header) + sizeof(TreeCache_Split)*Header.NumSplits + sizeof(uint32))
+		goto BadFile;
+
+	OldSplits = GE_RAM_ALLOCATE_ARRAY(TreeCache_Split, Header.NumSplits);
+
+	if (!OldSplits)
+	{
+		GHook.Error("LoadSplits:  Out of memory for splits.\n");
+		fclose(f);
+		return GE_FALSE;
+	}
+
+	if (fread(OldSplits, sizeof(TreeCache_Split), Header.NumSplits, f) != (uint32)Header.NumSplits)
+		goto BadFile;
+
+	if (fread(&FileCrc, sizeof(uint32), 1, f) != 1)
+		goto BadFile;
+
+	Crc = CRC32_AddArray(CRC32_Start(), (const uint8*)&Header, sizeof(TreeCache_Header));
+	Crc = CRC32_AddArray(Crc, (const uint8*)OldSplits, sizeof(TreeCache_Split)*Header.NumSplits);
+
+	if (CRC32_Finish(Crc) != FileCrc)
+		goto BadFile;
+
+	fclose(f);
+
+	NumOldSplits = Header.NumSplits;
+
+	qsort(OldSplits, NumOldSplits, sizeof(TreeCache_Split), CompareSplits);
+
+	if (Verbose)
+		GHook.Printf("Found tree cache with %i splits.\n", NumOldSplits);
+
+	return GE_TRUE;
+
+	BadFile:
+	{
+		GHook.Printf("*WARNING*  LoadSplits:  Tree cache is bad, skipping...\n");
+
+		fclose(f);
+
+		if (OldSplits)
+			geRam_Free(OldSplits);
+
+		OldSplits = NULL;
+		NumOldSplits = 0;
+
+		return GE_TRUE;
+	}
+}
+
+//========================================================================================
+//	SaveSplits
+//	Only one split is kept for each key (the same key always gets the same split)
+//========================================================================================
+static geBoolean SaveSplits(void)
+{
+	FILE				*f;
+	int32				i, NumSplits;
+	uint32				Crc;
+	TreeCache_Header	Header;
+
+	if (!NumNewSplits)
+		return GE_TRUE;
+
+	qsort(NewSplits, NumNewSplits, sizeof(TreeCache_Split), CompareSplits);
+
+	NumSplits = 1;
+
+	for (i=1; i< NumNewSplits; i++)
+	{
+		if (!CompareSplits(&NewSplits[i], &NewSplits[NumSplits-1]))
+			continue;
+
+		NewSplits[NumSplits++] = NewSplits[i];
+	}
+
+	f = fopen(CacheFile, "wb");
+
+	if (!f)
+	{
+		GHook.Printf("*WARNING* SaveSplits:  Could not open %s for writing...\n", CacheFile);
+		return GE_TRUE;
+	}
+
+	Header.Id = TREECACHE_FILE_ID;
+	Header.Version = TREECACHE_FILE_VERSION;
+	Header.GBSPVersion = GBSP_VERSION;
+	Header.NumSplits = NumSplits;
+
+	Crc = CRC32_AddArray(CRC32_Start(), (const uint8*)&Header, sizeof(TreeCache_Header));
+	Crc = CRC32_AddArray(Crc, (const uint8*)NewSplits, sizeof(TreeCache_Split)*NumSplits);
+	Crc = CRC32_Finish(Crc);
+
+	if (fwrite(&Header, sizeof(TreeCache_Header), 1, f) != 1)
+		goto WriteError;
+
+	if (fwrite(NewSplits, sizeof(TreeCache_Split), NumSplits, f) != (uint32)NumSplits)
+		goto WriteError;
+
+	if (fwrite(&Crc, sizeof(uint32), 1, f) != 1)
+		goto WriteError;
+
+	fclose(f);
+
+	return GE_TRUE;
+
+	WriteError:
+	{
+		GHook.Printf("*WARNING* SaveSplits:  Could not save the tree cache...\n");
+		fclose(f);
+		remove(CacheFile);			// Don't leave half a file around
+		return GE_TRUE;
+	}
+}
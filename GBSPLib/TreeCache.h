@@ -0,0 +1,74 @@
+/****************************************************************************************/
+/*  TreeCache.h                                                                         */
+/*                                                                                      */
+/*  Author:                                                                             */
+/*  Description: Split choices kept between compiles                                    */
+/*                                                                                      */
+/*  The contents of this file are subject to the Genesis3D Public License               */
+/*  Version 1.01 (the "License"); you may not use this file except in                   */
+/*  compliance with the License. You may obtain a copy of the License at                */
+/*  http://www.genesis3d.com                                                            */
+/*                                                                                      */
+/*  Software distributed under the License is distributed on an "AS IS"                 */
+/*  basis, WITHOUT WARRANTY OF ANY KIND, either express or implied.  See                */
+/*  the License for the specific language governing rights and limitations              */
+/*  under the License.                                                                  */
+/*                                                                                      */
+/*  The Original Code is Genesis3D, released March 25, 1999.                            */
+/*  Genesis3D Version 1.1 released November 15, 1999                                 */
+/*  Copyright (C) 1999 WildTangent, Inc. All Rights Reserved           */
+/*                                                                                      */
+/****************************************************************************************/
+#ifndef TREECACHE_H
+#define TREECACHE_H
+
+#include <Windows.h>
+
+#include "Basetype.h"
+#include "BSP.h"
+#include "Brush2.h"
+
+#define TREECACHE_LEAF			-1				// Split.Brush for a node that was made a leaf
+
+#define TREECACHE_DETAIL		(1<<0)			// Node was marked detail
+#define TREECACHE_NONVIS		(1<<1)			// Split came from a non visible side
+
+// Identifies everything SelectSplitSide looks at: the node volume, and the brushes (in order)
+typedef struct
+{
+	uint32		Crc;
+	uint32		Hash;
+	int32		NumBrushes;
+} TreeCache_Key;
+
+typedef struct
+{
+	TreeCache_Key	Key;
+	int32			Brush;					// Brush in the list that owns the split side, or TREECACHE_LEAF
+	int32			Side;					// Side on that brush
+	uint32			Flags;					// TREECACHE_DETAIL, TREECACHE_NONVIS
+} TreeCache_Split;
+
+//
+//	If Incremental, loads the choices saved by the last compile of MapFile for TreeCache_Find,
+//	and starts recording the choices of this compile, to be saved next to MapFile.
+//	Otherwise the cache stays inactive, and nothing is read or written.
+//	If Verify, the caller is asked to choose every reused split again, and report differences.
+//
+geBoolean	TreeCache_Begin(char *MapFile, geBoolean Incremental, geBoolean Verify);
+
+// Saves the choices recorded this compile if Save, and frees everything.  Safe to call twice.
+geBoolean	TreeCache_End(geBoolean Save);
+
+geBoolean	TreeCache_IsActive(void);
+geBoolean	TreeCache_IsVerifying(void);
+
+void		TreeCache_MakeKey(GBSP_Brush *Volume, GBSP_Brush *Brushes, TreeCache_Key *Key);
+
+// Returns the choice the last compile made for Key, or NULL
+const TreeCache_Split *TreeCache_Find(const TreeCache_Key *Key);
+
+geBoolean	TreeCache_Add(const TreeCache_Key *Key, int32 Brush, int32 Side, uint32 Flags);
+void		TreeCache_Mismatch(void);
+
+#endif
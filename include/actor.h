@@ -296,6 +296,25 @@ geBoolean GENESISCC geActor_RenderThroughFrustum(const geActor *A, geEngine *Eng
 geBoolean GENESISCC geActor_Render(const geActor *A, geEngine *Engine, geWorld *World, geCamera *Camera);
 #endif
 
+	// Poses and skins Actors for geActor_Render from Camera ahead of time, across NumThreads
+	// (0 for one per cpu).  Actors attached to each other are done on the same thread.
+	// geActor_Render uses the results as long as it comes next, with the same Camera.
+geBoolean GENESISCC geActor_RenderPrepBatch(const geActor * const *Actors, int32 Count, const geCamera *Camera, int32 NumThreads);
+
+	// Frees what geActor_RenderPrepBatch and geActor_AnimationStepBatch keep between calls
+void GENESISCC geActor_BatchShutdown(void);
+
+	// Returns a number that changes whenever the actors boxes (ExtBox and RenderHintExtBox) might have moved
+uint32 GENESISCC geActor_GetBoxStamp(const geActor *A);
+
+	// Called with Context and Tag whenever the actors boxes might have moved (from whatever
+	// thread moved them)
+typedef void GENESISCC geActor_BoxWatchCB(void *Context, int32 Tag);
+
+	// Has CB told about the actors box changes till the watch is removed
+geBoolean GENESISCC geActor_AddBoxWatch(geActor *A, geActor_BoxWatchCB *CB, void *Context, int32 Tag);
+void GENESISCC geActor_RemoveBoxWatch(geActor *A, geActor_BoxWatchCB *CB, void *Context, int32 Tag);
+
 // GENESIS_PUBLIC_APIS
 
 	// Poses the actor in its default pose
@@ -417,6 +436,11 @@ GENESISAPI geBoolean GENESISCC geActor_AnimationRemoveLastCue( geActor *A );
 	// Animation Cues. (failure implies Actor is incompletely initialized)
 GENESISAPI geBoolean GENESISCC geActor_AnimationStep(geActor *A, geFloat DeltaTime );
 
+	// geActor_AnimationStep for Count actors at once.  The cues are stepped on this thread, 
+	// and the poses are sampled across NumThreads (0 for one per cpu), with actors attached
+	// to each other on the same thread.
+GENESISAPI geBoolean GENESISCC geActor_AnimationStepBatch(geActor * const *Actors, int32 Count, geFloat DeltaTime, int32 NumThreads);
+
 	// applies a 'temporary' time step to actor A.  re-poses the actor according to all 
 	// currently appliciable cues.  (failure implies Actor is incompletely initialized)
 	// DeltaTime is always relative to the the last AnimationStep()
@@ -172,6 +172,17 @@ GENESISAPI geMotion *GENESISCC geMotion_CreateFromFile(geVFile *f);
 GENESISAPI geBoolean GENESISCC geMotion_WriteToFile(const geMotion *M, geVFile *f);
 GENESISAPI geBoolean GENESISCC geMotion_WriteToBinaryFile(const geMotion *M,geVFile *pFile);
 
+int GENESISCC geMotion_GetCursorCount(const geMotion *M);
+	// how many int32 cursors the *Cursor functions below need for M (0 if M has no paths yet).
+	// Start them all at -1.
+
+void GENESISCC geMotion_SampleChannelsCursor(const geMotion *M, int PathIndex, geFloat Time, int32 *Cursor, geQuaternion *Rotation, geVec3d *Translation);
+geBoolean GENESISCC geMotion_SampleChannelsNamedCursor(const geMotion *M, const char *PathName, geFloat Time, int32 *Cursor, geQuaternion *Rotation, geVec3d *Translation);
+geBoolean GENESISCC geMotion_GetTransformCursor(const geMotion *M, geFloat Time, int32 *Cursor, geXForm3d *Transform);
+	// same as the functions without Cursor, but every path sampled (blend paths included, all
+	// the way down through the sub-motions) keeps its keys in Cursor instead of in the path, so
+	// threads sampling shared motions don't write to them.  A NULL Cursor uses the paths' own.
+
 #ifdef __cplusplus
 }
 #endif
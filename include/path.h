@@ -120,6 +120,16 @@ void GENESISCC gePath_SampleChannels(
 	// returns a rotation and a translation for the path at 'Time'
 	// p is not const because information is cached in p for next sample
 
+void GENESISCC gePath_SampleChannelsCursor(
+	const gePath *P, 
+	geFloat Time, 
+	int32 *Cursor,
+	geQuaternion *Rotation, 
+	geVec3d *Translation);
+	// same as gePath_SampleChannels, but the caller keeps track of the keys used last time, in
+	// Cursor[0] (rotation) and Cursor[1] (translation).  Start them at -1.  Sampling is quicker
+	// when time moves forward, and the keys cached in p are not used or changed.
+
 GENESISAPI geBoolean GENESISCC gePath_OffsetTimes(gePath *P, 
 	int StartingIndex, int ChannelMask, geFloat TimeOffset );
 		// slides all samples in path starting with StartingIndex down by TimeOffset